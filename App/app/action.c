@@ -125,6 +125,9 @@ void (*action_opt_table[])(void) = {
     [ACTION_OPT_REGA_ALARM] = &ACTION_RegaAlarm,
     [ACTION_OPT_REGA_TEST] = &ACTION_RegaTest,
 #endif
+#ifdef ENABLE_CHANNEL_BANKS
+    [ACTION_OPT_CHANNEL_BANK] = &ACTION_ChannelBank,
+#endif
 };
 
 static_assert(ARRAY_SIZE(action_opt_table) == ACTION_OPT_LEN);
@@ -653,6 +656,15 @@ void ACTION_BackLightOnDemand(void)
     }
     //#endif
 
+#ifdef ENABLE_CHANNEL_BANKS
+    void ACTION_ChannelBank(void)
+    {
+        SETTINGS_SelectChannelBank((gEeprom.CHANNEL_BANK + 1) % CHANNEL_BANK_COUNT);
+        gVfoConfigureMode = VFO_CONFIGURE_RELOAD;
+        gUpdateDisplay    = true;
+    }
+#endif
+
     #ifdef ENABLE_FEAT_N7SIX_RESCUE_OPS
     void ACTION_Power_High(void)
     {
@@ -28,6 +28,7 @@
 #include "frequencies.h"
 #include "misc.h"
 #include "radio.h"
+#include "settings.h"
 #include "ui/helper.h"
 #include "ui/inputbox.h"
 #include "ui/ui.h"
@@ -138,6 +139,7 @@ void AIRCOPY_StorePacket(void)
         pData += 4;
         Offset += 8;
     }
+    SETTINGS_InvalidateChannelIndex();
 
     if (Offset == 0x1E00) {
         gAircopyState = AIRCOPY_COMPLETE;
@@ -54,6 +54,7 @@
 #include "driver/bk4819.h"
 #include "driver/gpio.h"
 #include "driver/keyboard.h"
+#include "driver/py25q16.h"
 #include "driver/st7565.h"
 #include "driver/system.h"
 #include "dtmf.h"
@@ -1360,6 +1361,37 @@ static void CheckKeys(void)
     }
 }
 
+#ifdef ENABLE_FLASH_WRITE_BACK
+// Writes held in the flash driver's sector cache go to the chip once the
+// radio is idle, or after flash_write_back_max_10ms whatever it is doing
+static void FlashWriteBack(void)
+{
+    static bool Pending;
+
+    if (PY25Q16_IsBusy())
+        return;
+
+    if (!PY25Q16_IsDirty()) {
+        Pending = false;
+        return;
+    }
+
+    if (!Pending) {
+        Pending = true;
+        gFlashWriteBackCountdown_10ms = flash_write_back_max_10ms;
+    }
+
+    const uint16_t Age  = flash_write_back_max_10ms - gFlashWriteBackCountdown_10ms;
+    const bool     Busy = gCurrentFunction == FUNCTION_TRANSMIT || gScanStateDir != SCAN_OFF ||
+                          SCANNER_IsScanning() || gCssBackgroundScan;
+
+    if (gFlashWriteBackCountdown_10ms == 0 || (!Busy && Age >= flash_write_back_idle_10ms)) {
+        PY25Q16_FlushAsync(NULL);   // stepped from the main loop
+        Pending = false;
+    }
+}
+#endif
+
 void APP_TimeSlice10ms(void)
 {
     gNextTimeslice = false;
@@ -1379,6 +1411,10 @@ void APP_TimeSlice10ms(void)
     }
 #endif
 
+#ifdef ENABLE_FLASH_WRITE_BACK
+    FlashWriteBack();
+#endif
+
     if (gReducedService)
         return;
 
@@ -1393,6 +1429,9 @@ void APP_TimeSlice10ms(void)
 #endif
     }
 
+#ifdef ENABLE_FRAME_GOVERNOR
+    const bool gRendered = GUI_Render();
+#else
     bool gUpdateDisplayCurrent = gUpdateDisplay;
     bool gUpdateStatusCurrent  = gUpdateStatus;
 
@@ -1405,10 +1444,15 @@ void APP_TimeSlice10ms(void)
         UI_DisplayStatus();
     }
 
+    const bool gRendered = gUpdateDisplayCurrent || gUpdateStatusCurrent;
+#endif
+
     #ifdef ENABLE_FEAT_N7SIX_SCREENSHOT
-    if (gUpdateDisplayCurrent || gUpdateStatusCurrent) {
+    if (gRendered) {
         getScreenShot(false);
     }
+    #else
+    (void)gRendered;
     #endif
 
     // Skipping authentic device checks
@@ -1672,6 +1716,7 @@ void APP_TimeSlice500ms(void)
 
         if (gBatteryCurrent > 500 || gBatteryCalibration[3] < gBatteryCurrentVoltage)
         {
+            PY25Q16_Flush();
             #ifdef ENABLE_OVERLAY
                 overlay_FLASH_RebootToBootloader();
             #else
@@ -0,0 +1,123 @@
+/* Spectrum blacklist, see blacklist.h. */
+
+#include <string.h>
+
+#include "app/blacklist.h"
+#include "driver/py25q16.h"
+#include "frequencies.h"
+
+#define NO_BAND     0xFF
+#define UNUSED      0xFFFFFFFFu     // erased flash
+
+uint8_t gBlacklistBits[BLACKLIST_BITS / 8];
+uint8_t gBlacklistShift;
+
+// Packed from entry 0, UNUSED after the last one, as stored
+static uint32_t gList[BLACKLIST_ENTRIES];
+static uint8_t  gCount;
+static uint8_t  gBand = NO_BAND;
+
+// Geometry of the projection in gBlacklistBits
+static uint32_t gStart;
+static uint16_t gStep;
+static uint16_t gSteps;
+
+static void Load(uint8_t Band)
+{
+    PY25Q16_ReadBuffer(BLACKLIST_FLASH_BASE + Band * BLACKLIST_PROFILE_SIZE, gList, sizeof(gList));
+
+    gCount = 0;
+    while (gCount < BLACKLIST_ENTRIES && gList[gCount] != UNUSED)
+        gCount++;
+
+    // Whatever follows a hole is not part of the list
+    for (unsigned i = gCount; i < BLACKLIST_ENTRIES; i++)
+        gList[i] = UNUSED;
+
+    gBand = Band;
+}
+
+static void Save(void)
+{
+    PY25Q16_WriteBuffer(BLACKLIST_FLASH_BASE + gBand * BLACKLIST_PROFILE_SIZE, gList, sizeof(gList), false);
+    PY25Q16_Flush();
+}
+
+static void Mark(uint32_t Frequency)
+{
+    // Nearest step, off the sweep is ignored
+    const uint32_t Offset = Frequency + gStep / 2;
+    if (gStep == 0 || Offset < gStart)
+        return;
+
+    const uint32_t Index = (Offset - gStart) / gStep;
+    if (Index >= gSteps)
+        return;
+
+    const uint16_t Bit = Index >> gBlacklistShift;
+    gBlacklistBits[Bit >> 3] |= 1u << (Bit & 7);
+}
+
+static void Reproject(void)
+{
+    memset(gBlacklistBits, 0, sizeof(gBlacklistBits));
+
+    gBlacklistShift = 0;
+    while (gSteps && (uint16_t)(gSteps - 1) >> gBlacklistShift >= BLACKLIST_BITS)
+        gBlacklistShift++;
+
+    for (unsigned i = 0; i < gCount; i++)
+        Mark(gList[i]);
+}
+
+void BLACKLIST_Project(uint32_t Start, uint16_t Step, uint16_t Count)
+{
+    const uint8_t Band = FREQUENCY_GetBand(Start);
+
+    if (Band == gBand && Start == gStart && Step == gStep && Count == gSteps)
+        return;
+
+    if (Band != gBand)
+        Load(Band);
+
+    gStart = Start;
+    gStep  = Step;
+    gSteps = Count;
+    Reproject();
+}
+
+void BLACKLIST_Add(uint32_t Frequency)
+{
+    if (gBand == NO_BAND)
+        Load(FREQUENCY_GetBand(Frequency));
+
+    for (unsigned i = 0; i < gCount; i++)
+        if (gList[i] == Frequency)
+            return;
+
+    if (gCount == BLACKLIST_ENTRIES) {
+        memmove(gList, gList + 1, sizeof(gList) - sizeof(gList[0]));
+        gCount--;
+        Reproject();
+    }
+
+    gList[gCount++] = Frequency;
+    Mark(Frequency);
+    Save();
+}
+
+void BLACKLIST_Clear(void)
+{
+    if (gBand == NO_BAND)
+        return;
+
+    memset(gList, 0xFF, sizeof(gList));
+    memset(gBlacklistBits, 0, sizeof(gBlacklistBits));
+    gCount = 0;
+    Save();
+}
+
+uint8_t BLACKLIST_GetCount(void)
+{
+    return gCount;
+}
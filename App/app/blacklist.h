@@ -0,0 +1,45 @@
+/* Spectrum blacklist: steps the sweep skips, kept per band in flash.
+ *
+ * The list itself holds frequencies, so it survives span and step changes
+ * and leaving the spectrum. For the sweep it is projected onto a bitmap of
+ * the current steps, redone only when the sweep start, step or length
+ * changes, which makes the per-step check a bit test. Sweeps longer than
+ * BLACKLIST_BITS steps share a bit between 2, 4, ... neighbouring steps.
+ *
+ * Each band of frequencyBandTable has its own list of BLACKLIST_ENTRIES in
+ * a BLACKLIST_PROFILE_SIZE slot of the sector at BLACKLIST_FLASH_BASE; the
+ * sweep start frequency picks the band.
+ */
+
+#ifndef APP_BLACKLIST_H
+#define APP_BLACKLIST_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define BLACKLIST_FLASH_BASE    0x015000
+#define BLACKLIST_PROFILE_SIZE  0x80
+#define BLACKLIST_ENTRIES       (BLACKLIST_PROFILE_SIZE / 4)
+#define BLACKLIST_BITS          1024
+
+extern uint8_t gBlacklistBits[BLACKLIST_BITS / 8];
+extern uint8_t gBlacklistShift;
+
+// Projects the list of Start's band onto a sweep of Count steps of Step
+// from Start (10 Hz units), loading the list when the band changes
+void BLACKLIST_Project(uint32_t Start, uint16_t Step, uint16_t Count);
+// Adds Frequency to the current band's list and saves it, the oldest entry
+// goes when the list is full
+void BLACKLIST_Add(uint32_t Frequency);
+// Empties the current band's list and saves it
+void BLACKLIST_Clear(void);
+uint8_t BLACKLIST_GetCount(void);
+
+// Step Index of the projected sweep is to be skipped
+static inline bool BLACKLIST_IsSet(uint16_t Index)
+{
+    const uint16_t Bit = Index >> gBlacklistShift;
+    return gBlacklistBits[Bit >> 3] & (1u << (Bit & 7));
+}
+
+#endif
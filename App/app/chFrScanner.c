@@ -1,6 +1,7 @@
 
 #include "app/app.h"
 #include "app/chFrScanner.h"
+#include "driver/bk4819.h"
 #include "functions.h"
 #include "misc.h"
 #include "settings.h"
@@ -15,6 +16,10 @@ uint32_t          gScanRangeStart;
 uint32_t          gScanRangeStop;
 #endif
 
+#ifdef ENABLE_SCAN_ADAPTIVE_DWELL
+uint32_t          gScanSteps;
+#endif
+
 typedef enum {
     SCAN_NEXT_CHAN_SCANLIST1 = 0,
     SCAN_NEXT_CHAN_SCANLIST2,
@@ -34,9 +39,63 @@ uint8_t             initialCROSS_BAND_RX_TX;
     uint32_t lastFoundFrqOrChanOld;
 #endif
 
+#ifdef ENABLE_CHANNEL_BANKS
+    // A memory scan runs its list across banks, the bank in view follows it
+    static uint8_t initialBank;
+    static uint8_t lastFoundBank;
+#endif
+
 static void NextFreqChannel(void);
 static void NextMemChannel(void);
 
+#ifdef ENABLE_SCAN_ADAPTIVE_DWELL
+// The step tuned last is sampled on the next tick, by then it has settled
+static bool     earlyPending;
+// Ticks of its full dwell left for a step that passes the sample
+static uint16_t earlyDwellRest;
+
+// The squelch opens only when all three indicators pass their thresholds, so
+// one of them well past its threshold means the step will not open
+static bool IsClearlyEmpty(void)
+{
+    const uint16_t rssi   = BK4819_GetRSSI();
+    const uint8_t  noise  = BK4819_GetExNoiceIndicator();
+    const uint8_t  glitch = BK4819_GetGlitchIndicator();
+
+    return rssi + gEeprom.SCAN_EARLY_RSSI < gRxVfo->SquelchOpenRSSIThresh
+        || noise  > gRxVfo->SquelchOpenNoiseThresh  + gEeprom.SCAN_EARLY_NOISE
+        || glitch > gRxVfo->SquelchOpenGlitchThresh + gEeprom.SCAN_EARLY_GLITCH;
+}
+#endif
+
+static void NextChannel(void)
+{
+#ifdef ENABLE_SCAN_ADAPTIVE_DWELL
+    // A clearly empty step moves straight on, only candidates wait out the
+    // full squelch open window
+    if (earlyPending) {
+        earlyPending = false;
+        if (!IsClearlyEmpty()) {
+            gScanPauseDelayIn_10ms = earlyDwellRest;
+            return;
+        }
+    }
+#endif
+
+    IS_FREQ_CHANNEL(gNextMrChannel) ? NextFreqChannel() : NextMemChannel();
+
+#ifdef ENABLE_SCAN_ADAPTIVE_DWELL
+    gScanSteps++;
+
+    // Retune and return, the sample waits for the next tick
+    if (gScanPauseDelayIn_10ms > 1) {
+        earlyDwellRest         = gScanPauseDelayIn_10ms - 1;
+        gScanPauseDelayIn_10ms = 1;
+        earlyPending           = true;
+    }
+#endif
+}
+
 void CHFRSCANNER_Start(const bool storeBackupSettings, const int8_t scan_direction)
 {
     if (storeBackupSettings) {
@@ -47,6 +106,10 @@ void CHFRSCANNER_Start(const bool storeBackupSettings, const int8_t scan_directi
     
     RADIO_SelectVfos();
 
+#ifdef ENABLE_SCAN_ADAPTIVE_DWELL
+    earlyPending = false;
+#endif
+
     gNextMrChannel   = gRxVfo->CHANNEL_SAVE;
     currentScanList = SCAN_NEXT_CHAN_SCANLIST1;
     gScanStateDir    = scan_direction;
@@ -56,7 +119,13 @@ void CHFRSCANNER_Start(const bool storeBackupSettings, const int8_t scan_directi
         if (storeBackupSettings) {
             initialFrqOrChan = gRxVfo->CHANNEL_SAVE;
             lastFoundFrqOrChan = initialFrqOrChan;
+#ifdef ENABLE_CHANNEL_BANKS
+            initialBank   = gEeprom.CHANNEL_BANK;
+            lastFoundBank = initialBank;
+#endif
         }
+        // Profiles fill on the first lap, hops after it replay them
+        RADIO_ClearChannelProfiles();
         NextMemChannel();
     }
     else
@@ -107,11 +176,14 @@ void CHFRSCANNER_ContinueScanning(void)
     if (gCurrentFunction == FUNCTION_INCOMING &&
         (IS_FREQ_CHANNEL(gNextMrChannel) || gCurrentCodeType == CODE_TYPE_OFF))
     {
+#ifdef ENABLE_SCAN_ADAPTIVE_DWELL
+        earlyPending = false;
+#endif
         APP_StartListening(gMonitor ? FUNCTION_MONITOR : FUNCTION_RECEIVE);
     }
     else
     {
-        IS_FREQ_CHANNEL(gNextMrChannel) ? NextFreqChannel() : NextMemChannel();
+        NextChannel();
     }
 
     gScanPauseMode      = false;
@@ -176,6 +248,9 @@ void CHFRSCANNER_Found(void)
 
     if (IS_MR_CHANNEL(gRxVfo->CHANNEL_SAVE)) { //memory scan
         lastFoundFrqOrChan = gRxVfo->CHANNEL_SAVE;
+#ifdef ENABLE_CHANNEL_BANKS
+        lastFoundBank = gEeprom.CHANNEL_BANK;
+#endif
     }
     else { // frequency scan
         lastFoundFrqOrChan = gRxVfo->freq_config_RX.Frequency;
@@ -195,8 +270,15 @@ void CHFRSCANNER_Stop(void)
     gScanStateDir = SCAN_OFF;
 
     const uint32_t chFr = gScanKeepResult ? lastFoundFrqOrChan : initialFrqOrChan;
+#ifdef ENABLE_CHANNEL_BANKS
+    const bool channelChanged = chFr != initialFrqOrChan || (gScanKeepResult && lastFoundBank != initialBank);
+#else
     const bool channelChanged = chFr != initialFrqOrChan;
+#endif
     if (IS_MR_CHANNEL(gNextMrChannel)) {
+#ifdef ENABLE_CHANNEL_BANKS
+        SETTINGS_SelectChannelBank(gScanKeepResult ? lastFoundBank : initialBank);
+#endif
         gEeprom.MrChannel[gEeprom.RX_VFO]     = chFr;
         gEeprom.ScreenChannel[gEeprom.RX_VFO] = chFr;
         RADIO_ConfigureChannel(gEeprom.RX_VFO, VFO_CONFIGURE_RELOAD);
@@ -236,7 +318,7 @@ static void NextFreqChannel(void)
 
     RADIO_ApplyOffset(gRxVfo);
     RADIO_ConfigureSquelchAndOutputPower(gRxVfo);
-    RADIO_SetupRegisters(true);
+    RADIO_RetuneRegisters();
 
 #ifdef ENABLE_FASTER_CHANNEL_SCAN
     gScanPauseDelayIn_10ms = 9;   // 90ms
@@ -250,9 +332,17 @@ static void NextFreqChannel(void)
 static void NextMemChannel(void)
 {
     static unsigned int prev_mr_chan = 0;
+#ifdef ENABLE_CHANNEL_BANKS
+    // Priority channels are numbers in the bank the scan started from
+    const bool          home         = gEeprom.CHANNEL_BANK == initialBank;
+    bool                crossed      = false;
+#else
+    const bool          home         = true;
+    const bool          crossed      = false;
+#endif
     const bool          enabled      = (gEeprom.SCAN_LIST_DEFAULT > 0 && gEeprom.SCAN_LIST_DEFAULT < 4) ? gEeprom.SCAN_LIST_ENABLED[gEeprom.SCAN_LIST_DEFAULT - 1] : true;
-    const int           chan1        = (gEeprom.SCAN_LIST_DEFAULT > 0 && gEeprom.SCAN_LIST_DEFAULT < 4) ? gEeprom.SCANLIST_PRIORITY_CH1[gEeprom.SCAN_LIST_DEFAULT - 1] : -1;
-    const int           chan2        = (gEeprom.SCAN_LIST_DEFAULT > 0 && gEeprom.SCAN_LIST_DEFAULT < 4) ? gEeprom.SCANLIST_PRIORITY_CH2[gEeprom.SCAN_LIST_DEFAULT - 1] : -1;
+    const int           chan1        = (home && gEeprom.SCAN_LIST_DEFAULT > 0 && gEeprom.SCAN_LIST_DEFAULT < 4) ? gEeprom.SCANLIST_PRIORITY_CH1[gEeprom.SCAN_LIST_DEFAULT - 1] : -1;
+    const int           chan2        = (home && gEeprom.SCAN_LIST_DEFAULT > 0 && gEeprom.SCAN_LIST_DEFAULT < 4) ? gEeprom.SCANLIST_PRIORITY_CH2[gEeprom.SCAN_LIST_DEFAULT - 1] : -1;
     const unsigned int  prev_chan    = gNextMrChannel;
     unsigned int        chan         = 0;
 
@@ -334,7 +424,18 @@ static void NextMemChannel(void)
 
     if (!enabled || chan == 0xff)
     {       
+#ifdef ENABLE_CHANNEL_BANKS
+        uint8_t bank = gEeprom.CHANNEL_BANK;
+
+        chan = RADIO_FindNextScanChannel(&bank, gNextMrChannel + gScanStateDir, gScanStateDir, gEeprom.SCAN_LIST_DEFAULT);
+        if (chan != 0xFF && bank != gEeprom.CHANNEL_BANK)
+        {   // on into the next bank with members of the list
+            SETTINGS_ViewChannelBank(bank);
+            crossed = true;
+        }
+#else
         chan = RADIO_FindNextChannel(gNextMrChannel + gScanStateDir, gScanStateDir, true, gEeprom.SCAN_LIST_DEFAULT);
+#endif
         if (chan == 0xFF)
         {   // no valid channel found
             chan = MR_CHANNEL_FIRST;
@@ -346,13 +447,16 @@ static void NextMemChannel(void)
         //LogUart(str);
     }
 
-    if (gNextMrChannel != prev_chan)
+    if (gNextMrChannel != prev_chan || crossed)
     {
         gEeprom.MrChannel[    gEeprom.RX_VFO] = gNextMrChannel;
         gEeprom.ScreenChannel[gEeprom.RX_VFO] = gNextMrChannel;
 
-        RADIO_ConfigureChannel(gEeprom.RX_VFO, VFO_CONFIGURE_RELOAD);
-        RADIO_SetupRegisters(true);
+        if (!RADIO_LoadChannelProfile(gEeprom.RX_VFO, gNextMrChannel)) {
+            RADIO_ConfigureChannel(gEeprom.RX_VFO, VFO_CONFIGURE_RELOAD);
+            RADIO_StoreChannelProfile(gEeprom.RX_VFO);
+        }
+        RADIO_RetuneRegisters();
 
         gUpdateDisplay = true;
     }
@@ -15,6 +15,11 @@ extern uint32_t          gScanRangeStart;
 extern uint32_t          gScanRangeStop;
 #endif
 
+#ifdef ENABLE_SCAN_ADAPTIVE_DWELL
+// steps tuned since boot, including the ones rejected early
+extern uint32_t          gScanSteps;
+#endif
+
 void CHFRSCANNER_Found(void);
 void CHFRSCANNER_Stop(void);
 void CHFRSCANNER_Start(const bool storeBackupSettings, const int8_t scan_direction);
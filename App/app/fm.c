@@ -24,7 +24,7 @@
 #include "audio.h"
 #include "driver/bk1080.h"
 #include "driver/bk4819.h"
-#include "driver/py25q16.h"
+#include "driver/flashlog.h"
 #include "driver/gpio.h"
 #include "functions.h"
 #include "misc.h"
@@ -124,7 +124,7 @@ void FM_TurnOff(void)
 
 void FM_EraseChannels(void)
 {
-    PY25Q16_SectorErase(0x003000);
+    FLASHLOG_SectorErase(0x003000);
     memset(gFM_Channels, 0xFF, sizeof(gFM_Channels));
 }
 
@@ -81,6 +81,7 @@ static void toggle_chan_scanlist(void)
     if(gMR_ChannelExclude[gTxVfo->CHANNEL_SAVE] == true)
     {
         gMR_ChannelExclude[gTxVfo->CHANNEL_SAVE] = false;
+        RADIO_InvalidateChannelIndex();
         return;
     }
 
@@ -693,6 +694,7 @@ static void MAIN_Key_MENU(bool bKeyPressed, bool bKeyHeld)
                 if(FUNCTION_IsRx() || gScanPauseDelayIn_10ms > 9)
                 {
                     gMR_ChannelExclude[gTxVfo->CHANNEL_SAVE] = true;
+                    RADIO_InvalidateChannelIndex();
 
                     gVfoConfigureMode = VFO_CONFIGURE;
                     gFlagResetVfos    = true;
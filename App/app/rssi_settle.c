@@ -0,0 +1,105 @@
+/* RSSI settle timing, see rssi_settle.h. */
+
+#include <stdbool.h>
+
+#include "app/rssi_settle.h"
+#include "driver/bk4819.h"
+#include "driver/systick.h"
+
+#define STEP_US         20      // calibration sampling period
+#define POLL_US         100
+#define RUNS            4
+#define RSSI_TOLERANCE  6       // raw units, 3 dB
+
+static uint16_t gLateReads;
+static uint32_t gSweepStartUs;
+
+static bool IsSettling(void)
+{
+    return (BK4819_ReadRegister(BK4819_REG_63) & 0xFF) >= 255;
+}
+
+// Time from the retune to the first sample after which all are in range
+static uint32_t MeasureOnce(SETTLE_Tune_t pTune, uint32_t Frequency, uint16_t Target)
+{
+    uint32_t Settled = 0;
+    bool     Off     = true;
+    uint32_t Now;
+
+    pTune(Frequency);
+    const uint32_t Start = SYSTICK_GetTimeUs();
+
+    do {
+        SYSTICK_DelayUs(STEP_US);
+
+        const bool     Settling = IsSettling();
+        const uint16_t Rssi     = BK4819_GetRSSI();
+
+        Now = SYSTICK_GetTimeUs() - Start;
+        if (Settling || Rssi + RSSI_TOLERANCE < Target || Rssi > Target + RSSI_TOLERANCE) {
+            Off = true;
+        } else if (Off) {
+            Off     = false;
+            Settled = Now;
+        }
+    } while (Now < SETTLE_MAX_US);
+
+    return Off ? SETTLE_MAX_US : Settled;
+}
+
+uint16_t SETTLE_Calibrate(SETTLE_Tune_t pTune, uint32_t Frequency, uint32_t Away)
+{
+    uint32_t Worst = 0;
+
+    // Level at Frequency long after any settle
+    pTune(Frequency);
+    SYSTICK_DelayUs(SETTLE_MAX_US);
+    const uint16_t Target = BK4819_GetRSSI();
+
+    for (unsigned Run = 0; Run < RUNS; Run++) {
+        pTune(Away);
+        SYSTICK_DelayUs(SETTLE_MAX_US);
+
+        const uint32_t Us = MeasureOnce(pTune, Frequency, Target);
+        if (Us > Worst)
+            Worst = Us;
+    }
+
+    return Worst;
+}
+
+uint16_t SETTLE_GetRssi(uint16_t SettleUs)
+{
+    if (SettleUs)
+        SYSTICK_DelayUs(SettleUs);
+
+    // Still settling: the glitch indicator gets a bounded number of polls,
+    // a receiver that keeps reporting 255 must not stall the sweep
+    if (IsSettling()) {
+        const uint32_t Start = SYSTICK_GetTimeUs();
+
+        gLateReads++;
+        do {
+            SYSTICK_DelayUs(POLL_US);
+        } while (IsSettling() && SYSTICK_GetTimeUs() - Start < SETTLE_POLL_MAX_US);
+    }
+
+    return BK4819_GetRSSI();
+}
+
+uint16_t SETTLE_TakeLateReads(void)
+{
+    const uint16_t Count = gLateReads;
+
+    gLateReads = 0;
+    return Count;
+}
+
+uint32_t SETTLE_MarkSweep(void)
+{
+    const uint32_t Now = SYSTICK_GetTimeUs();
+    const uint32_t Us  = Now - gSweepStartUs;
+
+    gSweepStartUs = Now;
+    return Us;
+}
@@ -0,0 +1,35 @@
+/* RSSI settle and sweep timing for the spectrum sweep.
+ *
+ * After a retune the BK4819 needs a while before REG_67 reads the new
+ * frequency: the RSSI ramps from the old level and the glitch indicator in
+ * REG_63 sits at 255. How long mostly depends on the RF filter bandwidth in
+ * REG_43, i.e. on the scan step. SETTLE_Calibrate() measures it with the
+ * filter in place, and SETTLE_GetRssi() waits that long before the read,
+ * polling the glitch indicator for a bounded time only if it still says
+ * the receiver is settling.
+ */
+
+#ifndef APP_RSSI_SETTLE_H
+#define APP_RSSI_SETTLE_H
+
+#include <stdint.h>
+
+// Longest settle looked for, and the glitch poll bound on top of a delay
+#define SETTLE_MAX_US           5000
+#define SETTLE_POLL_MAX_US      1000
+
+// Retunes the receiver to Frequency (10 Hz units) and restarts RX
+typedef void (*SETTLE_Tune_t)(uint32_t Frequency);
+
+// Worst time over a few retunes from Away to Frequency until RSSI is stable,
+// SETTLE_MAX_US if it never is. Takes about 10 * SETTLE_MAX_US.
+uint16_t SETTLE_Calibrate(SETTLE_Tune_t pTune, uint32_t Frequency, uint32_t Away);
+// Raw RSSI after waiting SettleUs, to be called right after the retune;
+// SettleUs is 0 when the receiver has not been retuned
+uint16_t SETTLE_GetRssi(uint16_t SettleUs);
+// Reads that needed the glitch poll since the last call
+uint16_t SETTLE_TakeLateReads(void);
+// Marks the start of a sweep, returns how long the previous one took in us
+uint32_t SETTLE_MarkSweep(void);
+
+#endif
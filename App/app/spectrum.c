@@ -25,7 +25,7 @@
  * =======================
  * - Display: 128x64 monochrome LCD with 8-pixel vertical resolution
  * - Spectrum Resolution: Configurable from 100kHz to 6.25kHz steps
- * - Waterfall History: 16 vertical samples for temporal analysis
+ * - Waterfall History: 24 packed rows in RAM, freeze (MENU) to scroll back
  * - Sample Rate: Adaptive based on sweep span
  * - RSSI Processing: 16-bit unsigned with dynamic range compression
  * - S-Meter: 0-9 scale per IARU R.1 recommendation
@@ -64,9 +64,22 @@
 #include <stdint.h>
 #include "driver/bk4819.h"
 #include "functions.h"
+#include "app/rssi_settle.h"
+#include "app/spectrum_occupancy.h"
+#include "app/spectrum_peaks.h"
+#include "app/waterfall.h"
+#ifdef ENABLE_SCAN_RANGES
+    #include "app/blacklist.h"
+    #include "app/spectrum_bins.h"
+#endif
+#ifdef ENABLE_SPECTRUM_STREAM
+    #include "app/spectrum_stream.h"
+    #include "app/uart.h"
+#endif
 
 // Forward declaration must be ABOVE Tick() to fix the "static follows non-static" error
 static void PushWaterfallLine(void);
+static void UpdateSweepTiming(void);
 
 extern uint16_t gBatteryVoltage;
 
@@ -141,7 +154,7 @@ uint8_t Rssi2Y(uint16_t rssi);
 #include "frequencies.h"
 
 #ifdef ENABLE_FEAT_N7SIX_SPECTRUM
-#include "driver/py25q16.h"
+#include "driver/flashlog.h"
 #endif
 
 #ifdef ENABLE_FEAT_N7SIX_SCREENSHOT
@@ -167,9 +180,6 @@ uint8_t Rssi2Y(uint16_t rssi);
 /** @brief Maximum number of frequency steps in spectrum */
 #define SPECTRUM_MAX_STEPS          128U
 
-/** @brief Number of waterfall history lines */
-#define WATERFALL_HISTORY_DEPTH     12U
-
 /** @brief Maximum frequency input length */
 #define FREQ_INPUT_MAX_LENGTH       10U
 
@@ -182,9 +192,6 @@ uint8_t Rssi2Y(uint16_t rssi);
 /** @brief Frequency input string buffer size */
 #define FREQ_INPUT_STRING_SIZE      11U
 
-/** @brief Maximum blacklist frequency entries */
-#define BLACKLIST_MAX_ENTRIES       15U
-
 /** @brief Waterfall update interval (every N scans) */
 #define WATERFALL_UPDATE_INTERVAL   2U
 
@@ -194,14 +201,10 @@ uint8_t Rssi2Y(uint16_t rssi);
 /** @brief Maximum dBm value for display */
 #define DISPLAY_DBM_MAX             -50
 
-#define WATERFALL_ROWS 40
-
 // --- Function Prototypes ---
 static bool IsPeakOverLevel(void);
 static void AutoTriggerLevel(void);
-static void UpdateWaterfall(void);
 static void DrawSpectrumEnhanced(void);
-static void ShowChannelName(uint32_t f);
 
 // =============================================================================
 // DATA STRUCTURES
@@ -252,10 +255,21 @@ int vfo;                                     /**< VFO selection */
 
 // Spectrum data buffers
 uint16_t rssiHistory[SPECTRUM_MAX_STEPS];    /**< RSSI history buffer */
-uint8_t waterfallHistory[SPECTRUM_MAX_STEPS][WATERFALL_HISTORY_DEPTH]; /**< Waterfall history */
 static uint16_t peakHold[SPECTRUM_MAX_STEPS] = {0};
-uint8_t waterfallIndex = 0;                  /**< Current waterfall line index */
-uint16_t waterfallUpdateCounter = 0;         /**< Waterfall update counter */
+static uint16_t settleUs[SCAN_STEP_COUNT];   /**< Calibrated settle per scan step, 0 = not yet */
+static bool rssiSettling = false;            /**< Retuned since the last RSSI read */
+static uint32_t sweepUs = 0;                 /**< Duration of the last sweep */
+static bool waterfallFrozen = false;         /**< Waterfall stopped for scroll-back */
+static uint16_t waterfallScroll = 0;         /**< Rows scrolled back while frozen */
+static TableView tableView = TABLE_NONE;     /**< Table shown instead of the trace */
+static uint8_t tableRow = 0;                 /**< Selected table row */
+static uint8_t occupancyOrder[OCCUPANCY_BINS]; /**< Occupancy table rows as last shown */
+static uint8_t occupancyRows = 0;
+#ifdef ENABLE_SCAN_RANGES
+static uint8_t viewZoom = 0;                 /**< Wide sweep zoom, 1 << viewZoom */
+static uint16_t viewOffset = 0;              /**< First fine column of the zoomed view */
+static bool blacklistPending = false;        /**< SIDE1 pressed, blacklist on release */
+#endif
 
 // Frequency input
 uint8_t freqInputIndex = 0;                  /**< Frequency input cursor position */
@@ -270,12 +284,6 @@ uint16_t listenT = 0;                        /**< Listen timer */
 // Display string buffer
 static char String[DISPLAY_STRING_BUFFER_SIZE]; /**< General purpose string buffer */
 
-// Blacklist (scan ranges feature)
-#ifdef ENABLE_SCAN_RANGES
-static uint16_t blacklistFreqs[BLACKLIST_MAX_ENTRIES]; /**< Blacklisted frequencies */
-static uint8_t blacklistFreqsIdx;                      /**< Blacklist index */
-#endif
-
 // =============================================================================
 // CONFIGURATION TABLES
 // =============================================================================
@@ -345,7 +353,7 @@ static void LoadSettings(void)
 {
     uint8_t data[8] = {0};
 
-    PY25Q16_ReadBuffer(0x00c000, data, sizeof(data));
+    FLASHLOG_ReadBuffer(0x00c000, data, sizeof(data));
 
     // Extract scan step index from upper nibble
     settings.scanStepIndex = ((data[3] & 0xF0) >> 4);
@@ -379,12 +387,12 @@ static void SaveSettings(void)
 {
     uint8_t data[8] = {0};
 
-    PY25Q16_ReadBuffer(0x00c000, data, sizeof(data));
+    FLASHLOG_ReadBuffer(0x00c000, data, sizeof(data));
 
     // Pack settings into data byte: [scanStepIndex:4][stepsCount:2][listenBw:2]
     data[3] = (settings.scanStepIndex << 4) | (settings.stepsCount << 2) | settings.listenBw;
 
-    PY25Q16_WriteBuffer(0x00c000, data, sizeof(data), true);
+    FLASHLOG_WriteBuffer(0x00c000, data, sizeof(data), false);
 }
 #endif
 
@@ -625,6 +633,7 @@ static void SetF(uint32_t f)
     uint16_t reg = BK4819_ReadRegister(BK4819_REG_30);
     BK4819_WriteRegister(BK4819_REG_30, 0);
     BK4819_WriteRegister(BK4819_REG_30, reg);
+    rssiSettling = true;
 }
 
 // Spectrum related
@@ -665,7 +674,13 @@ static void ResetPeak()
     }
 #endif
 
-bool IsCenterMode() { return settings.scanStepIndex < S_STEP_2_5kHz; }
+bool IsCenterMode()
+{
+#ifdef ENABLE_SCAN_RANGES
+    if (gScanRangeStart) return false;
+#endif
+    return settings.scanStepIndex < S_STEP_2_5kHz;
+}
 // scan step in 0.01khz
 uint16_t GetScanStep() { return scanStepValues[settings.scanStepIndex]; }
 
@@ -687,9 +702,40 @@ uint16_t GetStepsCount()
 }
 
 #ifdef ENABLE_SCAN_RANGES
+// Step of a scan range sweep, coarser than the scan step on a range too long
+// for the bins so the sweep still reaches its end
+static uint16_t GetRangeScanStep()
+{
+    return BINS_SweepStep(gScanRangeStop - gScanRangeStart, GetScanStep());
+}
 
+// Steps of a scan range sweep, at least a screenful
+static uint16_t GetRangeStepsCount()
+{
+    const uint32_t steps = (gScanRangeStop - gScanRangeStart) / GetRangeScanStep();
+    return steps < SPECTRUM_MAX_STEPS ? SPECTRUM_MAX_STEPS : steps;
+}
+
+// More steps than columns, folded by app/spectrum_bins.c
+static bool IsWideSweep() { return scanInfo.measurementsCount > SPECTRUM_MAX_STEPS; }
 #endif
 
+static uint16_t GetMeasurementsCount()
+{
+#ifdef ENABLE_SCAN_RANGES
+    if (gScanRangeStart) return GetRangeStepsCount();
+#endif
+    return GetStepsCount();
+}
+
+// A peak moving by up to a column between sweeps is the same signal
+static uint32_t GetPeakTolerance()
+{
+    const uint16_t count = scanInfo.measurementsCount;
+    const uint16_t perColumn = (count + SPECTRUM_MAX_STEPS - 1) / SPECTRUM_MAX_STEPS;
+    return (uint32_t)scanInfo.scanStep * perColumn;
+}
+
 uint32_t GetBW() { return GetStepsCount() * GetScanStep(); }
 uint32_t GetFStart()
 {
@@ -701,12 +747,32 @@ uint32_t GetFEnd()
 #ifdef ENABLE_SCAN_RANGES
     if (gScanRangeStart)
     {
-        return gScanRangeStop;
+        return GetFStart() + (uint32_t)GetRangeStepsCount() * GetRangeScanStep();
     }
 #endif
     return currentFreq + GetBW();
 }
 
+// Span on screen, the zoomed part of a wide sweep
+static uint32_t GetViewFStart()
+{
+#ifdef ENABLE_SCAN_RANGES
+    if (viewZoom)
+        return GetFStart() + (uint64_t)(GetFEnd() - GetFStart()) * viewOffset / BINS_FINE;
+#endif
+    return GetFStart();
+}
+
+static uint32_t GetViewFEnd()
+{
+#ifdef ENABLE_SCAN_RANGES
+    if (viewZoom)
+        return GetFStart() + (uint64_t)(GetFEnd() - GetFStart()) *
+                             (viewOffset + (BINS_FINE >> viewZoom)) / BINS_FINE;
+#endif
+    return GetFEnd();
+}
+
 static void TuneToPeak()
 {
     scanInfo.f = peak.f;
@@ -715,6 +781,24 @@ static void TuneToPeak()
     SetF(scanInfo.f);
 }
 
+static void OpenTable(TableView view)
+{
+    tableView = view;
+    tableRow = 0;
+    redrawScreen = true;
+}
+
+// Listens on a table entry, as KEY_PTT does on the peak
+static void TuneToEntry(uint32_t f, uint16_t i, uint16_t rssi)
+{
+    tableView = TABLE_NONE;
+    SetState(STILL);
+    scanInfo.f = f;
+    scanInfo.rssi = rssi;
+    scanInfo.i = i;
+    SetF(scanInfo.f);
+}
+
 static void DeInitSpectrum()
 {
     SetF(initialFreq);
@@ -722,20 +806,17 @@ static void DeInitSpectrum()
     isInitialized = false;
 }
 
-uint8_t GetBWRegValueForScan()
+uint16_t GetBWRegValueForScan()
 {
     return scanStepBWRegValues[settings.scanStepIndex];
 }
 
 uint16_t GetRssi()
 {
-    // SYSTICK_DelayUs(800);
-    // testing autodelay based on Glitch value
-    while ((BK4819_ReadRegister(0x63) & 0b11111111) >= 255)
-    {
-        SYSTICK_DelayUs(100);
-    }
-    uint16_t rssi = BK4819_GetRSSI();
+    // Right after SetF() wait the settle calibrated for the scan step's
+    // filter, the glitch indicator only covers what is left of it
+    uint16_t rssi = SETTLE_GetRssi(rssiSettling ? settleUs[settings.scanStepIndex] : 0);
+    rssiSettling = false;
 #ifdef ENABLE_AM_FIX
     if (settings.modulationType == MODULATION_AM && gSetting_AM_fix)
         rssi += AM_fix_get_gain_diff() * 2;
@@ -826,34 +907,49 @@ static void InitScan()
     scanInfo.f = GetFStart();
 
     scanInfo.scanStep = GetScanStep();
-    scanInfo.measurementsCount = GetStepsCount();
+#ifdef ENABLE_SCAN_RANGES
+    if (gScanRangeStart)
+        scanInfo.scanStep = GetRangeScanStep();
+#endif
+    scanInfo.measurementsCount = GetMeasurementsCount();
+
+    PEAKS_Forget(scanInfo.f, scanInfo.f + (uint32_t)scanInfo.scanStep * scanInfo.measurementsCount);
+    OCCUPANCY_Setup(scanInfo.f, scanInfo.scanStep, scanInfo.measurementsCount);
+
+#ifdef ENABLE_SCAN_RANGES
+    if (IsWideSweep())
+        BINS_Setup(rssiHistory, scanInfo.measurementsCount);
+    else
+        viewZoom = 0;
+
+    // Only redone when the span or step has changed
+    BLACKLIST_Project(scanInfo.f, scanInfo.scanStep, scanInfo.measurementsCount);
+#endif
 }
 
 #ifdef ENABLE_SCAN_RANGES
-// Insert it here:
 static bool IsBlacklisted(uint16_t idx)
 {
-    for (uint8_t i = 0; i < ARRAY_SIZE(blacklistFreqs); i++)
-    {
-        if (blacklistFreqs[i] == idx)
-            return true;
-    }
-    return false;
+    return BLACKLIST_IsSet(idx);
+}
+
+// Skips the peak's step from now on, in this band's saved list. The sweep
+// starts over so no bin keeps the level of the step just dropped
+static void Blacklist()
+{
+    BLACKLIST_Add(peak.f);
+    ResetPeak();
+    ToggleRX(false);
+    InitScan();
+    redrawScreen = true;
 }
-#endif
 
 static void ResetBlacklist()
 {
-    for (int i = 0; i < 128; ++i)
-    {
-        if (rssiHistory[i] == RSSI_MAX_VALUE)
-            rssiHistory[i] = 0;
-    }
-#ifdef ENABLE_SCAN_RANGES
-    memset(blacklistFreqs, 0, sizeof(blacklistFreqs));
-    blacklistFreqsIdx = 0;
-#endif
+    BLACKLIST_Clear();
+    redrawScreen = true;
 }
+#endif
 
 void RelaunchScan()
 {
@@ -970,6 +1066,19 @@ static void UpdatePeakInfoForce()
  */
 static void UpdatePeakInfo()
 {
+    // A carrier still tracked keeps the marker until another one is clearly
+    // stronger, two active ones no longer flip it every sweep
+    const PEAK_t *held = peak.f ? PEAKS_Near(peak.f, GetPeakTolerance()) : NULL;
+    if (held && !held->age && scanInfo.rssiMax < held->rssi + PEAKS_PROMINENCE)
+    {
+        peak.t = 0;
+        peak.rssi = held->rssi;
+        peak.f = held->f;
+        peak.i = held->i;
+        AutoTriggerLevel();
+        return;
+    }
+
     // Timeout-based peak refresh or new peak detection
     if (peak.f == 0 || peak.t >= 1024 || peak.rssi < scanInfo.rssiMax)
     {
@@ -981,21 +1090,38 @@ static void UpdatePeakInfo()
     }
 }
 
+// Peaks of the completed sweep into the signal table, one pass over rssiHistory
+static void UpdatePeaks()
+{
+    PEAK_Hit_t hits[PEAKS_MAX];
+    const uint16_t bars = scanInfo.measurementsCount > SPECTRUM_MAX_STEPS
+                            ? SPECTRUM_MAX_STEPS : scanInfo.measurementsCount;
+    const uint32_t start = scanInfo.f - (uint32_t)scanInfo.i * scanInfo.scanStep;
+    const uint8_t count = PEAKS_Find(rssiHistory, bars, scanInfo.rssiMin, hits);
+
+    for (uint8_t k = 0; k < count; k++)
+    {
+#ifdef ENABLE_SCAN_RANGES
+        // Tuned to the step the bin's max came from
+        if (IsWideSweep())
+            hits[k].i = BINS_GetMaxAt(hits[k].i);
+#endif
+        hits[k].f = start + (uint32_t)hits[k].i * scanInfo.scanStep;
+    }
+
+    PEAKS_Track(hits, count, GetPeakTolerance());
+}
+
 static void SetRssiHistory(uint16_t idx, uint16_t rssi)
 {
 #ifdef ENABLE_SCAN_RANGES
-    if (scanInfo.measurementsCount > 128)
+    if (IsWideSweep())
     {
-        // Professional scaling for extended frequency ranges
-        // Maps arbitrary measurement count to fixed 128-sample histogram
-        uint8_t i = (uint32_t)ARRAY_SIZE(rssiHistory) * 1000 / scanInfo.measurementsCount * idx / 1000;
-        
-        // Peak-hold: Keep highest RSSI, or update if listening mode
-        if (rssiHistory[i] < rssi || isListening)
-        {
-            rssiHistory[i] = rssi;
-        }
-        rssiHistory[(i + 1) % 128] = 0;
+        // Listening stays on one step, its bin shows the live level
+        if (isListening)
+            rssiHistory[BINS_Of(idx)] = rssi;
+        else
+            BINS_Add(idx, rssi);
         return;
     }
 #endif
@@ -1075,34 +1201,6 @@ static void DrawSpectrumCurve(const uint16_t *smoothed, uint8_t bars)
     }
 }
 
-static void ShowChannelName(uint32_t f)
-{
-    static uint32_t channelF = 0;
-    static char channelName[12]; 
-
-    if (isListening)
-    {
-        if (f != channelF) {
-            channelF = f;
-            memset(channelName, 0, sizeof(channelName));
-            for (int i = 0; i < 200; i++)
-            {
-                if (RADIO_CheckValidChannel(i, false, 0))
-                {
-                    if (SETTINGS_FetchChannelFrequency(i) == channelF)
-                    {
-                        SETTINGS_FetchChannelName(channelName, i);
-                        break;
-                    }
-                }
-            }
-        }
-        if (channelName[0] != 0) {
-            GUI_DisplaySmallest(channelName, 0, 14, false, true);
-        }
-    }
-}
-
 // --- 3. SPECTRUM & WATERFALL DRAWING ---
 
 static void DrawSpectrumEnhanced(void)
@@ -1110,8 +1208,18 @@ static void DrawSpectrumEnhanced(void)
     uint16_t steps = GetStepsCount();
     uint8_t bars = (steps > 128) ? 128 : steps;
     uint16_t smoothed[SPECTRUM_MAX_STEPS];
-    
-    SmoothRssiHistory(rssiHistory, smoothed, bars);
+    const uint16_t *history = rssiHistory;
+
+#ifdef ENABLE_SCAN_RANGES
+    uint16_t view[SPECTRUM_MAX_STEPS];
+    if (viewZoom)
+    {
+        BINS_View(view, viewZoom, viewOffset);
+        history = view;
+    }
+#endif
+
+    SmoothRssiHistory(history, smoothed, bars);
 
     for (uint8_t i = 0; i < bars; ++i) {
         if (smoothed[i] > peakHold[i]) {
@@ -1127,42 +1235,25 @@ static void DrawSpectrumEnhanced(void)
         uint8_t x = (i * 127) / (bars - 1);
         PutPixel(x, Rssi2Y(peakHold[i]), true);
     }
+
+#ifdef ENABLE_SCAN_RANGES
+    // Wide sweeps: the bin average between the peak-hold dots, and the bin
+    // min as a trace below
+    if (IsWideSweep() && !viewZoom)
+    {
+        for (uint8_t i = 1; i < bars; i += 2)
+            PutPixel((i * 127) / (bars - 1), Rssi2Y(BINS_GetAvg(i)), true);
+        for (uint8_t i = 0; i < bars; i++)
+            PutPixel((i * 127) / (bars - 1), Rssi2Y(BINS_GetMin(i)), true);
+    }
+#endif
 }
 
 
 
 static void DrawWaterfall(void)
 {
-    static const uint8_t bayer4x4[4][4] = {
-        { 0, 8, 2, 10 }, { 12, 4, 14, 6 }, { 3, 11, 1, 9 }, { 15, 7, 13, 5 }
-    };
-    const uint8_t WATERFALL_START_Y = 41;
-    const uint8_t WATERFALL_WIDTH = 128;
-    const uint16_t SPEC_WIDTH = GetStepsCount();
-    const float xScale = (float)SPEC_WIDTH / WATERFALL_WIDTH;
-
-    for (uint8_t y_offset = 0; y_offset < WATERFALL_HISTORY_DEPTH - 1; y_offset++)
-    {
-        int8_t historyRow = (int8_t)waterfallIndex - (int8_t)y_offset;
-        if (historyRow < 0) historyRow += WATERFALL_HISTORY_DEPTH;
-
-        uint8_t y_pos = WATERFALL_START_Y + y_offset;
-        if (y_pos > 63) break;
-
-        float fade = 1.0f - (float)y_offset / (WATERFALL_HISTORY_DEPTH - 1);
-        for (uint8_t x = 0; x < WATERFALL_WIDTH; x++)
-        {
-            uint16_t specIdx = (uint16_t)(x * xScale);
-            if (specIdx >= SPEC_WIDTH - 1) specIdx = SPEC_WIDTH - 2;
-            uint8_t l0 = waterfallHistory[specIdx][historyRow];
-            uint8_t l1 = waterfallHistory[specIdx+1][historyRow];
-            float frac = (x * xScale) - specIdx;
-            uint8_t level = (uint8_t)((l0 * (1.0f - frac) + l1 * frac) * fade);
-            if (level > 15) level = 15;
-
-            if (level > bayer4x4[y_pos & 3][x & 3]) PutPixel(x, y_pos, 1);
-        }
-    }
+    WATERFALL_Draw(GetStepsCount(), 41, waterfallScroll);
 }
 
 // --- 4. KEYBOARD HANDLERS & SETTINGS UPDATES ---
@@ -1243,6 +1334,59 @@ static void ToggleBacklight()
     else BACKLIGHT_TurnOff();
 }
 
+static void ToggleWaterfallFreeze()
+{
+    waterfallFrozen = !waterfallFrozen;
+    waterfallScroll = 0;
+    redrawStatus = true;
+    redrawScreen = true;
+}
+
+static void ScrollWaterfall(bool older)
+{
+    const uint16_t depth = WATERFALL_GetDepth();
+    const uint16_t maxScroll = depth > WATERFALL_VISIBLE ? depth - WATERFALL_VISIBLE : 0;
+    // A held key moves a few rows at a time
+    const uint16_t rows = kbd.counter == 16 ? 4 : 1;
+
+    if (older)
+        waterfallScroll = (waterfallScroll + rows < maxScroll) ? waterfallScroll + rows : maxScroll;
+    else
+        waterfallScroll = (waterfallScroll > rows) ? waterfallScroll - rows : 0;
+
+    redrawStatus = true;
+    redrawScreen = true;
+}
+
+#ifdef ENABLE_SCAN_RANGES
+// Centres a view of 1 / (1 << zoom) of the wide sweep on fine column center
+static void SetView(uint8_t zoom, int32_t center)
+{
+    const int32_t width = BINS_FINE >> zoom;
+    int32_t offset = center - width / 2;
+
+    if (offset < 0) offset = 0;
+    if (offset > BINS_FINE - width) offset = BINS_FINE - width;
+
+    viewZoom = zoom;
+    viewOffset = offset;
+    memset(peakHold, 0, sizeof(peakHold));
+    redrawScreen = true;
+}
+
+static void CycleZoom()
+{
+    if (IsWideSweep())
+        SetView((viewZoom + 1) % (BINS_ZOOM_MAX + 1), viewOffset + (BINS_FINE >> viewZoom) / 2);
+}
+
+static void PanView(bool right)
+{
+    const int32_t width = BINS_FINE >> viewZoom;
+    SetView(viewZoom, viewOffset + width / 2 + (right ? width / 8 : -width / 8));
+}
+#endif
+
 static void ToggleStepsCount()
 {
     settings.stepsCount = (settings.stepsCount + 1) % 4;
@@ -1335,6 +1479,19 @@ static void DrawStatus()
 #endif
     GUI_DisplaySmallest(String, 0, 1, true, true);
 
+    if (waterfallFrozen)
+    {
+        sprintf(String, "H-%u", waterfallScroll);
+        GUI_DisplaySmallest(String, 84, 1, true, true);
+    }
+    else if (sweepUs)
+    {
+        // Sweeps per second, in tenths
+        const uint32_t rate = 10000000U / sweepUs;
+        sprintf(String, "%u.%u/s", (unsigned)(rate / 10), (unsigned)(rate % 10));
+        GUI_DisplaySmallest(String, 84, 1, true, true);
+    }
+
     BOARD_ADC_GetBatteryInfo(&gBatteryVoltages[gBatteryCheckCounter++ % 4],
                              &gBatteryCurrent);
 
@@ -1380,6 +1537,11 @@ static void DrawNums()
     if (currentState == SPECTRUM) 
     {
         // 1. Draw Zoom level on the top line
+#ifdef ENABLE_SCAN_RANGES
+        if (IsWideSweep())
+            sprintf(String, "Z:%u x%u", scanInfo.measurementsCount, 1u << viewZoom);
+        else
+#endif
         sprintf(String, "Z:%ux", GetStepsCount());
         GUI_DisplaySmallest(String, 0, 1, false, true); // Y=1 (Top)
 
@@ -1387,10 +1549,17 @@ static void DrawNums()
         sprintf(String, "S:%u.%02ukHz", 
                 ScanStepTable[settings.scanStepIndex] / 100, 
                 ScanStepTable[settings.scanStepIndex] % 100);
+#ifdef ENABLE_SCAN_RANGES
+        // A range too long for the bins at that step is swept coarser
+        if (gScanRangeStart && scanInfo.scanStep != GetScanStep())
+            sprintf(String, "S:%u.%02uk>%u.%02uk",
+                    GetScanStep() / 100, GetScanStep() % 100,
+                    scanInfo.scanStep / 100, scanInfo.scanStep % 100);
+#endif
         GUI_DisplaySmallest(String, 0, 9, false, true); // Y=9 (Directly below)
     }
 
-    sprintf(String, "%u.%05u", GetFStart() / 100000, GetFStart() % 100000);
+    sprintf(String, "%u.%05u", GetViewFStart() / 100000, GetViewFStart() % 100000);
         // MOVED: Y coordinate 38 -> 34
         GUI_DisplaySmallest(String, 0, 34, false, true);
 
@@ -1399,15 +1568,15 @@ static void DrawNums()
         // MOVED: Y coordinate 38 -> 34
         GUI_DisplaySmallest(String, 48, 34, false, true);
 
-        sprintf(String, "%u.%05u", GetFEnd() / 100000, GetFEnd() % 100000);
+        sprintf(String, "%u.%05u", GetViewFEnd() / 100000, GetViewFEnd() % 100000);
         // MOVED: Y coordinate 38 -> 34
         GUI_DisplaySmallest(String, 93, 34, false, true);
 }
 
 static void DrawTicks()
 {
-    uint32_t fStart = GetFStart();
-    uint32_t span = GetFEnd() - fStart;
+    uint32_t fStart = GetViewFStart();
+    uint32_t span = GetViewFEnd() - fStart;
     uint32_t step = span / 128;
     if (step == 0) step = 1;
 
@@ -1462,15 +1631,47 @@ static void OnKeyDown(uint8_t key)
     case KEY_7: UpdateScanStep(false); break;
     case KEY_2: UpdateFreqChangeStep(true); break;
     case KEY_8: UpdateFreqChangeStep(false); break;
-    case KEY_UP: UpdateCurrentFreq(true); break;
-    case KEY_DOWN: UpdateCurrentFreq(false); break;
+    case KEY_UP:
+        if (waterfallFrozen) ScrollWaterfall(false);
+#ifdef ENABLE_SCAN_RANGES
+        else if (viewZoom) PanView(true);
+#endif
+        else UpdateCurrentFreq(true);
+        break;
+    case KEY_DOWN:
+        if (waterfallFrozen) ScrollWaterfall(true);
+#ifdef ENABLE_SCAN_RANGES
+        else if (viewZoom) PanView(false);
+#endif
+        else UpdateCurrentFreq(false);
+        break;
     case KEY_STAR: UpdateRssiTriggerLevel(true); break;
     case KEY_F: UpdateRssiTriggerLevel(false); break;
     case KEY_5: FreqInput(); break;
     case KEY_0: ToggleModulation(); break;
     case KEY_6: ToggleListeningBW(); break;
-    case KEY_4: ToggleStepsCount(); break;
+    case KEY_4:
+#ifdef ENABLE_SCAN_RANGES
+        // A scan range sets its own steps, zoom into it instead
+        if (gScanRangeStart) { CycleZoom(); break; }
+#endif
+        ToggleStepsCount();
+        break;
+    case KEY_MENU:
+        // Press: freeze the waterfall; hold: the signal table, undoing
+        // the freeze of the press before it
+        ToggleWaterfallFreeze();
+        if (kbd.counter == 16) OpenTable(TABLE_SIGNALS);
+        break;
     case KEY_SIDE2: ToggleBacklight(); break;
+#ifdef ENABLE_SCAN_RANGES
+    case KEY_SIDE1:
+        // Press: skip the peak, once released so that a hold only forgets
+        // this band's list
+        blacklistPending = kbd.counter != 16;
+        if (kbd.counter == 16) ResetBlacklist();
+        break;
+#endif
     case KEY_PTT: SetState(STILL); TuneToPeak(); break;
     case KEY_EXIT:
         if (menuState)
@@ -1487,6 +1688,50 @@ static void OnKeyDown(uint8_t key)
     }
 }
 
+static void TuneToRow()
+{
+    if (tableView == TABLE_SIGNALS)
+    {
+        if (tableRow < PEAKS_GetCount())
+        {
+            const PEAK_t *p = PEAKS_Get(tableRow);
+            TuneToEntry(p->f, p->i, p->rssi);
+        }
+    }
+    else if (tableRow < occupancyRows)
+    {
+        const uint8_t bin = occupancyOrder[tableRow];
+        TuneToEntry(OCCUPANCY_GetFrequency(bin), OCCUPANCY_GetStep(bin),
+                    OCCUPANCY_Get(bin)->Max);
+    }
+}
+
+static void OnKeyDownTable(uint8_t key)
+{
+    const uint8_t count = tableView == TABLE_SIGNALS ? PEAKS_GetCount() : occupancyRows;
+
+    switch (key)
+    {
+    case KEY_UP: if (tableRow) tableRow--; break;
+    case KEY_DOWN: if (tableRow + 1 < count) tableRow++; break;
+    case KEY_STAR:
+        OpenTable(tableView == TABLE_SIGNALS ? TABLE_OCCUPANCY : TABLE_SIGNALS);
+        break;
+    case KEY_0:
+        // Starts the survey over
+        if (tableView == TABLE_OCCUPANCY) OCCUPANCY_Reset();
+        break;
+    case KEY_MENU:
+        // Still held from opening the table
+        if (kbd.counter == 16) break;
+        // fall through
+    case KEY_PTT: TuneToRow(); break;
+    case KEY_EXIT: tableView = TABLE_NONE; break;
+    default: return;
+    }
+    redrawScreen = true;
+}
+
 static void OnKeyDownFreqInput(uint8_t key)
 {
     switch (key)
@@ -1572,10 +1817,25 @@ static void RenderStatus()
  * @see DrawNums() - Numeric information display
  * @see DrawWaterfall() - Temporal waterfall visualization
  */
+// Column of the peak on screen, may be off it when zoomed
+static int32_t PeakX()
+{
+#ifdef ENABLE_SCAN_RANGES
+    if (IsWideSweep())
+    {
+        const int32_t fine = (uint32_t)peak.i * BINS_FINE / scanInfo.measurementsCount;
+        return (fine - viewOffset) * (SPECTRUM_MAX_STEPS << viewZoom) / BINS_FINE;
+    }
+#endif
+    return 128u * peak.i / GetStepsCount();
+}
+
 static void RenderSpectrum(void)
 {
     DrawTicks();
-    DrawArrow(128u * peak.i / GetStepsCount());
+    const int32_t peakX = PeakX();
+    if (peakX >= 0 && peakX < 128)
+        DrawArrow(peakX);
 
     DrawSpectrumEnhanced(); 
     DrawRssiTriggerLevel();
@@ -1585,7 +1845,7 @@ static void RenderSpectrum(void)
         // Register 0x30 is the main audio gate for the BK chip
         BK4819_WriteRegister(BK4819_REG_30, 0x0000); //Former BK4829_WriteRegister(0x30, 0x0000); 
     } else {
-        BK4829_WriteRegister(0x30, 0xFFFF);
+        BK4819_WriteRegister(BK4819_REG_30, 0xFFFF);
     }
 
     DrawF(peak.f);
@@ -1593,6 +1853,101 @@ static void RenderSpectrum(void)
     DrawWaterfall(); 
 }
 
+// Tracked peaks in frequency order: frequency, level when last seen, share
+// of the sweeps it was seen in and the name of a channel on it
+static void RenderPeakTable(void)
+{
+    const uint8_t count = PEAKS_GetCount();
+    if (tableRow >= count)
+        tableRow = count ? count - 1 : 0;
+
+    GUI_DisplaySmallest("FREQ", 0, 1, false, true);
+    GUI_DisplaySmallest("DBM DUTY NAME", 48, 1, false, true);
+
+    if (!count)
+    {
+        GUI_DisplaySmallest("NO SIGNALS", 44, 25, false, true);
+        return;
+    }
+
+    for (uint8_t row = 0; row < count; row++)
+    {
+        const PEAK_t *p = PEAKS_Get(row);
+        const bool selected = row == tableRow;
+        const uint8_t y = (row + 1) * 8 + 1;
+
+        if (selected)
+            memset(gFrameBuffer[row + 1], 0xFF, LCD_WIDTH);
+
+        sprintf(String, "%u.%05u", p->f / 100000, p->f % 100000);
+        GUI_DisplaySmallest(String, 0, y, false, !selected);
+        sprintf(String, "%4d %3u%%", Rssi2DBm(p->rssi), PEAKS_GetDuty(p));
+        GUI_DisplaySmallest(String, 44, y, false, !selected);
+
+        const int channel = SETTINGS_FindChannelByFrequency(p->f);
+        if (channel >= 0)
+        {
+            char name[12] = {0};
+            SETTINGS_FetchChannelName(name, channel);
+            GUI_DisplaySmallest(name, 84, y, false, !selected);
+        }
+    }
+}
+
+// Time since a survey second, as a few characters
+static void FormatAgo(char *s, uint32_t seconds)
+{
+    if (seconds < 100)
+        sprintf(s, "%us", seconds);
+    else if (seconds < 6000)
+        sprintf(s, "%um", seconds / 60);
+    else
+        sprintf(s, "%uh", seconds / 3600);
+}
+
+// Bins that were busy during the survey, busiest first: frequency, share of
+// the sweeps over the trigger level, highest level and when it was last busy
+static void RenderOccupancyTable(void)
+{
+    const uint8_t ROWS = 6;
+    const uint32_t elapsed = OCCUPANCY_GetElapsed();
+
+    occupancyRows = OCCUPANCY_Sort(occupancyOrder);
+    if (tableRow >= occupancyRows)
+        tableRow = occupancyRows ? occupancyRows - 1 : 0;
+
+    sprintf(String, "N:%u", OCCUPANCY_GetSweeps());
+    GUI_DisplaySmallest(String, 0, 1, false, true);
+    GUI_DisplaySmallest("BUSY  MAX AGO", 44, 1, false, true);
+
+    if (!occupancyRows)
+    {
+        GUI_DisplaySmallest("NO ACTIVITY", 42, 25, false, true);
+        return;
+    }
+
+    const uint8_t top = tableRow < ROWS ? 0 : tableRow - (ROWS - 1);
+
+    for (uint8_t row = 0; row < ROWS && top + row < occupancyRows; row++)
+    {
+        const uint8_t bin = occupancyOrder[top + row];
+        const OCCUPANCY_Bin_t *p = OCCUPANCY_Get(bin);
+        const uint32_t f = OCCUPANCY_GetFrequency(bin);
+        const bool selected = top + row == tableRow;
+        const uint8_t y = (row + 1) * 8 + 1;
+        char ago[8];
+
+        if (selected)
+            memset(gFrameBuffer[row + 1], 0xFF, LCD_WIDTH);
+
+        sprintf(String, "%u.%05u", f / 100000, f % 100000);
+        GUI_DisplaySmallest(String, 0, y, false, !selected);
+        FormatAgo(ago, elapsed - p->LastSeen);
+        sprintf(String, "%3u%% %4d %s", OCCUPANCY_GetPercent(bin), Rssi2DBm(p->Max), ago);
+        GUI_DisplaySmallest(String, 44, y, false, !selected);
+    }
+}
+
 static void RenderStill()
 {
     DrawF(fMeasure);
@@ -1690,7 +2045,9 @@ static void Render()
     switch (currentState)
     {
     case SPECTRUM:
-        RenderSpectrum();
+        if (tableView == TABLE_SIGNALS) RenderPeakTable();
+        else if (tableView == TABLE_OCCUPANCY) RenderOccupancyTable();
+        else RenderSpectrum();
         break;
     case FREQ_INPUT:
         RenderFreqInput();
@@ -1718,6 +2075,11 @@ static bool HandleUserInput()
     }
     else
     {
+#ifdef ENABLE_SCAN_RANGES
+        if (blacklistPending && kbd.prev == KEY_SIDE1)
+            Blacklist();
+        blacklistPending = false;
+#endif
         kbd.counter = 0;
     }
 
@@ -1726,7 +2088,8 @@ static bool HandleUserInput()
         switch (currentState)
         {
         case SPECTRUM:
-            OnKeyDown(kbd.current);
+            if (tableView) OnKeyDownTable(kbd.current);
+            else OnKeyDown(kbd.current);
             break;
         case FREQ_INPUT:
             OnKeyDownFreqInput(kbd.current);
@@ -1757,20 +2120,24 @@ static bool HandleUserInput()
  */
 static void Scan()
 {
-    // Skip if already measured or if in blacklist
-    if (rssiHistory[scanInfo.i] != RSSI_MAX_VALUE
 #ifdef ENABLE_SCAN_RANGES
-        && !IsBlacklisted(scanInfo.i)
-#endif
-    )
+    // Blacklisted steps are not measured and read as the floor
+    if (IsBlacklisted(scanInfo.i))
     {
-        SetF(scanInfo.f);           // Tune receiver to target frequency
-        Measure();                   // Perform RSSI measurement
-        // Determine if signal is present (use rssiHistory or scanInfo.rssi)
-        bool hasSignal = (scanInfo.rssi > settings.rssiTriggerLevel);
-        SetBandLed(scanInfo.f, false, hasSignal); // Set LED for RX only if signal
-        UpdateScanInfo();            // Update peak/min statistics
+        if (IsWideSweep())
+            BINS_Skip(scanInfo.i);
+        else
+            rssiHistory[scanInfo.i] = 0;
+        return;
     }
+#endif
+
+    SetF(scanInfo.f);           // Tune receiver to target frequency
+    Measure();                   // Perform RSSI measurement
+    // Determine if signal is present (use rssiHistory or scanInfo.rssi)
+    bool hasSignal = (scanInfo.rssi > settings.rssiTriggerLevel);
+    SetBandLed(scanInfo.f, false, hasSignal); // Set LED for RX only if signal
+    UpdateScanInfo();            // Update peak/min statistics
 }
 
 /**
@@ -1818,37 +2185,17 @@ static void AutoTriggerLevel()
     }
 }
 
-// --- SECTION 2: OPTIMIZED WATERFALL ---
-
-static void UpdateWaterfall()
-{
-    // Optimized with Integer Math for high FPS
-    for (uint8_t x = 0; x < 128; x++)
-    {
-        uint16_t rssi = rssiHistory[x >> settings.stepsCount];
-        uint8_t intensity = 0;
-        
-        if (rssi > scanInfo.rssiMin) {
-            uint32_t diff = (uint32_t)(rssi - scanInfo.rssiMin);
-            // Dynamic range stretch: maps signal-to-noise onto 16 levels
-            intensity = (uint8_t)((diff * 15) / (scanInfo.rssiMax - scanInfo.rssiMin + 1));
-        }
-        waterfallHistory[waterfallIndex][x] = intensity;
-    }
-    waterfallIndex = (waterfallIndex + 1) % WATERFALL_ROWS;
-}
-
 // --- SECTION 3: UPDATE LOOPS ---
 
 static void UpdateScan()
 {
     Scan();
+    NextScanStep();
 
+    // Exactly measurementsCount steps, the last one used to be measured
+    // past the end of rssiHistory
     if (scanInfo.i < scanInfo.measurementsCount)
-    {
-        NextScanStep();
         return;
-    }
 
     if (!(scanInfo.measurementsCount >> 7)) 
         memset(&rssiHistory[scanInfo.measurementsCount], 0,
@@ -1856,15 +2203,29 @@ static void UpdateScan()
 
     redrawScreen = true;
     preventKeypress = false;
+    UpdatePeaks();
     UpdatePeakInfo();
-    
-    static uint8_t waterfallUpdateCounter = 0;
-    if (++waterfallUpdateCounter >= 2)
+    OCCUPANCY_Update(rssiHistory, settings.rssiTriggerLevel);
+
+#ifdef ENABLE_SPECTRUM_STREAM
+    // Wide ranges are folded into the 128 bins of rssiHistory
+    const uint16_t bins = scanInfo.measurementsCount > SPECTRUM_MAX_STEPS
+                            ? SPECTRUM_MAX_STEPS : scanInfo.measurementsCount;
+    const uint16_t *mins = NULL;
+#ifdef ENABLE_SCAN_RANGES
+    uint16_t binMin[SPECTRUM_MAX_STEPS];
+    if (IsWideSweep())
     {
-        UpdateWaterfall();
-        waterfallUpdateCounter = 0;
+        for (uint8_t b = 0; b < bins; b++)
+            binMin[b] = BINS_GetMin(b);
+        mins = binMin;
     }
-    
+#endif
+    STREAM_SendSweep(rssiHistory, mins, bins,
+                     scanInfo.f - (uint32_t)scanInfo.i * scanInfo.scanStep,
+                     (uint32_t)scanInfo.scanStep * scanInfo.measurementsCount / bins);
+#endif
+
     if (IsPeakOverLevel())
     {
         ToggleRX(true);
@@ -1922,10 +2283,11 @@ static void UpdateListening()
         Measure();
         BK4819_WriteRegister(0x43, listenBWRegValues[settings.listenBw]);
         
+        // The sweep is paused, keep the waterfall moving with its last rows
         static uint8_t waterfallUpdateCounter = 0;
-        if (++waterfallUpdateCounter >= 2)
+        if (++waterfallUpdateCounter >= WATERFALL_UPDATE_INTERVAL)
         {
-            UpdateWaterfall();
+            PushWaterfallLine();
             waterfallUpdateCounter = 0;
         }
     }
@@ -1964,6 +2326,18 @@ static void Tick()
     }
 #endif
 
+#ifdef ENABLE_WATERFALL_SCROLLBACK
+    // Steps the background program of full scroll-back sectors
+    PY25Q16_Poll();
+#endif
+
+#ifdef ENABLE_SPECTRUM_STREAM
+    // The main loop is not running, take the stream grants and survey reads
+    // here, nothing else
+    if (UART_IsCommandAvailable(UART_PORT_VCP))
+        UART_HandleSpectrumCommand(UART_PORT_VCP);
+#endif
+
     // Handle user input only once per tick
     if (!preventKeypress) HandleUserInput();
 
@@ -1972,6 +2346,7 @@ static void Tick()
     {
         // 1. Snapshot the whole scan into the waterfall
         PushWaterfallLine();
+        UpdateSweepTiming();
 
         // 2. Sugar 1 Squelch (Hardware Gate)
         // Switch to BK4819 prefix so the linker can find the function
@@ -1990,7 +2365,7 @@ static void Tick()
     if (gNextTimeslice_500ms)
     {
         gNextTimeslice_500ms = false;
-        if (GetStepsCount() > 128 && !isListening)
+        if (scanInfo.measurementsCount > SPECTRUM_MAX_STEPS && !isListening)
         {
             UpdatePeakInfo();
             if (IsPeakOverLevel())
@@ -2114,8 +2489,11 @@ void APP_RunSpectrum(void)
     RelaunchScan();
 
     memset(rssiHistory, 0, sizeof(rssiHistory));
-    memset(waterfallHistory, 0, sizeof(waterfallHistory));
-    waterfallIndex = 0;
+    WATERFALL_Clear();
+    waterfallFrozen = false;
+    waterfallScroll = 0;
+    tableView = TABLE_NONE;
+    PEAKS_Reset();
 
     isInitialized = true;
 
@@ -2135,19 +2513,46 @@ void APP_RunSpectrum(void)
         }
     }
 }
+static void UpdateSweepTiming(void)
+{
+    if (isListening)
+        return;
+
+    // The filter the settle is calibrated for, also after a step change
+    BK4819_WriteRegister(BK4819_REG_43, GetBWRegValueForScan());
+
+    // Too many reads of the last sweep needed the glitch poll: the receiver
+    // has drifted from its calibration, measure it again
+    const uint16_t late = SETTLE_TakeLateReads();
+    uint16_t *pSettle = &settleUs[settings.scanStepIndex];
+    if (late > GetStepsCount() / 8 && *pSettle < SETTLE_MAX_US)
+        *pSettle = 0;
+
+    if (!*pSettle)
+    {
+        const uint32_t f = GetFStart();
+        *pSettle = SETTLE_Calibrate(SetF, f, f + 100000);
+        SETTLE_MarkSweep();     // the calibration is not part of a sweep
+        sweepUs = 0;
+        return;
+    }
+
+    sweepUs = SETTLE_MarkSweep();
+}
+
 static void PushWaterfallLine(void)
 {
-    // Cycle the circular buffer
-    waterfallIndex = (waterfallIndex + 1) % WATERFALL_HISTORY_DEPTH;
+    if (waterfallFrozen)
+        return;
 
+    uint8_t levels[SPECTRUM_MAX_STEPS];
     uint16_t steps = GetStepsCount();
+    if (steps > SPECTRUM_MAX_STEPS)
+        steps = SPECTRUM_MAX_STEPS;
+
+    // Same dbMin..dbMax scale as the spectrum trace, on 16 levels
     for (uint16_t i = 0; i < steps; i++)
-    {
-        // Map RSSI to 0-15 level
-        uint8_t level = (rssiHistory[i] > settings.dbMin) ? (rssiHistory[i] - settings.dbMin) : 0;
-        level /= 4; 
-        if (level > 15) level = 15;
+        levels[i] = Rssi2PX(rssiHistory[i], 0, 15);
 
-        waterfallHistory[i][waterfallIndex] = level;
-    }
+    WATERFALL_Push(levels, steps);
 }
\ No newline at end of file
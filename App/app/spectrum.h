@@ -98,8 +98,14 @@ static const uint16_t scanStepBWRegValues[] = {
     0b0110110001001000, // 6.25
     // 1250
     0b0111111100001000, // 6.25
+    // 1500
+    0b0111111100001000, // 6.25
+    // 2000
+    0b0111111100001000, // 6.25
     // 2500
     0b0011011000101000, // 25
+    // 5000
+    0b0011011000101000, // 25
     // 10000
     0b0011011000101000, // 25
 };
@@ -117,6 +123,13 @@ typedef enum State
     STILL,
 } State;
 
+typedef enum TableView
+{
+    TABLE_NONE,
+    TABLE_SIGNALS,
+    TABLE_OCCUPANCY,
+} TableView;
+
 typedef enum StepsCount
 {
     STEPS_128,
@@ -0,0 +1,155 @@
+/* Wide sweep decimation, see spectrum_bins.h. */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "app/spectrum_bins.h"
+
+#define FINE_PER_BIN    (BINS_FINE / BINS_COUNT)
+
+static uint16_t *gMax;
+static uint16_t  gSteps;
+static uint16_t  gEnd[BINS_COUNT];      // first measurement past each bin
+static uint16_t  gMaxAt[BINS_COUNT];    // measurement the max came from
+static uint16_t  gMin[BINS_COUNT];
+static uint16_t  gSum[BINS_COUNT];
+static uint8_t   gCount[BINS_COUNT];    // samples in the sum, skipped steps aside
+static uint8_t   gBin;
+
+// Fine level in 1 dB, RSSI / 2, which is plenty for a zoomed look
+static uint8_t   gFine[BINS_FINE];
+static uint16_t  gFineCol;
+static uint16_t  gFineEnd;
+
+// First measurement past fine column Col, ceil((Col + 1) * Steps / BINS_FINE)
+static uint16_t FineEnd(uint16_t Col)
+{
+    return ((uint32_t)(Col + 1) * gSteps + BINS_FINE - 1) / BINS_FINE;
+}
+
+uint32_t BINS_SweepStep(uint32_t Span, uint16_t Step)
+{
+    const uint32_t Steps    = Span / Step;
+    const uint32_t Multiple = (Steps + BINS_MAX_STEPS - 1) / BINS_MAX_STEPS;
+
+    return Multiple > 1 ? Multiple * Step : Step;
+}
+
+void BINS_Setup(uint16_t *pMax, uint16_t Steps)
+{
+    gMax = pMax;
+
+    if (Steps == gSteps)
+        return;
+
+    for (unsigned b = 0; b < BINS_COUNT; b++)
+        gEnd[b] = ((uint32_t)(b + 1) * Steps + BINS_COUNT - 1) / BINS_COUNT;
+
+    gSteps = Steps;
+    memset(gFine, 0, sizeof(gFine));
+}
+
+// Skipped steps fold in as a floor sample that only the max sees
+static uint8_t Fold(uint16_t Index, uint16_t Rssi, bool Measured)
+{
+    const uint8_t Level = Rssi >= 2 * 255 ? 255 : Rssi >> 1;
+
+    if (Index == 0)
+        gBin = 0;
+
+    // A new bin starts from this sample instead of holding the last sweep's
+    if (Index == 0 || Index >= gEnd[gBin]) {
+        while (Index >= gEnd[gBin] && gBin < BINS_COUNT - 1)
+            gBin++;
+
+        gMax[gBin]   = Rssi;
+        gMaxAt[gBin] = Index;
+        gSum[gBin]   = 0;
+        gCount[gBin] = 0;
+    } else if (Rssi > gMax[gBin]) {
+        gMax[gBin]   = Rssi;
+        gMaxAt[gBin] = Index;
+    }
+
+    if (Measured) {
+        if (gCount[gBin] == 0 || Rssi < gMin[gBin])
+            gMin[gBin] = Rssi;
+        gSum[gBin] += Rssi;
+        gCount[gBin]++;
+    }
+
+    if (Index == 0) {
+        gFineCol  = 0;
+        gFineEnd  = FineEnd(0);
+        gFine[0]  = Level;
+    } else if (Index >= gFineEnd) {
+        // Columns narrower than a step hold the step that covers them
+        const uint8_t Held = gFine[gFineCol];
+
+        gFineCol++;
+        while ((gFineEnd = FineEnd(gFineCol)) <= Index && gFineCol < BINS_FINE - 1)
+            gFine[gFineCol++] = Held;
+        gFine[gFineCol] = Level;
+    } else if (Level > gFine[gFineCol]) {
+        gFine[gFineCol] = Level;
+    }
+
+    // With fewer steps than columns the last step covers the ones past it,
+    // which would otherwise show an older sweep
+    if (Index == gSteps - 1)
+        memset(&gFine[gFineCol + 1], gFine[gFineCol], BINS_FINE - 1 - gFineCol);
+
+    return gBin;
+}
+
+uint8_t BINS_Add(uint16_t Index, uint16_t Rssi)
+{
+    return Fold(Index, Rssi, true);
+}
+
+uint8_t BINS_Skip(uint16_t Index)
+{
+    return Fold(Index, 0, false);
+}
+
+uint8_t BINS_Of(uint16_t Index)
+{
+    const uint32_t Bin = (uint32_t)Index * BINS_COUNT / gSteps;
+    return Bin < BINS_COUNT ? Bin : BINS_COUNT - 1;
+}
+
+uint16_t BINS_GetMaxAt(uint8_t Bin)
+{
+    return gMaxAt[Bin];
+}
+
+uint16_t BINS_GetAvg(uint8_t Bin)
+{
+    return gCount[Bin] ? gSum[Bin] / gCount[Bin] : 0;
+}
+
+uint16_t BINS_GetMin(uint8_t Bin)
+{
+    return gCount[Bin] ? gMin[Bin] : 0;
+}
+
+void BINS_View(uint16_t *pOut, uint8_t Zoom, uint16_t Offset)
+{
+    if (Zoom > BINS_ZOOM_MAX)
+        Zoom = BINS_ZOOM_MAX;
+
+    const unsigned Per = FINE_PER_BIN >> Zoom;
+
+    if (Offset > BINS_FINE - BINS_COUNT * Per)
+        Offset = BINS_FINE - BINS_COUNT * Per;
+
+    const uint8_t *pFine = gFine + Offset;
+
+    for (unsigned x = 0; x < BINS_COUNT; x++, pFine += Per) {
+        uint8_t Max = pFine[0];
+        for (unsigned j = 1; j < Per; j++)
+            if (pFine[j] > Max)
+                Max = pFine[j];
+        pOut[x] = Max * 2;
+    }
+}
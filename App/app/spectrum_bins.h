@@ -0,0 +1,52 @@
+/* Decimation of wide spectrum sweeps into the 128 display bins.
+ *
+ * A scan range can hold far more steps than the display has columns. Each
+ * measurement is folded into its bin as it arrives: the bin keeps the max
+ * (written to the caller's history, which the display, peak search and
+ * waterfall read), the min and the sum for the average trace. Bin b holds the
+ * steps i with i * 128 / Steps == b; the boundaries are computed once per
+ * sweep length, so a sample costs compares and adds only.
+ *
+ * The same samples also fill a finer level of BINS_FINE max-held columns,
+ * the other level of a two level pyramid over the last sweep. BINS_View()
+ * reads a zoomed sub-span from it without sweeping that span again.
+ */
+
+#ifndef APP_SPECTRUM_BINS_H
+#define APP_SPECTRUM_BINS_H
+
+#include <stdint.h>
+
+#define BINS_COUNT      128
+#define BINS_FINE       512
+// Longest sweep folded, 64 steps per bin keeps the sums in 16 bits; a longer
+// range is swept with a coarser step, see BINS_SweepStep()
+#define BINS_MAX_STEPS  8192
+// Zoom factors BINS_View() takes, 1 << 0 .. 1 << BINS_ZOOM_MAX
+#define BINS_ZOOM_MAX   2
+
+// Step to sweep Span with, Step or the smallest multiple of it that fits the
+// span in BINS_MAX_STEPS measurements
+uint32_t BINS_SweepStep(uint32_t Span, uint16_t Step);
+// Prepares a sweep of Steps (BINS_COUNT..BINS_MAX_STEPS) measurements whose
+// per-bin max goes to pMax[BINS_COUNT]
+void     BINS_Setup(uint16_t *pMax, uint16_t Steps);
+// Folds measurement Index of the sweep, Index going up from 0 each sweep;
+// returns the bin it landed in
+uint8_t  BINS_Add(uint16_t Index, uint16_t Rssi);
+// Same for a step that is not measured, a blacklisted one: it reads as the
+// floor in the max and fine level, so a bin of only such steps does not
+// hold the last level measured in it, and stays out of the min and average
+uint8_t  BINS_Skip(uint16_t Index);
+// Bin of measurement Index, for a sample outside the sweep order
+uint8_t  BINS_Of(uint16_t Index);
+// Measurement the bin's max came from, to tune a peak found in the bins
+uint16_t BINS_GetMaxAt(uint8_t Bin);
+uint16_t BINS_GetAvg(uint8_t Bin);
+// Lowest measurement of the bin, 0 when none was measured
+uint16_t BINS_GetMin(uint8_t Bin);
+// BINS_COUNT columns of max RSSI covering 1 / (1 << Zoom) of the sweep from
+// fine column Offset, 0..BINS_FINE - (BINS_FINE >> Zoom)
+void     BINS_View(uint16_t *pOut, uint8_t Zoom, uint16_t Offset);
+
+#endif
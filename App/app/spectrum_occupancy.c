@@ -0,0 +1,130 @@
+/* Per-bin occupancy statistics, see spectrum_occupancy.h. */
+
+#include <string.h>
+
+#include "app/spectrum_occupancy.h"
+#include "scheduler.h"
+
+static OCCUPANCY_Bin_t gBin[OCCUPANCY_BINS];
+static uint16_t gSweeps;
+static uint32_t gStartS;
+
+// Sweep geometry the survey is of
+static uint32_t gStart;
+static uint16_t gStep;
+static uint16_t gSteps;
+static uint8_t  gBins;
+
+static uint32_t GetSeconds(void)
+{
+    return gGlobalSysTickCounter / 100;
+}
+
+void OCCUPANCY_Setup(uint32_t Start, uint16_t Step, uint16_t Steps)
+{
+    if (Start == gStart && Step == gStep && Steps == gSteps)
+        return;
+
+    gStart = Start;
+    gStep  = Step;
+    gSteps = Steps;
+    gBins  = Steps < OCCUPANCY_BINS ? Steps : OCCUPANCY_BINS;
+    OCCUPANCY_Reset();
+}
+
+void OCCUPANCY_Reset(void)
+{
+    memset(gBin, 0, sizeof(gBin));
+    gSweeps = 0;
+    gStartS = GetSeconds();
+}
+
+void OCCUPANCY_Update(const uint16_t *pRssi, uint16_t Trigger)
+{
+    const uint32_t Elapsed = OCCUPANCY_GetElapsed();
+    const uint16_t Second  = Elapsed < 0xFFFF ? Elapsed : 0xFFFF;
+
+    if (gSweeps == 0xFFFF) {
+        gSweeps >>= 1;
+        for (uint8_t b = 0; b < gBins; b++)
+            gBin[b].Busy >>= 1;
+    }
+    gSweeps++;
+
+    OCCUPANCY_Bin_t *pBin = gBin;
+    for (uint8_t b = 0; b < gBins; b++, pBin++) {
+        const uint16_t Rssi = pRssi[b];
+
+        if (Rssi > pBin->Max)
+            pBin->Max = Rssi;
+        if (Rssi > Trigger) {
+            pBin->Busy++;
+            pBin->LastSeen = Second;
+        }
+    }
+}
+
+uint16_t OCCUPANCY_GetSweeps(void)
+{
+    return gSweeps;
+}
+
+uint8_t OCCUPANCY_GetBins(void)
+{
+    return gBins;
+}
+
+uint32_t OCCUPANCY_GetElapsed(void)
+{
+    return GetSeconds() - gStartS;
+}
+
+const OCCUPANCY_Bin_t *OCCUPANCY_Get(uint8_t Bin)
+{
+    return &gBin[Bin];
+}
+
+uint16_t OCCUPANCY_GetStep(uint8_t Bin)
+{
+    // Bin b holds the steps i with i * gBins / gSteps == b
+    const uint16_t First = ((uint32_t)Bin * gSteps + gBins - 1) / gBins;
+    const uint16_t End   = ((uint32_t)(Bin + 1) * gSteps + gBins - 1) / gBins;
+
+    return (First + End - 1) / 2;
+}
+
+uint32_t OCCUPANCY_GetFrequency(uint8_t Bin)
+{
+    return gStart + (uint32_t)OCCUPANCY_GetStep(Bin) * gStep;
+}
+
+uint8_t OCCUPANCY_GetPercent(uint8_t Bin)
+{
+    return gSweeps ? (uint32_t)gBin[Bin].Busy * 100 / gSweeps : 0;
+}
+
+// Busier first, the stronger of two equally busy ones first
+static int Compare(uint8_t a, uint8_t b)
+{
+    if (gBin[a].Busy != gBin[b].Busy)
+        return gBin[a].Busy > gBin[b].Busy ? -1 : 1;
+
+    return gBin[a].Max > gBin[b].Max ? -1 : gBin[a].Max < gBin[b].Max;
+}
+
+uint8_t OCCUPANCY_Sort(uint8_t *pOrder)
+{
+    uint8_t Count = 0;
+
+    for (uint8_t b = 0; b < gBins; b++) {
+        if (!gBin[b].Busy)
+            continue;
+
+        uint8_t k = Count++;
+        for (; k && Compare(b, pOrder[k - 1]) < 0; k--)
+            pOrder[k] = pOrder[k - 1];
+        pOrder[k] = b;
+    }
+
+    return Count;
+}
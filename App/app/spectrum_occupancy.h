@@ -0,0 +1,48 @@
+/* Per-bin occupancy of the spectrum sweeps, for site surveys.
+ *
+ * Each completed sweep is folded into OCCUPANCY_BINS counters alongside
+ * rssiHistory: the sweeps the bin was over the trigger level in, its
+ * highest level and the survey second it was last over the trigger. The
+ * pass is a couple of integer compares per bin. The counters are 16 bit;
+ * before the sweep count saturates it is halved with every busy count, so
+ * the shares stay right and recent sweeps weigh a bit more.
+ *
+ * The survey starts over when the sweep's start, step or length changes.
+ */
+
+#ifndef APP_SPECTRUM_OCCUPANCY_H
+#define APP_SPECTRUM_OCCUPANCY_H
+
+#include <stdint.h>
+
+#define OCCUPANCY_BINS  128
+
+typedef struct {
+    uint16_t Busy;      // sweeps over the trigger level
+    uint16_t Max;       // highest level, raw RSSI
+    uint16_t LastSeen;  // survey second it was last over the trigger level
+} OCCUPANCY_Bin_t;
+
+// Survey of a sweep of Steps steps of Step from Start (10 Hz units), folded
+// into min(Steps, OCCUPANCY_BINS) bins as spectrum_bins.c does
+void     OCCUPANCY_Setup(uint32_t Start, uint16_t Step, uint16_t Steps);
+// Starts the survey over
+void     OCCUPANCY_Reset(void);
+// Folds a completed sweep of per-bin levels in
+void     OCCUPANCY_Update(const uint16_t *pRssi, uint16_t Trigger);
+
+uint16_t OCCUPANCY_GetSweeps(void);
+uint8_t  OCCUPANCY_GetBins(void);
+// Seconds since the survey started
+uint32_t OCCUPANCY_GetElapsed(void);
+const OCCUPANCY_Bin_t *OCCUPANCY_Get(uint8_t Bin);
+// Middle step of Bin, and its frequency
+uint16_t OCCUPANCY_GetStep(uint8_t Bin);
+uint32_t OCCUPANCY_GetFrequency(uint8_t Bin);
+// Share of the sweeps Bin was busy in, in percent
+uint8_t  OCCUPANCY_GetPercent(uint8_t Bin);
+// The bins that were ever busy into pOrder[OCCUPANCY_BINS], busiest first;
+// returns how many
+uint8_t  OCCUPANCY_Sort(uint8_t *pOrder);
+
+#endif
@@ -0,0 +1,209 @@
+/* Multi-peak detection, see spectrum_peaks.h. */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "app/spectrum_peaks.h"
+
+static PEAK_t  gPeaks[PEAKS_MAX];
+static uint8_t gCount;
+
+// Into the strongest-first pHits, the weakest dropping out when full
+static uint8_t Insert(PEAK_Hit_t *pHits, uint8_t Count, uint16_t Index, uint16_t Rssi)
+{
+    uint8_t k = Count;
+
+    if (Count == PEAKS_MAX) {
+        if (Rssi <= pHits[PEAKS_MAX - 1].rssi)
+            return Count;
+        k = PEAKS_MAX - 1;
+    } else {
+        Count++;
+    }
+
+    for (; k && pHits[k - 1].rssi < Rssi; k--)
+        pHits[k] = pHits[k - 1];
+
+    pHits[k].f    = 0;
+    pHits[k].i    = Index;
+    pHits[k].rssi = Rssi;
+
+    return Count;
+}
+
+uint8_t PEAKS_Find(const uint16_t *pRssi, uint16_t Count, uint16_t Floor, PEAK_Hit_t *pHits)
+{
+    const uint32_t Level = (uint32_t)Floor + PEAKS_PROMINENCE;
+    uint8_t  Found  = 0;
+    uint16_t Max    = 0;
+    uint16_t MaxAt  = 0;
+    uint16_t Min    = 0;
+    bool     Rising = true;
+
+    // Alternately after a max and after a min, each confirmed once the
+    // trace has moved a prominence away from it
+    for (uint16_t i = 0; i < Count; i++) {
+        const uint16_t Rssi = pRssi[i];
+
+        if (Rising) {
+            if (Rssi > Max) {
+                Max   = Rssi;
+                MaxAt = i;
+            } else if (Rssi + PEAKS_PROMINENCE <= Max) {
+                if (Max >= Level)
+                    Found = Insert(pHits, Found, MaxAt, Max);
+                Min    = Rssi;
+                Rising = false;
+            }
+        } else {
+            if (Rssi < Min) {
+                Min = Rssi;
+            } else if (Rssi >= Min + PEAKS_PROMINENCE) {
+                Max    = Rssi;
+                MaxAt  = i;
+                Rising = true;
+            }
+        }
+    }
+
+    // Still up at the end of the sweep
+    if (Rising && Max >= Level)
+        Found = Insert(pHits, Found, MaxAt, Max);
+
+    return Found;
+}
+
+static void Remove(uint8_t Index)
+{
+    memmove(&gPeaks[Index], &gPeaks[Index + 1], (gCount - Index - 1) * sizeof(gPeaks[0]));
+    gCount--;
+}
+
+static void Set(PEAK_t *pPeak, const PEAK_Hit_t *pHit)
+{
+    pPeak->f    = pHit->f;
+    pPeak->i    = pHit->i;
+    pPeak->rssi = pHit->rssi;
+    pPeak->age  = 0;
+}
+
+// Entry for a peak not tracked yet: a free one, else the stalest or the
+// weakest of those not seen this sweep if the new peak is stronger
+static PEAK_t *Allocate(const PEAK_Hit_t *pHit, uint8_t Matched)
+{
+    if (gCount < PEAKS_MAX)
+        return &gPeaks[gCount++];
+
+    PEAK_t *pVictim = NULL;
+    for (uint8_t k = 0; k < gCount; k++) {
+        PEAK_t *pPeak = &gPeaks[k];
+        if (Matched & (1u << k))
+            continue;
+        if (!pVictim || pPeak->age > pVictim->age ||
+            (pPeak->age == pVictim->age && pPeak->rssi < pVictim->rssi))
+            pVictim = pPeak;
+    }
+
+    if (pVictim && (pVictim->age || pVictim->rssi < pHit->rssi))
+        return pVictim;
+
+    return NULL;
+}
+
+void PEAKS_Track(const PEAK_Hit_t *pHits, uint8_t Count, uint32_t Tolerance)
+{
+    uint8_t Matched = 0;
+
+    for (uint8_t k = 0; k < gCount; k++) {
+        PEAK_t *pPeak = &gPeaks[k];
+        if (pPeak->sweeps == 0xFFFF) {
+            pPeak->sweeps >>= 1;
+            pPeak->seen   >>= 1;
+        }
+        pPeak->sweeps++;
+        if (pPeak->age < 0xFF)
+            pPeak->age++;
+    }
+
+    for (uint8_t h = 0; h < Count; h++) {
+        const PEAK_Hit_t *pHit = &pHits[h];
+        uint32_t Best = Tolerance + 1;
+        int8_t   At   = -1;
+
+        for (uint8_t k = 0; k < gCount; k++) {
+            if (Matched & (1u << k))
+                continue;
+            const uint32_t Distance = gPeaks[k].f > pHit->f ? gPeaks[k].f - pHit->f
+                                                            : pHit->f - gPeaks[k].f;
+            if (Distance < Best) {
+                Best = Distance;
+                At   = k;
+            }
+        }
+
+        if (At >= 0) {
+            Set(&gPeaks[At], pHit);
+            gPeaks[At].seen++;
+        } else {
+            PEAK_t *pPeak = Allocate(pHit, Matched);
+            if (!pPeak)
+                continue;
+            Set(pPeak, pHit);
+            pPeak->seen   = 1;
+            pPeak->sweeps = 1;
+            At = pPeak - gPeaks;
+        }
+
+        Matched |= 1u << At;
+    }
+
+    for (uint8_t k = gCount; k--; )
+        if (gPeaks[k].age > PEAKS_MAX_AGE)
+            Remove(k);
+
+    // Frequency order, a few entries mostly in place already
+    for (uint8_t k = 1; k < gCount; k++) {
+        const PEAK_t Peak = gPeaks[k];
+        uint8_t j = k;
+        for (; j && gPeaks[j - 1].f > Peak.f; j--)
+            gPeaks[j] = gPeaks[j - 1];
+        gPeaks[j] = Peak;
+    }
+}
+
+void PEAKS_Forget(uint32_t Start, uint32_t End)
+{
+    for (uint8_t k = gCount; k--; )
+        if (gPeaks[k].f < Start || gPeaks[k].f > End)
+            Remove(k);
+}
+
+void PEAKS_Reset(void)
+{
+    gCount = 0;
+}
+
+uint8_t PEAKS_GetCount(void)
+{
+    return gCount;
+}
+
+const PEAK_t *PEAKS_Get(uint8_t Index)
+{
+    return &gPeaks[Index];
+}
+
+const PEAK_t *PEAKS_Near(uint32_t Frequency, uint32_t Tolerance)
+{
+    for (uint8_t k = 0; k < gCount; k++)
+        if (gPeaks[k].f + Tolerance >= Frequency && gPeaks[k].f <= Frequency + Tolerance)
+            return &gPeaks[k];
+
+    return NULL;
+}
+
+uint8_t PEAKS_GetDuty(const PEAK_t *pPeak)
+{
+    return (uint32_t)pPeak->seen * 100 / pPeak->sweeps;
+}
@@ -0,0 +1,60 @@
+/* Multi-peak detection over a completed spectrum sweep.
+ *
+ * PEAKS_Find() picks the strongest PEAKS_MAX local maxima of a sweep in one
+ * pass: a maximum counts once the trace has fallen PEAKS_PROMINENCE below
+ * it, and only if it stands that far above the sweep's noise floor, so two
+ * carriers are told apart by the dip between them and noise ripple is not
+ * reported.
+ *
+ * PEAKS_Track() matches each sweep's peaks to the ones already known by
+ * frequency, so a carrier keeps its entry while it comes and goes: the
+ * entry counts the sweeps it was seen in, for the duty cycle, and its age
+ * since it was last seen; it is forgotten after PEAKS_MAX_AGE sweeps.
+ * The tracked list is kept in frequency order for the signal table.
+ */
+
+#ifndef APP_SPECTRUM_PEAKS_H
+#define APP_SPECTRUM_PEAKS_H
+
+#include <stdint.h>
+
+#define PEAKS_MAX           6
+// In RSSI units of 0.5 dB, 6 dB
+#define PEAKS_PROMINENCE    12
+#define PEAKS_MAX_AGE       64
+
+typedef struct {
+    uint32_t f;
+    uint16_t i;
+    uint16_t rssi;
+} PEAK_Hit_t;
+
+typedef struct {
+    uint32_t f;
+    uint16_t i;         // measurement of the sweep it was last seen at
+    uint16_t rssi;      // level when last seen
+    uint16_t seen;      // sweeps it was seen in
+    uint16_t sweeps;    // sweeps since it was first seen, halved with seen before saturating
+    uint8_t  age;       // sweeps since it was last seen
+} PEAK_t;
+
+// Peaks of pRssi[Count] over Floor + PEAKS_PROMINENCE into pHits[PEAKS_MAX],
+// strongest first, with .i the index in pRssi and .f left to the caller;
+// returns how many
+uint8_t PEAKS_Find(const uint16_t *pRssi, uint16_t Count, uint16_t Floor, PEAK_Hit_t *pHits);
+// Updates the tracked peaks with the Count hits of a sweep, a hit within
+// Tolerance (10 Hz units) of a tracked peak being that peak
+void    PEAKS_Track(const PEAK_Hit_t *pHits, uint8_t Count, uint32_t Tolerance);
+// Forgets the tracked peaks outside Start..End, after the span has moved
+void    PEAKS_Forget(uint32_t Start, uint32_t End);
+void    PEAKS_Reset(void);
+
+uint8_t       PEAKS_GetCount(void);
+// Tracked peak Index, in frequency order
+const PEAK_t *PEAKS_Get(uint8_t Index);
+// Tracked peak within Tolerance of Frequency, NULL if none
+const PEAK_t *PEAKS_Near(uint32_t Frequency, uint32_t Tolerance);
+// Share of its sweeps the peak was seen in, in percent
+uint8_t       PEAKS_GetDuty(const PEAK_t *pPeak);
+
+#endif
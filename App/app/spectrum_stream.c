@@ -0,0 +1,78 @@
+/* Spectrum sweep stream, see spectrum_stream.h. */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "app/spectrum_stream.h"
+#include "driver/systick.h"
+#include "driver/vcp.h"
+
+#define PREFIX_SIZE     5       // AA 55 type size
+
+// Owned by the IN endpoint until VCP_IsBusy() clears
+static uint8_t  gFrame[PREFIX_SIZE + sizeof(STREAM_Header_t) + STREAM_MAX_BINS * 4 + 1];
+
+static bool     gActive;
+static uint8_t  gCredits;
+static uint16_t gSeq;
+static uint16_t gDropBusy;
+static uint16_t gDropCredit;
+
+void STREAM_Grant(uint8_t Credits)
+{
+    // A new stream starts its counters from zero
+    if (!gActive) {
+        gSeq        = 0;
+        gDropBusy   = 0;
+        gDropCredit = 0;
+    }
+
+    gActive  = Credits != 0;
+    gCredits = Credits;
+}
+
+void STREAM_SendSweep(const uint16_t *pRssi, const uint16_t *pMin, uint16_t Count, uint32_t Start, uint32_t Step)
+{
+    if (!gActive)
+        return;
+
+    const uint16_t Seq = gSeq++;
+
+    if (gCredits == 0) {
+        gDropCredit++;
+        return;
+    }
+    if (VCP_IsBusy()) {
+        gDropBusy++;
+        return;
+    }
+
+    if (Count > STREAM_MAX_BINS)
+        Count = STREAM_MAX_BINS;
+
+    const STREAM_Header_t Header = {
+        .Seq        = Seq,
+        .DropBusy   = gDropBusy,
+        .DropCredit = gDropCredit,
+        .TimeUs     = SYSTICK_GetTimeUs(),
+        .Start      = Start,
+        .Step       = Step,
+        .Count      = Count,
+        .MinCount   = pMin ? Count : 0,
+    };
+    const uint16_t Size = sizeof(Header) + (Count + Header.MinCount) * 2;
+
+    gFrame[0] = 0xAA;
+    gFrame[1] = 0x55;
+    gFrame[2] = STREAM_FRAME_TYPE;
+    gFrame[3] = Size >> 8;
+    gFrame[4] = Size & 0xFF;
+    memcpy(gFrame + PREFIX_SIZE, &Header, sizeof(Header));
+    memcpy(gFrame + PREFIX_SIZE + sizeof(Header), pRssi, Count * 2);
+    if (pMin)
+        memcpy(gFrame + PREFIX_SIZE + sizeof(Header) + Count * 2, pMin, Count * 2);
+    gFrame[PREFIX_SIZE + Size] = 0x0A;
+
+    gCredits--;
+    VCP_SendAsync(gFrame, PREFIX_SIZE + Size + 1);
+}
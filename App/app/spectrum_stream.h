@@ -0,0 +1,40 @@
+/* Binary spectrum sweep stream over the USB VCP.
+ *
+ * Each completed sweep goes out as one frame in the k5viewer framing:
+ *
+ *   AA 55 03 <size, big endian> <payload> 0A
+ *
+ * with a little endian payload of STREAM_Header_t followed by Count raw
+ * REG_67 RSSI values, one per bin, then MinCount more with the lowest value
+ * of each bin when a wide sweep was folded into the bins. The PC grants frames with command 0x0612
+ * and keeps topping the grant up; a sweep that finds no credit, or the IN
+ * endpoint still sending the previous frame, is dropped and counted so a
+ * PC that stops reading only loses sweeps, never the radio's time.
+ */
+
+#ifndef APP_SPECTRUM_STREAM_H
+#define APP_SPECTRUM_STREAM_H
+
+#include <stdint.h>
+
+#define STREAM_FRAME_TYPE       0x03
+#define STREAM_MAX_BINS         128
+
+typedef struct __attribute__((__packed__)) {
+    uint16_t Seq;           // sweep number, dropped sweeps included
+    uint16_t DropBusy;      // sweeps dropped while the endpoint was busy
+    uint16_t DropCredit;    // sweeps dropped for lack of credit
+    uint32_t TimeUs;        // sweep end on the radio's clock
+    uint32_t Start;         // frequency of bin 0, 10 Hz units
+    uint32_t Step;          // bin width, 10 Hz units
+    uint16_t Count;
+    uint16_t MinCount;      // 0, or Count when the min trace follows
+} STREAM_Header_t;
+
+// Allows the next Credits sweeps to be sent, 0 stops the stream
+void STREAM_Grant(uint8_t Credits);
+// Sends a completed sweep of Count bins if the PC has asked for it, with the
+// per-bin min of pMin unless it is NULL
+void STREAM_SendSweep(const uint16_t *pRssi, const uint16_t *pMin, uint16_t Count, uint32_t Start, uint32_t Step);
+
+#endif
@@ -31,8 +31,22 @@
 #include "driver/crc.h"
 #include "driver/eeprom.h"
 #include "driver/gpio.h"
+#ifdef ENABLE_BOOT_PROFILE
+    #include "helper/boot_profile.h"
+#endif
+#ifdef ENABLE_FRAME_GOVERNOR
+    #include "ui/ui.h"
+#endif
+#ifdef ENABLE_SPECTRUM
+    #include "app/spectrum_occupancy.h"
+#endif
+#ifdef ENABLE_SPECTRUM_STREAM
+    #include "app/spectrum_stream.h"
+    #include "driver/systick.h"
+#endif
 
 #if defined(ENABLE_UART)
+#include "driver/py25q16.h"
 #include "driver/uart.h"
 #endif
 
@@ -201,6 +215,12 @@ static void SendReply_VCP(void *pReply, uint16_t Size)
         return;
     }
 
+#ifdef ENABLE_SPECTRUM_STREAM
+    // A sweep frame may still be on its way out, give it up to 10 ms
+    for (unsigned int i = 0; i < 100 && VCP_IsBusy(); i++)
+        SYSTICK_DelayUs(100);
+#endif
+
     memcpy(VCP_ReplyBuf + sizeof(Header_t), pReply, Size);
 
     Header_t *pHeader = (Header_t *)VCP_ReplyBuf;
@@ -469,6 +489,11 @@ static void CMD_051D(uint32_t Port, const uint8_t *pBuffer)
             }
         }
 
+        // Raw writes may touch any channel
+        RADIO_ClearChannelProfiles();
+        RADIO_InvalidateChannelIndex();
+        SETTINGS_InvalidateChannelIndex();
+
         if (bReloadEeprom)
             SETTINGS_InitEEPROM();
     }
@@ -638,6 +663,106 @@ static void CMD_0602_WriteBK4819Reg(const uint8_t *pBuffer)
 }
 #endif
 
+#ifdef ENABLE_BOOT_PROFILE
+static void CMD_0610_ReadBootProfile(uint32_t Port)
+{
+    struct __attribute__((__packed__)) {
+        Header_t header;
+        uint32_t us[BOOT_PHASE_COUNT];
+    } reply;
+
+    reply.header.ID = 0x0610;
+    reply.header.Size = sizeof(reply.us);
+    for (unsigned int i = 0; i < BOOT_PHASE_COUNT; i++)
+        reply.us[i] = BOOT_PROFILE_Get(i);
+    SendReply(Port, &reply, sizeof(reply));
+}
+#endif
+
+#ifdef ENABLE_FRAME_GOVERNOR
+static void CMD_0611_ReadRenderStats(uint32_t Port)
+{
+    struct __attribute__((__packed__)) {
+        Header_t header;
+        GUI_RenderStats_t stats;
+    } reply;
+
+    reply.header.ID = 0x0611;
+    reply.header.Size = sizeof(reply.stats);
+    reply.stats = *GUI_GetRenderStats();
+    SendReply(Port, &reply, sizeof(reply));
+}
+#endif
+
+#ifdef ENABLE_SPECTRUM_STREAM
+static void CMD_0612_StreamSpectrum(const uint8_t *pBuffer)
+{
+    typedef struct __attribute__((__packed__)) {
+        Header_t header;
+        uint8_t credits;
+    } CMD_0612_t;
+
+    const CMD_0612_t *cmd = (const CMD_0612_t *)pBuffer;
+    STREAM_Grant(cmd->credits);
+}
+#endif
+
+#ifdef ENABLE_SPECTRUM
+// Bins of the spectrum occupancy survey, read a chunk at a time
+static void CMD_0613_ReadOccupancy(uint32_t Port, const uint8_t *pBuffer)
+{
+    typedef struct __attribute__((__packed__)) {
+        Header_t header;
+        uint8_t first;
+        uint8_t count;
+    } CMD_0613_t;
+
+    typedef struct __attribute__((__packed__)) {
+        uint32_t frequency;
+        OCCUPANCY_Bin_t bin;
+    } Entry_t;
+
+    const CMD_0613_t *cmd = (const CMD_0613_t *)pBuffer;
+
+    struct __attribute__((__packed__)) {
+        Header_t header;
+        struct __attribute__((__packed__)) {
+            uint16_t sweeps;
+            uint32_t elapsed;
+            uint8_t bins;
+            uint8_t first;
+            uint8_t count;
+            Entry_t entry[12];
+        } data;
+    } reply;
+
+    const uint8_t bins = OCCUPANCY_GetBins();
+    uint8_t count = cmd->count;
+    if (count > ARRAY_SIZE(reply.data.entry))
+        count = ARRAY_SIZE(reply.data.entry);
+    if (cmd->first >= bins)
+        count = 0;
+    else if (count > bins - cmd->first)
+        count = bins - cmd->first;
+
+    reply.data.sweeps = OCCUPANCY_GetSweeps();
+    reply.data.elapsed = OCCUPANCY_GetElapsed();
+    reply.data.bins = bins;
+    reply.data.first = cmd->first;
+    reply.data.count = count;
+    for (uint8_t i = 0; i < count; i++)
+    {
+        reply.data.entry[i].frequency = OCCUPANCY_GetFrequency(cmd->first + i);
+        reply.data.entry[i].bin = *OCCUPANCY_Get(cmd->first + i);
+    }
+
+    const uint16_t size = sizeof(reply.data) - sizeof(reply.data.entry) + count * sizeof(Entry_t);
+    reply.header.ID = 0x0613;
+    reply.header.Size = size;
+    SendReply(Port, &reply, sizeof(Header_t) + size);
+}
+#endif
+
 bool UART_IsCommandAvailable(uint32_t Port)
 {
     uint16_t Index;
@@ -826,6 +951,7 @@ void UART_HandleCommand(uint32_t Port)
 #endif
 
         case 0x05DD: // reset
+            PY25Q16_Flush();
             #if defined(ENABLE_OVERLAY)
                 overlay_FLASH_RebootToBootloader();
             #else
@@ -842,9 +968,59 @@ void UART_HandleCommand(uint32_t Port)
             CMD_0602_WriteBK4819Reg(pUART_Command->Buffer);
             break;
 #endif
+
+#ifdef ENABLE_BOOT_PROFILE
+        case 0x0610:
+            CMD_0610_ReadBootProfile(Port);
+            break;
+#endif
+
+#ifdef ENABLE_FRAME_GOVERNOR
+        case 0x0611:
+            CMD_0611_ReadRenderStats(Port);
+            break;
+#endif
+
+#ifdef ENABLE_SPECTRUM_STREAM
+        case 0x0612: // the stream only goes out over the VCP
+            if (Port == UART_PORT_VCP)
+                CMD_0612_StreamSpectrum(pUART_Command->Buffer);
+            break;
+#endif
+
+#ifdef ENABLE_SPECTRUM
+        case 0x0613:
+            CMD_0613_ReadOccupancy(Port, pUART_Command->Buffer);
+            break;
+#endif
     } // switch
 
     #ifdef ENABLE_FEAT_N7SIX_SCREENSHOT
         gUART_LockScreenshot = 20; // lock screenshot
     #endif
 }
+
+#ifdef ENABLE_SPECTRUM_STREAM
+void UART_HandleSpectrumCommand(uint32_t Port)
+{
+    const UART_Command_t *pUART_Command = &VCP_Command;
+
+    if (Port != UART_PORT_VCP)
+        return;
+
+    // Flash writes, register access and reboots would land in the middle of
+    // a sweep, those are dropped and the host retries once the app exits
+    switch (pUART_Command->Header.ID)
+    {
+        case 0x0612:
+            CMD_0612_StreamSpectrum(pUART_Command->Buffer);
+            break;
+
+#ifdef ENABLE_SPECTRUM
+        case 0x0613:
+            CMD_0613_ReadOccupancy(Port, pUART_Command->Buffer);
+            break;
+#endif
+    }
+}
+#endif
@@ -32,6 +32,10 @@ enum
 
 bool UART_IsCommandAvailable(uint32_t Port);
 void UART_HandleCommand(uint32_t Port);
+#ifdef ENABLE_SPECTRUM_STREAM
+    // Only the commands the spectrum serves while it owns the main loop
+    void UART_HandleSpectrumCommand(uint32_t Port);
+#endif
 
 #endif
 
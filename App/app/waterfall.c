@@ -0,0 +1,243 @@
+/* Waterfall history and renderer, see waterfall.h. */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "app/waterfall.h"
+#include "driver/st7565.h"
+#ifdef ENABLE_WATERFALL_SCROLLBACK
+    #include "driver/py25q16.h"
+    #include "driver/systick.h"
+    #include "misc.h"
+#endif
+
+#define ROWS        WATERFALL_VISIBLE
+#define FRAC_ONE    128     // interpolation weights are in 1/128
+
+#ifdef ENABLE_WATERFALL_SCROLLBACK
+    #define SECTOR_SIZE         0x1000
+    #define SECTOR_ROWS         (SECTOR_SIZE / WATERFALL_ROW_BYTES)
+    #define FLASH_ROWS          (WATERFALL_FLASH_SECTORS * SECTOR_ROWS)
+#endif
+
+typedef struct {
+    uint8_t Index;          // left step
+    uint8_t Frac;           // weight of the right step, 0..FRAC_ONE
+} XMap_t;
+
+static const uint8_t BAYER[4][4] = {
+    { 0, 8, 2, 10 }, { 12, 4, 14, 6 }, { 3, 11, 1, 9 }, { 15, 7, 13, 5 }
+};
+
+static uint8_t  gRows[WATERFALL_DEPTH][WATERFALL_ROW_BYTES];
+static uint8_t  gHead;          // slot of the next row
+static uint8_t  gCount;
+
+#ifdef ENABLE_WATERFALL_SCROLLBACK
+// The flash ring carries on where it stopped across Clear() so the wear
+// moves round all of its sectors
+static uint16_t gFlashHead;
+static uint16_t gFlashCount;
+
+// Max of the rows that left RAM since the last flash row was written
+static uint8_t  gSpillRow[WATERFALL_ROW_BYTES];
+static bool     gSpillPending;
+static uint32_t gSpillUs;
+#endif
+
+static XMap_t   gXMap[LCD_WIDTH];
+static uint16_t gXMapSteps;
+
+// Row r is drawn with fade (ROWS - r) / ROWS and a pixel is lit when the faded
+// level exceeds the Bayer entry b, i.e. when the interpolated level in 1/128
+// reaches (b + 1) * FRAC_ONE * ROWS / (ROWS - r)
+static uint16_t gThreshold[ROWS][4];
+static uint8_t  gThresholdTop = 0xFF;
+
+#ifdef ENABLE_WATERFALL_SCROLLBACK
+// Per step max of two packed rows into pDst
+static void MaxRow(uint8_t *pDst, const uint8_t *pRow)
+{
+    for (unsigned i = 0; i < WATERFALL_ROW_BYTES; i++) {
+        pDst[i] = MAX(pRow[i] & 0xF0, pDst[i] & 0xF0) | MAX(pRow[i] & 0x0F, pDst[i] & 0x0F);
+    }
+}
+
+static void Spill(const uint8_t *pRow)
+{
+    if (gSpillPending)
+        MaxRow(gSpillRow, pRow);
+    else
+        memcpy(gSpillRow, pRow, WATERFALL_ROW_BYTES);
+    gSpillPending = true;
+
+    const uint32_t Now = SYSTICK_GetTimeUs();
+    if (Now - gSpillUs < WATERFALL_SPILL_MS * 1000u)
+        return;
+    gSpillUs      = Now;
+    gSpillPending = false;
+
+    const unsigned Slot = gFlashHead;
+
+    // Appending at the start of a sector drops the rest of it, so the erase
+    // comes with the first row instead of a separate pass
+    PY25Q16_WriteBuffer(WATERFALL_FLASH_BASE + Slot * WATERFALL_ROW_BYTES, gSpillRow, WATERFALL_ROW_BYTES, true);
+
+    gFlashHead = (Slot + 1) % FLASH_ROWS;
+
+    const unsigned Max = FLASH_ROWS - SECTOR_ROWS + Slot % SECTOR_ROWS + 1;
+    if (++gFlashCount > Max)
+        gFlashCount = Max;
+
+    // Sector full, program it in the background while the next one fills
+    if (gFlashHead % SECTOR_ROWS == 0)
+        PY25Q16_FlushAsync(NULL);
+}
+#endif
+
+void WATERFALL_Clear(void)
+{
+    memset(gRows, 0, sizeof(gRows));
+    gHead  = 0;
+    gCount = 0;
+#ifdef ENABLE_WATERFALL_SCROLLBACK
+    gFlashCount   = 0;
+    gSpillPending = false;
+    gSpillUs      = SYSTICK_GetTimeUs() - WATERFALL_SPILL_MS * 1000u;    // first one goes out
+#endif
+}
+
+void WATERFALL_Push(const uint8_t *pLevels, uint16_t Steps)
+{
+    uint8_t *pRow = gRows[gHead];
+
+    if (Steps > WATERFALL_STEPS)
+        Steps = WATERFALL_STEPS;
+
+    if (gCount == WATERFALL_DEPTH) {
+#ifdef ENABLE_WATERFALL_SCROLLBACK
+        Spill(pRow);
+#endif
+    } else {
+        gCount++;
+    }
+
+    memset(pRow, 0, WATERFALL_ROW_BYTES);
+    for (unsigned i = 0; i < Steps; i++)
+        pRow[i / 2] |= (pLevels[i] & 0x0F) << ((i & 1) * 4);
+
+    gHead = (gHead + 1) % WATERFALL_DEPTH;
+}
+
+uint16_t WATERFALL_GetDepth(void)
+{
+#ifdef ENABLE_WATERFALL_SCROLLBACK
+    return gCount + gFlashCount;
+#else
+    return gCount;
+#endif
+}
+
+void WATERFALL_OpenReader(WATERFALL_Reader_t *pReader, uint16_t Age)
+{
+    pReader->Age = Age;
+}
+
+const uint8_t *WATERFALL_ReadRow(WATERFALL_Reader_t *pReader)
+{
+    const unsigned Age = pReader->Age;
+
+    if (Age < gCount) {
+        pReader->Age++;
+        return gRows[(gHead + WATERFALL_DEPTH - 1 - Age) % WATERFALL_DEPTH];
+    }
+
+#ifdef ENABLE_WATERFALL_SCROLLBACK
+    if (Age - gCount < gFlashCount) {
+        const unsigned Slot = (gFlashHead + FLASH_ROWS - 1 - (Age - gCount)) % FLASH_ROWS;
+
+        PY25Q16_ReadBuffer(WATERFALL_FLASH_BASE + Slot * WATERFALL_ROW_BYTES, pReader->Buffer, WATERFALL_ROW_BYTES);
+        pReader->Age++;
+        return pReader->Buffer;
+    }
+#endif
+
+    return NULL;
+}
+
+static void BuildXMap(uint16_t Steps)
+{
+    for (unsigned x = 0; x < LCD_WIDTH; x++) {
+        const unsigned Pos   = x * Steps;      // in 1/LCD_WIDTH steps
+        unsigned       Index = Pos / LCD_WIDTH;
+        unsigned       Frac  = (Pos % LCD_WIDTH) * FRAC_ONE / LCD_WIDTH;
+
+        // Past the last step, hold it rather than extrapolate
+        if (Index > Steps - 2u) {
+            Index = Steps - 2u;
+            Frac  = FRAC_ONE;
+        }
+
+        gXMap[x].Index = Index;
+        gXMap[x].Frac  = Frac;
+    }
+
+    gXMapSteps = Steps;
+}
+
+static void BuildThresholds(uint8_t Top)
+{
+    for (unsigned r = 0; r < ROWS; r++) {
+        const unsigned Fade = ROWS - r;
+
+        for (unsigned i = 0; i < 4; i++) {
+            const unsigned Bayer = BAYER[(Top + r) & 3][i];
+            gThreshold[r][i] = ((Bayer + 1) * FRAC_ONE * ROWS + Fade - 1) / Fade;
+        }
+    }
+
+    gThresholdTop = Top;
+}
+
+void WATERFALL_Draw(uint16_t Steps, uint8_t Top, uint16_t Scroll)
+{
+    WATERFALL_Reader_t Reader;
+    const uint8_t     *pRow;
+
+    if (Steps < 2 || Steps > LCD_WIDTH)
+        return;
+
+    if (Steps != gXMapSteps)
+        BuildXMap(Steps);
+    if (Top != gThresholdTop)
+        BuildThresholds(Top);
+
+    WATERFALL_OpenReader(&Reader, Scroll);
+
+    for (unsigned r = 0; r < ROWS && (pRow = WATERFALL_ReadRow(&Reader)) != NULL; r++) {
+        const unsigned  y = Top + r;
+        if (y >= FRAME_LINES * 8)
+            break;
+
+        // Unpacked once per row, the pixel loop reads two neighbours per x
+        uint8_t Levels[WATERFALL_STEPS];
+        for (unsigned i = 0; i < Steps; i += 2) {
+            Levels[i]     = pRow[i / 2] & 0x0F;
+            Levels[i + 1] = pRow[i / 2] >> 4;
+        }
+
+        const uint16_t *pThreshold = gThreshold[r];
+        uint8_t        *pLine      = gFrameBuffer[y / 8];
+        const uint8_t   Mask       = 1u << (y % 8);
+
+        for (unsigned x = 0; x < LCD_WIDTH; x++) {
+            const XMap_t   *pMap  = &gXMap[x];
+            const unsigned  l0    = Levels[pMap->Index];
+            const unsigned  l1    = Levels[pMap->Index + 1];
+            const unsigned  Level = l0 * (FRAC_ONE - pMap->Frac) + l1 * pMap->Frac;
+
+            if (Level >= pThreshold[x & 3])
+                pLine[x] |= Mask;
+        }
+    }
+}
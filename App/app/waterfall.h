@@ -0,0 +1,70 @@
+/* Waterfall history and renderer for the spectrum analyzer.
+ *
+ * The history is a ring of rows, one row per sweep, each step a 4-bit level
+ * packed two to a byte (even step in the low nibble). Rows are only ever
+ * read newest first through a WATERFALL_Reader_t, which hides where the row
+ * lives: the RAM ring holds the newest WATERFALL_DEPTH rows and, with
+ * ENABLE_WATERFALL_SCROLLBACK, rows pushed out of it go on to a ring of
+ * sectors in the SPI flash so a frozen screen can scroll further back. At
+ * most one flash row is written per WATERFALL_SPILL_MS, holding the max of
+ * the rows that left RAM since the last one, so the flash part of the
+ * history is coarser in time than the RAM part.
+ *
+ * The renderer is integer only: the x -> (step, fraction) map is rebuilt
+ * when the number of steps changes, and each row's fade is folded with the
+ * 4x4 Bayer matrix into four thresholds on the interpolated level, so a
+ * pixel costs two multiplies and a compare.
+ */
+
+#ifndef APP_WATERFALL_H
+#define APP_WATERFALL_H
+
+#include <stdint.h>
+
+#define WATERFALL_STEPS         128
+#define WATERFALL_ROW_BYTES     (WATERFALL_STEPS / 2)
+
+// Rows kept in RAM, 1.5 KB
+#define WATERFALL_DEPTH         24
+
+// Rows on screen
+#define WATERFALL_VISIBLE       11
+
+#ifdef ENABLE_WATERFALL_SCROLLBACK
+    // Each sector holds 64 rows and is erased once per 64 rows written, the
+    // oldest sector being dropped as the ring wraps
+    #define WATERFALL_FLASH_BASE        0x030000
+    #define WATERFALL_FLASH_SECTORS     16
+    // Wear budget: with the spectrum running nonstop a sector is erased at
+    // most every 64 * 2 s = 128 s, each of the 16 once per 34 minutes, so
+    // 100k erase cycles last about 6.5 years of continuous use
+    #define WATERFALL_SPILL_MS          2000
+#endif
+
+typedef struct {
+    uint16_t Age;                           // of the next row, 0 = newest
+    uint8_t  Buffer[WATERFALL_ROW_BYTES];   // flash rows are read into this
+} WATERFALL_Reader_t;
+
+static inline uint8_t WATERFALL_Level(const uint8_t *pRow, unsigned Step)
+{
+    return (pRow[Step / 2] >> ((Step & 1) * 4)) & 0x0F;
+}
+
+// Forgets every row, flash rows included
+void WATERFALL_Clear(void);
+// Appends a row of Steps levels (0..15), steps past Steps read as 0
+void WATERFALL_Push(const uint8_t *pLevels, uint16_t Steps);
+// Rows that can be read back, RAM and flash
+uint16_t WATERFALL_GetDepth(void);
+
+void WATERFALL_OpenReader(WATERFALL_Reader_t *pReader, uint16_t Age);
+// Next older row, NULL once past the oldest one
+const uint8_t *WATERFALL_ReadRow(WATERFALL_Reader_t *pReader);
+
+// Draws the WATERFALL_VISIBLE rows starting Scroll rows back into
+// gFrameBuffer, the newest at pixel row Top and fading out downwards.
+// Steps is 2..128.
+void WATERFALL_Draw(uint16_t Steps, uint8_t Top, uint16_t Scroll);
+
+#endif
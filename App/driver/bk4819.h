@@ -63,13 +63,22 @@ enum BK4819_CssScanResult_t
 
 typedef enum BK4819_CssScanResult_t BK4819_CssScanResult_t;
 
+typedef struct
+{
+    uint8_t  Register;
+    uint16_t Value;
+} BK4819_RegisterWrite_t;
+
 // radio is asleep, not listening
 extern bool gRxIdleMode;
 
 void     BK4819_Init(void);
 uint16_t BK4819_ReadRegister(BK4819_REGISTER_t Register);
 void     BK4819_WriteRegister(BK4819_REGISTER_t Register, uint16_t Data);
+void     BK4819_WriteRegisters(const BK4819_RegisterWrite_t *pList, unsigned int Count);
 void     BK4819_SetRegValue(RegisterSpec s, uint16_t v);
+void     BK4819_InvalidateShadow(void);
+uint32_t BK4819_GetSavedWrites(void);
 void     BK4819_WriteU8(uint8_t Data);
 void     BK4819_WriteU16(uint16_t Data);
 
@@ -41,8 +41,28 @@ static const uint16_t FSK_RogerTable[7] = {0xF1A2, 0x7446, 0x61A4, 0x6544, 0x4E8
 //static const uint8_t DTMF_TONE1_GAIN = 65;
 //static const uint8_t DTMF_TONE2_GAIN = 93;
 
+// Bus phase delay in NOPs. The 3-wire port latches SDA on the rising SCL edge
+// and is happy with a few hundred ns per phase; SYSTICK_DelayUs(1) polls
+// SysTick->VAL and costs several times the microsecond it asks for.
+#ifndef BK4819_BUS_DELAY_NOPS
+    #define BK4819_BUS_DELAY_NOPS   6
+#endif
+
+// Bit loops run from RAM (.data) when enabled, away from flash wait states
+#ifdef ENABLE_BK4819_RAM_BUS
+    #define BUS_RAMFUNC __attribute__((noinline, section(".data.bk4819_bus")))
+#else
+    #define BUS_RAMFUNC
+#endif
+
 static uint16_t gBK4819_GpioOutState;
 
+// Write-through shadow of the chip's registers. A write of the value a
+// register already holds is dropped instead of being clocked out.
+static uint16_t gShadow[128];
+static uint32_t gShadowValid[128 / 32];
+static uint32_t gSavedWrites;
+
 bool gRxIdleMode;
 
 static inline void CS_Assert()
@@ -85,6 +105,12 @@ static inline uint32_t SDA_ReadInput()
     return GPIO_IsInputPinSet(PIN_SDA) ? 1 : 0;
 }
 
+static inline void BUS_Delay()
+{
+    for (unsigned int i = 0; i < BK4819_BUS_DELAY_NOPS; i++)
+        __NOP();
+}
+
 static inline uint16_t scale_freq(const uint16_t freq)
 {
 //  return (((uint32_t)freq * 1032444u) + 50000u) / 100000u;   // with rounding
@@ -146,8 +172,10 @@ void BK4819_Init(void)
 
 #if 1
     const uint8_t dtmf_coeffs[] = {111, 107, 103, 98, 80, 71, 58, 44, 65, 55, 37, 23, 228, 203, 181, 159};
+    BK4819_RegisterWrite_t dtmf_writes[ARRAY_SIZE(dtmf_coeffs)];
     for (unsigned int i = 0; i < ARRAY_SIZE(dtmf_coeffs); i++)
-        BK4819_WriteRegister(BK4819_REG_09, (i << 12) | dtmf_coeffs[i]);
+        dtmf_writes[i] = (BK4819_RegisterWrite_t){BK4819_REG_09, (i << 12) | dtmf_coeffs[i]};
+    BK4819_WriteRegisters(dtmf_writes, ARRAY_SIZE(dtmf_writes));
 #else
     // original code
     BK4819_WriteRegister(BK4819_REG_09, 0x006F);  // 6F
@@ -195,28 +223,113 @@ void BK4819_Init(void)
     BK4819_WriteRegister(BK4819_REG_3F, 0);
 }
 
-static uint16_t BK4819_ReadU16(void)
+static BUS_RAMFUNC uint16_t BK4819_ReadU16(void)
 {
     unsigned int i;
     uint16_t     Value;
 
     SDA_SetDir(false);
-    SYSTICK_DelayUs(1);
+    BUS_Delay();
     Value = 0;
     for (i = 0; i < 16; i++)
     {
         Value <<= 1;
         Value |= SDA_ReadInput();
         SCL_Set();
-        SYSTICK_DelayUs(1);
+        BUS_Delay();
         SCL_Reset();
-        SYSTICK_DelayUs(1);
+        BUS_Delay();
     }
     SDA_SetDir(true);
 
     return Value;
 }
 
+// Registers that act on write, are multiplexed behind an index or are
+// changed by the chip itself. These always go out.
+static bool IsVolatileRegister(uint8_t Register)
+{
+    switch (Register)
+    {
+        case BK4819_REG_00:     // soft reset
+        case BK4819_REG_02:     // interrupt acknowledge
+        case BK4819_REG_08:     // CDCSS code word, two halves
+        case BK4819_REG_09:     // DTMF coefficients, indexed
+        case BK4819_REG_0B:
+        case BK4819_REG_0C:
+        case BK4819_REG_0D:
+        case BK4819_REG_0E:
+        case BK4819_REG_30:     // RX/TX enable, VCO calibration
+        case BK4819_REG_32:     // frequency scan start
+        case BK4819_REG_59:     // FSK control, FIFO clear
+        case BK4819_REG_5F:     // FSK FIFO
+        case BK4819_REG_63:
+        case BK4819_REG_64:
+        case BK4819_REG_65:
+        case BK4819_REG_67:
+        case BK4819_REG_68:
+        case BK4819_REG_69:
+        case BK4819_REG_6A:
+        case BK4819_REG_6F:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+void BK4819_InvalidateShadow(void)
+{
+    for (unsigned int i = 0; i < ARRAY_SIZE(gShadowValid); i++)
+        gShadowValid[i] = 0;
+}
+
+uint32_t BK4819_GetSavedWrites(void)
+{
+    return gSavedWrites;
+}
+
+static inline bool ShadowMatches(uint8_t Index, uint16_t Data)
+{
+    if ((gShadowValid[Index / 32] & (1u << (Index % 32))) && gShadow[Index] == Data)
+    {
+        gSavedWrites++;
+        return true;
+    }
+
+    return false;
+}
+
+static inline void ShadowStore(uint8_t Index, uint16_t Data)
+{
+    if (Index == BK4819_REG_00)
+    {
+        BK4819_InvalidateShadow();
+    }
+    else if (!IsVolatileRegister(Index))
+    {
+        gShadow[Index] = Data;
+        gShadowValid[Index / 32] |= 1u << (Index % 32);
+    }
+}
+
+// One framed register write. Expects CS released and SCL low, leaves them so.
+static void BK4819_Transfer(uint8_t Register, uint16_t Data)
+{
+    CS_Assert();
+    BK4819_WriteU8(Register);
+
+    BUS_Delay();
+
+    BK4819_WriteU16(Data);
+
+    BUS_Delay();
+
+    CS_Release();
+
+    BUS_Delay();
+}
+
 uint16_t BK4819_ReadRegister(BK4819_REGISTER_t Register)
 {
     uint16_t Value;
@@ -224,14 +337,14 @@ uint16_t BK4819_ReadRegister(BK4819_REGISTER_t Register)
     CS_Release();
     SCL_Reset();
 
-    SYSTICK_DelayUs(1);
+    BUS_Delay();
 
     CS_Assert();
     BK4819_WriteU8(Register | 0x80);
     Value = BK4819_ReadU16();
     CS_Release();
 
-    SYSTICK_DelayUs(1);
+    BUS_Delay();
 
     SCL_Set();
     SDA_Set();
@@ -241,29 +354,57 @@ uint16_t BK4819_ReadRegister(BK4819_REGISTER_t Register)
 
 void BK4819_WriteRegister(BK4819_REGISTER_t Register, uint16_t Data)
 {
+    const uint8_t Index = Register & 0x7F;
+
+    if (ShadowMatches(Index, Data))
+        return;
+
     CS_Release();
     SCL_Reset();
 
-    SYSTICK_DelayUs(1);
+    BUS_Delay();
 
-    CS_Assert();
-    BK4819_WriteU8(Register);
+    BK4819_Transfer(Register, Data);
 
-    SYSTICK_DelayUs(1);
+    SCL_Set();
+    SDA_Set();
 
-    BK4819_WriteU16(Data);
+    ShadowStore(Index, Data);
+}
 
-    SYSTICK_DelayUs(1);
+// Same as WriteRegister() for each entry, in order, but the bus is only
+// brought out of and back to idle once for the whole list.
+void BK4819_WriteRegisters(const BK4819_RegisterWrite_t *pList, unsigned int Count)
+{
+    bool Active = false;
 
-    CS_Release();
+    for (unsigned int i = 0; i < Count; i++)
+    {
+        const uint8_t Index = pList[i].Register & 0x7F;
 
-    SYSTICK_DelayUs(1);
+        if (ShadowMatches(Index, pList[i].Value))
+            continue;
 
-    SCL_Set();
-    SDA_Set();
+        if (!Active)
+        {
+            Active = true;
+            CS_Release();
+            SCL_Reset();
+            BUS_Delay();
+        }
+
+        BK4819_Transfer(pList[i].Register, pList[i].Value);
+        ShadowStore(Index, pList[i].Value);
+    }
+
+    if (Active)
+    {
+        SCL_Set();
+        SDA_Set();
+    }
 }
 
-void BK4819_WriteU8(uint8_t Data)
+BUS_RAMFUNC void BK4819_WriteU8(uint8_t Data)
 {
     unsigned int i;
 
@@ -275,18 +416,18 @@ void BK4819_WriteU8(uint8_t Data)
         else
             SDA_Set();
 
-        SYSTICK_DelayUs(1);
+        BUS_Delay();
         SCL_Set();
-        SYSTICK_DelayUs(1);
+        BUS_Delay();
 
         Data <<= 1;
 
         SCL_Reset();
-        SYSTICK_DelayUs(1);
+        BUS_Delay();
     }
 }
 
-void BK4819_WriteU16(uint16_t Data)
+BUS_RAMFUNC void BK4819_WriteU16(uint16_t Data)
 {
     unsigned int i;
 
@@ -298,14 +439,14 @@ void BK4819_WriteU16(uint16_t Data)
         else
             SDA_Set();
 
-        SYSTICK_DelayUs(1);
+        BUS_Delay();
         SCL_Set();
 
         Data <<= 1;
 
-        SYSTICK_DelayUs(1);
+        BUS_Delay();
         SCL_Reset();
-        SYSTICK_DelayUs(1);
+        BUS_Delay();
     }
 }
 
@@ -758,8 +899,12 @@ void BK4819_SetupPowerAmplifier(const uint8_t bias, const uint32_t frequency)
 
 void BK4819_SetFrequency(uint32_t Frequency)
 {
-    BK4819_WriteRegister(BK4819_REG_38, (Frequency >>  0) & 0xFFFF);
-    BK4819_WriteRegister(BK4819_REG_39, (Frequency >> 16) & 0xFFFF);
+    const BK4819_RegisterWrite_t Writes[] = {
+        {BK4819_REG_38, (Frequency >>  0) & 0xFFFF},
+        {BK4819_REG_39, (Frequency >> 16) & 0xFFFF},
+    };
+
+    BK4819_WriteRegisters(Writes, ARRAY_SIZE(Writes));
 }
 
 void BK4819_SetupSquelch(
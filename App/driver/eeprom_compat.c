@@ -23,7 +23,7 @@
  */
 
 #include "driver/eeprom.h"
-#include "driver/py25q16.h"
+#include "driver/flashlog.h"
 #include <string.h>
 
 #define HOLE_ADDR 0x1000000
@@ -79,7 +79,7 @@ void EEPROM_ReadBuffer(uint16_t Address, void *pBuffer, uint8_t Size)
         }
         else
         {
-            PY25Q16_ReadBuffer(PY_Addr, pBuffer, PY_Size);
+            FLASHLOG_ReadBuffer(PY_Addr, pBuffer, PY_Size);
         }
         Address += PY_Size;
         pBuffer += PY_Size;
@@ -100,7 +100,7 @@ void EEPROM_WriteBuffer(uint16_t Address, const void *pBuffer)
         AddrTranslate(Address, Size, &PY_Addr, &PY_Size, &AppendFlag);
         if (PY_Addr < HOLE_ADDR)
         {
-            PY25Q16_WriteBuffer(PY_Addr, pBuffer, PY_Size, AppendFlag);
+            FLASHLOG_WriteBuffer(PY_Addr, pBuffer, PY_Size, AppendFlag);
         }
         Address += PY_Size;
         pBuffer += PY_Size;
@@ -0,0 +1,340 @@
+/* Log-structured settings store, see flashlog.h.
+ *
+ * Each pool sector is a run of 16-byte slots. Slot 0 is the header and is
+ * programmed last, once the sector holds a copy of every logged record, so
+ * a sector without a valid header is ignored. Records follow in write order;
+ * the newest version of a record is the last one in the active sector, the
+ * sector with the highest header sequence number. When it fills up, the
+ * latest version of every record is copied into the next sector of the pool,
+ * which is the only erase the log ever does.
+ */
+
+#include <string.h>
+
+#include "driver/crc.h"
+#include "driver/flashlog.h"
+#include "driver/py25q16.h"
+
+#define SECTOR_SIZE     0x1000
+#define SLOT_SIZE       16
+#define SLOTS           (SECTOR_SIZE / SLOT_SIZE)
+#define PAGE_SLOTS      (0x100 / SLOT_SIZE)
+#define RECORD_SIZE     8
+
+#define ID_HEADER       0xFE
+
+#define READ_BATCH      16      // chip reads handed to PY25Q16_ReadList() at once
+
+typedef struct {
+    uint16_t Crc;       // over the rest of the slot
+    uint8_t  Id;        // record number, or ID_HEADER
+    uint8_t  Reserved;
+    uint32_t Seq;
+    uint8_t  Data[RECORD_SIZE];
+} Slot_t;
+
+typedef struct {
+    uint32_t Address;
+    uint16_t Size;
+} Region_t;
+
+// Sorted by address, each one at the start of its legacy sector
+static const Region_t REGIONS[] = {
+    { 0x001000, 0xE0 },     // 0C80..0D60 VFOs
+    { 0x002000, 0xD0 },     // 0D60..0E30 channel attributes
+    { 0x003000, 0x28 },     // 0E40..0E68 FM channels
+    { 0x004000, 0x10 },     // 0E70..0E80
+    { 0x005000, 0x08 },     // 0E80..0E88
+    { 0x006000, 0x08 },     // 0E88..0E90
+    { 0x007000, 0x50 },     // 0E90..0EE0
+    { 0x008000, 0x38 },     // 0EE0..0F18
+    { 0x009000, 0x08 },     // 0F18..0F20
+    { 0x00a000, 0x10 },     // 0F30..0F40
+    { 0x00b000, 0x08 },     // 0F40..0F48
+    { 0x00c000, 0x10 },     // 1FF0..2000
+};
+
+#define RECORD_COUNT    ((0xE0 + 0xD0 + 0x28 + 0x10 + 0x08 + 0x08 + 0x50 + 0x38 + 0x08 + 0x10 + 0x08 + 0x10) / RECORD_SIZE)
+
+static const uint8_t MAGIC[RECORD_SIZE] = { 'S', 'E', 'T', 'L', 'O', 'G', 0, 1 };
+
+static bool     gReady;
+static uint8_t  gActive;
+static uint16_t gFree;                  // next slot to program in gActive
+static uint32_t gSeq;
+static uint8_t  gIndex[RECORD_COUNT];   // slot in gActive, 0 = never logged
+
+static uint32_t SlotAddress(unsigned Sector, unsigned Slot)
+{
+    return FLASHLOG_BASE + Sector * SECTOR_SIZE + Slot * SLOT_SIZE;
+}
+
+static void Fill(Slot_t *pSlot, uint8_t Id, const uint8_t *pData)
+{
+    pSlot->Id       = Id;
+    pSlot->Reserved = 0;
+    pSlot->Seq      = gSeq++;
+    memcpy(pSlot->Data, pData, RECORD_SIZE);
+    pSlot->Crc      = CRC_Calculate((const uint8_t *)pSlot + 2, SLOT_SIZE - 2);
+}
+
+static bool IsValid(const Slot_t *pSlot)
+{
+    return pSlot->Crc == CRC_Calculate((const uint8_t *)pSlot + 2, SLOT_SIZE - 2);
+}
+
+static bool IsErased(const Slot_t *pSlot)
+{
+    const uint8_t *p = (const uint8_t *)pSlot;
+
+    for (unsigned i = 0; i < SLOT_SIZE; i++)
+        if (p[i] != 0xFF)
+            return false;
+
+    return true;
+}
+
+static void Scan(void)
+{
+    Slot_t   Page[PAGE_SLOTS];
+    bool     Found = false;
+    uint32_t Newest = 0;
+
+    memset(gIndex, 0, sizeof(gIndex));
+    gActive = 0;
+    gFree   = SLOTS;    // no committed sector yet, the first write starts one
+    gSeq    = 0;
+    gReady  = true;
+
+    for (unsigned s = 0; s < FLASHLOG_SECTORS; s++) {
+        PY25Q16_ReadBuffer(SlotAddress(s, 0), Page, SLOT_SIZE);
+        if (Page[0].Id != ID_HEADER || !IsValid(&Page[0]) || memcmp(Page[0].Data, MAGIC, RECORD_SIZE) != 0)
+            continue;
+        if (Found && Page[0].Seq <= Newest)
+            continue;
+
+        Found   = true;
+        Newest  = Page[0].Seq;
+        gActive = s;
+    }
+
+    if (!Found)
+        return;
+
+    gSeq = Newest + 1;
+
+    for (unsigned Slot = 0; Slot < SLOTS; Slot += PAGE_SLOTS) {
+        PY25Q16_ReadBuffer(SlotAddress(gActive, Slot), Page, sizeof(Page));
+
+        for (unsigned i = Slot ? 0 : 1; i < PAGE_SLOTS; i++) {
+            const Slot_t *p = &Page[i];
+
+            if (IsErased(p)) {
+                gFree = Slot + i;
+                return;
+            }
+
+            // Torn writes fail the CRC, their slot is simply skipped
+            if (!IsValid(p))
+                continue;
+            if (p->Id < RECORD_COUNT)
+                gIndex[p->Id] = Slot + i;
+            if (p->Seq >= gSeq)
+                gSeq = p->Seq + 1;
+        }
+    }
+}
+
+// Copies the latest version of every logged record into the next sector of
+// the pool and commits it, the old sector is left alone until its turn
+static void Compact(void)
+{
+    const unsigned Old = gActive;
+    const unsigned New = (gActive + 1) % FLASHLOG_SECTORS;
+    Slot_t         Page[PAGE_SLOTS];
+    unsigned       Slot  = 1;
+    unsigned       First = 1;   // first slot of Page still to be programmed
+
+    PY25Q16_SectorErase(SlotAddress(New, 0));
+
+    for (unsigned Id = 0; Id < RECORD_COUNT; Id++) {
+        if (!gIndex[Id])
+            continue;
+
+        uint8_t Data[RECORD_SIZE];
+        PY25Q16_ReadBuffer(SlotAddress(Old, gIndex[Id]) + 8, Data, RECORD_SIZE);
+        Fill(&Page[Slot % PAGE_SLOTS], Id, Data);
+        gIndex[Id] = Slot++;
+
+        if (Slot % PAGE_SLOTS == 0) {
+            PY25Q16_WriteBuffer(SlotAddress(New, First), &Page[First % PAGE_SLOTS], (Slot - First) * SLOT_SIZE, false);
+            First = Slot;
+        }
+    }
+
+    if (Slot != First)
+        PY25Q16_WriteBuffer(SlotAddress(New, First), &Page[First % PAGE_SLOTS], (Slot - First) * SLOT_SIZE, false);
+
+    // The records have to be on the chip before the header that vouches for them
+    PY25Q16_Flush();
+    Fill(&Page[0], ID_HEADER, MAGIC);
+    PY25Q16_WriteBuffer(SlotAddress(New, 0), &Page[0], SLOT_SIZE, false);
+    PY25Q16_Flush();
+
+    gActive = New;
+    gFree   = Slot;
+}
+
+static void Append(unsigned Id, const uint8_t *pData)
+{
+    Slot_t Slot;
+
+    if (gFree >= SLOTS)
+        Compact();
+
+    Fill(&Slot, Id, pData);
+    PY25Q16_WriteBuffer(SlotAddress(gActive, gFree), &Slot, SLOT_SIZE, false);
+    gIndex[Id] = gFree++;
+}
+
+// Length of the leading piece of [Address, Address + Size) that is either
+// all inside one region or all outside; *pRecord is its first record, or -1
+static uint32_t Locate(uint32_t Address, uint32_t Size, int *pRecord)
+{
+    unsigned Base = 0;
+
+    *pRecord = -1;
+
+    for (unsigned i = 0; i < sizeof(REGIONS) / sizeof(REGIONS[0]); i++) {
+        const Region_t *r = &REGIONS[i];
+
+        if (Address < r->Address)
+            return Size < r->Address - Address ? Size : r->Address - Address;
+
+        if (Address < r->Address + r->Size) {
+            const uint32_t Rem = r->Address + r->Size - Address;
+            *pRecord = Base + (Address - r->Address) / RECORD_SIZE;
+            return Size < Rem ? Size : Rem;
+        }
+
+        Base += r->Size / RECORD_SIZE;
+    }
+
+    return Size;
+}
+
+void FLASHLOG_Init(void)
+{
+    gReady = false;
+}
+
+void FLASHLOG_ReadBuffer(uint32_t Address, void *pBuffer, uint32_t Size)
+{
+    const PY25Q16_ReadSeg_t Seg = { Address, pBuffer, Size };
+
+    FLASHLOG_ReadList(&Seg, 1);
+}
+
+void FLASHLOG_ReadList(const PY25Q16_ReadSeg_t *pList, uint32_t Count)
+{
+    PY25Q16_ReadSeg_t Batch[READ_BATCH];
+    unsigned          n = 0;
+
+    if (!gReady)
+        Scan();
+
+    for (uint32_t i = 0; i < Count; i++) {
+        uint32_t Address = pList[i].Address;
+        uint8_t *pData   = pList[i].pBuffer;
+        uint32_t Size    = pList[i].Size;
+
+        while (Size) {
+            int      Record;
+            uint32_t Length = Locate(Address, Size, &Record);
+            uint32_t Source = Address;
+
+            if (Record >= 0) {
+                const uint32_t Offset = Address % RECORD_SIZE;
+                uint32_t       Chunk  = RECORD_SIZE - Offset;
+
+                if (gIndex[Record]) {
+                    Source = SlotAddress(gActive, gIndex[Record]) + 8 + Offset;
+                } else {
+                    // Never logged, read it and its unlogged neighbours in place
+                    while (Chunk < Length && !gIndex[Record + (Offset + Chunk) / RECORD_SIZE])
+                        Chunk += RECORD_SIZE;
+                }
+
+                if (Chunk < Length)
+                    Length = Chunk;
+            }
+
+            if (n == READ_BATCH) {
+                PY25Q16_ReadList(Batch, n);
+                n = 0;
+            }
+            Batch[n].Address = Source;
+            Batch[n].pBuffer = pData;
+            Batch[n].Size    = Length;
+            n++;
+
+            Address += Length;
+            pData   += Length;
+            Size    -= Length;
+        }
+    }
+
+    if (n)
+        PY25Q16_ReadList(Batch, n);
+}
+
+void FLASHLOG_WriteBuffer(uint32_t Address, const void *pBuffer, uint32_t Size, bool bAppend)
+{
+    const uint8_t *pData = pBuffer;
+
+    if (!gReady)
+        Scan();
+
+    while (Size) {
+        int      Record;
+        uint32_t Length = Locate(Address, Size, &Record);
+
+        if (Record >= 0) {
+            const uint32_t Offset = Address % RECORD_SIZE;
+            uint8_t        Data[RECORD_SIZE];
+
+            if (Length > RECORD_SIZE - Offset)
+                Length = RECORD_SIZE - Offset;
+
+            FLASHLOG_ReadBuffer(Address - Offset, Data, RECORD_SIZE);
+            if (memcmp(Data + Offset, pData, Length) != 0) {
+                memcpy(Data + Offset, pData, Length);
+                Append(Record, Data);
+            }
+        } else {
+            PY25Q16_WriteBuffer(Address, pData, Length, bAppend);
+        }
+
+        Address += Length;
+        pData   += Length;
+        Size    -= Length;
+    }
+}
+
+void FLASHLOG_SectorErase(uint32_t Address)
+{
+    static const uint8_t Erased[RECORD_SIZE] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+    int                  Record;
+
+    Address -= Address % SECTOR_SIZE;
+
+    const uint32_t Length = Locate(Address, SECTOR_SIZE, &Record);
+    if (Record < 0) {
+        PY25Q16_SectorErase(Address);
+        return;
+    }
+
+    // Only the region is in use, log it as erased instead of erasing
+    for (uint32_t i = 0; i < Length; i += RECORD_SIZE)
+        FLASHLOG_WriteBuffer(Address + i, Erased, RECORD_SIZE, false);
+}
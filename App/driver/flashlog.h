@@ -0,0 +1,42 @@
+/* Log-structured store for the settings area of the SPI flash.
+ *
+ * The small settings blocks of the legacy EEPROM layout (VFOs, channel
+ * attributes, FM channels, 0x0E70..0x0F48 and 0x1FF0..0x1FFF) are kept as
+ * 8-byte records appended to a pool of sectors instead of being rewritten in
+ * place. The FLASHLOG_* calls take the usual PY25Q16 addresses: ranges in the
+ * settings area go through the log, anything else goes straight to the chip.
+ * A record that was never logged reads from its legacy location.
+ */
+
+#ifndef DRIVER_FLASHLOG_H
+#define DRIVER_FLASHLOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "driver/py25q16.h"
+
+#ifdef ENABLE_SETTINGS_LOG
+
+// Pool of sectors the records rotate through, erased one at a time
+#define FLASHLOG_BASE           0x011000
+#define FLASHLOG_SECTORS        4
+
+// Drops the RAM index, the pool is rescanned on the next access
+void FLASHLOG_Init(void);
+void FLASHLOG_ReadBuffer(uint32_t Address, void *pBuffer, uint32_t Size);
+void FLASHLOG_ReadList(const PY25Q16_ReadSeg_t *pList, uint32_t Count);
+void FLASHLOG_WriteBuffer(uint32_t Address, const void *pBuffer, uint32_t Size, bool Append);
+void FLASHLOG_SectorErase(uint32_t Address);
+
+#else
+
+#define FLASHLOG_Init()         do {} while (0)
+#define FLASHLOG_ReadBuffer     PY25Q16_ReadBuffer
+#define FLASHLOG_ReadList       PY25Q16_ReadList
+#define FLASHLOG_WriteBuffer    PY25Q16_WriteBuffer
+#define FLASHLOG_SectorErase    PY25Q16_SectorErase
+
+#endif
+
+#endif
@@ -39,6 +39,33 @@
 
 static uint32_t SectorCacheAddr = 0x1000000;
 static uint8_t SectorCache[SECTOR_SIZE];
+#ifdef ENABLE_FLASH_WRITE_BACK
+// SectorCache holds writes not yet on the chip: [DirtyStart, DirtyEnd) still
+// has to be programmed, or the whole sector erased and rewritten
+static bool CacheDirty;
+static bool CacheNeedsErase;
+static uint16_t DirtyStart;
+static uint16_t DirtyEnd;
+
+// Flush of the sector cache in progress, one chip operation per step
+typedef enum
+{
+    JOB_IDLE,
+    JOB_ERASE,
+    JOB_PROGRAM,
+    JOB_VERIFY,
+} JobState_t;
+
+static struct
+{
+    JobState_t State;
+    uint16_t Start;
+    uint16_t End;
+    uint16_t Offset;
+    bool Ok;
+    PY25Q16_Callback_t pDone;
+} Job;
+#endif
 static uint8_t BlackHole[1];
 static volatile bool TC_Flag;
 
@@ -214,9 +241,136 @@ static void WriteAddr(uint32_t Addr);
 static uint8_t ReadStatusReg(uint32_t Which);
 static void WaitWIP();
 static void WriteEnable();
+static void StartSectorErase(uint32_t Addr);
 static void SectorErase(uint32_t Addr);
+static void StartPageProgram(uint32_t Addr, const uint8_t *Buf, uint32_t Size);
+#ifndef ENABLE_FLASH_WRITE_BACK
 static void SectorProgram(uint32_t Addr, const uint8_t *Buf, uint32_t Size);
 static void PageProgram(uint32_t Addr, const uint8_t *Buf, uint32_t Size);
+#endif
+static void ReadList(const PY25Q16_ReadSeg_t *pList, uint32_t Count);
+
+#ifdef ENABLE_FLASH_WRITE_BACK
+static void MarkDirty(uint32_t Start, uint32_t End, bool Erase)
+{
+    if (!CacheDirty)
+    {
+        CacheDirty = true;
+        CacheNeedsErase = false;
+        DirtyStart = Start;
+        DirtyEnd = End;
+    }
+
+    if (Start < DirtyStart)
+    {
+        DirtyStart = Start;
+    }
+    if (End > DirtyEnd)
+    {
+        DirtyEnd = End;
+    }
+    CacheNeedsErase |= Erase;
+}
+
+// Reads see pending writes: copy the dirty sector over what came off the chip
+static void OverlayCache(uint32_t Address, void *pBuffer, uint32_t Size)
+{
+    if (!CacheDirty || Address >= SectorCacheAddr + SECTOR_SIZE || Address + Size <= SectorCacheAddr)
+    {
+        return;
+    }
+
+    const uint32_t Start = Address > SectorCacheAddr ? Address : SectorCacheAddr;
+    const uint32_t End = Address + Size < SectorCacheAddr + SECTOR_SIZE ? Address + Size : SectorCacheAddr + SECTOR_SIZE;
+
+    memcpy((uint8_t *)pBuffer + (Start - Address), SectorCache + (Start - SectorCacheAddr), End - Start);
+}
+
+static bool IsBusy()
+{
+    return 1 & ReadStatusReg(0); // WIP
+}
+
+static void JobFinish()
+{
+    Job.State = JOB_IDLE;
+
+    if (!Job.Ok)
+    {
+        // Try again with a full erase on the next flush
+        MarkDirty(0, SECTOR_SIZE, true);
+    }
+
+    if (Job.pDone)
+    {
+        Job.pDone(Job.Ok);
+    }
+}
+
+// Starts the next chip operation of the flush, the chip must not be busy
+static void JobStep()
+{
+    switch (Job.State)
+    {
+    case JOB_IDLE:
+        return;
+
+    case JOB_ERASE:
+        Job.State = JOB_PROGRAM;
+        // fallthrough
+
+    case JOB_PROGRAM:
+        if (Job.Offset < Job.End)
+        {
+            uint32_t Size = PAGE_SIZE - (Job.Offset % PAGE_SIZE);
+            if (Size > (uint32_t)(Job.End - Job.Offset))
+            {
+                Size = Job.End - Job.Offset;
+            }
+
+            StartPageProgram(SectorCacheAddr + Job.Offset, SectorCache + Job.Offset, Size);
+            Job.Offset += Size;
+            return;
+        }
+
+        Job.State = JOB_VERIFY;
+        Job.Offset = Job.Start;
+        // fallthrough
+
+    case JOB_VERIFY:
+        if (Job.Offset < Job.End)
+        {
+            uint8_t Buf[64];
+            uint32_t Size = Job.End - Job.Offset;
+            if (Size > sizeof(Buf))
+            {
+                Size = sizeof(Buf);
+            }
+
+            const PY25Q16_ReadSeg_t Seg = {SectorCacheAddr + Job.Offset, Buf, Size};
+            ReadList(&Seg, 1);
+            if (0 != memcmp(Buf, SectorCache + Job.Offset, Size))
+            {
+                Job.Ok = false;
+            }
+            Job.Offset += Size;
+            return;
+        }
+
+        JobFinish();
+        return;
+    }
+}
+
+static void WaitJob()
+{
+    while (Job.State != JOB_IDLE)
+    {
+        WaitWIP();
+        JobStep();
+    }
+}
+#endif
 
 void PY25Q16_Init()
 {
@@ -226,33 +380,66 @@ void PY25Q16_Init()
 
 void PY25Q16_ReadBuffer(uint32_t Address, void *pBuffer, uint32_t Size)
 {
-#ifdef DEBUG
-    printf("spi flash read: %06x %ld\n", Address, Size);
+    const PY25Q16_ReadSeg_t Seg = {Address, pBuffer, Size};
+    PY25Q16_ReadList(&Seg, 1);
+}
+
+void PY25Q16_ReadList(const PY25Q16_ReadSeg_t *pList, uint32_t Count)
+{
+#ifdef ENABLE_FLASH_WRITE_BACK
+    WaitJob();
 #endif
-    CS_Assert();
 
-    SPI_WriteByte(0x03); // Fast read
-    WriteAddr(Address);
+    ReadList(pList, Count);
 
-    if (Size >= 16)
+#ifdef ENABLE_FLASH_WRITE_BACK
+    for (uint32_t i = 0; i < Count; i++)
     {
-        SPI_ReadBuf((uint8_t *)pBuffer, Size);
+        OverlayCache(pList[i].Address, pList[i].pBuffer, pList[i].Size);
     }
-    else
+#endif
+}
+
+// One fast read per run of contiguous segments, every segment clocked in by
+// DMA straight into its destination
+static void ReadList(const PY25Q16_ReadSeg_t *pList, uint32_t Count)
+{
+    uint32_t i = 0;
+
+    while (i < Count)
     {
-        for (uint32_t i = 0; i < Size; i++)
+        uint32_t Address = pList[i].Address;
+
+#ifdef DEBUG
+        printf("spi flash read: %06x\n", Address);
+#endif
+        CS_Assert();
+
+        SPI_WriteByte(0x0b); // Fast read
+        WriteAddr(Address);
+        SPI_WriteByte(0xff); // Dummy byte
+
+        do
         {
-            ((uint8_t *)(pBuffer))[i] = SPI_WriteByte(0xff);
-        }
-    }
+            if (pList[i].Size)
+            {
+                SPI_ReadBuf((uint8_t *)pList[i].pBuffer, pList[i].Size);
+            }
+            Address += pList[i].Size;
+            i++;
+        } while (i < Count && pList[i].Address == Address);
 
-    CS_Release();
+        CS_Release();
+    }
 }
 
 void PY25Q16_WriteBuffer(uint32_t Address, const void *pBuffer, uint32_t Size, bool Append)
 {
 #ifdef DEBUG
     printf("spi flash write: %06x %ld %d\n", Address, Size, Append);
+#endif
+#ifdef ENABLE_FLASH_WRITE_BACK
+    WaitJob();
 #endif
     uint32_t SecIndex = Address / SECTOR_SIZE;
     uint32_t SecAddr = SecIndex * SECTOR_SIZE;
@@ -268,6 +455,7 @@ void PY25Q16_WriteBuffer(uint32_t Address, const void *pBuffer, uint32_t Size, b
 
         if (SecAddr != SectorCacheAddr)
         {
+            PY25Q16_Flush();
             PY25Q16_ReadBuffer(SecAddr, SectorCache, SECTOR_SIZE);
             SectorCacheAddr = SecAddr;
         }
@@ -286,6 +474,13 @@ void PY25Q16_WriteBuffer(uint32_t Address, const void *pBuffer, uint32_t Size, b
 
             memcpy(SectorCache + SecOffset, pBuffer, SecSize);
 
+#ifdef ENABLE_FLASH_WRITE_BACK
+            if (Erase && Append)
+            {
+                memset(SectorCache + SecOffset + SecSize, 0xff, SECTOR_SIZE - SecOffset - SecSize);
+            }
+            MarkDirty(SecOffset, SecOffset + SecSize, Erase);
+#else
             if (Erase)
             {
                 SectorErase(SecAddr);
@@ -303,6 +498,7 @@ void PY25Q16_WriteBuffer(uint32_t Address, const void *pBuffer, uint32_t Size, b
             {
                 SectorProgram(Address, pBuffer, SecSize);
             }
+#endif
         }
 
         Address += SecSize;
@@ -317,12 +513,104 @@ void PY25Q16_WriteBuffer(uint32_t Address, const void *pBuffer, uint32_t Size, b
 
 void PY25Q16_SectorErase(uint32_t Address)
 {
+#ifdef ENABLE_FLASH_WRITE_BACK
+    WaitJob();
+#endif
     Address -= (Address % SECTOR_SIZE);
     SectorErase(Address);
     if (SectorCacheAddr == Address)
     {
         memset(SectorCache, 0xff, SECTOR_SIZE);
+#ifdef ENABLE_FLASH_WRITE_BACK
+        CacheDirty = false;
+#endif
+    }
+}
+
+void PY25Q16_FlushAsync(PY25Q16_Callback_t pDone)
+{
+#ifdef ENABLE_FLASH_WRITE_BACK
+    WaitJob();
+
+    if (!CacheDirty)
+    {
+        if (pDone)
+        {
+            pDone(true);
+        }
+        return;
     }
+
+    CacheDirty = false;
+
+    Job.Ok = true;
+    Job.pDone = pDone;
+
+    if (CacheNeedsErase)
+    {
+        // Everything after the last programmed byte is already 0xff
+        uint32_t Size = SECTOR_SIZE;
+        while (Size && 0xff == SectorCache[Size - 1])
+        {
+            Size--;
+        }
+
+        Job.Start = 0;
+        Job.End = Size;
+        Job.Offset = 0;
+        Job.State = JOB_ERASE;
+        StartSectorErase(SectorCacheAddr);
+    }
+    else
+    {
+        Job.Start = DirtyStart;
+        Job.End = DirtyEnd;
+        Job.Offset = DirtyStart;
+        Job.State = JOB_PROGRAM;
+        JobStep();
+    }
+#else
+    if (pDone)
+    {
+        pDone(true);
+    }
+#endif
+}
+
+void PY25Q16_Flush()
+{
+    PY25Q16_FlushAsync(NULL);
+#ifdef ENABLE_FLASH_WRITE_BACK
+    WaitJob();
+#endif
+}
+
+void PY25Q16_Poll()
+{
+#ifdef ENABLE_FLASH_WRITE_BACK
+    if (Job.State != JOB_IDLE && !IsBusy())
+    {
+        JobStep();
+    }
+#endif
+}
+
+bool PY25Q16_IsBusy()
+{
+#ifdef ENABLE_FLASH_WRITE_BACK
+    return Job.State != JOB_IDLE;
+#else
+    return false;
+#endif
+}
+
+bool PY25Q16_IsDirty()
+{
+#ifdef ENABLE_FLASH_WRITE_BACK
+    return CacheDirty;
+#else
+    return false;
+#endif
 }
 
 static inline void WriteAddr(uint32_t Addr)
@@ -379,7 +667,7 @@ static void WriteEnable()
     CS_Release();
 }
 
-static void SectorErase(uint32_t Addr)
+static void StartSectorErase(uint32_t Addr)
 {
 #ifdef DEBUG
     printf("spi flash sector erase: %06x\n", Addr);
@@ -391,32 +679,15 @@ static void SectorErase(uint32_t Addr)
     SPI_WriteByte(0x20);
     WriteAddr(Addr);
     CS_Release();
-
-    WaitWIP();
 }
 
-static void SectorProgram(uint32_t Addr, const uint8_t *Buf, uint32_t Size)
+static void SectorErase(uint32_t Addr)
 {
-    uint32_t Size1 = PAGE_SIZE - (Addr % PAGE_SIZE);
-
-    while (Size)
-    {
-        if (Size < Size1)
-        {
-            Size1 = Size;
-        }
-
-        PageProgram(Addr, Buf, Size1);
-
-        Addr += Size1;
-        Buf += Size1;
-        Size -= Size1;
-
-        Size1 = PAGE_SIZE;
-    }
+    StartSectorErase(Addr);
+    WaitWIP();
 }
 
-static void PageProgram(uint32_t Addr, const uint8_t *Buf, uint32_t Size)
+static void StartPageProgram(uint32_t Addr, const uint8_t *Buf, uint32_t Size)
 {
 #ifdef DEBUG
     printf("spi flash page program: %06x %ld\n", Addr, Size);
@@ -443,10 +714,37 @@ static void PageProgram(uint32_t Addr, const uint8_t *Buf, uint32_t Size)
     }
 
     CS_Release();
+}
 
+#ifndef ENABLE_FLASH_WRITE_BACK
+static void PageProgram(uint32_t Addr, const uint8_t *Buf, uint32_t Size)
+{
+    StartPageProgram(Addr, Buf, Size);
     WaitWIP();
 }
 
+static void SectorProgram(uint32_t Addr, const uint8_t *Buf, uint32_t Size)
+{
+    uint32_t Size1 = PAGE_SIZE - (Addr % PAGE_SIZE);
+
+    while (Size)
+    {
+        if (Size < Size1)
+        {
+            Size1 = Size;
+        }
+
+        PageProgram(Addr, Buf, Size1);
+
+        Addr += Size1;
+        Buf += Size1;
+        Size -= Size1;
+
+        Size1 = PAGE_SIZE;
+    }
+}
+#endif
+
 void DMA1_Channel4_5_6_7_IRQHandler()
 {
     if (LL_DMA_IsActiveFlag_TC4(DMA1) && LL_DMA_IsEnabledIT_TC(DMA1, CHANNEL_RD))
@@ -20,9 +20,33 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+typedef struct
+{
+    uint32_t Address;
+    void *pBuffer;
+    uint32_t Size;
+} PY25Q16_ReadSeg_t;
+
 void PY25Q16_Init();
 void PY25Q16_ReadBuffer(uint32_t Address, void *pBuffer, uint32_t Size);
+// Scatter-gather read: segments that follow each other in flash share one
+// read command, whatever their destinations
+void PY25Q16_ReadList(const PY25Q16_ReadSeg_t *pList, uint32_t Count);
 void PY25Q16_WriteBuffer(uint32_t Address, const void *pBuffer, uint32_t Size, bool Append);
 void PY25Q16_SectorErase(uint32_t Address);
+// With ENABLE_FLASH_WRITE_BACK, writes stay in the sector cache until the
+// cache moves to another sector or it is flushed
+bool PY25Q16_IsDirty();
+void PY25Q16_Flush();
+
+// Flushes in the background: each PY25Q16_Poll() starts the next erase,
+// page program or verify read once the chip is ready, and pDone (may be
+// NULL) gets the verify result at the end. Any other PY25Q16_* call waits
+// for the flush to complete first.
+typedef void (*PY25Q16_Callback_t)(bool Ok);
+
+void PY25Q16_FlushAsync(PY25Q16_Callback_t pDone);
+void PY25Q16_Poll();
+bool PY25Q16_IsBusy();
 
 #endif
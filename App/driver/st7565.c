@@ -16,10 +16,15 @@
 
 #include <stdint.h>
 #include <stdio.h>     // NULL
+#include <string.h>
 
 #include "py32f071_ll_bus.h"
 #include "py32f071_ll_spi.h"
 #include "py32f071_ll_gpio.h"
+#ifdef ENABLE_LCD_ASYNC_FLUSH
+    #include "py32f071_ll_dma.h"
+    #include "py32f071_ll_system.h"
+#endif
 #include "driver/gpio.h"
 #include "driver/st7565.h"
 #include "driver/system.h"
@@ -33,6 +38,25 @@
 uint8_t gStatusLine[LCD_WIDTH];
 uint8_t gFrameBuffer[FRAME_LINES][LCD_WIDTH];
 
+#ifdef ENABLE_LCD_ASYNC_FLUSH
+    // Blits only queue their pages, the DMA interrupt sends them one after
+    // the other. A page is cut into chunks and only the span between the first
+    // and last chunk whose hash differs from what the panel holds goes out.
+
+    #define CHANNEL_TX LL_DMA_CHANNEL_1
+
+    #define PAGES (FRAME_LINES + 1)     // page 0 is the status line
+    #define CHUNK_WIDTH 16
+    #define CHUNKS (LCD_WIDTH / CHUNK_WIDTH)
+
+    static uint32_t gPanelHash[PAGES][CHUNKS];  // 0 = unknown, never a valid hash
+    static uint8_t gDmaBuf[LCD_WIDTH];          // copy of the page being sent
+    static volatile uint8_t gPending;           // pages still to send
+    static volatile bool gBusy;
+
+    static void DMA_Init(void);
+#endif
+
 static void SPI_Init()
 {
     LL_APB1_GRP2_EnableClock(LL_APB1_GRP2_PERIPH_SPI1);
@@ -68,10 +92,15 @@ static void SPI_Init()
     InitStruct.NSS = LL_SPI_NSS_SOFT;
     InitStruct.BitOrder = LL_SPI_MSB_FIRST;
     InitStruct.CRCCalculation = LL_SPI_CRCCALCULATION_DISABLE;
-    InitStruct.BaudRate = LL_SPI_BAUDRATEPRESCALER_DIV64;
+    // 6 MHz, the ST7565 serial interface is specified up to 20 MHz
+    InitStruct.BaudRate = LL_SPI_BAUDRATEPRESCALER_DIV8;
     LL_SPI_Init(SPIx, &InitStruct);
 
     LL_SPI_Enable(SPIx);
+
+#ifdef ENABLE_LCD_ASYNC_FLUSH
+    DMA_Init();
+#endif
 }
 
 static inline void CS_Assert()
@@ -116,15 +145,199 @@ static void DrawLine(uint8_t column, uint8_t line, const uint8_t * lineBuffer, u
     }
 }
 
+#ifdef ENABLE_LCD_ASYNC_FLUSH
+    static void DMA_Init(void)
+    {
+        LL_AHB1_GRP1_EnableClock(LL_AHB1_GRP1_PERIPH_DMA1);
+        LL_APB1_GRP2_EnableClock(LL_APB1_GRP2_PERIPH_SYSCFG);
+
+        LL_SYSCFG_SetDMARemap(DMA1, CHANNEL_TX, LL_SYSCFG_DMA_MAP_SPI1_WR);
+
+        LL_DMA_DisableChannel(DMA1, CHANNEL_TX);
+        LL_DMA_ConfigTransfer(DMA1, CHANNEL_TX,                 //
+                              LL_DMA_DIRECTION_MEMORY_TO_PERIPH //
+                                  | LL_DMA_MODE_NORMAL          //
+                                  | LL_DMA_PERIPH_NOINCREMENT   //
+                                  | LL_DMA_MEMORY_INCREMENT     //
+                                  | LL_DMA_PDATAALIGN_BYTE      //
+                                  | LL_DMA_MDATAALIGN_BYTE      //
+                                  | LL_DMA_PRIORITY_LOW         //
+        );
+        LL_DMA_SetPeriphAddress(DMA1, CHANNEL_TX, LL_SPI_DMA_GetRegAddr(SPIx));
+        LL_DMA_EnableIT_TC(DMA1, CHANNEL_TX);
+
+        NVIC_SetPriority(DMA1_Channel1_IRQn, 2);
+        NVIC_EnableIRQ(DMA1_Channel1_IRQn);
+
+        gPending = 0;
+        gBusy = false;
+        memset(gPanelHash, 0, sizeof(gPanelHash));
+    }
+
+    // FNV-1a, forced odd so it never reads as unknown
+    static uint32_t HashChunk(const uint8_t *pData)
+    {
+        uint32_t Hash = 2166136261u;
+
+        for (unsigned i = 0; i < CHUNK_WIDTH; i++)
+            Hash = (Hash ^ pData[i]) * 16777619u;
+
+        return Hash | 1;
+    }
+
+    static int TakePage(void)
+    {
+        int Page = -1;
+
+        __disable_irq();
+        if (gPending)
+        {
+            for (Page = 0; !(gPending & (1u << Page)); Page++)
+                ;
+            gPending &= ~(1u << Page);
+        }
+        else
+        {
+            gBusy = false;
+        }
+        __enable_irq();
+
+        return Page;
+    }
+
+    // Starts the transfer of the next pending page that changed, or goes idle.
+    // Runs from the DMA interrupt, or from a blit that found the flush idle.
+    static void StartNext(void)
+    {
+        int Page;
+
+        while ((Page = TakePage()) >= 0)
+        {
+            int First = -1;
+            int Last = 0;
+
+            // Work on a copy, the UI may redraw the page while it is sent
+            memcpy(gDmaBuf, Page ? gFrameBuffer[Page - 1] : gStatusLine, LCD_WIDTH);
+
+            for (int i = 0; i < CHUNKS; i++)
+            {
+                const uint32_t Hash = HashChunk(gDmaBuf + i * CHUNK_WIDTH);
+
+                if (Hash != gPanelHash[Page][i])
+                {
+                    gPanelHash[Page][i] = Hash;
+                    if (First < 0)
+                        First = i;
+                    Last = i;
+                }
+            }
+
+            if (First < 0)
+                continue;
+
+            const unsigned Column = First * CHUNK_WIDTH;
+
+            CS_Assert();
+            ST7565_WriteByte(0x40);    // start line 0
+            ST7565_SelectColumnAndLine(Column + 4, Page);
+            A0_Set();
+
+            LL_DMA_SetMemoryAddress(DMA1, CHANNEL_TX, (uintptr_t)(gDmaBuf + Column));
+            LL_DMA_SetDataLength(DMA1, CHANNEL_TX, (Last + 1) * CHUNK_WIDTH - Column);
+            LL_DMA_EnableChannel(DMA1, CHANNEL_TX);
+            LL_SPI_EnableDMAReq_TX(SPIx);
+            return;
+        }
+    }
+
+    static void Flush(uint8_t Pages)
+    {
+        bool Start;
+
+        __disable_irq();
+        gPending |= Pages;
+        Start = !gBusy;
+        gBusy = true;
+        __enable_irq();
+
+        if (Start)
+            StartNext();
+    }
+
+    // The panel no longer holds what was last flushed for these columns
+    static void Invalidate(unsigned Page, unsigned Column, unsigned Size)
+    {
+        if (Page >= PAGES || Size == 0)
+            return;
+
+        for (unsigned i = Column / CHUNK_WIDTH; i < CHUNKS && i * CHUNK_WIDTH < Column + Size; i++)
+            gPanelHash[Page][i] = 0;
+    }
+
+    void DMA1_Channel1_IRQHandler(void)
+    {
+        if (!LL_DMA_IsActiveFlag_TC1(DMA1))
+            return;
+
+        LL_DMA_ClearFlag_TC1(DMA1);
+        LL_DMA_DisableChannel(DMA1, CHANNEL_TX);
+
+        while (LL_SPI_TX_FIFO_EMPTY != LL_SPI_GetTxFIFOLevel(SPIx))
+            ;
+        while (LL_SPI_IsActiveFlag_BSY(SPIx))
+            ;
+
+        LL_SPI_DisableDMAReq_TX(SPIx);
+
+        // Nothing read the bytes clocked in meanwhile
+        while (LL_SPI_RX_FIFO_EMPTY != LL_SPI_GetRxFIFOLevel(SPIx))
+            LL_SPI_ReceiveData8(SPIx);
+        LL_SPI_ClearFlag_OVR(SPIx);
+
+        CS_Release();
+        StartNext();
+    }
+
+    void ST7565_WaitFlush(void)
+    {
+        while (gBusy)
+            __NOP();
+    }
+
+    bool ST7565_IsBusy(void)
+    {
+        return gBusy;
+    }
+#endif
+
 void ST7565_DrawLine(const unsigned int Column, const unsigned int Line, const uint8_t *pBitmap, const unsigned int Size)
 {
+    ST7565_WaitFlush();
+#ifdef ENABLE_LCD_ASYNC_FLUSH
+    Invalidate(Line, Column, Size);
+#endif
     CS_Assert();
     DrawLine(Column, Line, pBitmap, Size);
     CS_Release();
 }
 
 
-#ifdef ENABLE_FEAT_N7SIX
+#ifdef ENABLE_LCD_ASYNC_FLUSH
+    void ST7565_BlitFullScreen(void)
+    {
+        Flush(0xFE);
+    }
+
+    void ST7565_BlitLine(unsigned line)
+    {
+        Flush(1u << (line + 1));
+    }
+
+    void ST7565_BlitStatusLine(void)
+    {
+        Flush(1u << 0);
+    }
+#elif defined(ENABLE_FEAT_N7SIX)
     // Optimization
     //
     // ST7565_BlitScreen(0) = ST7565_BlitStatusLine()
@@ -199,6 +412,10 @@ void ST7565_DrawLine(const unsigned int Column, const unsigned int Line, const u
 
 void ST7565_FillScreen(uint8_t value)
 {
+    ST7565_WaitFlush();
+#ifdef ENABLE_LCD_ASYNC_FLUSH
+    memset(gPanelHash, 0, sizeof(gPanelHash));
+#endif
     CS_Assert();
     for (unsigned i = 0; i < 8; i++) {
         // TODO: This is wrong
@@ -290,6 +507,7 @@ uint8_t cmds[] = {
     #if defined(ENABLE_FEAT_N7SIX_CTR) || defined(ENABLE_FEAT_N7SIX_INV)
     void ST7565_ContrastAndInv(void)
     {
+        ST7565_WaitFlush();
         CS_Assert();
         ST7565_WriteByte(ST7565_CMD_SOFTWARE_RESET);   // software reset
 
@@ -362,6 +580,7 @@ void ST7565_Init(void)
 #ifdef ENABLE_FEAT_N7SIX_SLEEP
     void ST7565_ShutDown(void)
     {
+        ST7565_WaitFlush();
         CS_Assert();
         ST7565_WriteByte(ST7565_CMD_POWER_CIRCUIT | 0b000);   // VB=0 VR=1 VF=1
         ST7565_WriteByte(ST7565_CMD_SET_START_LINE | 0);   // line 0
@@ -372,6 +591,11 @@ void ST7565_Init(void)
 
 void ST7565_FixInterfGlitch(void)
 {
+    ST7565_WaitFlush();
+#ifdef ENABLE_LCD_ASYNC_FLUSH
+    // Blits skip unchanged columns, repaint everything in case RAM got hit too
+    memset(gPanelHash, 0, sizeof(gPanelHash));
+#endif
     CS_Assert();
     for(uint8_t i = 0; i < ARRAY_SIZE(cmds); i++)
 #ifdef ENABLE_FEAT_N7SIX
@@ -27,6 +27,8 @@
 extern uint8_t gStatusLine[LCD_WIDTH];
 extern uint8_t gFrameBuffer[FRAME_LINES][LCD_WIDTH];
 
+// With ENABLE_LCD_ASYNC_FLUSH the Blit* calls return before the pages are on
+// the panel, ST7565_WaitFlush() waits for them. The other calls wait first.
 void ST7565_DrawLine(const unsigned int Column, const unsigned int Line, const uint8_t *pBitmap, const unsigned int Size);
 void ST7565_BlitFullScreen(void);
 void ST7565_BlitLine(unsigned line);
@@ -40,6 +42,13 @@ void ST7565_FixInterfGlitch(void);
 void ST7565_HardwareReset(void);
 void ST7565_SelectColumnAndLine(uint8_t Column, uint8_t Line);
 void ST7565_WriteByte(uint8_t Value);
+#ifdef ENABLE_LCD_ASYNC_FLUSH
+    void ST7565_WaitFlush(void);
+    bool ST7565_IsBusy(void);
+#else
+    #define ST7565_WaitFlush() do {} while (0)
+    #define ST7565_IsBusy() false
+#endif
 
 #ifdef ENABLE_FEAT_N7SIX
     #if defined(ENABLE_FEAT_N7SIX_CTR) || defined(ENABLE_FEAT_N7SIX_INV)
@@ -17,6 +17,7 @@
 #include "py32f0xx.h"
 #include "systick.h"
 #include "misc.h"
+#include "scheduler.h"
 
 // 0x20000324
 static uint32_t gTickMultiplier;
@@ -49,3 +50,22 @@ void SYSTICK_DelayUs(uint32_t Delay)
         Previous = Current;
     } while (elapsed_ticks < ticks);
 }
+
+uint32_t SYSTICK_GetElapsedUs(void)
+{
+    return (SysTick->LOAD - SysTick->VAL) / gTickMultiplier;
+}
+
+uint32_t SYSTICK_GetTimeUs(void)
+{
+    uint32_t Ticks;
+    uint32_t Us;
+
+    // Read again when the 10 ms tick lands in between
+    do {
+        Ticks = gGlobalSysTickCounter;
+        Us    = SYSTICK_GetElapsedUs();
+    } while (Ticks != gGlobalSysTickCounter);
+
+    return Ticks * 10000 + Us;
+}
@@ -21,6 +21,10 @@
 
 void SYSTICK_Init(void);
 void SYSTICK_DelayUs(uint32_t Delay);
+// Microseconds into the current 10 ms SysTick period
+uint32_t SYSTICK_GetElapsedUs(void);
+// Microseconds since SYSTICK_Init(), wraps after about 71 minutes
+uint32_t SYSTICK_GetTimeUs(void);
 
 #endif
 
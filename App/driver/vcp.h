@@ -46,4 +46,10 @@ static inline void VCP_SendAsync(const uint8_t *Buf, uint32_t Size)
     cdc_acm_data_send_with_dtr_async(Buf, Size);
 }
 
+// Buf of the last VCP_SendAsync() is still in use
+static inline bool VCP_IsBusy(void)
+{
+    return cdc_acm_tx_busy();
+}
+
 #endif // _DRIVER_VCP_H
@@ -18,6 +18,7 @@
 
 #include "battery.h"
 #include "driver/backlight.h"
+#include "driver/py25q16.h"
 #include "driver/st7565.h"
 #include "functions.h"
 #include "misc.h"
@@ -260,6 +261,9 @@ void BATTERY_TimeSlice500ms(void)
 
     gReducedService = true;
 
+    // The battery may not last until the next write-back
+    PY25Q16_Flush();
+
     FUNCTION_Select(FUNCTION_POWER_SAVE);
 
     ST7565_HardwareReset();
@@ -0,0 +1,17 @@
+/* Boot-phase timestamps, see boot_profile.h. */
+
+#include "helper/boot_profile.h"
+#include "driver/systick.h"
+
+static uint32_t gBootProfile[BOOT_PHASE_COUNT];
+
+void BOOT_PROFILE_Mark(BOOT_Phase_t Phase)
+{
+    if (Phase < BOOT_PHASE_COUNT)
+        gBootProfile[Phase] = SYSTICK_GetTimeUs();
+}
+
+uint32_t BOOT_PROFILE_Get(BOOT_Phase_t Phase)
+{
+    return Phase < BOOT_PHASE_COUNT ? gBootProfile[Phase] : 0;
+}
@@ -0,0 +1,34 @@
+/* Boot-phase timestamps, for measuring time from reset to first RX.
+ *
+ * Main() marks the end of each boot phase; the marks are microseconds since
+ * SYSTICK_Init() and can be read back over UART/USB with command 0x0610.
+ */
+
+#ifndef HELPER_BOOT_PROFILE_H
+#define HELPER_BOOT_PROFILE_H
+
+#include <stdint.h>
+
+typedef enum
+{
+    BOOT_PHASE_BOARD = 0,       // board, UART/USB and BK4819 up
+    BOOT_PHASE_SETTINGS,        // settings and calibration loaded
+    BOOT_PHASE_CHANNELS,        // both VFOs configured
+    BOOT_PHASE_REGISTERS,       // first RADIO_SetupRegisters()
+    BOOT_PHASE_BATTERY,         // battery readings and AM fix table
+    BOOT_PHASE_WELCOME,         // welcome screen dismissed
+    BOOT_PHASE_FIRST_RX,        // radio set up for RX after the welcome screen
+    BOOT_PHASE_MAIN_LOOP,       // entering the main loop
+
+    BOOT_PHASE_COUNT
+} BOOT_Phase_t;
+
+#ifdef ENABLE_BOOT_PROFILE
+    void     BOOT_PROFILE_Mark(BOOT_Phase_t Phase);
+    // 0 when the phase was never reached
+    uint32_t BOOT_PROFILE_Get(BOOT_Phase_t Phase);
+#else
+    #define BOOT_PROFILE_Mark(Phase) do {} while (0)
+#endif
+
+#endif
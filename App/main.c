@@ -57,6 +57,7 @@
 #endif
 #include "helper/battery.h"
 #include "helper/boot.h"
+#include "helper/boot_profile.h"
 
 #include "ui/lock.h"
 #include "ui/welcome.h"
@@ -102,6 +103,7 @@ void Main(void)
     BK4819_Init();
 
     BOARD_ADC_GetBatteryInfo(&gBatteryCurrentVoltage, &gBatteryCurrent);
+    BOOT_PROFILE_Mark(BOOT_PHASE_BOARD);
 
     SETTINGS_InitEEPROM();
 
@@ -112,13 +114,16 @@ void Main(void)
 
     SETTINGS_WriteBuildOptions();
     SETTINGS_LoadCalibration();
+    BOOT_PROFILE_Mark(BOOT_PHASE_SETTINGS);
 
     RADIO_ConfigureChannel(0, VFO_CONFIGURE_RELOAD);
     RADIO_ConfigureChannel(1, VFO_CONFIGURE_RELOAD);
 
     RADIO_SelectVfos();
+    BOOT_PROFILE_Mark(BOOT_PHASE_CHANNELS);
 
     RADIO_SetupRegisters(true);
+    BOOT_PROFILE_Mark(BOOT_PHASE_REGISTERS);
 
     for (unsigned int i = 0; i < ARRAY_SIZE(gBatteryVoltages); i++)
         BOARD_ADC_GetBatteryInfo(&gBatteryVoltages[i], &gBatteryCurrent);
@@ -128,6 +133,7 @@ void Main(void)
 #ifdef ENABLE_AM_FIX
     AM_fix_init();
 #endif
+    BOOT_PROFILE_Mark(BOOT_PHASE_BATTERY);
 
     BOOT_Mode_t  BootMode = BOOT_GetMode();
 
@@ -239,24 +245,17 @@ void Main(void)
             SYSTEM_DelayMs(10);
         }
 
-        // 2. Wait for the user to RELEASE the button first
-        while (KEYBOARD_Poll() != KEY_INVALID || GPIO_IsPttPressed())
-        {
-            SYSTEM_DelayMs(10);
-        }
-
-        // 3. Small "breathing" delay for the hardware
-        SYSTEM_DelayMs(100);
-
-        // Wait for button release
+        // 2. Wait for the user to RELEASE the button
         while (KEYBOARD_Poll() != KEY_INVALID || GPIO_IsPttPressed())
         {
             SYSTEM_DelayMs(10);
         }
+        BOOT_PROFILE_Mark(BOOT_PHASE_WELCOME);
 
         // Finalize boot
         boot_counter_10ms = 0;
         RADIO_SetupRegisters(true);
+        BOOT_PROFILE_Mark(BOOT_PHASE_FIRST_RX);
 
 #ifdef ENABLE_PWRON_PASSWORD
         if (gEeprom.POWER_ON_PASSWORD < 1000000)
@@ -373,8 +372,13 @@ void Main(void)
         }
         #endif
     #endif
-        
+
+    BOOT_PROFILE_Mark(BOOT_PHASE_MAIN_LOOP);
+
     while (true) {
+#ifdef ENABLE_FLASH_WRITE_BACK
+        PY25Q16_Poll();
+#endif
         APP_Update();
 
         if (gNextTimeslice) {
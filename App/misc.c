@@ -76,6 +76,15 @@ const uint16_t    battery_save_count_10ms          = 10000 / 10;   // 10 seconds
 const uint16_t    power_save1_10ms                 =   100 / 10;   // 100ms
 const uint16_t    power_save2_10ms                 =   200 / 10;   // 200ms
 
+#ifdef ENABLE_FRAME_GOVERNOR
+    const uint8_t     gui_frame_period_10ms            =    40 / 10;   // 25 frames per second
+#endif
+
+#ifdef ENABLE_FLASH_WRITE_BACK
+    const uint16_t    flash_write_back_idle_10ms       =  1000 / 10;   // 1 second
+    const uint16_t    flash_write_back_max_10ms        =  5000 / 10;   // 5 seconds
+#endif
+
 #ifdef ENABLE_VOX
     const uint16_t    vox_stop_count_down_10ms         =  1000 / 10;   // 1 second
 #endif
@@ -167,6 +176,12 @@ ChannelAttributes_t gMR_ChannelAttributes[FREQ_CHANNEL_LAST + 1];
 bool                gMR_ChannelExclude[FREQ_CHANNEL_LAST + 1];
 
 volatile uint16_t gBatterySaveCountdown_10ms = battery_save_count_10ms;
+#ifdef ENABLE_FLASH_WRITE_BACK
+    volatile uint16_t gFlashWriteBackCountdown_10ms;
+#endif
+#ifdef ENABLE_FRAME_GOVERNOR
+    volatile uint8_t  gGuiFrameCountdown_10ms;
+#endif
 
 volatile bool     gPowerSaveCountdownExpired;
 volatile bool     gSchedulePowerSave;
@@ -109,6 +109,15 @@ extern const uint16_t        battery_save_count_10ms;
 extern const uint16_t        power_save1_10ms;
 extern const uint16_t        power_save2_10ms;
 
+#ifdef ENABLE_FRAME_GOVERNOR
+    extern const uint8_t     gui_frame_period_10ms;
+#endif
+
+#ifdef ENABLE_FLASH_WRITE_BACK
+    extern const uint16_t    flash_write_back_idle_10ms;
+    extern const uint16_t    flash_write_back_max_10ms;
+#endif
+
 #ifdef ENABLE_VOX
     extern const uint16_t    vox_stop_count_down_10ms;
 #endif
@@ -233,6 +242,12 @@ extern ChannelAttributes_t   gMR_ChannelAttributes[207];
 extern bool                  gMR_ChannelExclude[207];
 
 extern volatile uint16_t     gBatterySaveCountdown_10ms;
+#ifdef ENABLE_FLASH_WRITE_BACK
+    extern volatile uint16_t gFlashWriteBackCountdown_10ms;
+#endif
+#ifdef ENABLE_FRAME_GOVERNOR
+    extern volatile uint8_t  gGuiFrameCountdown_10ms;
+#endif
 
 extern volatile bool         gPowerSaveCountdownExpired;
 extern volatile bool         gSchedulePowerSave;
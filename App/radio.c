@@ -15,6 +15,8 @@
  */
 
 #include "driver/bk4819-regs.h"
+#include <assert.h>
+#include <stddef.h>
 #include <string.h>
 
 #include "am_fix.h"
@@ -25,7 +27,7 @@
 #include "audio.h"
 #include "dcs.h"
 #include "driver/bk4819.h"
-#include "driver/py25q16.h"
+#include "driver/flashlog.h"
 #include "driver/gpio.h"
 #include "driver/system.h"
 #include "frequencies.h"
@@ -53,6 +55,16 @@ const char gModulationStr[MODULATION_UKNOWN][4] = {
 #endif
 };
 
+// Scan list 0 is the channels in no list, 4 those in any list
+static bool IsInScanList(ChannelAttributes_t att, uint8_t scanList)
+{
+    return !((scanList == 0 && (att.scanlist1 == 1 || att.scanlist2 == 1 || att.scanlist3 == 1)) ||
+             (scanList == 1 && att.scanlist1 != 1) ||
+             (scanList == 2 && att.scanlist2 != 1) ||
+             (scanList == 3 && att.scanlist3 != 1) ||
+             (scanList == 4 && (att.scanlist1 == 0 && att.scanlist2 == 0 && att.scanlist3 == 0)));
+}
+
 bool RADIO_CheckValidChannel(uint16_t channel, bool checkScanList, uint8_t scanList)
 {
     // return true if the channel appears valid
@@ -93,40 +105,279 @@ bool RADIO_CheckValidChannel(uint16_t channel, bool checkScanList, uint8_t scanL
     }
     */
 
-    if ((scanList == 0 && (att.scanlist1 == 1 || att.scanlist2 == 1 || att.scanlist3 == 1)) ||
-        (scanList == 1 && att.scanlist1 != 1) ||
-        (scanList == 2 && att.scanlist2 != 1) ||
-        (scanList == 3 && att.scanlist3 != 1) ||
-        (scanList == 4 && (att.scanlist1 == 0 && att.scanlist2 == 0 && att.scanlist3 == 0))) {
+    if (!IsInScanList(att, scanList)) {
         return false;
     }
 
-    //return true;
+    // Priority channels are visited separately by the scanner. Only lists
+    // 1..3 have them, 0 and 4 used to index outside the arrays here.
+    if (scanList < 1 || scanList > 3)
+        return true;
 
-    // I don't understand what this code is for...
-    
     const uint8_t PriorityCh1 = gEeprom.SCANLIST_PRIORITY_CH1[scanList - 1];
     const uint8_t PriorityCh2 = gEeprom.SCANLIST_PRIORITY_CH2[scanList - 1];
 
     return PriorityCh1 != channel && PriorityCh2 != channel;
 }
 
+// Channels RADIO_CheckValidChannel() accepts, one bitset per kind of query:
+// scan lists 0..4, "all lists" (scanList > 4) and no scan list check. Built
+// on first use after RADIO_InvalidateChannelIndex().
+enum {
+    INDEX_ALL_LISTS = 5,
+    INDEX_ANY,
+    INDEX_COUNT
+};
+
+#define INDEX_WORDS ((MR_CHANNEL_LAST + 32) / 32)
+
+static uint32_t gChannelIndex[INDEX_COUNT][INDEX_WORDS];
+static uint8_t  gChannelIndexPriority[2][3];
+static bool     gChannelIndexValid;
+#ifdef ENABLE_CHANNEL_BANKS
+    static uint8_t gChannelIndexBank;
+#endif
+
+static void InvalidateScanIndex(void);
+
+void RADIO_InvalidateChannelIndex(void)
+{
+    gChannelIndexValid = false;
+    InvalidateScanIndex();
+}
+
+static const uint32_t *GetChannelIndex(bool bCheckScanList, uint8_t ScanList)
+{
+    // Priority channels are changed from the menu and on load, compare
+    // rather than hooking every writer
+    if (memcmp(gChannelIndexPriority[0], gEeprom.SCANLIST_PRIORITY_CH1, 3) != 0 ||
+        memcmp(gChannelIndexPriority[1], gEeprom.SCANLIST_PRIORITY_CH2, 3) != 0)
+        gChannelIndexValid = false;
+#ifdef ENABLE_CHANNEL_BANKS
+    // and a bank switch only swaps gMR_ChannelAttributes
+    if (gChannelIndexBank != gEeprom.CHANNEL_BANK)
+        gChannelIndexValid = false;
+#endif
+
+    if (!gChannelIndexValid)
+    {
+        memset(gChannelIndex, 0, sizeof(gChannelIndex));
+
+        for (unsigned int ch = MR_CHANNEL_FIRST; IS_MR_CHANNEL(ch); ch++)
+        {
+            const uint32_t Bit = 1u << (ch % 32);
+
+            for (unsigned int list = 0; list < INDEX_ANY; list++)
+                if (RADIO_CheckValidChannel(ch, true, list))
+                    gChannelIndex[list][ch / 32] |= Bit;
+
+            if (RADIO_CheckValidChannel(ch, false, 0))
+                gChannelIndex[INDEX_ANY][ch / 32] |= Bit;
+        }
+
+        memcpy(gChannelIndexPriority[0], gEeprom.SCANLIST_PRIORITY_CH1, 3);
+        memcpy(gChannelIndexPriority[1], gEeprom.SCANLIST_PRIORITY_CH2, 3);
+#ifdef ENABLE_CHANNEL_BANKS
+        gChannelIndexBank = gEeprom.CHANNEL_BANK;
+#endif
+        gChannelIndexValid = true;
+    }
+
+    if (!bCheckScanList)
+        return gChannelIndex[INDEX_ANY];
+
+    return gChannelIndex[ScanList > 4 ? INDEX_ALL_LISTS : ScanList];
+}
+
+// First set bit at or above Channel, at most MR_CHANNEL_LAST, else 0xFF
+static uint8_t IndexNextUp(const uint32_t *pIndex, unsigned int Channel)
+{
+    unsigned int Word = Channel / 32;
+    uint32_t     Bits = pIndex[Word] & (~0u << (Channel % 32));
+
+    while (Bits == 0)
+    {
+        if (++Word == INDEX_WORDS)
+            return 0xFF;
+        Bits = pIndex[Word];
+    }
+
+    const unsigned int Found = Word * 32 + __builtin_ctz(Bits);
+    return IS_MR_CHANNEL(Found) ? Found : 0xFF;
+}
+
+// Last set bit at or below Channel, else 0xFF
+static uint8_t IndexNextDown(const uint32_t *pIndex, unsigned int Channel)
+{
+    int      Word = Channel / 32;
+    uint32_t Bits = pIndex[Word] & (~0u >> (31 - Channel % 32));
+
+    while (Bits == 0)
+    {
+        if (--Word < 0)
+            return 0xFF;
+        Bits = pIndex[Word];
+    }
+
+    return Word * 32 + 31 - __builtin_clz(Bits);
+}
+
 uint8_t RADIO_FindNextChannel(uint8_t Channel, int8_t Direction, bool bCheckScanList, uint8_t VFO)
 {
-    for (unsigned int i = 0; IS_MR_CHANNEL(i); i++, Channel += Direction) {
-        if (Channel == 0xFF) {
-            Channel = MR_CHANNEL_LAST;
-        } else if (!IS_MR_CHANNEL(Channel)) {
-            Channel = MR_CHANNEL_FIRST;
+    if (Channel == 0xFF) {
+        Channel = MR_CHANNEL_LAST;
+    } else if (!IS_MR_CHANNEL(Channel)) {
+        Channel = MR_CHANNEL_FIRST;
+    }
+
+    if (Direction != 1 && Direction != -1) {
+        return RADIO_CheckValidChannel(Channel, bCheckScanList, VFO) ? Channel : 0xFF;
+    }
+
+    const uint32_t *pIndex = GetChannelIndex(bCheckScanList, VFO);
+    uint8_t         Next;
+
+    if (Direction > 0) {
+        Next = IndexNextUp(pIndex, Channel);
+        if (Next == 0xFF)
+            Next = IndexNextUp(pIndex, MR_CHANNEL_FIRST);
+    } else {
+        Next = IndexNextDown(pIndex, Channel);
+        if (Next == 0xFF)
+            Next = IndexNextDown(pIndex, MR_CHANNEL_LAST);
+    }
+
+    return Next;
+}
+
+// Members of the list being scanned in every bank, so one list can run
+// across banks. Built from each bank's attribute block when the list or any
+// channel attributes change, not when the bank in view does. Priority and
+// excluded channels are left in: gScanBankFirst[b] counts the members of the
+// banks before b, and a member's place in the list, which is also its
+// profile slot, is a few popcounts away.
+#ifdef ENABLE_CHANNEL_BANKS
+    #define SCAN_BANKS CHANNEL_BANK_COUNT
+    #define VIEW_BANK  gEeprom.CHANNEL_BANK
+#else
+    #define SCAN_BANKS 1
+    #define VIEW_BANK  0
+#endif
+
+static uint32_t gScanIndex[SCAN_BANKS][INDEX_WORDS];
+static uint16_t gScanBankFirst[SCAN_BANKS + 1];
+static uint8_t  gScanIndexList = 0xFF;  // 0xFF: to be built
+
+static void InvalidateScanIndex(void)
+{
+    gScanIndexList = 0xFF;
+}
+
+static void BuildScanIndex(uint8_t ScanList)
+{
+    memset(gScanIndex, 0, sizeof(gScanIndex));
+
+    for (unsigned int Bank = 0; Bank < SCAN_BANKS; Bank++)
+    {
+        uint16_t Count = 0;
+
+        for (unsigned int First = MR_CHANNEL_FIRST; IS_MR_CHANNEL(First); First += 40)
+        {
+            ChannelAttributes_t Att[40];
+
+            if (Bank == VIEW_BANK)
+                memcpy(Att, &gMR_ChannelAttributes[First], sizeof(Att));
+#ifdef ENABLE_CHANNEL_BANKS
+            else
+                FLASHLOG_ReadBuffer(SETTINGS_BankAttributesAddress(Bank, First), Att, sizeof(Att));
+#endif
+
+            for (unsigned int i = 0; i < 40; i++)
+            {
+                if (Att[i].band > BAND7_470MHz || !IsInScanList(Att[i], ScanList))   // erased: band 7
+                    continue;
+
+                gScanIndex[Bank][(First + i) / 32] |= 1u << ((First + i) % 32);
+                Count++;
+            }
         }
 
-        if (RADIO_CheckValidChannel(Channel, bCheckScanList, VFO)) {
-            return Channel;
+        gScanBankFirst[Bank + 1] = gScanBankFirst[Bank] + Count;
+    }
+
+    gScanIndexList = ScanList;
+
+    // Profile slots follow the list
+    RADIO_ClearChannelProfiles();
+}
+
+static void UpdateScanIndex(uint8_t ScanList)
+{
+    if (gScanIndexList != ScanList)
+        BuildScanIndex(ScanList);
+}
+
+// Place of Channel of the bank in view in the scan list, -1 if not a member
+static int GetScanPosition(uint8_t Channel)
+{
+    const uint32_t *pIndex = gScanIndex[VIEW_BANK];
+    const unsigned int Word = Channel / 32;
+    const uint32_t     Bit  = 1u << (Channel % 32);
+
+    if (gScanIndexList == 0xFF || !IS_MR_CHANNEL(Channel) || (pIndex[Word] & Bit) == 0)
+        return -1;
+
+    int Position = gScanBankFirst[VIEW_BANK] + __builtin_popcount(pIndex[Word] & (Bit - 1));
+    for (unsigned int w = 0; w < Word; w++)
+        Position += __builtin_popcount(pIndex[w]);
+
+    return Position;
+}
+
+#ifdef ENABLE_CHANNEL_BANKS
+uint8_t RADIO_FindNextScanChannel(uint8_t *pBank, uint8_t Channel, int8_t Direction, uint8_t ScanList)
+{
+    uint8_t Bank = *pBank;
+
+    UpdateScanIndex(ScanList);
+
+    // Into the next bank and round to where it started, at most
+    for (unsigned int i = 0; i <= SCAN_BANKS; i++)
+    {
+        if (IS_MR_CHANNEL(Channel))
+        {
+            // The bank in view also honours priority channels; the others
+            // leave out the exclusions they kept
+            const uint32_t *pIndex;
+            uint32_t        Members[INDEX_WORDS];
+
+            if (Bank == VIEW_BANK)
+                pIndex = GetChannelIndex(true, ScanList);
+            else
+            {
+                const uint32_t *pExclude = SETTINGS_GetBankExclusions(Bank);
+
+                for (unsigned int w = 0; w < INDEX_WORDS; w++)
+                    Members[w] = gScanIndex[Bank][w] & ~pExclude[w];
+                pIndex = Members;
+            }
+
+            const uint8_t Next = (Direction > 0) ? IndexNextUp(pIndex, Channel) : IndexNextDown(pIndex, Channel);
+
+            if (Next != 0xFF)
+            {
+                *pBank = Bank;
+                return Next;
+            }
         }
+
+        Bank    = (Bank + SCAN_BANKS + Direction) % SCAN_BANKS;
+        Channel = (Direction > 0) ? MR_CHANNEL_FIRST : MR_CHANNEL_LAST;
     }
 
     return 0xFF;
 }
+#endif
 
 void RADIO_InitInfo(VFO_Info_t *pInfo, const uint8_t ChannelSave, const uint32_t Frequency)
 {
@@ -242,7 +493,7 @@ void RADIO_ConfigureChannel(const unsigned int VFO, const unsigned int configure
 
     uint32_t base;
     if (IS_MR_CHANNEL(channel))
-        base = channel * 16;
+        base = SETTINGS_ChannelAddress(channel);
     else
         base = 0x001000 + ((channel - FREQ_CHANNEL_FIRST) * 32) + (VFO * 16);
 
@@ -253,7 +504,7 @@ void RADIO_ConfigureChannel(const unsigned int VFO, const unsigned int configure
         
         // ***************
 
-        PY25Q16_ReadBuffer(base + 8, data, sizeof(data));
+        FLASHLOG_ReadBuffer(base + 8, data, sizeof(data));
 
         tmp = data[3] & 0x0F;
         if (tmp > TX_OFFSET_FREQUENCY_DIRECTION_SUB)
@@ -366,7 +617,7 @@ void RADIO_ConfigureChannel(const unsigned int VFO, const unsigned int configure
             uint32_t Frequency;
             uint32_t Offset;
         } __attribute__((packed)) info;
-        PY25Q16_ReadBuffer(base, &info, sizeof(info));
+        FLASHLOG_ReadBuffer(base, &info, sizeof(info));
         if(info.Frequency==0xFFFFFFFF)
             pVfo->freq_config_RX.Frequency = frequencyBandTable[band].lower;
         else
@@ -441,6 +692,200 @@ void RADIO_ConfigureChannel(const unsigned int VFO, const unsigned int configure
     RADIO_ConfigureSquelchAndOutputPower(pVfo);
 }
 
+// Channel profiles: what a scanner hop needs of a configured memory channel,
+// packed into 12 bytes, one per place in the scan list for its first
+// SCAN_PROFILE_SLOTS members; later members take the slow path on every hop.
+// The scanner fills them on its first lap. Band,
+// compander and scan lists come from gMR_ChannelAttributes and the squelch
+// thresholds from one set per calibration range, as in
+// RADIO_ConfigureChannel(). Transmit-only fields (offset, PTT ID, busy lock,
+// TX power, name) are left as they were: CHFRSCANNER_Stop() configures the
+// channel in full before anything can transmit.
+typedef struct
+{
+    uint32_t RxFrequency : 27;
+    uint32_t Modulation  : 3;
+    uint32_t Bandwidth   : 1;
+    uint32_t Reverse     : 1;
+
+    uint32_t TxFrequency : 27;
+    uint32_t Direction   : 2;
+    uint32_t RxIsTx      : 1;   // pRX points at freq_config_TX
+    uint32_t TxIsRx      : 1;   // pTX points at freq_config_RX
+    uint32_t TxLock      : 1;
+
+    uint32_t RxCode      : 7;
+    uint32_t TxCode      : 7;
+    uint32_t RxCodeType  : 2;
+    uint32_t TxCodeType  : 2;
+    uint32_t Power       : 3;
+    uint32_t Scrambling  : 4;
+    uint32_t Step        : 5;
+    uint32_t Dtmf        : 1;
+    uint32_t Valid       : 1;
+} Profile_t;
+
+// Globals RADIO_ConfigureChannel() reads, the profiles hold while they match
+typedef struct
+{
+    uint8_t SquelchLevel;
+    bool    Enable350;
+    bool    RemoveOffset;
+    bool    PowerHigh;
+} ProfileContext_t;
+
+// 32 slots are 384 bytes of RAM, against 2.4 KB for every channel
+#define SCAN_PROFILE_SLOTS 32
+
+static Profile_t        gProfile[SCAN_PROFILE_SLOTS];       // by scan position
+static uint8_t          gProfileSquelch[2][6];  // VHF, UHF calibration range
+static bool             gProfileSquelchValid[2];
+static ProfileContext_t gProfileContext;
+
+// The six squelch thresholds are copied as one block
+static_assert(offsetof(VFO_Info_t, SquelchOpenGlitchThresh) - offsetof(VFO_Info_t, SquelchOpenRSSIThresh) == 5);
+
+static void GetProfileContext(ProfileContext_t *pContext)
+{
+    memset(pContext, 0, sizeof(*pContext));
+
+    pContext->SquelchLevel = gEeprom.SQUELCH_LEVEL;
+    pContext->Enable350    = gSetting_350EN;
+    #ifdef ENABLE_FEAT_N7SIX_RESCUE_OPS
+        pContext->RemoveOffset = gRemoveOffset;
+        pContext->PowerHigh    = gPowerHigh;
+    #endif
+}
+
+// Which squelch set RADIO_ConfigureSquelchAndOutputPower() reads for pInfo
+static bool IsUhfSquelch(const VFO_Info_t *pInfo)
+{
+    return FREQUENCY_GetBand(pInfo->pRX->Frequency) >= BAND4_174MHz;
+}
+
+void RADIO_ClearChannelProfiles(void)
+{
+    memset(gProfile, 0, sizeof(gProfile));
+    memset(gProfileSquelchValid, 0, sizeof(gProfileSquelchValid));
+    GetProfileContext(&gProfileContext);
+}
+
+// Profile of Channel in the bank in view, NULL when it has no slot
+static Profile_t *GetProfile(uint8_t Channel)
+{
+    const int Position = GetScanPosition(Channel);
+
+    return (Position >= 0 && Position < (int)ARRAY_SIZE(gProfile)) ? &gProfile[Position] : NULL;
+}
+
+void RADIO_InvalidateChannelProfile(uint8_t Channel)
+{
+    Profile_t *pProfile = GetProfile(Channel);
+
+    if (pProfile != NULL)
+        pProfile->Valid = false;
+}
+
+void RADIO_StoreChannelProfile(unsigned int VFO)
+{
+    const VFO_Info_t *pVfo    = &gEeprom.VfoInfo[VFO];
+    const uint8_t     Channel = pVfo->CHANNEL_SAVE;
+    ProfileContext_t  Context;
+
+    // Out of the packed range (an offset below 0 Hz), take the slow path
+    if (!IS_MR_CHANNEL(Channel) || (pVfo->freq_config_RX.Frequency | pVfo->freq_config_TX.Frequency) >> 27)
+        return;
+
+    GetProfileContext(&Context);
+    if (memcmp(&Context, &gProfileContext, sizeof(Context)) != 0)
+        RADIO_ClearChannelProfiles();
+
+    UpdateScanIndex(gEeprom.SCAN_LIST_DEFAULT);
+    Profile_t *pProfile = GetProfile(Channel);
+    if (pProfile == NULL)
+        return;
+
+    const bool Uhf = IsUhfSquelch(pVfo);
+    memcpy(gProfileSquelch[Uhf], &pVfo->SquelchOpenRSSIThresh, 6);
+    gProfileSquelchValid[Uhf] = true;
+
+    pProfile->RxFrequency = pVfo->freq_config_RX.Frequency;
+    pProfile->Modulation  = pVfo->Modulation;
+    pProfile->Bandwidth   = pVfo->CHANNEL_BANDWIDTH;
+    pProfile->Reverse     = pVfo->FrequencyReverse;
+    pProfile->TxFrequency = pVfo->freq_config_TX.Frequency;
+    pProfile->Direction   = pVfo->TX_OFFSET_FREQUENCY_DIRECTION;
+    pProfile->RxIsTx      = pVfo->pRX == &pVfo->freq_config_TX;
+    pProfile->TxIsRx      = pVfo->pTX == &pVfo->freq_config_RX;
+    pProfile->TxLock      = pVfo->TX_LOCK;
+    pProfile->RxCode      = pVfo->freq_config_RX.Code;
+    pProfile->TxCode      = pVfo->freq_config_TX.Code;
+    pProfile->RxCodeType  = pVfo->freq_config_RX.CodeType;
+    pProfile->TxCodeType  = pVfo->freq_config_TX.CodeType;
+    pProfile->Power       = pVfo->OUTPUT_POWER;
+    pProfile->Scrambling  = pVfo->SCRAMBLING_TYPE;
+    pProfile->Step        = pVfo->STEP_SETTING;
+#ifdef ENABLE_DTMF_CALLING
+    pProfile->Dtmf        = pVfo->DTMF_DECODING_ENABLE;
+#endif
+    pProfile->Valid       = true;
+}
+
+bool RADIO_LoadChannelProfile(unsigned int VFO, uint8_t Channel)
+{
+    VFO_Info_t       *pVfo = &gEeprom.VfoInfo[VFO];
+    ProfileContext_t  Context;
+
+    UpdateScanIndex(gEeprom.SCAN_LIST_DEFAULT);
+    const Profile_t *pProfile = GetProfile(Channel);
+    if (pProfile == NULL || !pProfile->Valid)
+        return false;
+
+    GetProfileContext(&Context);
+    if (memcmp(&Context, &gProfileContext, sizeof(Context)) != 0)
+    {
+        RADIO_ClearChannelProfiles();
+        return false;
+    }
+
+    const ChannelAttributes_t att = gMR_ChannelAttributes[Channel];
+
+    pVfo->freq_config_RX.Frequency     = pProfile->RxFrequency;
+    pVfo->freq_config_RX.Code          = pProfile->RxCode;
+    pVfo->freq_config_RX.CodeType      = pProfile->RxCodeType;
+    pVfo->freq_config_TX.Frequency     = pProfile->TxFrequency;
+    pVfo->freq_config_TX.Code          = pProfile->TxCode;
+    pVfo->freq_config_TX.CodeType      = pProfile->TxCodeType;
+    pVfo->pRX = pProfile->RxIsTx ? &pVfo->freq_config_TX : &pVfo->freq_config_RX;
+    pVfo->pTX = pProfile->TxIsRx ? &pVfo->freq_config_RX : &pVfo->freq_config_TX;
+
+    const bool Uhf = IsUhfSquelch(pVfo);
+    if (!gProfileSquelchValid[Uhf])
+        return false;
+    memcpy(&pVfo->SquelchOpenRSSIThresh, gProfileSquelch[Uhf], 6);
+
+    pVfo->CHANNEL_SAVE                  = Channel;
+    pVfo->Band                          = att.band > BAND7_470MHz ? BAND6_400MHz : att.band;
+    pVfo->SCANLIST1_PARTICIPATION       = att.scanlist1;
+    pVfo->SCANLIST2_PARTICIPATION       = att.scanlist2;
+    pVfo->SCANLIST3_PARTICIPATION       = att.scanlist3;
+    pVfo->Compander                     = att.compander;
+    pVfo->Modulation                    = pProfile->Modulation;
+    pVfo->CHANNEL_BANDWIDTH             = pProfile->Bandwidth;
+    pVfo->FrequencyReverse              = pProfile->Reverse;
+    pVfo->TX_OFFSET_FREQUENCY_DIRECTION = pProfile->Direction;
+    pVfo->TX_LOCK                       = pProfile->TxLock;
+    pVfo->OUTPUT_POWER                  = pProfile->Power;
+    pVfo->SCRAMBLING_TYPE               = pProfile->Scrambling;
+    pVfo->STEP_SETTING                  = pProfile->Step;
+    pVfo->StepFrequency                 = gStepFrequencyTable[pProfile->Step];
+#ifdef ENABLE_DTMF_CALLING
+    pVfo->DTMF_DECODING_ENABLE          = pProfile->Dtmf;
+#endif
+
+    return true;
+}
+
 void RADIO_ConfigureSquelchAndOutputPower(VFO_Info_t *pInfo)
 {
 
@@ -466,14 +911,14 @@ void RADIO_ConfigureSquelchAndOutputPower(VFO_Info_t *pInfo)
     {   // squelch >= 1
         Base += gEeprom.SQUELCH_LEVEL;                                        // my eeprom squelch-1
                                                                               // VHF   UHF
-        PY25Q16_ReadBuffer(Base + 0x00, &pInfo->SquelchOpenRSSIThresh,    1);  //  50    10
-        PY25Q16_ReadBuffer(Base + 0x10, &pInfo->SquelchCloseRSSIThresh,   1);  //  40     5
+        FLASHLOG_ReadBuffer(Base + 0x00, &pInfo->SquelchOpenRSSIThresh,    1);  //  50    10
+        FLASHLOG_ReadBuffer(Base + 0x10, &pInfo->SquelchCloseRSSIThresh,   1);  //  40     5
 
-        PY25Q16_ReadBuffer(Base + 0x20, &pInfo->SquelchOpenNoiseThresh,   1);  //  65    90
-        PY25Q16_ReadBuffer(Base + 0x30, &pInfo->SquelchCloseNoiseThresh,  1);  //  70   100
+        FLASHLOG_ReadBuffer(Base + 0x20, &pInfo->SquelchOpenNoiseThresh,   1);  //  65    90
+        FLASHLOG_ReadBuffer(Base + 0x30, &pInfo->SquelchCloseNoiseThresh,  1);  //  70   100
 
-        PY25Q16_ReadBuffer(Base + 0x40, &pInfo->SquelchCloseGlitchThresh, 1);  //  90    90
-        PY25Q16_ReadBuffer(Base + 0x50, &pInfo->SquelchOpenGlitchThresh,  1);  // 100   100
+        FLASHLOG_ReadBuffer(Base + 0x40, &pInfo->SquelchCloseGlitchThresh, 1);  //  90    90
+        FLASHLOG_ReadBuffer(Base + 0x50, &pInfo->SquelchOpenGlitchThresh,  1);  // 100   100
 
 
         uint16_t noise_open   = pInfo->SquelchOpenNoiseThresh;
@@ -552,7 +997,7 @@ void RADIO_ConfigureSquelchAndOutputPower(VFO_Info_t *pInfo)
         currentPower--;
     }
 
-    PY25Q16_ReadBuffer(0x100D0 + (Band * 16) + (Op * 3), Txp, 3);
+    FLASHLOG_ReadBuffer(0x100D0 + (Band * 16) + (Op * 3), Txp, 3);
 
 #ifdef ENABLE_FEAT_N7SIX
     // make low and mid even lower
@@ -682,6 +1127,92 @@ void RADIO_SelectVfos(void)
     RADIO_SelectCurrentVfo();
 }
 
+// What the last full RADIO_SetupRegisters() programmed beyond frequency and
+// squelch. While it still matches, RADIO_RetuneRegisters() can hop without
+// redoing filters, CSS, VOX, compander, DTMF and AGC.
+typedef struct
+{
+    uint16_t VoxThreshold[2];
+    uint8_t  Modulation;
+    uint8_t  Bandwidth;
+    uint8_t  CodeType;
+    uint8_t  Code;
+    uint8_t  Compander;
+    uint8_t  Scrambling;
+    uint8_t  VolumeGain;
+    uint8_t  DacGain;
+    uint8_t  MicSensitivity;
+    bool     Narrower;
+    bool     ScrambleEnable;
+    bool     Vox;
+    bool     FmRadio;
+    bool     NoaaChannel;
+    bool     Noaa;
+} RxSetup_t;
+
+static RxSetup_t gRxSetup;
+static bool      gRxSetupValid;
+static uint16_t  gRxInterruptMask;
+
+static void GetRxSetup(RxSetup_t *pSetup)
+{
+    memset(pSetup, 0, sizeof(*pSetup));
+
+    pSetup->Modulation     = gRxVfo->Modulation;
+    pSetup->Bandwidth      = gRxVfo->CHANNEL_BANDWIDTH;
+    pSetup->CodeType       = gRxVfo->pRX->CodeType;
+    pSetup->Code           = gRxVfo->pRX->Code;
+    pSetup->Compander      = gRxVfo->Compander;
+    pSetup->Scrambling     = gRxVfo->SCRAMBLING_TYPE;
+    pSetup->VolumeGain     = gEeprom.VOLUME_GAIN;
+    pSetup->DacGain        = gEeprom.DAC_GAIN;
+    pSetup->MicSensitivity = gEeprom.MIC_SENSITIVITY_TUNING;
+    pSetup->ScrambleEnable = gSetting_ScrambleEnable;
+#ifdef ENABLE_FEAT_N7SIX_NARROWER
+    pSetup->Narrower       = gSetting_set_nfm;
+#endif
+#ifdef ENABLE_VOX
+    // VOX follows the current VFO, which need not be the RX one
+    pSetup->Vox            = gEeprom.VOX_SWITCH && gCurrentVfo->Modulation == MODULATION_FM
+    #ifdef ENABLE_NOAA
+                             && !IS_NOAA_CHANNEL(gCurrentVfo->CHANNEL_SAVE)
+    #endif
+                             ;
+    pSetup->VoxThreshold[0] = gEeprom.VOX0_THRESHOLD;
+    pSetup->VoxThreshold[1] = gEeprom.VOX1_THRESHOLD;
+#endif
+#ifdef ENABLE_FMRADIO
+    pSetup->FmRadio        = gFmRadioMode;
+#endif
+#ifdef ENABLE_NOAA
+    pSetup->NoaaChannel    = IS_NOAA_CHANNEL(gRxVfo->CHANNEL_SAVE);
+    pSetup->Noaa           = IS_NOAA_CHANNEL(gRxVfo->CHANNEL_SAVE) && gIsNoaaMode;
+#endif
+}
+
+static uint32_t GetRxFrequency(void)
+{
+    #ifdef ENABLE_NOAA
+        if (IS_NOAA_CHANNEL(gRxVfo->CHANNEL_SAVE) && gIsNoaaMode)
+            return NoaaFrequencyTable[gNoaaChannel];
+    #endif
+
+    return gRxVfo->pRX->Frequency;
+}
+
+static void ClearPendingInterrupts(void)
+{
+    while (1)
+    {
+        const uint16_t Status = BK4819_ReadRegister(BK4819_REG_0C);
+        if ((Status & 1u) == 0) // INTERRUPT REQUEST
+            break;
+
+        BK4819_WriteRegister(BK4819_REG_02, 0);
+        SYSTEM_DelayMs(1);
+    }
+}
+
 void RADIO_SetupRegisters(bool switchToForeground)
 {
     BK4819_FilterBandwidth_t Bandwidth = gRxVfo->CHANNEL_BANDWIDTH;
@@ -727,29 +1258,13 @@ void RADIO_SetupRegisters(bool switchToForeground)
 
     BK4819_ToggleGpioOut(BK4819_GPIO1_PIN29_PA_ENABLE, false);
 
-    while (1)
-    {
-        const uint16_t Status = BK4819_ReadRegister(BK4819_REG_0C);
-        if ((Status & 1u) == 0) // INTERRUPT REQUEST
-            break;
-
-        BK4819_WriteRegister(BK4819_REG_02, 0);
-        SYSTEM_DelayMs(1);
-    }
+    ClearPendingInterrupts();
     BK4819_WriteRegister(BK4819_REG_3F, 0);
 
     // mic gain 0.5dB/step 0 to 31
     BK4819_WriteRegister(BK4819_REG_7D, 0xE940 | (gEeprom.MIC_SENSITIVITY_TUNING & 0x1f));
 
-    uint32_t Frequency;
-    #ifdef ENABLE_NOAA
-        if (!IS_NOAA_CHANNEL(gRxVfo->CHANNEL_SAVE) || !gIsNoaaMode)
-            Frequency = gRxVfo->pRX->Frequency;
-        else
-            Frequency = NoaaFrequencyTable[gNoaaChannel];
-    #else
-        Frequency = gRxVfo->pRX->Frequency;
-    #endif
+    const uint32_t Frequency = GetRxFrequency();
     BK4819_SetFrequency(Frequency);
 
     BK4819_SetupSquelch(
@@ -873,12 +1388,51 @@ void RADIO_SetupRegisters(bool switchToForeground)
     // enable/disable BK4819 selected interrupts
     BK4819_WriteRegister(BK4819_REG_3F, InterruptMask);
 
+    GetRxSetup(&gRxSetup);
+    gRxSetupValid    = true;
+    gRxInterruptMask = InterruptMask;
+
     FUNCTION_Init();
 
     if (switchToForeground)
         FUNCTION_Select(FUNCTION_FOREGROUND);
 }
 
+void RADIO_RetuneRegisters(void)
+{
+    RxSetup_t Setup;
+
+    GetRxSetup(&Setup);
+
+    if (!gRxSetupValid || gCurrentFunction != FUNCTION_FOREGROUND || memcmp(&Setup, &gRxSetup, sizeof(Setup)) != 0)
+    {
+        RADIO_SetupRegisters(true);
+        return;
+    }
+
+    // Same sequence as the full setup, minus everything that cannot differ
+    AUDIO_AudioPathOff();
+
+    gEnableSpeaker = false;
+
+    BK4819_WriteRegister(BK4819_REG_3F, 0);
+    ClearPendingInterrupts();
+
+    const uint32_t Frequency = GetRxFrequency();
+    BK4819_SetFrequency(Frequency);
+
+    BK4819_SetupSquelch(
+        gRxVfo->SquelchOpenRSSIThresh,    gRxVfo->SquelchCloseRSSIThresh,
+        gRxVfo->SquelchOpenNoiseThresh,   gRxVfo->SquelchCloseNoiseThresh,
+        gRxVfo->SquelchCloseGlitchThresh, gRxVfo->SquelchOpenGlitchThresh);
+
+    BK4819_PickRXFilterPathBasedOnFrequency(Frequency);
+
+    BK4819_WriteRegister(BK4819_REG_3F, gRxInterruptMask);
+
+    FUNCTION_Init();
+}
+
 #ifdef ENABLE_NOAA
     void RADIO_ConfigureNOAA(void)
     {
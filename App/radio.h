@@ -152,12 +152,29 @@ extern VfoState_t     VfoState[2];
 
 bool     RADIO_CheckValidChannel(uint16_t channel, bool checkScanList, uint8_t scanList);
 uint8_t  RADIO_FindNextChannel(uint8_t ChNum, int8_t Direction, bool bCheckScanList, uint8_t RadioNum);
+#ifdef ENABLE_CHANNEL_BANKS
+// Next member of ScanList from Channel of *pBank on, going on through the
+// other banks and round; sets *pBank to the bank it is in. 0xFF if none.
+uint8_t  RADIO_FindNextScanChannel(uint8_t *pBank, uint8_t Channel, int8_t Direction, uint8_t ScanList);
+#endif
+// Call after changing gMR_ChannelAttributes or gMR_ChannelExclude
+void     RADIO_InvalidateChannelIndex(void);
 void     RADIO_InitInfo(VFO_Info_t *pInfo, const uint8_t ChannelSave, const uint32_t Frequency);
 void     RADIO_ConfigureChannel(const unsigned int VFO, const unsigned int configure);
 void     RADIO_ConfigureSquelchAndOutputPower(VFO_Info_t *pInfo);
+
+// Memory channel profiles kept in RAM while scanning, one per channel of the
+// bank, see chFrScanner.c
+void     RADIO_ClearChannelProfiles(void);
+void     RADIO_InvalidateChannelProfile(uint8_t Channel);
+void     RADIO_StoreChannelProfile(unsigned int VFO);
+bool     RADIO_LoadChannelProfile(unsigned int VFO, uint8_t Channel);
 void     RADIO_ApplyOffset(VFO_Info_t *pInfo);
 void     RADIO_SelectVfos(void);
 void     RADIO_SetupRegisters(bool switchToForeground);
+// Scanner hop: reprograms frequency, squelch and LNA path only, falling back
+// to RADIO_SetupRegisters(true) when anything else about the channel differs.
+void     RADIO_RetuneRegisters(void);
 #ifdef ENABLE_NOAA
     void RADIO_ConfigureNOAA(void);
 #endif
@@ -42,7 +42,7 @@
                 flag = true;             \
     } while (0)
 
-static volatile uint32_t gGlobalSysTickCounter;
+volatile uint32_t gGlobalSysTickCounter;
 
 // we come here every 10ms
 void SysTick_Handler(void)
@@ -76,6 +76,14 @@ void SysTick_Handler(void)
 
     DECREMENT(gFoundCTCSSCountdown_10ms);
 
+#ifdef ENABLE_FLASH_WRITE_BACK
+    DECREMENT(gFlashWriteBackCountdown_10ms);
+#endif
+
+#ifdef ENABLE_FRAME_GOVERNOR
+    DECREMENT(gGuiFrameCountdown_10ms);
+#endif
+
     if (gCurrentFunction == FUNCTION_FOREGROUND)
         DECREMENT_AND_TRIGGER(gBatterySaveCountdown_10ms, gSchedulePowerSave);
 
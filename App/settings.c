@@ -23,7 +23,7 @@
 #endif
 #include "driver/bk1080.h"
 #include "driver/bk4819.h"
-#include "driver/py25q16.h"
+#include "driver/flashlog.h"
 #include "misc.h"
 #include "settings.h"
 #include "ui/menu.h"
@@ -41,11 +41,85 @@ static const uint32_t gDefaultFrequencyTable[] =
 
 EEPROM_Config_t gEeprom = { 0 };
 
+// Erased attributes mean an empty channel
+static void FixChannelAttributes(void)
+{
+    for(uint16_t i = 0; i < sizeof(gMR_ChannelAttributes); i++) {
+        ChannelAttributes_t *att = &gMR_ChannelAttributes[i];
+        if(att->__val == 0xff){
+            att->__val = 0;
+            att->band = 0x7;
+        }
+    }
+}
+
+#ifdef ENABLE_CHANNEL_BANKS
+// Exclusions of the banks not in view, so a bank switch or a scan running
+// across banks keeps each bank's own until the next boot
+static uint32_t gBankExclude[CHANNEL_BANK_COUNT][(MR_CHANNEL_LAST + 32) / 32];
+
+static void StashExclusions(uint8_t Bank)
+{
+    memset(gBankExclude[Bank], 0, sizeof(gBankExclude[Bank]));
+    for (unsigned i = 0; IS_MR_CHANNEL(i); i++)
+        if (gMR_ChannelExclude[i])
+            gBankExclude[Bank][i / 32] |= 1u << (i % 32);
+}
+
+const uint32_t *SETTINGS_GetBankExclusions(uint8_t Bank)
+{
+    return gBankExclude[Bank];
+}
+
+static void RestoreExclusions(uint8_t Bank)
+{
+    for (unsigned i = 0; IS_MR_CHANNEL(i); i++)
+        gMR_ChannelExclude[i] = (gBankExclude[Bank][i / 32] >> (i % 32)) & 1;
+}
+#endif
+
 void SETTINGS_InitEEPROM(void)
 {
     uint8_t Data[16] = {0};
+
+    // Every settings block in one scatter-gather read, parsed from RAM below
+    struct
+    {
+        uint8_t Settings4000[0x10];
+        uint8_t Settings5000[8];
+        uint8_t Settings6000[8];
+        uint8_t Settings7000[0x50];
+        uint8_t Settings8000[0x38];
+        uint8_t Settings9000[8];
+        uint8_t SettingsB000[8];
+        uint8_t SettingsC000[8];
+#ifdef ENABLE_CHANNEL_BANKS
+        uint8_t SettingsC008[8];
+#endif
+    } Raw;
+
+    const PY25Q16_ReadSeg_t List[] = {
+        {0x002000, gMR_ChannelAttributes, sizeof(gMR_ChannelAttributes)},
+#ifdef ENABLE_FMRADIO
+        {0x003000, gFM_Channels,          sizeof(gFM_Channels)},
+#endif
+        {0x004000, Raw.Settings4000,      sizeof(Raw.Settings4000)},
+        {0x005000, Raw.Settings5000,      sizeof(Raw.Settings5000)},
+        {0x006000, Raw.Settings6000,      sizeof(Raw.Settings6000)},
+        {0x007000, Raw.Settings7000,      sizeof(Raw.Settings7000)},
+        {0x008000, Raw.Settings8000,      sizeof(Raw.Settings8000)},
+        {0x009000, Raw.Settings9000,      sizeof(Raw.Settings9000)},
+        {0x00a000, gCustomAesKey,         sizeof(gCustomAesKey)},
+        {0x00b000, Raw.SettingsB000,      sizeof(Raw.SettingsB000)},
+        {0x00c000, Raw.SettingsC000,      sizeof(Raw.SettingsC000)},
+#ifdef ENABLE_CHANNEL_BANKS
+        {0x00c008, Raw.SettingsC008,      sizeof(Raw.SettingsC008)},
+#endif
+    };
+    FLASHLOG_ReadList(List, ARRAY_SIZE(List));
+
     // 0E70..0E77
-    PY25Q16_ReadBuffer(0x004000, Data, 8);
+    memcpy(Data, Raw.Settings4000, 8);
     gEeprom.CHAN_1_CALL          = IS_MR_CHANNEL(Data[0]) ? Data[0] : MR_CHANNEL_FIRST;
     gEeprom.SQUELCH_LEVEL        = (Data[1] < 10) ? Data[1] : 1;
     gEeprom.TX_TIMEOUT_TIMER     = (Data[2] > 4 && Data[2] < 180) ? Data[2] : 11;
@@ -66,7 +140,7 @@ void SETTINGS_InitEEPROM(void)
     gEeprom.MIC_SENSITIVITY      = (Data[7] <  5) ? Data[7] : 4;
 
     // 0E78..0E7F
-    PY25Q16_ReadBuffer(0x004008, Data, 8);
+    memcpy(Data, Raw.Settings4000 + 0x8, 8);
     gEeprom.BACKLIGHT_MAX         = (Data[0] & 0xF) <= 10 ? (Data[0] & 0xF) : 10;
     gEeprom.BACKLIGHT_MIN         = (Data[0] >> 4) < gEeprom.BACKLIGHT_MAX ? (Data[0] >> 4) : 0;
 #ifdef ENABLE_BLMIN_TMP_OFF
@@ -93,7 +167,7 @@ void SETTINGS_InitEEPROM(void)
     #endif
 
     // 0E80..0E87
-    PY25Q16_ReadBuffer(0x005000, Data, 8);
+    memcpy(Data, Raw.Settings5000, 8);
     gEeprom.ScreenChannel[0]   = IS_VALID_CHANNEL(Data[0]) ? Data[0] : (FREQ_CHANNEL_FIRST + BAND6_400MHz);
     gEeprom.ScreenChannel[1]   = IS_VALID_CHANNEL(Data[3]) ? Data[3] : (FREQ_CHANNEL_FIRST + BAND6_400MHz);
     gEeprom.MrChannel[0]       = IS_MR_CHANNEL(Data[1])    ? Data[1] : MR_CHANNEL_FIRST;
@@ -115,7 +189,7 @@ void SETTINGS_InitEEPROM(void)
             uint8_t  band:2;
             //uint8_t  space:2;
         } __attribute__((packed)) fmCfg;
-        PY25Q16_ReadBuffer(0x006000, &fmCfg, 4);
+        memcpy(&fmCfg, Raw.Settings6000, 4);
 
         gEeprom.FM_Band = fmCfg.band;
         //gEeprom.FM_Space = fmCfg.space;
@@ -127,13 +201,12 @@ void SETTINGS_InitEEPROM(void)
         gEeprom.FM_IsMrMode        = fmCfg.isMrMode;
     }
 
-    // 0E40..0E67
-    PY25Q16_ReadBuffer(0x003000, gFM_Channels, sizeof(gFM_Channels));
+    // 0E40..0E67 read into gFM_Channels above
     FM_ConfigureChannelState();
 #endif
 
     // 0E90..0E97
-    PY25Q16_ReadBuffer(0x007000, Data, 8);
+    memcpy(Data, Raw.Settings7000, 8);
     gEeprom.BEEP_CONTROL                 = Data[0] & 1;
     gEeprom.KEY_M_LONG_PRESS_ACTION      = ((Data[0] >> 1) < ACTION_OPT_LEN) ? (Data[0] >> 1) : ACTION_OPT_NONE;
     gEeprom.KEY_1_SHORT_PRESS_ACTION     = (Data[1] < ACTION_OPT_LEN) ? Data[1] : ACTION_OPT_MONITOR;
@@ -150,12 +223,12 @@ void SETTINGS_InitEEPROM(void)
 
     // 0E98..0E9F
     #ifdef ENABLE_PWRON_PASSWORD
-        PY25Q16_ReadBuffer(0x007000 + 0x8, Data, 8);
+        memcpy(Data, Raw.Settings7000 + 0x8, 8);
         memcpy(&gEeprom.POWER_ON_PASSWORD, Data, 4);
     #endif
 
     // 0EA0..0EA7
-    PY25Q16_ReadBuffer(0x007000 + 0x10, Data, 8);
+    memcpy(Data, Raw.Settings7000 + 0x10, 8);
     #ifdef ENABLE_VOICE
     gEeprom.VOICE_PROMPT = (Data[0] < 3) ? Data[0] : VOICE_PROMPT_ENGLISH;
     #endif
@@ -171,7 +244,7 @@ void SETTINGS_InitEEPROM(void)
     #endif
 
     // 0EA8..0EAF
-    PY25Q16_ReadBuffer(0x007000 + 0x18, Data, 8);
+    memcpy(Data, Raw.Settings7000 + 0x18, 8);
     #ifdef ENABLE_ALARM
         gEeprom.ALARM_MODE                 = (Data[0] <  2) ? Data[0] : true;
     #endif
@@ -179,9 +252,14 @@ void SETTINGS_InitEEPROM(void)
     gEeprom.REPEATER_TAIL_TONE_ELIMINATION = (Data[2] < 11) ? Data[2] : 0;
     gEeprom.TX_VFO                         = (Data[3] <  2) ? Data[3] : 0;
     gEeprom.BATTERY_TYPE                   = (Data[4] < BATTERY_TYPE_UNKNOWN) ? Data[4] : BATTERY_TYPE_1600_MAH;
+#ifdef ENABLE_SCAN_ADAPTIVE_DWELL
+    gEeprom.SCAN_EARLY_RSSI                = (Data[5] >= 2 && Data[5] <= 80)  ? Data[5] : 10;
+    gEeprom.SCAN_EARLY_NOISE               = (Data[6] >= 2 && Data[6] <= 60)  ? Data[6] : 6;
+    gEeprom.SCAN_EARLY_GLITCH              = (Data[7] >= 5 && Data[7] <= 200) ? Data[7] : 20;
+#endif
 
     // 0ED0..0ED7
-    PY25Q16_ReadBuffer(0x007000 + 0x40, Data, 8);
+    memcpy(Data, Raw.Settings7000 + 0x40, 8);
     gEeprom.DTMF_SIDE_TONE               = (Data[0] <   2) ? Data[0] : true;
 
 #ifdef ENABLE_DTMF_CALLING
@@ -195,7 +273,7 @@ void SETTINGS_InitEEPROM(void)
     gEeprom.DTMF_HASH_CODE_PERSIST_TIME  = (Data[7] < 101) ? Data[7] * 10 : 100;
 
     // 0ED8..0EDF
-    PY25Q16_ReadBuffer(0x007000 + 0x48, Data, 8);
+    memcpy(Data, Raw.Settings7000 + 0x48, 8);
     gEeprom.DTMF_CODE_PERSIST_TIME  = (Data[0] < 101) ? Data[0] * 10 : 100;
     gEeprom.DTMF_CODE_INTERVAL_TIME = (Data[1] < 101) ? Data[1] * 10 : 100;
 #ifdef ENABLE_DTMF_CALLING
@@ -203,7 +281,7 @@ void SETTINGS_InitEEPROM(void)
 
     // 0EE0..0EE7
 
-    PY25Q16_ReadBuffer(0x008000, Data, sizeof(gEeprom.ANI_DTMF_ID));
+    memcpy(Data, Raw.Settings8000, sizeof(gEeprom.ANI_DTMF_ID));
     if (DTMF_ValidateCodes((char *)Data, sizeof(gEeprom.ANI_DTMF_ID))) {
         memcpy(gEeprom.ANI_DTMF_ID, Data, sizeof(gEeprom.ANI_DTMF_ID));
     } else {
@@ -212,7 +290,7 @@ void SETTINGS_InitEEPROM(void)
 
 
     // 0EE8..0EEF
-    PY25Q16_ReadBuffer(0x008000 + 0x8, Data, sizeof(gEeprom.KILL_CODE));
+    memcpy(Data, Raw.Settings8000 + 0x8, sizeof(gEeprom.KILL_CODE));
     if (DTMF_ValidateCodes((char *)Data, sizeof(gEeprom.KILL_CODE))) {
         memcpy(gEeprom.KILL_CODE, Data, sizeof(gEeprom.KILL_CODE));
     } else {
@@ -220,7 +298,7 @@ void SETTINGS_InitEEPROM(void)
     }
 
     // 0EF0..0EF7
-    PY25Q16_ReadBuffer(0x008000 + 0x10, Data, sizeof(gEeprom.REVIVE_CODE));
+    memcpy(Data, Raw.Settings8000 + 0x10, sizeof(gEeprom.REVIVE_CODE));
     if (DTMF_ValidateCodes((char *)Data, sizeof(gEeprom.REVIVE_CODE))) {
         memcpy(gEeprom.REVIVE_CODE, Data, sizeof(gEeprom.REVIVE_CODE));
     } else {
@@ -229,7 +307,7 @@ void SETTINGS_InitEEPROM(void)
 #endif
 
     // 0EF8..0F07
-    PY25Q16_ReadBuffer(0x008000 + 0x18, Data, sizeof(gEeprom.DTMF_UP_CODE));
+    memcpy(Data, Raw.Settings8000 + 0x18, sizeof(gEeprom.DTMF_UP_CODE));
     if (DTMF_ValidateCodes((char *)Data, sizeof(gEeprom.DTMF_UP_CODE))) {
         memcpy(gEeprom.DTMF_UP_CODE, Data, sizeof(gEeprom.DTMF_UP_CODE));
     } else {
@@ -237,7 +315,7 @@ void SETTINGS_InitEEPROM(void)
     }
 
     // 0F08..0F17
-    PY25Q16_ReadBuffer(0x008000 + 0x28, Data, sizeof(gEeprom.DTMF_DOWN_CODE));
+    memcpy(Data, Raw.Settings8000 + 0x28, sizeof(gEeprom.DTMF_DOWN_CODE));
     if (DTMF_ValidateCodes((char *)Data, sizeof(gEeprom.DTMF_DOWN_CODE))) {
         memcpy(gEeprom.DTMF_DOWN_CODE, Data, sizeof(gEeprom.DTMF_DOWN_CODE));
     } else {
@@ -245,7 +323,7 @@ void SETTINGS_InitEEPROM(void)
     }
 
     // 0F18..0F1F
-    PY25Q16_ReadBuffer(0x009000, Data, 8);
+    memcpy(Data, Raw.Settings9000, 8);
     gEeprom.SCAN_LIST_DEFAULT = (Data[0] < 6) ? Data[0] : 0;  // we now have 'all' channel scan option
 
     // Fake data
@@ -278,7 +356,7 @@ void SETTINGS_InitEEPROM(void)
     }
 
     // 0F40..0F47
-    PY25Q16_ReadBuffer(0x00b000, Data, 8);
+    memcpy(Data, Raw.SettingsB000, 8);
     gSetting_F_LOCK            = (Data[0] < F_LOCK_LEN) ? Data[0] : F_LOCK_DEF;
 #ifndef ENABLE_FEAT_N7SIX
     gSetting_350TX             = (Data[1] < 2) ? Data[1] : false;  // was true
@@ -316,19 +394,21 @@ void SETTINGS_InitEEPROM(void)
         gEeprom.ScreenChannel[1] = gEeprom.MrChannel[1];
     }
 
-    // 0D60..0E27
-    PY25Q16_ReadBuffer(0x002000, gMR_ChannelAttributes, sizeof(gMR_ChannelAttributes));
-    for(uint16_t i = 0; i < sizeof(gMR_ChannelAttributes); i++) {
-        ChannelAttributes_t *att = &gMR_ChannelAttributes[i];
-        if(att->__val == 0xff){
-            att->__val = 0;
-            att->band = 0x7;
-        }
-        gMR_ChannelExclude[i] = false;
-    }
+    // 0D60..0E27 read into gMR_ChannelAttributes above
+#ifdef ENABLE_CHANNEL_BANKS
+    // 1FF8
+    gEeprom.CHANNEL_BANK = (Raw.SettingsC008[0] < CHANNEL_BANK_COUNT) ? Raw.SettingsC008[0] : 0;
+    if (gEeprom.CHANNEL_BANK != 0)
+        FLASHLOG_ReadBuffer(SETTINGS_ChannelAttributesAddress(0), gMR_ChannelAttributes, MR_CHANNEL_LAST + 1);
+#endif
+    FixChannelAttributes();
+    memset(gMR_ChannelExclude, 0, sizeof(gMR_ChannelExclude));
+#ifdef ENABLE_CHANNEL_BANKS
+    memset(gBankExclude, 0, sizeof(gBankExclude));
+#endif
+    RADIO_InvalidateChannelIndex();
 
-        // 0F30..0F3F
-        PY25Q16_ReadBuffer(0x00a000, gCustomAesKey, sizeof(gCustomAesKey));
+        // 0F30..0F3F read into gCustomAesKey above
         bHasCustomAesKey = false;
         #ifndef ENABLE_FEAT_N7SIX
             for (unsigned int i = 0; i < ARRAY_SIZE(gCustomAesKey); i++)
@@ -344,7 +424,7 @@ void SETTINGS_InitEEPROM(void)
     #ifdef ENABLE_FEAT_N7SIX
         // 1FF0..0x1FF7
         // TODO: address TBD
-        PY25Q16_ReadBuffer(0x00c000, Data, 8);
+        memcpy(Data, Raw.SettingsC000, 8);
         gSetting_set_pwr = (((Data[7] & 0xF0) >> 4) < 7) ? ((Data[7] & 0xF0) >> 4) : 0;
         gSetting_set_ptt = (((Data[7] & 0x0F)) < 2) ? ((Data[7] & 0x0F)) : 0;
 
@@ -400,19 +480,34 @@ void SETTINGS_LoadCalibration(void)
 {
 //  uint8_t Mic;
 
-    // 0x1EC0
-    PY25Q16_ReadBuffer(0x010000 + 0xc0, gEEPROM_RSSI_CALIB[3], 8);
+    struct
+    {
+        int16_t  BK4819_XtalFreqLow;
+        uint16_t EEPROM_1F8A;
+        uint16_t EEPROM_1F8C;
+        uint8_t  VOLUME_GAIN;
+        uint8_t  DAC_GAIN;
+    } __attribute__((packed)) Misc;
+
+    const PY25Q16_ReadSeg_t List[] = {
+        {0x010000 + 0xc0,  gEEPROM_RSSI_CALIB[3], 8},     // 0x1EC0
+        {0x010000 + 0xc8,  gEEPROM_RSSI_CALIB[0], 8},     // 0x1EC8
+        {0x010000 + 0x140, gBatteryCalibration,   12},    // 0x1F40
+#ifdef ENABLE_VOX
+        {0x010000 + 0x150 + (gEeprom.VOX_LEVEL * 2), &gEeprom.VOX1_THRESHOLD, 2},  // 0x1F50
+        {0x010000 + 0x168 + (gEeprom.VOX_LEVEL * 2), &gEeprom.VOX0_THRESHOLD, 2},  // 0x1F68
+#endif
+        {0x010000 + 0x188, &Misc,                 8},     // 0x1F88
+    };
+    FLASHLOG_ReadList(List, ARRAY_SIZE(List));
+
     memcpy(gEEPROM_RSSI_CALIB[4], gEEPROM_RSSI_CALIB[3], 8);
     memcpy(gEEPROM_RSSI_CALIB[5], gEEPROM_RSSI_CALIB[3], 8);
     memcpy(gEEPROM_RSSI_CALIB[6], gEEPROM_RSSI_CALIB[3], 8);
 
-    // 0x1EC8
-    PY25Q16_ReadBuffer(0x010000 + 0xc8, gEEPROM_RSSI_CALIB[0], 8);
     memcpy(gEEPROM_RSSI_CALIB[1], gEEPROM_RSSI_CALIB[0], 8);
     memcpy(gEEPROM_RSSI_CALIB[2], gEEPROM_RSSI_CALIB[0], 8);
 
-    // 0x1F40
-    PY25Q16_ReadBuffer(0x010000 + 0x140, gBatteryCalibration, 12);
     if (gBatteryCalibration[0] >= 5000)
     {
         gBatteryCalibration[0] = 1900;
@@ -420,31 +515,13 @@ void SETTINGS_LoadCalibration(void)
     }
     gBatteryCalibration[5] = 2300;
 
-    #ifdef ENABLE_VOX
-        // 0x1F50
-        PY25Q16_ReadBuffer(0x010000 + 0x150 + (gEeprom.VOX_LEVEL * 2), &gEeprom.VOX1_THRESHOLD, 2);
-        // 0x1F68
-        PY25Q16_ReadBuffer(0x010000 + 0x168 + (gEeprom.VOX_LEVEL * 2), &gEeprom.VOX0_THRESHOLD, 2);
-    #endif
-
-    //PY25Q16_ReadBuffer(0x1F80 + gEeprom.MIC_SENSITIVITY, &Mic, 1);
+    //FLASHLOG_ReadBuffer(0x1F80 + gEeprom.MIC_SENSITIVITY, &Mic, 1);
     //gEeprom.MIC_SENSITIVITY_TUNING = (Mic < 32) ? Mic : 15;
     gEeprom.MIC_SENSITIVITY_TUNING = gMicGain_dB2[gEeprom.MIC_SENSITIVITY];
 
     {
-        struct
-        {
-            int16_t  BK4819_XtalFreqLow;
-            uint16_t EEPROM_1F8A;
-            uint16_t EEPROM_1F8C;
-            uint8_t  VOLUME_GAIN;
-            uint8_t  DAC_GAIN;
-        } __attribute__((packed)) Misc;
-
         // radio 1 .. 04 00 46 00 50 00 2C 0E
         // radio 2 .. 05 00 46 00 50 00 2C 0E
-        // 0x1F88
-        PY25Q16_ReadBuffer(0x010000 + 0x188, &Misc, 8);
 
         gEeprom.BK4819_XTAL_FREQ_LOW = (Misc.BK4819_XtalFreqLow >= -1000 && Misc.BK4819_XtalFreqLow <= 1000) ? Misc.BK4819_XtalFreqLow : 0;
         gEEPROM_1F8A                 = Misc.EEPROM_1F8A & 0x01FF;
@@ -461,15 +538,238 @@ void SETTINGS_LoadCalibration(void)
     }
 }
 
+// Cuts a 10-byte raw name at the first invalid char, drops trailing spaces
+static void SanitizeName(char *s)
+{
+    int i;
+    for (i = 0; i < 10; i++)
+        if (s[i] < 32 || s[i] > 127)
+            break;                // invalid char
+
+    s[i--] = 0;                   // null term
+
+    while (i >= 0 && s[i] == 32)  // trim trailing spaces
+        s[i--] = 0;               // null term
+}
+
+#ifdef ENABLE_CHANNEL_BANKS
+static uint32_t BankBase(uint8_t Bank)
+{
+    return CHANNEL_BANK_BASE + (Bank - 1) * CHANNEL_BANK_SIZE;
+}
+
+uint32_t SETTINGS_BankChannelAddress(uint8_t Bank, uint8_t Channel)
+{
+    if (Bank == 0 || !IS_MR_CHANNEL(Channel))
+        return Channel * 16;
+
+    return BankBase(Bank) + Channel * 16;
+}
+
+uint32_t SETTINGS_BankAttributesAddress(uint8_t Bank, uint8_t Channel)
+{
+    // VFO attributes stay in the legacy area whatever the bank
+    if (Bank == 0 || !IS_MR_CHANNEL(Channel))
+        return 0x002000 + Channel;
+
+    return BankBase(Bank) + 0x0D00 + Channel;
+}
+
+uint32_t SETTINGS_ChannelAddress(uint8_t Channel)
+{
+    return SETTINGS_BankChannelAddress(gEeprom.CHANNEL_BANK, Channel);
+}
+
+uint32_t SETTINGS_ChannelNameAddress(uint8_t Channel)
+{
+    if (gEeprom.CHANNEL_BANK == 0 || !IS_MR_CHANNEL(Channel))
+        return 0x00e000 + Channel * 16;
+
+    return BankBase(gEeprom.CHANNEL_BANK) + 0x1000 + Channel * 16;
+}
+
+uint32_t SETTINGS_ChannelAttributesAddress(uint8_t Channel)
+{
+    return SETTINGS_BankAttributesAddress(gEeprom.CHANNEL_BANK, Channel);
+}
+
+void SETTINGS_ViewChannelBank(uint8_t Bank)
+{
+    if (Bank >= CHANNEL_BANK_COUNT || Bank == gEeprom.CHANNEL_BANK)
+        return;
+
+    StashExclusions(gEeprom.CHANNEL_BANK);
+    gEeprom.CHANNEL_BANK = Bank;
+
+    FLASHLOG_ReadBuffer(SETTINGS_ChannelAttributesAddress(0), gMR_ChannelAttributes, MR_CHANNEL_LAST + 1);
+    FixChannelAttributes();
+    RestoreExclusions(Bank);
+
+    SETTINGS_InvalidateChannelIndex();
+}
+
+void SETTINGS_SelectChannelBank(uint8_t Bank)
+{
+    uint8_t Data[8];
+
+    if (Bank >= CHANNEL_BANK_COUNT)
+        return;
+
+    SETTINGS_ViewChannelBank(Bank);
+
+    // 1FF8
+    FLASHLOG_ReadBuffer(0x00c008, Data, sizeof(Data));
+    if (Data[0] != Bank)
+    {
+        Data[0] = Bank;
+        FLASHLOG_WriteBuffer(0x00c008, Data, sizeof(Data), false);
+    }
+}
+#endif
+
+#ifdef ENABLE_CHANNEL_INDEX
+// RAM copy of what the memory channel lookups need, so redraws and the
+// spectrum view don't go to the flash: every channel's RX frequency, the
+// channels ordered by frequency, and which channels have a name. Built on
+// first use after SETTINGS_InvalidateChannelIndex(), patched by the channel
+// save functions. The names themselves are read on demand and the last few
+// kept, enough for both VFOs and the spectrum peak table.
+#define INDEX_CHANNELS      (MR_CHANNEL_LAST + 1)
+#define INDEX_BATCH         16      // channels read from flash at once
+#define NAME_CACHE          8
+
+static uint32_t gChannelFrequency[INDEX_CHANNELS];
+static uint8_t  gChannelByFrequency[INDEX_CHANNELS];
+static uint32_t gChannelNamed[(INDEX_CHANNELS + 31) / 32];
+static bool     gChannelLookupValid;
+
+static struct
+{
+    uint8_t Channel;        // 0xFF: free
+    char    Name[11];
+} gNameCache[NAME_CACHE];
+static uint8_t  gNameCacheNext;
+
+static void SetChannelNamed(uint8_t Channel, const char *pName)
+{
+    if (pName[0] != 0)
+        gChannelNamed[Channel / 32] |= 1u << (Channel % 32);
+    else
+        gChannelNamed[Channel / 32] &= ~(1u << (Channel % 32));
+}
+
+static void ForgetChannelName(uint8_t Channel)
+{
+    for (unsigned int i = 0; i < NAME_CACHE; i++)
+        if (gNameCache[i].Channel == Channel)
+            gNameCache[i].Channel = 0xFF;
+}
+
+// Moves the channel to its place in gChannelByFrequency, ties in channel order
+static void SortChannel(unsigned int Pos)
+{
+    const uint8_t  Channel   = gChannelByFrequency[Pos];
+    const uint32_t Frequency = gChannelFrequency[Channel];
+
+    while (Pos > 0)
+    {
+        const uint8_t Prev = gChannelByFrequency[Pos - 1];
+        if (gChannelFrequency[Prev] < Frequency || (gChannelFrequency[Prev] == Frequency && Prev < Channel))
+            break;
+        gChannelByFrequency[Pos] = Prev;
+        Pos--;
+    }
+
+    while (Pos + 1 < INDEX_CHANNELS)
+    {
+        const uint8_t Next = gChannelByFrequency[Pos + 1];
+        if (gChannelFrequency[Next] > Frequency || (gChannelFrequency[Next] == Frequency && Next > Channel))
+            break;
+        gChannelByFrequency[Pos] = Next;
+        Pos++;
+    }
+
+    gChannelByFrequency[Pos] = Channel;
+}
+
+static void BuildChannelLookup(void)
+{
+    uint8_t Buf[INDEX_BATCH][16];
+
+    for (unsigned int First = 0; First < INDEX_CHANNELS; First += INDEX_BATCH)
+    {
+        const unsigned int Count = MIN(INDEX_BATCH, INDEX_CHANNELS - First);
+
+        FLASHLOG_ReadBuffer(SETTINGS_ChannelAddress(First), Buf, Count * 16);
+        for (unsigned int i = 0; i < Count; i++)
+            memcpy(&gChannelFrequency[First + i], Buf[i], 4);
+
+        // 0x0F50
+        FLASHLOG_ReadBuffer(SETTINGS_ChannelNameAddress(First), Buf, Count * 16);
+        for (unsigned int i = 0; i < Count; i++)
+        {
+            char *pName = (char *)Buf[i];
+            SanitizeName(pName);
+            SetChannelNamed(First + i, pName);
+        }
+    }
+
+    for (unsigned int i = 0; i < INDEX_CHANNELS; i++)
+    {
+        gChannelByFrequency[i] = i;
+        SortChannel(i);
+    }
+
+    memset(gNameCache, 0xFF, sizeof(gNameCache));
+    gChannelLookupValid = true;
+}
+
+static void CheckChannelLookup(void)
+{
+    if (!gChannelLookupValid)
+        BuildChannelLookup();
+}
+
+static void UpdateChannelFrequency(uint8_t Channel, uint32_t Frequency)
+{
+    if (!gChannelLookupValid || !IS_MR_CHANNEL(Channel))
+        return;
+
+    gChannelFrequency[Channel] = Frequency;
+
+    for (unsigned int Pos = 0; Pos < INDEX_CHANNELS; Pos++)
+    {
+        if (gChannelByFrequency[Pos] == Channel)
+        {
+            SortChannel(Pos);
+            break;
+        }
+    }
+}
+
+void SETTINGS_InvalidateChannelIndex(void)
+{
+    gChannelLookupValid = false;
+}
+#endif
+
 uint32_t SETTINGS_FetchChannelFrequency(const int channel)
 {
+#ifdef ENABLE_CHANNEL_INDEX
+    if (channel >= 0 && IS_MR_CHANNEL(channel))
+    {
+        CheckChannelLookup();
+        return gChannelFrequency[channel];
+    }
+#endif
+
     struct
     {
         uint32_t frequency;
         uint32_t offset;
     } __attribute__((packed)) info;
 
-    PY25Q16_ReadBuffer(channel * 16, &info, sizeof(info));
+    FLASHLOG_ReadBuffer(SETTINGS_ChannelAddress(channel), &info, sizeof(info));
 
     return info.frequency;
 }
@@ -487,44 +787,88 @@ void SETTINGS_FetchChannelName(char *s, const int channel)
     if (!RADIO_CheckValidChannel(channel, false, 0))
         return;
 
+#ifdef ENABLE_CHANNEL_INDEX
+    CheckChannelLookup();
+    if (!(gChannelNamed[channel / 32] & (1u << (channel % 32))))
+        return;                   // no name, nothing to read
+
+    for (unsigned int i = 0; i < NAME_CACHE; i++)
+    {
+        if (gNameCache[i].Channel == channel)
+        {
+            strcpy(s, gNameCache[i].Name);
+            return;
+        }
+    }
+#endif
+
     // 0x0F50
-    PY25Q16_ReadBuffer(0x00e000 + (channel * 16), s, 10);
+    FLASHLOG_ReadBuffer(SETTINGS_ChannelNameAddress(channel), s, 10);
 
-    int i;
-    for (i = 0; i < 10; i++)
-        if (s[i] < 32 || s[i] > 127)
-            break;                // invalid char
+    SanitizeName(s);
 
-    s[i--] = 0;                   // null term
+#ifdef ENABLE_CHANNEL_INDEX
+    gNameCache[gNameCacheNext].Channel = channel;
+    strcpy(gNameCache[gNameCacheNext].Name, s);
+    gNameCacheNext = (gNameCacheNext + 1) % NAME_CACHE;
+#endif
+}
 
-    while (i >= 0 && s[i] == 32)  // trim trailing spaces
-        s[i--] = 0;               // null term
+int SETTINGS_FindChannelByFrequency(uint32_t Frequency)
+{
+#ifdef ENABLE_CHANNEL_INDEX
+    CheckChannelLookup();
+
+    // First entry at or above Frequency
+    unsigned int Low  = 0;
+    unsigned int High = INDEX_CHANNELS;
+    while (Low < High)
+    {
+        const unsigned int Mid = (Low + High) / 2;
+        if (gChannelFrequency[gChannelByFrequency[Mid]] < Frequency)
+            Low = Mid + 1;
+        else
+            High = Mid;
+    }
+
+    for (; Low < INDEX_CHANNELS && gChannelFrequency[gChannelByFrequency[Low]] == Frequency; Low++)
+        if (RADIO_CheckValidChannel(gChannelByFrequency[Low], false, 0))
+            return gChannelByFrequency[Low];
+#else
+    for (int i = MR_CHANNEL_FIRST; IS_MR_CHANNEL(i); i++)
+        if (RADIO_CheckValidChannel(i, false, 0) && SETTINGS_FetchChannelFrequency(i) == Frequency)
+            return i;
+#endif
+
+    return -1;
 }
 
 void SETTINGS_FactoryReset(bool bIsAll)
 {
+    SETTINGS_InvalidateChannelIndex();
+
     // 0000 - 0c80
-    PY25Q16_SectorErase(0);
+    FLASHLOG_SectorErase(0);
     // 0c80 - 0d60
-    PY25Q16_SectorErase(0x001000);
+    FLASHLOG_SectorErase(0x001000);
     // 0d60 - 0e30
     if (bIsAll)
     {
-        PY25Q16_SectorErase(0x002000);
+        FLASHLOG_SectorErase(0x002000);
     }
     // 0e40 - 0e68
     if (bIsAll)
     {
-        PY25Q16_SectorErase(0x003000);
+        FLASHLOG_SectorErase(0x003000);
     }
     // 0e70 - 0e80
-    PY25Q16_SectorErase(0x004000);
+    FLASHLOG_SectorErase(0x004000);
     // 0e80 - 0e88
-    PY25Q16_SectorErase(0x005000);
+    FLASHLOG_SectorErase(0x005000);
     // 0e88 - 0e90
     if (bIsAll)
     {
-        PY25Q16_SectorErase(0x006000);
+        FLASHLOG_SectorErase(0x006000);
     }
     // 0e90 - 0ee0
     do
@@ -532,26 +876,35 @@ void SETTINGS_FactoryReset(bool bIsAll)
         uint8_t Buf[0x50];
         memset(Buf, 0xff, 0x50);
         // 0EA0 - 0EA8 : keep
-        PY25Q16_ReadBuffer(0x007000 + 0x10, Buf + 0x10, 8);
+        FLASHLOG_ReadBuffer(0x007000 + 0x10, Buf + 0x10, 8);
         // 0EB0 - 0ED0 : keep
-        PY25Q16_ReadBuffer(0x007000 + 0x20, Buf + 0x20, 0x20);
-        PY25Q16_WriteBuffer(0x007000, Buf, 0x50, true);
+        FLASHLOG_ReadBuffer(0x007000 + 0x20, Buf + 0x20, 0x20);
+        FLASHLOG_WriteBuffer(0x007000, Buf, 0x50, true);
     } while (0);
     // 0ee0 - 0f18 : keep
     // 0f18 - 0f20
     if (bIsAll)
     {
-        PY25Q16_SectorErase(0x009000);
+        FLASHLOG_SectorErase(0x009000);
     }
     // 0f30 - 0f40 : keep
     // 0f40 - 0f48 : keep
     // 0f50 - 1bd0
     if (bIsAll)
     {
-        PY25Q16_SectorErase(0x00e000);
+        FLASHLOG_SectorErase(0x00e000);
     }
     // 1c00 - 1d00 : keep
 
+#ifdef ENABLE_CHANNEL_BANKS
+    if (bIsAll)
+    {
+        for (uint32_t Address = CHANNEL_BANK_BASE; Address < CHANNEL_BANK_BASE + (CHANNEL_BANK_COUNT - 1) * CHANNEL_BANK_SIZE; Address += 0x1000)
+            FLASHLOG_SectorErase(Address);
+        SETTINGS_SelectChannelBank(0);
+    }
+#endif
+
     if (bIsAll)
     {
         RADIO_InitInfo(gRxVfo, FREQ_CHANNEL_FIRST + BAND6_400MHz, 43350000);
@@ -569,7 +922,7 @@ void SETTINGS_FactoryReset(bool bIsAll)
         #endif
 
         #ifdef ENABLE_FEAT_N7SIX
-            PY25Q16_SectorErase(0x00c000);
+            FLASHLOG_SectorErase(0x00c000);
         #endif
     }
 
@@ -579,12 +932,12 @@ void SETTINGS_FactoryReset(bool bIsAll)
             uint8_t buf[0x10];
 
             // Bloc 0x0E70..0x0E7F -> offset 0x004000
-            PY25Q16_ReadBuffer(0x004000, buf, sizeof(buf));
+            FLASHLOG_ReadBuffer(0x004000, buf, sizeof(buf));
 
             // bit 1 = MENU_LOCK => on le force à 0
             buf[4] &= (uint8_t)~0x02;
 
-            PY25Q16_WriteBuffer(0x004000, buf, sizeof(buf), true);
+            FLASHLOG_WriteBuffer(0x004000, buf, sizeof(buf), true);
 
             // cohérence RAM
             gEeprom.MENU_LOCK = 0;
@@ -613,10 +966,10 @@ void SETTINGS_SaveFM(void)
         fmCfg.band     = gEeprom.FM_Band;
         // fmCfg.space    = gEeprom.FM_Space;
         // 0E88
-        PY25Q16_WriteBuffer(0x006000, fmCfg.__raw, 8, true);
+        FLASHLOG_WriteBuffer(0x006000, fmCfg.__raw, 8, true);
 
         // 0E40
-        PY25Q16_WriteBuffer(0x003000, gFM_Channels, sizeof(gFM_Channels), true);
+        FLASHLOG_WriteBuffer(0x003000, gFM_Channels, sizeof(gFM_Channels), true);
     }
 #endif
 
@@ -626,7 +979,7 @@ void SETTINGS_SaveVfoIndices(void)
 
     #ifndef ENABLE_NOAA
         // 0x0E80
-        PY25Q16_ReadBuffer(0x005000, State, sizeof(State));
+        FLASHLOG_ReadBuffer(0x005000, State, sizeof(State));
     #endif
 
     State[0] = gEeprom.ScreenChannel[0];
@@ -641,7 +994,7 @@ void SETTINGS_SaveVfoIndices(void)
     #endif
 
     // 0x0E80
-    PY25Q16_WriteBuffer(0x005000, State, 8, true);
+    FLASHLOG_WriteBuffer(0x005000, State, 8, true);
 }
 
 void SETTINGS_SaveSettings(void)
@@ -719,13 +1072,13 @@ void SETTINGS_SaveSettings(void)
         State[7] = gEeprom.VFO_OPEN;
     #endif
 
-    PY25Q16_WriteBuffer(0x004000, SecBuf, 0x10, true);
+    FLASHLOG_WriteBuffer(0x004000, SecBuf, 0x10, true);
 
     // -------------------------
     //  0e90 - 0ee0
 
     // memset(SecBuf, 0xff, 0x50);
-    PY25Q16_ReadBuffer(0x007000, SecBuf, 0x50);
+    FLASHLOG_ReadBuffer(0x007000, SecBuf, 0x50);
 
     // 0x0E90
     State = SecBuf;
@@ -766,6 +1119,11 @@ void SETTINGS_SaveSettings(void)
     State[2] = gEeprom.REPEATER_TAIL_TONE_ELIMINATION;
     State[3] = gEeprom.TX_VFO;
     State[4] = gEeprom.BATTERY_TYPE;
+#ifdef ENABLE_SCAN_ADAPTIVE_DWELL
+    State[5] = gEeprom.SCAN_EARLY_RSSI;
+    State[6] = gEeprom.SCAN_EARLY_NOISE;
+    State[7] = gEeprom.SCAN_EARLY_GLITCH;
+#endif
 
     // 0x0ED0
     State = SecBuf + 0x40;
@@ -788,7 +1146,7 @@ void SETTINGS_SaveSettings(void)
     State[2] = gEeprom.PERMIT_REMOTE_KILL;
 #endif
 
-    PY25Q16_WriteBuffer(0x007000, SecBuf, 0x50, true);
+    FLASHLOG_WriteBuffer(0x007000, SecBuf, 0x50, true);
 
     // -------------------------
     // 0f18 - 0f20
@@ -816,7 +1174,7 @@ void SETTINGS_SaveSettings(void)
     State[6] = gEeprom.SCANLIST_PRIORITY_CH1[2];
     State[7] = gEeprom.SCANLIST_PRIORITY_CH2[2];
 
-    PY25Q16_WriteBuffer(0x009000, SecBuf, 8, true);
+    FLASHLOG_WriteBuffer(0x009000, SecBuf, 8, true);
 
     // ---------------------
     // 0f40 - 0f48
@@ -856,7 +1214,7 @@ void SETTINGS_SaveSettings(void)
     #endif
     State[7] = (State[7] & ~(3u << 6)) | ((gSetting_backlight_on_tx_rx & 3u) << 6);
 
-    PY25Q16_WriteBuffer(0x00b000, SecBuf, 8, true);
+    FLASHLOG_WriteBuffer(0x00b000, SecBuf, 8, true);
 
     // ------------------
 
@@ -864,7 +1222,7 @@ void SETTINGS_SaveSettings(void)
     // 0x1FF0
     State = SecBuf;
     // TODO: TBD
-    PY25Q16_ReadBuffer(0x00c000, State, 8);
+    FLASHLOG_ReadBuffer(0x00c000, State, 8);
 
     //memset(State, 0xFF, sizeof(State));
 
@@ -905,7 +1263,7 @@ void SETTINGS_SaveSettings(void)
 
     gEeprom.KEY_LOCK_PTT = gSetting_set_lck;
 
-    PY25Q16_WriteBuffer(0x00c000, SecBuf, 8, true);
+    FLASHLOG_WriteBuffer(0x00c000, SecBuf, 8, false);
 #endif
 
 #ifdef ENABLE_FEAT_N7SIX_VOL
@@ -920,8 +1278,10 @@ void SETTINGS_SaveChannel(uint8_t Channel, uint8_t VFO, const VFO_Info_t *pVFO,
         return;
 #endif
 
+    RADIO_InvalidateChannelProfile(Channel);
+
     // 0
-    uint16_t OffsetVFO = 0 + Channel * 16;
+    uint32_t OffsetVFO = SETTINGS_ChannelAddress(Channel);
 
     if (IS_FREQ_CHANNEL(Channel)) { // it's a VFO, not a channel
         // 0x0C80
@@ -966,7 +1326,10 @@ void SETTINGS_SaveChannel(uint8_t Channel, uint8_t VFO, const VFO_Info_t *pVFO,
         State -> _8[7] =  pVFO->SCRAMBLING_TYPE;
 #endif
 
-        PY25Q16_WriteBuffer(OffsetVFO, Buf, 0x10, false);
+        FLASHLOG_WriteBuffer(OffsetVFO, Buf, 0x10, false);
+#ifdef ENABLE_CHANNEL_INDEX
+        UpdateChannelFrequency(Channel, pVFO->freq_config_RX.Frequency);
+#endif
 
         SETTINGS_UpdateChannel(Channel, pVFO, true, true, true);
 
@@ -987,16 +1350,26 @@ void SETTINGS_SaveChannel(uint8_t Channel, uint8_t VFO, const VFO_Info_t *pVFO,
 void SETTINGS_SaveBatteryCalibration(const uint16_t * batteryCalibration)
 {
     // 0x1F40
-    PY25Q16_WriteBuffer(0x010000 + 0x140, batteryCalibration, 12, false);
+    FLASHLOG_WriteBuffer(0x010000 + 0x140, batteryCalibration, 12, false);
 }
 
 void SETTINGS_SaveChannelName(uint8_t channel, const char * name)
 {
-    uint16_t offset = channel * 16;
+    RADIO_InvalidateChannelProfile(channel);
+
     uint8_t buf[16] = {0};
     memcpy(buf, name, MIN(strlen(name), 10u));
     // 0x0F50
-    PY25Q16_WriteBuffer(0x00e000 + offset, buf, 0x10, false);
+    FLASHLOG_WriteBuffer(SETTINGS_ChannelNameAddress(channel), buf, 0x10, false);
+
+#ifdef ENABLE_CHANNEL_INDEX
+    if (gChannelLookupValid && IS_MR_CHANNEL(channel))
+    {
+        SanitizeName((char *)buf);
+        SetChannelNamed(channel, (char *)buf);
+        ForgetChannelName(channel);
+    }
+#endif
 }
 
 void SETTINGS_UpdateChannel(uint8_t channel, const VFO_Info_t *pVFO, bool keep, bool check, bool save)
@@ -1015,7 +1388,7 @@ void SETTINGS_UpdateChannel(uint8_t channel, const VFO_Info_t *pVFO, bool keep,
             };        // default attributes
 
         // 0x0D60
-        PY25Q16_ReadBuffer(0x002000 + channel, &state, 1);
+        FLASHLOG_ReadBuffer(SETTINGS_ChannelAttributesAddress(channel), &state, 1);
 
         if (keep) {
             att.band = pVFO->Band;
@@ -1031,16 +1404,25 @@ void SETTINGS_UpdateChannel(uint8_t channel, const VFO_Info_t *pVFO, bool keep,
 
 #ifndef ENABLE_FEAT_N7SIX
         save = true;
+#endif
+#ifdef ENABLE_CHANNEL_BANKS
+        if (save && SETTINGS_ChannelAttributesAddress(channel) >= CHANNEL_BANK_BASE)
+        {   // banks keep one byte per channel outside the settings log
+            FLASHLOG_WriteBuffer(SETTINGS_ChannelAttributesAddress(channel), &state, 1, false);
+        }
+        else
 #endif
         if(save)
         {
             uint8_t buf[224];
-            PY25Q16_ReadBuffer(0x002000, buf, sizeof(buf));
+            FLASHLOG_ReadBuffer(0x002000, buf, sizeof(buf));
             buf[channel] = state.__val;
-            PY25Q16_WriteBuffer(0x002000, buf, sizeof(buf), true);
+            FLASHLOG_WriteBuffer(0x002000, buf, sizeof(buf), true);
         }
 
         gMR_ChannelAttributes[channel] = att;
+        RADIO_InvalidateChannelProfile(channel);
+        RADIO_InvalidateChannelIndex();
 
         if (IS_MR_CHANNEL(channel)) {   // it's a memory channel
             if (!keep) {
@@ -1057,7 +1439,7 @@ void SETTINGS_WriteBuildOptions(void)
 
 #ifdef ENABLE_FEAT_N7SIX
     // 0x1FF0
-    PY25Q16_ReadBuffer(0x00c000, State, sizeof(State));
+    FLASHLOG_ReadBuffer(0x00c000, State, sizeof(State));
 #endif
     
 State[0] = 0
@@ -1110,7 +1492,7 @@ State[1] = 0
     | (1 << 6)
 #endif
 ;
-    PY25Q16_WriteBuffer(0x00c000, State, sizeof(State), true);
+    FLASHLOG_WriteBuffer(0x00c000, State, sizeof(State), false);
 }
 
 #ifdef ENABLE_FEAT_N7SIX_RESUME_STATE
@@ -1118,10 +1500,10 @@ State[1] = 0
     {
         uint8_t State[0x10];
         // 0x0E78
-        PY25Q16_ReadBuffer(0x004000, State, sizeof(State));
+        FLASHLOG_ReadBuffer(0x004000, State, sizeof(State));
         //State[11] = (gEeprom.CURRENT_STATE << 4) | (gEeprom.BATTERY_SAVE & 0x0F);
         State[15] = (gEeprom.VFO_OPEN & 0x01) | ((gEeprom.CURRENT_STATE & 0x07) << 1) | ((gEeprom.SCAN_LIST_DEFAULT & 0x07) << 4);
-        PY25Q16_WriteBuffer(0x004000, State, sizeof(State), true);
+        FLASHLOG_WriteBuffer(0x004000, State, sizeof(State), true);
     }
 #endif
 
@@ -1130,9 +1512,9 @@ State[1] = 0
     {
         uint8_t State[8];
         // 0x1F88
-        PY25Q16_ReadBuffer(0x010000 + 0x188, State, sizeof(State));
+        FLASHLOG_ReadBuffer(0x010000 + 0x188, State, sizeof(State));
         State[6] = gEeprom.VOLUME_GAIN;
-        PY25Q16_WriteBuffer(0x010000 + 0x188, State, sizeof(State), false);
+        FLASHLOG_WriteBuffer(0x010000 + 0x188, State, sizeof(State), false);
     }
 #endif
 
@@ -1147,10 +1529,15 @@ void SETTINGS_ResetTxLock(void)
     const uint32_t BatchSize = 0xc80 / SETTINGS_ResetTxLock_BATCH;
     const uint32_t BatchChCnt = BatchSize / 0x10;
 
+#ifdef ENABLE_CHANNEL_BANKS
+    for (uint8_t Bank = 0; Bank < CHANNEL_BANK_COUNT; Bank++)
+#else
+    const uint8_t Bank = 0;
+#endif
     for (uint32_t i = 0; i < SETTINGS_ResetTxLock_BATCH; i++)
     {
-        uint32_t Offset = i * BatchSize;
-        PY25Q16_ReadBuffer(0 + Offset, Buf, sizeof(Buf));
+        uint32_t Offset = SETTINGS_BankChannelAddress(Bank, 0) + i * BatchSize;
+        FLASHLOG_ReadBuffer(Offset, Buf, sizeof(Buf));
 
         uint8_t *State;
         for (uint8_t channel = 0; channel < BatchChCnt; channel++)
@@ -1160,7 +1547,7 @@ void SETTINGS_ResetTxLock(void)
             State[4] |= (1 << 6);
         }
 
-        PY25Q16_WriteBuffer(0 + Offset, Buf, sizeof(Buf), false);
+        FLASHLOG_WriteBuffer(Offset, Buf, sizeof(Buf), false);
     }
 
 #undef SETTINGS_ResetTxLock_BATCH
@@ -126,6 +126,9 @@ enum ACTION_OPT_t {
 #ifdef ENABLE_REGA
     ACTION_OPT_REGA_ALARM,
     ACTION_OPT_REGA_TEST,
+#endif
+#ifdef ENABLE_CHANNEL_BANKS
+    ACTION_OPT_CHANNEL_BANK,
 #endif
     ACTION_OPT_LEN
 };
@@ -213,6 +216,16 @@ typedef struct {
     uint8_t               BATTERY_SAVE;
     uint8_t               BACKLIGHT_TIME;
     uint8_t               SCAN_RESUME_MODE;
+#ifdef ENABLE_SCAN_ADAPTIVE_DWELL
+    // margins past the squelch open thresholds for rejecting a scan step
+    // early, EEPROM 0x0EAD..0x0EAF; values out of range load the default
+    uint8_t               SCAN_EARLY_RSSI;      // 0x0EAD, 2..80 half dB, 10
+    uint8_t               SCAN_EARLY_NOISE;     // 0x0EAE, 2..60, 6
+    uint8_t               SCAN_EARLY_GLITCH;    // 0x0EAF, 5..200, 20
+#endif
+#ifdef ENABLE_CHANNEL_BANKS
+    uint8_t               CHANNEL_BANK;     // bank the memory channels are read from
+#endif
     uint8_t               SCAN_LIST_DEFAULT;
     bool                  SCAN_LIST_ENABLED[3];
     uint8_t               SCANLIST_PRIORITY_CH1[3];
@@ -310,6 +323,46 @@ void     SETTINGS_InitEEPROM(void);
 void     SETTINGS_LoadCalibration(void);
 uint32_t SETTINGS_FetchChannelFrequency(const int channel);
 void     SETTINGS_FetchChannelName(char *s, const int channel);
+// Lowest valid memory channel on Frequency, -1 if none
+int      SETTINGS_FindChannelByFrequency(uint32_t Frequency);
+// Flash addresses of a memory channel's 16-byte record and name, and of a
+// channel's attribute byte. With ENABLE_CHANNEL_BANKS the memory channels
+// are a window onto one bank: bank 0 is the legacy layout that the CPS
+// sees, the others live past the calibration area, one 8 KB block each,
+// records at +0x0000, attributes at +0x0D00 and names at +0x1000.
+#ifdef ENABLE_CHANNEL_BANKS
+    #ifndef CHANNEL_BANK_COUNT
+        #define CHANNEL_BANK_COUNT  5
+    #endif
+    #define CHANNEL_BANK_BASE       0x020000
+    #define CHANNEL_BANK_SIZE       0x2000
+
+    uint32_t SETTINGS_ChannelAddress(uint8_t Channel);
+    uint32_t SETTINGS_ChannelNameAddress(uint8_t Channel);
+    uint32_t SETTINGS_ChannelAttributesAddress(uint8_t Channel);
+    // The same in a given bank rather than the one in view
+    uint32_t SETTINGS_BankChannelAddress(uint8_t Bank, uint8_t Channel);
+    uint32_t SETTINGS_BankAttributesAddress(uint8_t Bank, uint8_t Channel);
+    // Switches the memory channels to Bank for now, as a scan crossing banks
+    // does; each bank keeps its own channel exclusions
+    void     SETTINGS_ViewChannelBank(uint8_t Bank);
+    // Excluded channels of Bank, one bit each, as of when it was last in view
+    const uint32_t *SETTINGS_GetBankExclusions(uint8_t Bank);
+    // Switches the memory channels to Bank and remembers it across reboots
+    void     SETTINGS_SelectChannelBank(uint8_t Bank);
+#else
+    #define SETTINGS_BankChannelAddress(Bank, Channel)  ((void)(Bank), (uint32_t)(Channel) * 16)
+    #define SETTINGS_ChannelAddress(Channel)            ((uint32_t)(Channel) * 16)
+    #define SETTINGS_ChannelNameAddress(Channel)        (0x00e000 + (uint32_t)(Channel) * 16)
+    #define SETTINGS_ChannelAttributesAddress(Channel)  (0x002000 + (uint32_t)(Channel))
+#endif
+
+#ifdef ENABLE_CHANNEL_INDEX
+    // Call after writing channel data or names behind the save functions' back
+    void SETTINGS_InvalidateChannelIndex(void);
+#else
+    #define SETTINGS_InvalidateChannelIndex() do {} while (0)
+#endif
 void     SETTINGS_FactoryReset(bool bIsAll);
 #ifdef ENABLE_FMRADIO
     void SETTINGS_SaveFM(void);
@@ -22,6 +22,7 @@
 #include "ui/helper.h"
 #include "ui/inputbox.h"
 #include "misc.h"
+#include "settings.h"
 
 #ifndef ARRAY_SIZE
     #define ARRAY_SIZE(arr) (sizeof(arr)/sizeof((arr)[0]))
@@ -44,6 +45,15 @@ void UI_GenerateChannelString(char *pString, const uint8_t Channel)
         pString[i + 3] = (gInputBox[i] == 10) ? '-' : gInputBox[i] + '0';
 }
 
+unsigned int UI_ChannelNumber(const uint8_t Channel)
+{
+#ifdef ENABLE_CHANNEL_BANKS
+    return gEeprom.CHANNEL_BANK * (MR_CHANNEL_LAST + 1) + Channel + 1;
+#else
+    return Channel + 1;
+#endif
+}
+
 void UI_GenerateChannelStringEx(char *pString, const bool bShowPrefix, const uint8_t ChannelNumber)
 {
     if (gInputBoxIndex > 0) {
@@ -57,7 +67,7 @@ void UI_GenerateChannelStringEx(char *pString, const bool bShowPrefix, const uin
 
     if (bShowPrefix) {
         // BUG here? Prefixed NULLs are allowed
-        sprintf(pString, "CH-%03u", ChannelNumber + 1);
+        sprintf(pString, "CH-%03u", UI_ChannelNumber(ChannelNumber));
     } else if (ChannelNumber == 0xFF) {
         strcpy(pString, "NULL");
     } else {
@@ -21,6 +21,8 @@
 #include <stdint.h>
 
 void UI_GenerateChannelString(char *pString, const uint8_t Channel);
+// Number shown for a memory channel, counting on through the channel banks
+unsigned int UI_ChannelNumber(const uint8_t Channel);
 void UI_GenerateChannelStringEx(char *pString, const bool bShowPrefix, const uint8_t ChannelNumber);
 void UI_PrintString(const char *pString, uint8_t Start, uint8_t End, uint8_t Line, uint8_t Width);
 void UI_PrintStringSmallNormal(const char *pString, uint8_t Start, uint8_t End, uint8_t Line);
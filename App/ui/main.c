@@ -233,7 +233,7 @@ void UI_DisplayAudioBar(void)
         DrawLevelBar(2, line, barsOld, 25);
 
         if (gCurrentFunction == FUNCTION_TRANSMIT)
-            ST7565_BlitFullScreen();
+            GUI_BlitLine(line);
     }
 }
 #endif
@@ -284,7 +284,7 @@ void DisplayRSSIBar(const bool now)
             }
             RxBlink = 1;
         }
-        ST7565_BlitLine(RxLine);
+        GUI_BlitLine(RxLine);
     }
 #else
     const unsigned int line = 3;
@@ -394,7 +394,7 @@ void DisplayRSSIBar(const bool now)
 #endif
     DrawLevelBar(bar_x, line, s_level + overS9Bars, 13);
     if (now)
-        ST7565_BlitLine(line);
+        GUI_BlitLine(line);
 #else
     int16_t rssi = BK4819_GetRSSI();
     uint8_t Level;
@@ -416,7 +416,7 @@ void DisplayRSSIBar(const bool now)
         memset(pLine, 0, 23);
     DrawSmallAntennaAndBars(pLine, Level);
     if (now)
-        ST7565_BlitFullScreen();
+        GUI_BlitLine((gEeprom.RX_VFO == 0) ? 2 : 6);
 #endif
 
 }
@@ -456,7 +456,7 @@ void UI_MAIN_PrintAGC(bool now)
     sprintf(buf, "%d%2d %2d %2d %3d", reg7e.agcEnab, reg7e.gainIdx, -agcGain, reg7e.agcSigStrength, BK4819_GetRSSI());
     UI_PrintStringSmallNormal(buf, 2, 0, 3);
     if(now)
-        ST7565_BlitLine(3);
+        GUI_BlitLine(3);
 }
 #endif
 
@@ -958,7 +958,7 @@ void UI_DisplayMain(void)
                         break;
 
                     case MDF_CHANNEL:   // show the channel number
-                        sprintf(String, "CH-%03u", gEeprom.ScreenChannel[vfo_num] + 1);
+                        sprintf(String, "CH-%03u", UI_ChannelNumber(gEeprom.ScreenChannel[vfo_num]));
                         UI_PrintString(String, 32, 0, line, 8);
                         break;
 
@@ -968,7 +968,7 @@ void UI_DisplayMain(void)
                         SETTINGS_FetchChannelName(String, gEeprom.ScreenChannel[vfo_num]);
                         if (String[0] == 0)
                         {   // no channel name, show the channel number instead
-                            sprintf(String, "CH-%03u", gEeprom.ScreenChannel[vfo_num] + 1);
+                            sprintf(String, "CH-%03u", UI_ChannelNumber(gEeprom.ScreenChannel[vfo_num]));
                         }
 
                         if (gEeprom.CHANNEL_DISPLAY_MODE == MDF_NAME) {
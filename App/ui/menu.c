@@ -476,6 +476,9 @@ const t_sidefunction gSubMenu_SIDEFUNCTIONS[] =
         {"REMOVE\nOFFSET",  ACTION_OPT_REMOVE_OFFSET},
     #endif
 #endif
+#ifdef ENABLE_CHANNEL_BANKS
+    {"CHANNEL\nBANK",   ACTION_OPT_CHANNEL_BANK},
+#endif
 };
 
 const uint8_t gSubMenu_SIDEFUNCTIONS_size = ARRAY_SIZE(gSubMenu_SIDEFUNCTIONS);
@@ -23,6 +23,7 @@
     #include "app/fm.h"
 #endif
 #include "driver/keyboard.h"
+#include "driver/st7565.h"
 #include "misc.h"
 #ifdef ENABLE_AIRCOPY
     #include "ui/aircopy.h"
@@ -37,6 +38,7 @@
 #include "ui/main.h"
 #include "ui/menu.h"
 #include "ui/scanner.h"
+#include "ui/status.h"
 #include "ui/ui.h"
 #include "../misc.h"
 
@@ -75,6 +77,60 @@ void GUI_DisplayScreen(void)
     }
 }
 
+#ifdef ENABLE_FRAME_GOVERNOR
+static uint8_t           gPendingLines;
+static GUI_RenderStats_t gRenderStats;
+
+void GUI_BlitLine(unsigned Line)
+{
+    if (Line < FRAME_LINES)
+        gPendingLines |= 1u << Line;
+}
+
+bool GUI_Render(void)
+{
+    const bool Display = gUpdateDisplay;
+    const bool Status  = gUpdateStatus;
+
+    if (!Display && !Status && !gPendingLines)
+        return false;
+
+    gRenderStats.Requested++;
+
+    // Anything asked for meanwhile is folded into the next frame
+    if (gGuiFrameCountdown_10ms > 0)
+        return false;
+
+    gGuiFrameCountdown_10ms = gui_frame_period_10ms;
+    gRenderStats.Rendered++;
+
+    if (Display) {
+        gUpdateDisplay = false;
+        GUI_DisplayScreen();
+    }
+
+    if (Status)
+        UI_DisplayStatus();
+
+    if (Display) {
+        gPendingLines = 0;      // went out with the full screen
+    } else if (gPendingLines) {
+        gRenderStats.Partial++;
+        for (unsigned Line = 0; Line < FRAME_LINES; Line++)
+            if (gPendingLines & (1u << Line))
+                ST7565_BlitLine(Line);
+        gPendingLines = 0;
+    }
+
+    return Display || Status;
+}
+
+const GUI_RenderStats_t *GUI_GetRenderStats(void)
+{
+    return &gRenderStats;
+}
+#endif
+
 void GUI_SelectNextDisplay(GUI_DisplayType_t Display)
 {
     if (Display == DISPLAY_INVALID)
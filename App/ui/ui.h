@@ -54,4 +54,24 @@ extern bool              gAskToDelete;
 void GUI_DisplayScreen(void);
 void GUI_SelectNextDisplay(GUI_DisplayType_t Display);
 
+#ifdef ENABLE_FRAME_GOVERNOR
+    // Redraws requested through gUpdateDisplay, gUpdateStatus and GUI_BlitLine()
+    // are composed by GUI_Render() at most once per gui_frame_period_10ms.
+    typedef struct
+    {
+        uint32_t Requested;     // 10 ms slices that found a redraw pending
+        uint32_t Rendered;      // frames composed
+        uint32_t Partial;       // frames that only blitted widget lines
+    } GUI_RenderStats_t;
+
+    // Widgets that redrew a frame line on their own queue it for the next frame
+    void GUI_BlitLine(unsigned Line);
+    // Returns true when the screen or the status line was rendered
+    bool GUI_Render(void);
+    const GUI_RenderStats_t *GUI_GetRenderStats(void);
+#else
+    #include "driver/st7565.h"
+    #define GUI_BlitLine ST7565_BlitLine
+#endif
+
 #endif
@@ -16,7 +16,7 @@
 
 #include <string.h>
 
-#include "driver/py25q16.h"
+#include "driver/flashlog.h"
 #include "driver/st7565.h"
 #include "external/printf/printf.h"
 #include "helper/battery.h"
@@ -76,9 +76,9 @@ void UI_DisplayWelcome(void)
         memset(WelcomeString1, 0, sizeof(WelcomeString1));
 
         // 0x0EB0
-        PY25Q16_ReadBuffer(0x007020, WelcomeString0, 16);
+        FLASHLOG_ReadBuffer(0x007020, WelcomeString0, 16);
         // 0x0EC0
-        PY25Q16_ReadBuffer(0x007030, WelcomeString1, 16);
+        FLASHLOG_ReadBuffer(0x007030, WelcomeString1, 16);
 
         sprintf(WelcomeString2, "%u.%02uV %u%%",
                 gBatteryVoltageAverage / 100,
@@ -86,6 +86,8 @@
 
 #define USBD_IRQHandler USB_IRQHandler
 
+#include <stdbool.h>
+
 typedef struct
 {
     uint8_t *buf;
@@ -96,5 +98,7 @@ typedef struct
 void cdc_acm_init(cdc_acm_rx_buf_t rx_buf);
 void cdc_acm_data_send_with_dtr(const uint8_t *buf, uint32_t size);
 void cdc_acm_data_send_with_dtr_async(const uint8_t *buf, uint32_t size);
+// An IN transfer is still in flight to a PC that has the port open
+bool cdc_acm_tx_busy(void);
 
 #endif
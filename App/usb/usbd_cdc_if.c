@@ -181,6 +181,9 @@ void usbd_cdc_acm_set_dtr(uint8_t intf, bool dtr)
         dtr_enable = 1;
     } else {
         dtr_enable = 0;
+        // The PC closed the port, an IN transfer it never read must not
+        // keep the next sender waiting
+        ep_tx_busy_flag = false;
     }
 }
 
@@ -199,6 +202,12 @@ void cdc_acm_data_send_with_dtr_async(const uint8_t *buf, uint32_t size)
 {
     if (0 != size)
     {
+        ep_tx_busy_flag = true;
         usbd_ep_start_write(CDC_IN_EP, buf, size);
     }
 }
+
+bool cdc_acm_tx_busy(void)
+{
+    return dtr_enable && ep_tx_busy_flag;
+}
@@ -0,0 +1,61 @@
+# Feature set for the host build: the Bandscope edition from CMakePresets.json,
+# so spectrum, scan ranges, UART/USB protocol and aircopy are all compiled.
+# Anything already set on the command line or by a preset wins.
+
+set(HOST_FEATURES_ON
+    ENABLE_UART
+    ENABLE_USB
+    ENABLE_AIRCOPY
+    ENABLE_TX1750
+    ENABLE_FLASHLIGHT
+    ENABLE_SPECTRUM
+    ENABLE_BIG_FREQ
+    ENABLE_SMALL_BOLD
+    ENABLE_CUSTOM_MENU_LAYOUT
+    ENABLE_KEEP_MEM_NAME
+    ENABLE_WIDE_RX
+    ENABLE_NO_CODE_SCAN_TIMEOUT
+    ENABLE_SQUELCH_MORE_SENSITIVE
+    ENABLE_FASTER_CHANNEL_SCAN
+    ENABLE_SCAN_ADAPTIVE_DWELL
+    ENABLE_RSSI_BAR
+    ENABLE_AUDIO_BAR
+    ENABLE_COPY_CHAN_TO_VFO
+    ENABLE_SCAN_RANGES
+    ENABLE_NAVIG_LEFT_RIGHT
+    ENABLE_SETTINGS_LOG
+    ENABLE_FLASH_WRITE_BACK
+    ENABLE_CHANNEL_INDEX
+    ENABLE_CHANNEL_BANKS
+    ENABLE_LCD_ASYNC_FLUSH
+    ENABLE_FRAME_GOVERNOR
+    ENABLE_WATERFALL_SCROLLBACK
+    ENABLE_SPECTRUM_STREAM
+    ENABLE_BOOT_PROFILE
+    ENABLE_FEAT_N7SIX
+    ENABLE_FEAT_N7SIX_SCREENSHOT
+    ENABLE_FEAT_N7SIX_SPECTRUM
+    ENABLE_FEAT_N7SIX_RX_TX_TIMER
+    ENABLE_FEAT_N7SIX_SLEEP
+    ENABLE_FEAT_N7SIX_RESUME_STATE
+    ENABLE_FEAT_N7SIX_NARROWER
+    ENABLE_FEAT_N7SIX_INV
+    ENABLE_FEAT_N7SIX_CTR
+    ENABLE_FEAT_N7SIX_PMR
+    ENABLE_FEAT_N7SIX_GMRS_FRS_MURS
+    ENABLE_FEAT_N7SIX_CA
+)
+
+foreach(feature ${HOST_FEATURES_ON})
+    set(${feature} ON CACHE BOOL "")
+endforeach()
+
+if(NOT EDITION_STRING)
+    set(EDITION_STRING "Host")
+endif()
+if(NOT VERSION_STRING_1)
+    set(VERSION_STRING_1 "v0.22")
+endif()
+if(NOT VERSION_STRING_2)
+    set(VERSION_STRING_2 "v7.6.2br3")
+endif()
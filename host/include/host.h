@@ -0,0 +1,202 @@
+/* Host (x86 Linux) harness for running the firmware logic off-device.
+ *
+ * The stubs under host/stubs replace the hardware-facing drivers. Everything
+ * they model is reachable from tests through the HOST_* calls below:
+ *
+ *  - a virtual 48 MHz clock advanced by SYSTICK_DelayUs() and by modelled
+ *    peripheral cost, firing SysTick_Handler() every 10 ms;
+ *  - a GPIO latch model that decodes the BK4819 3-wire bus, so the real
+ *    driver/bk4829.c runs against a behavioural model of the chip: squelch,
+ *    CTCSS/CDCSS, frequency scan and FSK RX are derived from a scripted band
+ *    of virtual signals and reported through the status registers and
+ *    interrupt flags the firmware polls;
+ *  - a 2 MB PY25Q16 NOR image, optionally backed by a file;
+ *  - an ST7565 panel on SPI1 decoding what driver/st7565.c sends;
+ *  - a key matrix on the GPIO model read by driver/keyboard.c, fed by
+ *    scripted key presses, plus PTT and per-frequency RSSI;
+ *  - captured UART/VCP output.
+ */
+
+#ifndef HOST_H
+#define HOST_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "py32f0xx.h"
+#include "driver/keyboard.h"
+
+// ---- Virtual clock ----
+
+#define HOST_CPU_HZ             48000000u
+#define HOST_CYCLES_PER_US      (HOST_CPU_HZ / 1000000u)
+#define HOST_CYCLES_PER_TICK    480000u     // SysTick reload, 10 ms
+
+uint64_t HOST_GetCycles(void);
+uint64_t HOST_GetTimeUs(void);
+void     HOST_AdvanceCycles(uint32_t Cycles);
+void     HOST_AdvanceUs(uint32_t Us);
+
+// ---- GPIO ----
+
+// Cost of one LL_GPIO_* call, in CPU cycles (BSRR/IDR access + call overhead).
+#define HOST_GPIO_CYCLES        6u
+
+void     HOST_GPIO_SetInput(GPIO_TypeDef *Port, uint32_t PinMask, bool Level);
+uint32_t HOST_GPIO_GetOutput(GPIO_TypeDef *Port);
+void     HOST_PTT_Set(bool Pressed);
+
+// ---- BK4819 bus model ----
+
+typedef struct {
+    uint32_t Reads;
+    uint32_t Writes;
+    uint32_t RegWrites[128];
+    uint32_t RegReads[128];
+    uint32_t Retunes;       // REG_38/39 changes and RX restarts via REG_30
+    uint32_t SquelchOpens;
+    uint32_t FalseOpens;    // squelch opened with no signal in the passband
+    uint64_t LastOpenUs;    // virtual time of the last squelch open
+} HOST_BK4819_Stats_t;
+
+// Time after a retune during which RSSI ramps from the old to the new
+// frequency and the glitch indicator reads 255, with an RF filter of
+// 3.75 kHz or wider in REG_43. Narrower filters ring longer, in proportion.
+#define HOST_BK4819_SETTLE_US   1000u
+
+// Called on every register read; returns the value put on the bus.
+typedef uint16_t (*HOST_BK4819_ReadHook_t)(uint8_t Reg, uint16_t Value);
+// Called after every register write has been latched.
+typedef void (*HOST_BK4819_WriteHook_t)(uint8_t Reg, uint16_t Value);
+// Scripted RSSI source, frequency in 10 Hz units, returns the raw REG_67 value.
+typedef uint16_t (*HOST_RssiSource_t)(uint32_t Frequency);
+
+uint16_t HOST_BK4819_Peek(uint8_t Reg);
+void     HOST_BK4819_Poke(uint8_t Reg, uint16_t Value);
+uint32_t HOST_BK4819_GetFrequency(void);
+// Settle time a retune would get with the current REG_43.
+uint32_t HOST_BK4819_GetSettleUs(void);
+bool     HOST_BK4819_IsSquelchOpen(void);
+void     HOST_BK4819_SetHooks(HOST_BK4819_ReadHook_t Read, HOST_BK4819_WriteHook_t Write);
+void     HOST_BK4819_SetRssiSource(HOST_RssiSource_t Source);
+const HOST_BK4819_Stats_t *HOST_BK4819_GetStats(void);
+void     HOST_BK4819_ResetStats(void);
+
+// Bus pin edges, forwarded by the GPIO model.
+void     HOST_BK4819_BusCs(bool Level);
+void     HOST_BK4819_BusScl(bool Level);
+void     HOST_BK4819_BusSdaOut(bool Level);
+bool     HOST_BK4819_BusSdaIn(void);
+
+// ---- Virtual band ----
+
+typedef enum {
+    HOST_CSS_NONE,
+    HOST_CSS_CTCSS,
+    HOST_CSS_CDCSS,
+} HOST_Css_t;
+
+typedef struct {
+    uint32_t        Frequency;  // 10 Hz units
+    uint32_t        Width;      // occupied bandwidth, 10 Hz units, 0 = 12.5 kHz
+    int16_t         Level;      // dBm at the antenna
+    uint32_t        OnMs;       // keyed from this virtual time...
+    uint32_t        OffMs;      // ...until this one, 0 = forever
+    HOST_Css_t      Css;
+    uint32_t        CssCode;    // CTCSS in 0.1 Hz, CDCSS as the 24-bit code word
+    const uint16_t *Fsk;        // FSK words sent once per key-up, may be NULL
+    uint8_t         FskWords;
+} HOST_Signal_t;
+
+#define HOST_BAND_MAX_SIGNALS   32
+#define HOST_BAND_NOISE_FLOOR   (-125)  // dBm
+
+void     HOST_BAND_Clear(void);
+// Returns the signal index, -1 when the band is full.
+int      HOST_BAND_Add(const HOST_Signal_t *Signal);
+void     HOST_BAND_SetNoiseFloor(int16_t Dbm);
+int16_t  HOST_BAND_GetNoiseFloor(void);
+bool     HOST_BAND_IsKeyed(const HOST_Signal_t *Signal, uint32_t Ms);
+// Level seen by a receiver tuned to Frequency; *Signal is the strongest
+// keyed signal inside the passband, or NULL for noise / adjacent splatter.
+int16_t  HOST_BAND_Level(uint32_t Frequency, uint32_t Ms, const HOST_Signal_t **Signal);
+// Strongest keyed signal anywhere at or above MinDbm, for the frequency scan.
+const HOST_Signal_t *HOST_BAND_Strongest(uint32_t Ms, int16_t MinDbm);
+
+// ---- PY25Q16 flash model ----
+
+#define HOST_FLASH_SIZE         0x200000u
+#define HOST_FLASH_SECTOR_SIZE  0x1000u
+#define HOST_FLASH_PAGE_SIZE    0x100u
+
+typedef struct {
+    uint32_t Reads;         // read commands
+    uint32_t ReadBytes;
+    uint32_t PagePrograms;
+    uint32_t ProgramBytes;
+    uint32_t SectorErases;
+    uint16_t EraseCount[HOST_FLASH_SIZE / HOST_FLASH_SECTOR_SIZE];
+} HOST_FLASH_Stats_t;
+
+// Path == NULL keeps the image in RAM only. A missing file starts erased.
+bool     HOST_FLASH_Open(const char *Path);
+void     HOST_FLASH_Close(void);
+void     HOST_FLASH_Erase(void);
+// Pending write-back data is flushed first, edits bypass the driver cache.
+uint8_t *HOST_FLASH_Image(void);
+const HOST_FLASH_Stats_t *HOST_FLASH_GetStats(void);
+void     HOST_FLASH_ResetStats(void);
+
+// ---- ST7565 LCD model ----
+
+typedef struct {
+    uint32_t CommandBytes;
+    uint32_t DataBytes;
+    uint32_t PageWrites;    // page address commands followed by pixel data
+    uint32_t DmaTransfers;  // background transfers on SPI1
+} HOST_LCD_Stats_t;
+
+// Pixel as last sent to the panel; Y 0..7 is the status line.
+bool     HOST_LCD_GetPixel(unsigned X, unsigned Y);
+void     HOST_LCD_Dump(FILE *Out);
+const HOST_LCD_Stats_t *HOST_LCD_GetStats(void);
+void     HOST_LCD_ResetStats(void);
+
+// ---- Keyboard ----
+
+// Queue a key press starting after DelayMs, held for HoldMs.
+void     HOST_KEY_Press(KEY_Code_t Key, uint32_t DelayMs, uint32_t HoldMs);
+void     HOST_KEY_Clear(void);
+// Port B levels of the rows (PB15..PB12) and PTT (PB10) seen with the given
+// column outputs (PB6..PB3); only bits in HOST_KEY_INPUT_MASK are meaningful.
+#define HOST_KEY_INPUT_MASK     0xF400u
+uint32_t HOST_KEY_ReadInputs(uint32_t PortOutput);
+
+// ---- Serial capture ----
+
+size_t   HOST_UART_Read(uint8_t *Buf, size_t Size);
+void     HOST_UART_Inject(const uint8_t *Buf, size_t Size);
+size_t   HOST_VCP_Read(uint8_t *Buf, size_t Size);
+void     HOST_VCP_Inject(const uint8_t *Buf, size_t Size);
+// Virtual time an async VCP send keeps the IN endpoint busy, about a full
+// speed bulk pipe the PC drains every frame
+#define HOST_VCP_US_PER_BYTE    1u
+// A stalled PC stops reading, the IN endpoint stays busy until released
+void     HOST_VCP_SetStalled(bool Stalled);
+
+// ---- Harness ----
+
+// Resets every model to power-on state (flash contents are kept, writes still
+// pending in the driver's write-back cache are lost as on a power cut).
+void     HOST_Reset(void);
+// Runs the Main() boot sequence up to the main loop, without the welcome delays.
+void     HOST_Boot(void);
+// Runs the main loop for Ms of virtual time.
+void     HOST_RunMs(uint32_t Ms);
+// Writes factory-like squelch tables into the calibration area. On erased
+// flash every threshold reads 0xFF and the squelch never stays open.
+void     HOST_WriteSquelchCalibration(void);
+
+#endif
@@ -0,0 +1,27 @@
+/* Host build replacement for the PY32F071 LL bus (RCC clock gate) driver.
+ *
+ * Clock gating has no effect off-device.
+ */
+
+#ifndef HOST_PY32F071_LL_BUS_H
+#define HOST_PY32F071_LL_BUS_H
+
+#include "py32f0xx.h"
+
+#define LL_AHB1_GRP1_PERIPH_DMA1    0x00000001U
+#define LL_APB1_GRP1_PERIPH_TIM7    0x00000020U
+#define LL_APB1_GRP1_PERIPH_USBD    0x00800000U
+#define LL_APB1_GRP1_PERIPH_PWR     0x10000000U
+#define LL_APB1_GRP2_PERIPH_SYSCFG  0x00000001U
+#define LL_APB1_GRP2_PERIPH_SPI1    0x00001000U
+#define LL_IOP_GRP1_PERIPH_GPIOA    0x00000001U
+#define LL_IOP_GRP1_PERIPH_GPIOB    0x00000002U
+#define LL_IOP_GRP1_PERIPH_GPIOC    0x00000004U
+#define LL_IOP_GRP1_PERIPH_GPIOF    0x00000020U
+
+static inline void LL_AHB1_GRP1_EnableClock(uint32_t Periphs) { (void)Periphs; }
+static inline void LL_APB1_GRP1_EnableClock(uint32_t Periphs) { (void)Periphs; }
+static inline void LL_APB1_GRP2_EnableClock(uint32_t Periphs) { (void)Periphs; }
+static inline void LL_IOP_GRP1_EnableClock(uint32_t Periphs)  { (void)Periphs; }
+
+#endif
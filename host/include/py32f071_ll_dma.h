@@ -0,0 +1,46 @@
+/* Host build replacement for the PY32F071 LL DMA driver.
+ *
+ * app/uart.c polls the UART RX channel's remaining length to find the DMA
+ * write position; the UART stub drives that value. Channel 1 mapped to the
+ * SPI1 TX request is modelled by stubs/spi.c for the background LCD flush,
+ * other channels only take their configuration.
+ */
+
+#ifndef HOST_PY32F071_LL_DMA_H
+#define HOST_PY32F071_LL_DMA_H
+
+#include "py32f0xx.h"
+#include "py32f071_ll_system.h"
+
+#define LL_DMA_CHANNEL_1    0x00000001U
+#define LL_DMA_CHANNEL_2    0x00000002U
+#define LL_DMA_CHANNEL_3    0x00000003U
+#define LL_DMA_CHANNEL_4    0x00000004U
+#define LL_DMA_CHANNEL_5    0x00000005U
+#define LL_DMA_CHANNEL_6    0x00000006U
+#define LL_DMA_CHANNEL_7    0x00000007U
+
+#define LL_DMA_DIRECTION_PERIPH_TO_MEMORY   0x00000000U
+#define LL_DMA_DIRECTION_MEMORY_TO_PERIPH   0x00000010U
+#define LL_DMA_MODE_NORMAL                  0x00000000U
+#define LL_DMA_PERIPH_NOINCREMENT           0x00000000U
+#define LL_DMA_MEMORY_INCREMENT             0x00000080U
+#define LL_DMA_PDATAALIGN_BYTE              0x00000000U
+#define LL_DMA_MDATAALIGN_BYTE              0x00000000U
+#define LL_DMA_PRIORITY_LOW                 0x00000000U
+
+uint32_t LL_DMA_GetDataLength(DMA_TypeDef *DMAx, uint32_t Channel);
+
+void     LL_SYSCFG_SetDMARemap(DMA_TypeDef *DMAx, uint32_t Channel, uint32_t MapReqNum);
+void     LL_DMA_ConfigTransfer(DMA_TypeDef *DMAx, uint32_t Channel, uint32_t Configuration);
+// Addresses are full host pointers, callers cast through uintptr_t
+void     LL_DMA_SetPeriphAddress(DMA_TypeDef *DMAx, uint32_t Channel, uintptr_t PeriphAddress);
+void     LL_DMA_SetMemoryAddress(DMA_TypeDef *DMAx, uint32_t Channel, uintptr_t MemoryAddress);
+void     LL_DMA_SetDataLength(DMA_TypeDef *DMAx, uint32_t Channel, uint32_t NbData);
+void     LL_DMA_EnableChannel(DMA_TypeDef *DMAx, uint32_t Channel);
+void     LL_DMA_DisableChannel(DMA_TypeDef *DMAx, uint32_t Channel);
+void     LL_DMA_EnableIT_TC(DMA_TypeDef *DMAx, uint32_t Channel);
+uint32_t LL_DMA_IsActiveFlag_TC1(DMA_TypeDef *DMAx);
+void     LL_DMA_ClearFlag_TC1(DMA_TypeDef *DMAx);
+
+#endif
@@ -0,0 +1,80 @@
+/* Host build replacement for the PY32F071 LL GPIO driver.
+ *
+ * Pin operations are routed to stubs/gpio.c, which keeps per-port output
+ * and input latches and forwards the BK4819 bus pins to the chip model.
+ */
+
+#ifndef HOST_PY32F071_LL_GPIO_H
+#define HOST_PY32F071_LL_GPIO_H
+
+#include "py32f0xx.h"
+
+#define LL_GPIO_PIN_0       (1U << 0)
+#define LL_GPIO_PIN_1       (1U << 1)
+#define LL_GPIO_PIN_2       (1U << 2)
+#define LL_GPIO_PIN_3       (1U << 3)
+#define LL_GPIO_PIN_4       (1U << 4)
+#define LL_GPIO_PIN_5       (1U << 5)
+#define LL_GPIO_PIN_6       (1U << 6)
+#define LL_GPIO_PIN_7       (1U << 7)
+#define LL_GPIO_PIN_8       (1U << 8)
+#define LL_GPIO_PIN_9       (1U << 9)
+#define LL_GPIO_PIN_10      (1U << 10)
+#define LL_GPIO_PIN_11      (1U << 11)
+#define LL_GPIO_PIN_12      (1U << 12)
+#define LL_GPIO_PIN_13      (1U << 13)
+#define LL_GPIO_PIN_14      (1U << 14)
+#define LL_GPIO_PIN_15      (1U << 15)
+#define LL_GPIO_PIN_ALL     0x0000FFFFU
+
+#define LL_GPIO_MODE_INPUT      0x00000000U
+#define LL_GPIO_MODE_OUTPUT     0x00000001U
+#define LL_GPIO_MODE_ALTERNATE  0x00000002U
+#define LL_GPIO_MODE_ANALOG     0x00000003U
+
+#define LL_GPIO_OUTPUT_PUSHPULL         0x00000000U
+#define LL_GPIO_OUTPUT_OPENDRAIN        0x00000001U
+#define LL_GPIO_SPEED_FREQ_LOW          0x00000000U
+#define LL_GPIO_SPEED_FREQ_MEDIUM       0x00000001U
+#define LL_GPIO_SPEED_FREQ_HIGH         0x00000002U
+#define LL_GPIO_SPEED_FREQ_VERY_HIGH    0x00000003U
+#define LL_GPIO_PULL_NO                 0x00000000U
+#define LL_GPIO_PULL_UP                 0x00000001U
+#define LL_GPIO_PULL_DOWN               0x00000002U
+#define LL_GPIO_AF_0                    0x00000000U
+#define LL_GPIO_AF0_SPI1                LL_GPIO_AF_0
+
+typedef struct
+{
+    uint32_t Pin;
+    uint32_t Mode;
+    uint32_t Speed;
+    uint32_t OutputType;
+    uint32_t Pull;
+    uint32_t Alternate;
+} LL_GPIO_InitTypeDef;
+
+void     LL_GPIO_SetPinMode(GPIO_TypeDef *GPIOx, uint32_t Pin, uint32_t Mode);
+void     LL_GPIO_SetOutputPin(GPIO_TypeDef *GPIOx, uint32_t PinMask);
+void     LL_GPIO_ResetOutputPin(GPIO_TypeDef *GPIOx, uint32_t PinMask);
+void     LL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint32_t PinMask);
+uint32_t LL_GPIO_IsInputPinSet(GPIO_TypeDef *GPIOx, uint32_t PinMask);
+uint32_t LL_GPIO_ReadInputPort(GPIO_TypeDef *GPIOx);
+
+static inline void LL_GPIO_StructInit(LL_GPIO_InitTypeDef *GPIO_InitStruct)
+{
+    GPIO_InitStruct->Pin        = LL_GPIO_PIN_ALL;
+    GPIO_InitStruct->Mode       = LL_GPIO_MODE_ANALOG;
+    GPIO_InitStruct->Speed      = LL_GPIO_SPEED_FREQ_LOW;
+    GPIO_InitStruct->OutputType = LL_GPIO_OUTPUT_PUSHPULL;
+    GPIO_InitStruct->Pull       = LL_GPIO_PULL_NO;
+    GPIO_InitStruct->Alternate  = LL_GPIO_AF_0;
+}
+
+static inline uint32_t LL_GPIO_Init(GPIO_TypeDef *GPIOx, LL_GPIO_InitTypeDef *GPIO_InitStruct)
+{
+    LL_GPIO_SetPinMode(GPIOx, GPIO_InitStruct->Pin, GPIO_InitStruct->Mode);
+    return 0;
+}
+
+#endif
@@ -0,0 +1,78 @@
+/* Host build replacement for the PY32F071 LL SPI driver.
+ *
+ * SPI1 is wired to the ST7565 panel model in stubs/spi.c. Polled transfers
+ * complete instantly but advance the virtual clock by one byte time at the
+ * configured prescaler; DMA transfers finish in the background, see
+ * py32f071_ll_dma.h. The FIFOs always read empty and the bus idle.
+ */
+
+#ifndef HOST_PY32F071_LL_SPI_H
+#define HOST_PY32F071_LL_SPI_H
+
+#include "py32f0xx.h"
+
+typedef struct SPI_TypeDef SPI_TypeDef;
+
+#define SPI1_BASE   0x40013000UL
+#define SPI2_BASE   0x40003800UL
+#define SPI1        ((SPI_TypeDef *)SPI1_BASE)
+#define SPI2        ((SPI_TypeDef *)SPI2_BASE)
+
+#define LL_SPI_FULL_DUPLEX              0x00000000U
+#define LL_SPI_MODE_MASTER              0x00000104U
+#define LL_SPI_DATAWIDTH_8BIT           0x00000000U
+#define LL_SPI_POLARITY_LOW             0x00000000U
+#define LL_SPI_POLARITY_HIGH            0x00000002U
+#define LL_SPI_PHASE_1EDGE              0x00000000U
+#define LL_SPI_PHASE_2EDGE              0x00000001U
+#define LL_SPI_NSS_SOFT                 0x00000200U
+#define LL_SPI_MSB_FIRST                0x00000000U
+#define LL_SPI_CRCCALCULATION_DISABLE   0x00000000U
+#define LL_SPI_RX_FIFO_EMPTY            0x00000000U
+#define LL_SPI_TX_FIFO_EMPTY            0x00000000U
+
+// Stored as the division factor's log2 minus one, as in SPI_CR1.BR
+#define LL_SPI_BAUDRATEPRESCALER_DIV2   0x00000000U
+#define LL_SPI_BAUDRATEPRESCALER_DIV4   0x00000008U
+#define LL_SPI_BAUDRATEPRESCALER_DIV8   0x00000010U
+#define LL_SPI_BAUDRATEPRESCALER_DIV16  0x00000018U
+#define LL_SPI_BAUDRATEPRESCALER_DIV32  0x00000020U
+#define LL_SPI_BAUDRATEPRESCALER_DIV64  0x00000028U
+#define LL_SPI_BAUDRATEPRESCALER_DIV128 0x00000030U
+#define LL_SPI_BAUDRATEPRESCALER_DIV256 0x00000038U
+
+typedef struct
+{
+    uint32_t TransferDirection;
+    uint32_t Mode;
+    uint32_t DataWidth;
+    uint32_t ClockPolarity;
+    uint32_t ClockPhase;
+    uint32_t NSS;
+    uint32_t BaudRate;
+    uint32_t BitOrder;
+    uint32_t CRCCalculation;
+    uint32_t CRCPoly;
+} LL_SPI_InitTypeDef;
+
+static inline void LL_SPI_StructInit(LL_SPI_InitTypeDef *SPI_InitStruct)
+{
+    *SPI_InitStruct = (LL_SPI_InitTypeDef){ .BaudRate = LL_SPI_BAUDRATEPRESCALER_DIV2, .CRCPoly = 7 };
+}
+
+uint32_t LL_SPI_Init(SPI_TypeDef *SPIx, LL_SPI_InitTypeDef *SPI_InitStruct);
+void     LL_SPI_Enable(SPI_TypeDef *SPIx);
+uint32_t LL_SPI_IsActiveFlag_TXE(SPI_TypeDef *SPIx);
+uint32_t LL_SPI_IsActiveFlag_RXNE(SPI_TypeDef *SPIx);
+void     LL_SPI_TransmitData8(SPI_TypeDef *SPIx, uint8_t TxData);
+uint8_t  LL_SPI_ReceiveData8(SPI_TypeDef *SPIx);
+void     LL_SPI_EnableDMAReq_TX(SPI_TypeDef *SPIx);
+void     LL_SPI_DisableDMAReq_TX(SPI_TypeDef *SPIx);
+
+static inline uintptr_t LL_SPI_DMA_GetRegAddr(SPI_TypeDef *SPIx)   { return (uintptr_t)SPIx + 0x0C; }
+static inline uint32_t  LL_SPI_IsActiveFlag_BSY(SPI_TypeDef *SPIx) { (void)SPIx; return 0; }
+static inline uint32_t  LL_SPI_GetTxFIFOLevel(SPI_TypeDef *SPIx)   { (void)SPIx; return LL_SPI_TX_FIFO_EMPTY; }
+static inline uint32_t  LL_SPI_GetRxFIFOLevel(SPI_TypeDef *SPIx)   { (void)SPIx; return LL_SPI_RX_FIFO_EMPTY; }
+static inline void      LL_SPI_ClearFlag_OVR(SPI_TypeDef *SPIx)    { (void)SPIx; }
+
+#endif
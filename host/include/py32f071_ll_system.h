@@ -0,0 +1,14 @@
+/* Host build replacement for the PY32F071 LL SYSCFG driver.
+ *
+ * Only the DMA request mapping values are provided.
+ */
+
+#ifndef HOST_PY32F071_LL_SYSTEM_H
+#define HOST_PY32F071_LL_SYSTEM_H
+
+#include "py32f0xx.h"
+
+#define LL_SYSCFG_DMA_MAP_SPI1_RD   0x00000003U
+#define LL_SYSCFG_DMA_MAP_SPI1_WR   0x00000004U
+
+#endif
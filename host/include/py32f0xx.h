@@ -0,0 +1,54 @@
+/* Host build replacement for the PY32F0xx CMSIS device header.
+ *
+ * Only the handful of symbols the App sources touch outside the stubbed
+ * drivers are provided. Peripheral "pointers" are plain integer constants
+ * so the GPIO_MAKE_PIN()/GPIO_PORT() packing in driver/gpio.h keeps working;
+ * they are never dereferenced, the LL shims decode them instead.
+ */
+
+#ifndef HOST_PY32F0XX_H
+#define HOST_PY32F0XX_H
+
+#include <stdint.h>
+
+#define __IO volatile
+#define __STATIC_INLINE static inline
+// One core cycle on the virtual clock, so NOP-timed delays are charged
+void HOST_AdvanceCycles(uint32_t Cycles);
+#define __NOP() HOST_AdvanceCycles(1)
+
+typedef enum
+{
+    SysTick_IRQn = -1,
+    DMA1_Channel1_IRQn = 9,
+    DMA1_Channel2_3_IRQn = 10,
+    DMA1_Channel4_5_6_7_IRQn = 11,
+    USART1_IRQn = 27,
+    USB_IRQn = 31,
+} IRQn_Type;
+
+typedef struct GPIO_TypeDef GPIO_TypeDef;
+typedef struct DMA_TypeDef DMA_TypeDef;
+
+#define IOPORT_BASE     0x50000000UL
+#define GPIOA_BASE      (IOPORT_BASE + 0x00000000UL)
+#define GPIOB_BASE      (IOPORT_BASE + 0x00000400UL)
+#define GPIOC_BASE      (IOPORT_BASE + 0x00000800UL)
+#define GPIOF_BASE      (IOPORT_BASE + 0x00001400UL)
+#define DMA1_BASE       0x40020000UL
+
+#define GPIOA           ((GPIO_TypeDef *)GPIOA_BASE)
+#define GPIOB           ((GPIO_TypeDef *)GPIOB_BASE)
+#define GPIOC           ((GPIO_TypeDef *)GPIOC_BASE)
+#define GPIOF           ((GPIO_TypeDef *)GPIOF_BASE)
+#define DMA1            ((DMA_TypeDef *)DMA1_BASE)
+
+void NVIC_EnableIRQ(IRQn_Type IRQn);
+void NVIC_DisableIRQ(IRQn_Type IRQn);
+void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority);
+void NVIC_SystemReset(void);
+
+void __enable_irq(void);
+void __disable_irq(void);
+
+#endif
@@ -0,0 +1,113 @@
+/* Backlight for the host build.
+ *
+ * Same countdown and brightness bookkeeping as driver/backlight.c, minus the
+ * TIM7/DMA PWM; the backlight pin is simply on for any non-zero level.
+ */
+
+#include "driver/backlight.h"
+#include "driver/gpio.h"
+#include "driver/system.h"
+#include "audio.h"
+#include "misc.h"
+#include "settings.h"
+
+uint16_t gBacklightCountdown_500ms = 0;
+bool backlightOn;
+
+#ifdef ENABLE_FEAT_N7SIX
+    const uint8_t value[] = {0, 3, 6, 9, 15, 24, 38, 62, 100, 159, 255};
+#endif
+
+#ifdef ENABLE_FEAT_N7SIX_SLEEP
+    uint16_t gSleepModeCountdown_500ms = 0;
+#endif
+
+static uint8_t currentBrightness = 0;
+
+void BACKLIGHT_InitHardware()
+{
+}
+
+static void BACKLIGHT_Sound(void)
+{
+    if (gEeprom.POWER_ON_DISPLAY_MODE == POWER_ON_DISPLAY_MODE_SOUND || gEeprom.POWER_ON_DISPLAY_MODE == POWER_ON_DISPLAY_MODE_ALL)
+    {
+        AUDIO_PlayBeep(BEEP_880HZ_60MS_DOUBLE_BEEP);
+        AUDIO_PlayBeep(BEEP_880HZ_60MS_DOUBLE_BEEP);
+    }
+
+    gK5startup = false;
+}
+
+void BACKLIGHT_TurnOn(void)
+{
+    #ifdef ENABLE_FEAT_N7SIX_SLEEP
+        gSleepModeCountdown_500ms = gSetting_set_off * 120;
+    #endif
+
+    #ifdef ENABLE_FEAT_N7SIX
+        gBacklightBrightnessOld = BACKLIGHT_GetBrightness();
+    #endif
+
+    if (gEeprom.BACKLIGHT_TIME == 0) {
+        BACKLIGHT_TurnOff();
+        #ifdef ENABLE_FEAT_N7SIX
+            if(gK5startup == true)
+            {
+                BACKLIGHT_Sound();
+            }
+        #endif
+        return;
+    }
+
+    backlightOn = true;
+
+    BACKLIGHT_SetBrightness(gEeprom.BACKLIGHT_MAX);
+
+#ifdef ENABLE_FEAT_N7SIX
+    if(gK5startup == true) {
+        BACKLIGHT_Sound();
+    }
+#endif
+
+    switch (gEeprom.BACKLIGHT_TIME) {
+        default:
+        case 1 ... 60:  // 5 sec * value
+            gBacklightCountdown_500ms = 1 + (gEeprom.BACKLIGHT_TIME * 5) * 2;
+            break;
+        case 61:    // always on
+            gBacklightCountdown_500ms = 0;
+            break;
+    }
+}
+
+void BACKLIGHT_TurnOff()
+{
+#ifdef ENABLE_BLMIN_TMP_OFF
+    BACKLIGHT_SetBrightness(gEeprom.BACKLIGHT_MIN_STAT == BLMIN_STAT_ON ? gEeprom.BACKLIGHT_MIN : 0);
+#else
+    BACKLIGHT_SetBrightness(gEeprom.BACKLIGHT_MIN);
+#endif
+    gBacklightCountdown_500ms = 0;
+    backlightOn = false;
+}
+
+bool BACKLIGHT_IsOn()
+{
+    return backlightOn;
+}
+
+void BACKLIGHT_SetBrightness(uint8_t brigtness)
+{
+    if (brigtness)
+        GPIO_TurnOnBacklight();
+    else
+        GPIO_TurnOffBacklight();
+
+    currentBrightness = brigtness;
+}
+
+uint8_t BACKLIGHT_GetBrightness(void)
+{
+    return currentBrightness;
+}
@@ -0,0 +1,633 @@
+/* BK4819 3-wire bus decoder and behavioural chip model.
+ *
+ * driver/bk4829.c is compiled unmodified; its pin wiggling arrives here via
+ * the GPIO model. A transaction starts on CSN falling, the first 8 SCL
+ * rising edges clock in the address (bit 7 set for a read), then 16 data
+ * bits are either sampled from SDA or presented on it MSB first.
+ *
+ * Plain registers read back what was written. The status registers are
+ * derived from the virtual band (band.c) at the tuned frequency:
+ *
+ *  REG_67          RSSI, (dBm + 160) * 2, ramping over the settle time
+ *  REG_63, REG_65  glitch and noise indicators, falling with SNR
+ *  REG_0C, REG_02  interrupt request and latched flags, masked by REG_3F
+ *  REG_0D, REG_0E  frequency scan result while REG_32 bit 0 is set
+ *  REG_68..REG_6A  CTCSS/CDCSS scan results
+ *  REG_5F          FSK RX FIFO while REG_59 bit 12 is set
+ *
+ * The squelch, CxCSS and FSK state machines advance in 1 ms steps of
+ * virtual time, caught up lazily on every bus access, so the interrupts the
+ * firmware sees only depend on the script and on when it looks.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "host.h"
+
+#define REG_COUNT   128
+
+#define REG_02      0x02
+#define REG_07      0x07
+#define REG_08      0x08
+#define REG_0B      0x0B
+#define REG_0C      0x0C
+#define REG_0D      0x0D
+#define REG_0E      0x0E
+#define REG_30      0x30
+#define REG_32      0x32
+#define REG_38      0x38
+#define REG_39      0x39
+#define REG_3F      0x3F
+#define REG_43      0x43
+#define REG_4D      0x4D
+#define REG_4E      0x4E
+#define REG_4F      0x4F
+#define REG_51      0x51
+#define REG_59      0x59
+#define REG_5F      0x5F
+#define REG_63      0x63
+#define REG_65      0x65
+#define REG_67      0x67
+#define REG_68      0x68
+#define REG_69      0x69
+#define REG_6A      0x6A
+#define REG_78      0x78
+
+// REG_02 / REG_3F bits
+#define IRQ_FSK_RX_FINISHED     (1u << 13)
+#define IRQ_FSK_FIFO_ALMOST_FULL (1u << 12)
+#define IRQ_CxCSS_TAIL          (1u << 10)
+#define IRQ_CDCSS_FOUND         (1u << 9)
+#define IRQ_CDCSS_LOST          (1u << 8)
+#define IRQ_CTCSS_FOUND         (1u << 7)
+#define IRQ_CTCSS_LOST          (1u << 6)
+#define IRQ_SQUELCH_FOUND       (1u << 3)
+#define IRQ_SQUELCH_LOST        (1u << 2)
+
+#define SIM_STEP_US         1000u
+#define SIM_MAX_GAP_US      2000000u
+
+#define CTCSS_DETECT_MS     150
+#define CDCSS_DETECT_MS     200
+#define FREQ_SCAN_MIN_DBM   (-100)
+#define FSK_WORD_US         13333u      // 16 bits at 1200 bd
+#define FSK_PREAMBLE_US     60000u
+#define FSK_FIFO_WORDS      64
+#define FSK_ALMOST_FULL     4
+
+typedef struct {
+    uint16_t             Rssi;
+    uint8_t              Noise;
+    uint8_t              Glitch;
+    const HOST_Signal_t *Signal;
+} Measurement_t;
+
+static uint16_t gRegs[REG_COUNT];
+
+static bool     gCsActive;
+static bool     gScl;
+static bool     gSda;
+static unsigned gBitCount;
+static uint8_t  gAddress;
+static uint16_t gShift;
+static uint16_t gReadValue;
+
+static HOST_BK4819_ReadHook_t  gReadHook;
+static HOST_BK4819_WriteHook_t gWriteHook;
+static HOST_RssiSource_t       gRssiSource;
+
+static HOST_BK4819_Stats_t gStats;
+
+// Chip state
+static uint32_t gSeed;
+static uint64_t gSimUs;
+static bool     gRxOn;
+static uint64_t gTuneUs;
+static uint32_t gSettleUs;          // of the last retune
+static uint16_t gSettleFromRssi;
+static uint16_t gPending;           // flags raised since the last REG_02 write
+static uint16_t gStatus;            // what REG_02 reads back
+static uint32_t gCdcssWord;
+
+static bool     gSquelchOpen;
+static unsigned gSquelchHeldMs;
+static bool     gCtcssFound;
+static bool     gCdcssFound;
+static unsigned gCssHeldMs;
+static const HOST_Signal_t *gOpenSignal;
+
+static uint64_t gFreqScanStartUs;
+
+static uint16_t gFifo[FSK_FIFO_WORDS];
+static unsigned gFifoHead;
+static unsigned gFifoCount;
+static unsigned gFifoSinceIrq;
+static const HOST_Signal_t *gFskSignal;
+static uint32_t gFskOnMs;
+static unsigned gFskIndex;
+static uint64_t gFskNextUs;
+static const HOST_Signal_t *gFskDoneSignal;
+static uint32_t gFskDoneOnMs;
+
+static unsigned Jitter(unsigned Span)
+{
+    gSeed = gSeed * 1103515245u + 12345u;
+    return ((gSeed >> 16) & 0x7FFF) % Span;
+}
+
+static void Raise(uint16_t Flags)
+{
+    gPending |= Flags & gRegs[REG_3F];
+}
+
+static Measurement_t Measure(uint64_t Us)
+{
+    Measurement_t m = { 0, 127, 255, NULL };
+
+    if (!gRxOn)
+        return m;
+
+    const uint32_t Frequency = HOST_BK4819_GetFrequency();
+    const int16_t  Floor     = HOST_BAND_GetNoiseFloor();
+    int            Level;
+    int            Rssi;
+
+    if (gRssiSource) {
+        Rssi  = gRssiSource(Frequency) & 0x1FF;
+        Level = Rssi / 2 - 160;
+    } else {
+        Level = HOST_BAND_Level(Frequency, Us / 1000, &m.Signal);
+        Rssi  = (Level + 160) * 2 + (int)Jitter(5) - 2;
+        if (Rssi < 0)
+            Rssi = 0;
+        if (Rssi > 0x1FF)
+            Rssi = 0x1FF;
+    }
+
+    const uint64_t Elapsed = Us - gTuneUs;
+    if (Elapsed < gSettleUs) {
+        Rssi = gSettleFromRssi + (Rssi - (int)gSettleFromRssi) * (int)Elapsed / (int)gSettleUs;
+        m.Rssi = Rssi;
+        return m;               // noise and glitch not valid yet
+    }
+
+    // Noise alone reads glitch 230..254 and noise 72..75; both fall with SNR
+    const int Snr    = Level > Floor ? Level - Floor : 0;
+    const int Noise  = 72 - 3 * Snr;
+    const int Glitch = 230 - 12 * Snr;
+
+    m.Rssi   = Rssi;
+    m.Noise  = (Noise  > 2 ? Noise  : 2) + Jitter(4);
+    m.Glitch = (Glitch > 0 ? Glitch : 0) + Jitter(25);
+
+    return m;
+}
+
+static bool CtcssMatches(const HOST_Signal_t *Signal)
+{
+    if ((gRegs[REG_51] & 0xA000) != 0x8000 || (gRegs[REG_07] >> 13) != 0)
+        return false;
+    if (!Signal || Signal->Css != HOST_CSS_CTCSS)
+        return false;
+
+    const int Programmed = gRegs[REG_07] & 0x1FFF;
+    const int Expected   = (Signal->CssCode * 206488u + 50000u) / 100000u;
+    const int Delta      = Programmed > Expected ? Programmed - Expected : Expected - Programmed;
+
+    return Delta <= Expected / 100 + 1;
+}
+
+static bool CdcssMatches(const HOST_Signal_t *Signal)
+{
+    if ((gRegs[REG_51] & 0xA000) != 0xA000)
+        return false;
+
+    return Signal && Signal->Css == HOST_CSS_CDCSS && (Signal->CssCode & 0xFFFFFF) == gCdcssWord;
+}
+
+static void CssLost(bool Tail)
+{
+    if (gCtcssFound)
+        Raise(IRQ_CTCSS_LOST | (Tail ? IRQ_CxCSS_TAIL : 0));
+    if (gCdcssFound)
+        Raise(IRQ_CDCSS_LOST | (Tail ? IRQ_CxCSS_TAIL : 0));
+
+    gCtcssFound = false;
+    gCdcssFound = false;
+    gCssHeldMs  = 0;
+}
+
+static void StepSquelch(uint64_t Us, const Measurement_t *m)
+{
+    const unsigned OpenDelayMs  = 1 + ((gRegs[REG_4E] >> 11) & 7) * 2;
+    const unsigned CloseDelayMs = 1 + ((gRegs[REG_4E] >> 9) & 3) * 32;
+
+    if (!gSquelchOpen) {
+        const bool Open = m->Rssi   >= (gRegs[REG_78] >> 8)
+                       && m->Noise  <= (gRegs[REG_4F] & 0xFF)
+                       && m->Glitch <= (gRegs[REG_4E] & 0xFF);
+
+        gSquelchHeldMs = Open ? gSquelchHeldMs + 1 : 0;
+        if (gSquelchHeldMs < OpenDelayMs)
+            return;
+
+        gSquelchOpen   = true;
+        gSquelchHeldMs = 0;
+        gOpenSignal    = m->Signal;
+        gStats.SquelchOpens++;
+        gStats.LastOpenUs = Us;
+        if (!m->Signal)
+            gStats.FalseOpens++;
+        Raise(IRQ_SQUELCH_LOST);    // the chip calls the gate opening "lost"
+        return;
+    }
+
+    const bool Close = m->Rssi   <  (gRegs[REG_78] & 0xFF)
+                    || m->Noise  >  (gRegs[REG_4F] >> 8)
+                    || m->Glitch >  (gRegs[REG_4D] & 0xFF);
+
+    gSquelchHeldMs = Close ? gSquelchHeldMs + 1 : 0;
+    if (gSquelchHeldMs < CloseDelayMs)
+        return;
+
+    gSquelchOpen   = false;
+    gSquelchHeldMs = 0;
+    CssLost(gOpenSignal && gOpenSignal->Css != HOST_CSS_NONE && !HOST_BAND_IsKeyed(gOpenSignal, Us / 1000));
+    gOpenSignal    = NULL;
+    Raise(IRQ_SQUELCH_FOUND);
+}
+
+static void StepCss(const Measurement_t *m)
+{
+    const bool Ctcss = gSquelchOpen && CtcssMatches(m->Signal);
+    const bool Cdcss = gSquelchOpen && CdcssMatches(m->Signal);
+
+    if (gCtcssFound || gCdcssFound) {
+        if ((gCtcssFound && !Ctcss) || (gCdcssFound && !Cdcss))
+            CssLost(false);
+        return;
+    }
+
+    if (!Ctcss && !Cdcss) {
+        gCssHeldMs = 0;
+        return;
+    }
+
+    if (++gCssHeldMs < (Ctcss ? CTCSS_DETECT_MS : CDCSS_DETECT_MS))
+        return;
+
+    gCtcssFound = Ctcss;
+    gCdcssFound = Cdcss;
+    Raise(Ctcss ? IRQ_CTCSS_FOUND : IRQ_CDCSS_FOUND);
+}
+
+static void StepFsk(uint64_t Us, const Measurement_t *m)
+{
+    if (!(gRegs[REG_59] & (1u << 12)))
+        return;
+
+    if (!gFskSignal) {
+        const HOST_Signal_t *s = m->Signal;
+        if (!s || !s->Fsk || !s->FskWords)
+            return;
+        if (s == gFskDoneSignal && s->OnMs == gFskDoneOnMs)
+            return;             // already received this key-up
+
+        gFskSignal = s;
+        gFskOnMs   = s->OnMs;
+        gFskIndex  = 0;
+        gFskNextUs = Us + FSK_PREAMBLE_US;
+        return;
+    }
+
+    if (m->Signal != gFskSignal) {  // carrier gone or retuned mid-packet
+        gFskSignal = NULL;
+        return;
+    }
+
+    while (gFskSignal && Us >= gFskNextUs) {
+        if (gFifoCount < FSK_FIFO_WORDS) {
+            gFifo[(gFifoHead + gFifoCount) % FSK_FIFO_WORDS] = gFskSignal->Fsk[gFskIndex];
+            gFifoCount++;
+        }
+        gFskIndex++;
+        gFskNextUs += FSK_WORD_US;
+
+        if (++gFifoSinceIrq >= FSK_ALMOST_FULL) {
+            gFifoSinceIrq = 0;
+            Raise(IRQ_FSK_FIFO_ALMOST_FULL);
+        }
+
+        if (gFskIndex >= gFskSignal->FskWords) {
+            gFskDoneSignal = gFskSignal;
+            gFskDoneOnMs   = gFskOnMs;
+            gFskSignal     = NULL;
+            Raise(IRQ_FSK_RX_FINISHED);
+        }
+    }
+}
+
+static void Step(uint64_t Us)
+{
+    const Measurement_t m = Measure(Us);
+
+    if (!gRxOn) {
+        gSquelchOpen   = false;
+        gSquelchHeldMs = 0;
+        gCtcssFound    = false;
+        gCdcssFound    = false;
+        gCssHeldMs     = 0;
+        gFskSignal     = NULL;
+        return;
+    }
+
+    StepSquelch(Us, &m);
+    StepCss(&m);
+    StepFsk(Us, &m);
+}
+
+static void Simulate(void)
+{
+    const uint64_t Now = HOST_GetTimeUs();
+
+    if (Now - gSimUs > SIM_MAX_GAP_US)
+        gSimUs = Now - SIM_MAX_GAP_US;
+
+    while (gSimUs + SIM_STEP_US <= Now) {
+        gSimUs += SIM_STEP_US;
+        Step(gSimUs);
+    }
+}
+
+static void Retune(void)
+{
+    const uint64_t Now = HOST_GetTimeUs();
+
+    gSettleFromRssi = Measure(Now).Rssi;
+    gTuneUs         = Now;
+    gSettleUs       = HOST_BK4819_GetSettleUs();
+    gSquelchHeldMs  = gSquelchOpen ? gSquelchHeldMs : 0;
+    gCssHeldMs      = 0;
+    gStats.Retunes++;
+}
+
+static uint16_t FrequencyScanResult(bool High)
+{
+    const uint32_t ScanUs = 200000u << ((gRegs[REG_32] >> 14) & 3);
+
+    if (!(gRegs[REG_32] & 1u) || HOST_GetTimeUs() - gFreqScanStartUs < ScanUs)
+        return High ? 0x8000 : 0;
+
+    const HOST_Signal_t *s = HOST_BAND_Strongest(HOST_GetTimeUs() / 1000, FREQ_SCAN_MIN_DBM);
+    if (!s)
+        return High ? 0x8000 : 0;
+
+    return High ? (s->Frequency >> 16) & 0x7FF : s->Frequency & 0xFFFF;
+}
+
+static uint16_t StatusRead(uint8_t Reg, uint16_t Value)
+{
+    const Measurement_t m = Measure(HOST_GetTimeUs());
+
+    switch (Reg) {
+    case REG_02:
+        return gStatus;
+    case REG_0B:
+        return Value & ~0x0010;     // FSK CRC ok
+    case REG_0C:
+        return (Value & ~1u) | (gPending ? 1u : 0u);
+    case REG_0D:
+        return FrequencyScanResult(true);
+    case REG_0E:
+        return FrequencyScanResult(false);
+    case REG_5F:
+        if (!gFifoCount)
+            return 0;
+        Value = gFifo[gFifoHead];
+        gFifoHead = (gFifoHead + 1) % FSK_FIFO_WORDS;
+        gFifoCount--;
+        return Value;
+    case REG_63:
+        return (Value & 0xFF00) | m.Glitch;
+    case REG_65:
+        return (Value & 0xFF80) | m.Noise;
+    case REG_67:
+        return (Value & 0xFE00) | m.Rssi;
+    case REG_68:
+        if (gSquelchOpen && m.Signal && m.Signal->Css == HOST_CSS_CTCSS)
+            return ((m.Signal->CssCode * 10000u + 2421u) / 4843u) & 0x1FFF;
+        return 0x8000;
+    case REG_69:
+        if (gSquelchOpen && m.Signal && m.Signal->Css == HOST_CSS_CDCSS)
+            return (m.Signal->CssCode >> 12) & 0x0FFF;
+        return 0x8000;
+    case REG_6A:
+        if (gSquelchOpen && m.Signal && m.Signal->Css == HOST_CSS_CDCSS)
+            return m.Signal->CssCode & 0x0FFF;
+        return 0;
+    default:
+        return Value;
+    }
+}
+
+static uint16_t RegisterRead(uint8_t Reg)
+{
+    Simulate();
+
+    uint16_t Value = StatusRead(Reg, gRegs[Reg]);
+
+    if (gReadHook)
+        Value = gReadHook(Reg, Value);
+
+    gStats.Reads++;
+    gStats.RegReads[Reg]++;
+
+    return Value;
+}
+
+static void RegisterWrite(uint8_t Reg, uint16_t Value)
+{
+    const uint16_t Old = gRegs[Reg];
+
+    Simulate();
+
+    gRegs[Reg] = Value;
+
+    switch (Reg) {
+    case REG_02:                // acknowledges the request, latches the flags
+        gStatus  = gPending;
+        gPending = 0;
+        break;
+    case REG_08:                // two halves selected by bit 15
+        if (Value & 0x8000)
+            gCdcssWord = (gCdcssWord & 0x000FFF) | ((uint32_t)(Value & 0x0FFF) << 12);
+        else
+            gCdcssWord = (gCdcssWord & 0xFFF000) | (Value & 0x0FFF);
+        break;
+    case REG_30:
+        if ((Value & 1u) && !(Old & 1u))
+            Retune();
+        gRxOn = Value & 1u;
+        break;
+    case REG_32:
+        if ((Value & 1u) && !(Old & 1u))
+            gFreqScanStartUs = HOST_GetTimeUs();
+        break;
+    case REG_38:
+    case REG_39:
+        if (Value != Old)
+            Retune();
+        break;
+    case REG_59:
+        if (Value & (1u << 14)) {   // clear RX FIFO
+            gFifoHead     = 0;
+            gFifoCount    = 0;
+            gFifoSinceIrq = 0;
+        }
+        break;
+    }
+
+    gStats.Writes++;
+    gStats.RegWrites[Reg]++;
+
+    if (gWriteHook)
+        gWriteHook(Reg, Value);
+}
+
+void HOST_BK4819_BusCs(bool Level)
+{
+    gCsActive = !Level;
+    gBitCount = 0;
+    gShift    = 0;
+}
+
+void HOST_BK4819_BusScl(bool Level)
+{
+    const bool Rising = Level && !gScl;
+
+    gScl = Level;
+    if (!gCsActive || !Rising)
+        return;
+
+    if (gBitCount < 8) {
+        gShift = (gShift << 1) | gSda;
+        if (++gBitCount == 8) {
+            gAddress = gShift & 0xFF;
+            gShift   = 0;
+            if (gAddress & 0x80)
+                gReadValue = RegisterRead(gAddress & 0x7F);
+        }
+        return;
+    }
+
+    if (gBitCount < 24) {
+        gShift = (gShift << 1) | gSda;
+        if (++gBitCount == 24 && !(gAddress & 0x80))
+            RegisterWrite(gAddress & 0x7F, gShift);
+    }
+}
+
+void HOST_BK4819_BusSdaOut(bool Level)
+{
+    gSda = Level;
+}
+
+bool HOST_BK4819_BusSdaIn(void)
+{
+    if (!gCsActive || !(gAddress & 0x80) || gBitCount < 8 || gBitCount >= 24)
+        return true;
+
+    return (gReadValue >> (15 - (gBitCount - 8))) & 1u;
+}
+
+uint16_t HOST_BK4819_Peek(uint8_t Reg)
+{
+    return gRegs[Reg & 0x7F];
+}
+
+void HOST_BK4819_Poke(uint8_t Reg, uint16_t Value)
+{
+    gRegs[Reg & 0x7F] = Value;
+}
+
+uint32_t HOST_BK4819_GetFrequency(void)
+{
+    return ((uint32_t)gRegs[REG_39] << 16) | gRegs[REG_38];
+}
+
+bool HOST_BK4819_IsSquelchOpen(void)
+{
+    Simulate();
+    return gSquelchOpen;
+}
+
+void HOST_BK4819_SetHooks(HOST_BK4819_ReadHook_t Read, HOST_BK4819_WriteHook_t Write)
+{
+    gReadHook  = Read;
+    gWriteHook = Write;
+}
+
+void HOST_BK4819_SetRssiSource(HOST_RssiSource_t Source)
+{
+    gRssiSource = Source;
+}
+
+const HOST_BK4819_Stats_t *HOST_BK4819_GetStats(void)
+{
+    return &gStats;
+}
+
+void HOST_BK4819_ResetStats(void)
+{
+    memset(&gStats, 0, sizeof(gStats));
+}
+
+uint32_t HOST_BK4819_GetSettleUs(void)
+{
+    // REG_43 <14:12> RF filter bandwidth in Hz, doubled by <5>
+    static const uint16_t BW_HZ[8] = { 1700, 2000, 2500, 3000, 3750, 4000, 4250, 4500 };
+    const uint32_t        Bw = (uint32_t)BW_HZ[(gRegs[REG_43] >> 12) & 7] << ((gRegs[REG_43] >> 5) & 1);
+
+    return Bw >= 3750 ? HOST_BK4819_SETTLE_US : HOST_BK4819_SETTLE_US * 3750 / Bw;
+}
+
+void HOST_BK4819_Reset(void)
+{
+    memset(gRegs, 0, sizeof(gRegs));
+    gRegs[REG_43] = 0x3028;     // 25 kHz, as BK4819_SetFilterBandwidth() sets it
+    gCsActive   = false;
+    gScl        = false;
+    gSda        = false;
+    gBitCount   = 0;
+    gAddress    = 0;
+    gShift      = 0;
+    gReadHook   = NULL;
+    gWriteHook  = NULL;
+    gRssiSource = NULL;
+
+    gSeed            = 1;
+    gSimUs           = HOST_GetTimeUs();
+    gRxOn            = false;
+    gTuneUs          = 0;
+    gSettleUs        = HOST_BK4819_SETTLE_US;
+    gSettleFromRssi  = 0;
+    gPending         = 0;
+    gStatus          = 0;
+    gCdcssWord       = 0;
+    gSquelchOpen     = false;
+    gSquelchHeldMs   = 0;
+    gCtcssFound      = false;
+    gCdcssFound      = false;
+    gCssHeldMs       = 0;
+    gOpenSignal      = NULL;
+    gFreqScanStartUs = 0;
+    gFifoHead        = 0;
+    gFifoCount       = 0;
+    gFifoSinceIrq    = 0;
+    gFskSignal       = NULL;
+    gFskDoneSignal   = NULL;
+
+    HOST_BK4819_ResetStats();
+}
@@ -0,0 +1,53 @@
+/* Board bring-up and battery ADC for the host build. */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "board.h"
+#include "host.h"
+#include "driver/backlight.h"
+#include "driver/crc.h"
+#include "driver/py25q16.h"
+#include "driver/st7565.h"
+#include "helper/battery.h"
+
+// Battery voltage reported by the ADC, in 10 mV units after calibration
+#define HOST_BATTERY_10MV   800u
+
+void BOARD_FLASH_Init(void)
+{
+}
+
+void BOARD_GPIO_Init(void)
+{
+}
+
+void BOARD_ADC_Init(void)
+{
+}
+
+void BOARD_ADC_GetBatteryInfo(uint16_t *pVoltage, uint16_t *pCurrent)
+{
+    // battery.c scales by 760 / gBatteryCalibration[3]
+    const uint32_t Calibration = gBatteryCalibration[3] ? gBatteryCalibration[3] : 2000;
+
+    *pVoltage = Calibration * HOST_BATTERY_10MV / 760;
+    *pCurrent = 0;
+}
+
+void BOARD_Init(void)
+{
+    BOARD_GPIO_Init();
+    BACKLIGHT_InitHardware();
+    BOARD_ADC_Init();
+    PY25Q16_Init();
+    ST7565_Init();
+    CRC_Init();
+}
+
+void NVIC_SystemReset(void)
+{
+    fprintf(stderr, "host: NVIC_SystemReset() at %llu us\n", (unsigned long long)HOST_GetTimeUs());
+    exit(EXIT_FAILURE);
+}
@@ -0,0 +1,136 @@
+/* GPIO latch model behind the LL_GPIO_* shims.
+ *
+ * Outputs are latched, inputs read back a scripted level (all high by
+ * default, i.e. pull-ups and nothing pressed). Ports are identified by the
+ * integer "pointers" from py32f0xx.h. Output changes on the BK4819 bus pins
+ * (PF9 CSN, PB8 SCL, PB9 SDA) are forwarded to the chip model; every access
+ * costs HOST_GPIO_CYCLES of virtual time.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "host.h"
+#include "py32f071_ll_gpio.h"
+
+#define PORT_COUNT  6
+
+#define BK_PORT_CSN GPIOF
+#define BK_PIN_CSN  LL_GPIO_PIN_9
+#define BK_PORT_BUS GPIOB
+#define BK_PIN_SCL  LL_GPIO_PIN_8
+#define BK_PIN_SDA  LL_GPIO_PIN_9
+
+typedef struct {
+    uint32_t Output;
+    uint32_t Input;
+} Port_t;
+
+static Port_t gPorts[PORT_COUNT];
+static bool   gSdaIsOutput;
+
+static Port_t *GetPort(const GPIO_TypeDef *GPIOx)
+{
+    const uintptr_t Index = ((uintptr_t)GPIOx - IOPORT_BASE) / 0x400u;
+    return &gPorts[Index < PORT_COUNT ? Index : 0];
+}
+
+static void WriteOutput(GPIO_TypeDef *GPIOx, uint32_t Value)
+{
+    Port_t        *Port    = GetPort(GPIOx);
+    const uint32_t Changed = Port->Output ^ Value;
+
+    Port->Output = Value;
+    HOST_AdvanceCycles(HOST_GPIO_CYCLES);
+
+    if (GPIOx == BK_PORT_CSN && (Changed & BK_PIN_CSN))
+        HOST_BK4819_BusCs(Value & BK_PIN_CSN);
+
+    if (GPIOx == BK_PORT_BUS) {
+        // Data before clock, so a write that changes both samples the new bit
+        if (Changed & BK_PIN_SDA)
+            HOST_BK4819_BusSdaOut(Value & BK_PIN_SDA);
+        if (Changed & BK_PIN_SCL)
+            HOST_BK4819_BusScl(Value & BK_PIN_SCL);
+    }
+}
+
+static uint32_t ReadInput(GPIO_TypeDef *GPIOx)
+{
+    const Port_t *Port  = GetPort(GPIOx);
+    uint32_t      Value = Port->Input;
+
+    HOST_AdvanceCycles(HOST_GPIO_CYCLES);
+
+    if (GPIOx == GPIOB) {
+        Value &= HOST_KEY_ReadInputs(Port->Output) | ~HOST_KEY_INPUT_MASK;
+    }
+
+    if (GPIOx == BK_PORT_BUS) {
+        const bool Sda = gSdaIsOutput ? (Port->Output & BK_PIN_SDA) : HOST_BK4819_BusSdaIn();
+        Value = (Value & ~BK_PIN_SDA) | (Sda ? BK_PIN_SDA : 0);
+    }
+
+    return Value;
+}
+
+void HOST_GPIO_Reset(void)
+{
+    for (unsigned i = 0; i < PORT_COUNT; i++) {
+        gPorts[i].Output = 0;
+        gPorts[i].Input  = 0xFFFF;  // pull-ups, nothing pressed
+    }
+    gSdaIsOutput = true;
+}
+
+void HOST_GPIO_SetInput(GPIO_TypeDef *Port, uint32_t PinMask, bool Level)
+{
+    Port_t *p = GetPort(Port);
+    if (Level)
+        p->Input |= PinMask;
+    else
+        p->Input &= ~PinMask;
+}
+
+uint32_t HOST_GPIO_GetOutput(GPIO_TypeDef *Port)
+{
+    return GetPort(Port)->Output;
+}
+
+void HOST_PTT_Set(bool Pressed)
+{
+    HOST_GPIO_SetInput(GPIOB, LL_GPIO_PIN_10, !Pressed);
+}
+
+void LL_GPIO_SetPinMode(GPIO_TypeDef *GPIOx, uint32_t Pin, uint32_t Mode)
+{
+    if (GPIOx == BK_PORT_BUS && (Pin & BK_PIN_SDA))
+        gSdaIsOutput = (Mode == LL_GPIO_MODE_OUTPUT);
+
+    HOST_AdvanceCycles(HOST_GPIO_CYCLES);
+}
+
+void LL_GPIO_SetOutputPin(GPIO_TypeDef *GPIOx, uint32_t PinMask)
+{
+    WriteOutput(GPIOx, GetPort(GPIOx)->Output | PinMask);
+}
+
+void LL_GPIO_ResetOutputPin(GPIO_TypeDef *GPIOx, uint32_t PinMask)
+{
+    WriteOutput(GPIOx, GetPort(GPIOx)->Output & ~PinMask);
+}
+
+void LL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint32_t PinMask)
+{
+    WriteOutput(GPIOx, GetPort(GPIOx)->Output ^ PinMask);
+}
+
+uint32_t LL_GPIO_IsInputPinSet(GPIO_TypeDef *GPIOx, uint32_t PinMask)
+{
+    return (ReadInput(GPIOx) & PinMask) == PinMask;
+}
+
+uint32_t LL_GPIO_ReadInputPort(GPIO_TypeDef *GPIOx)
+{
+    return ReadInput(GPIOx);
+}
@@ -0,0 +1,176 @@
+/* Harness entry points: reset the models, boot the firmware, run its loop. */
+
+#include <string.h>
+
+#include "host.h"
+#include "stubs.h"
+
+#ifdef ENABLE_AM_FIX
+    #include "am_fix.h"
+#endif
+#include "app/app.h"
+#include "app/dtmf.h"
+#include "app/menu.h"
+#include "board.h"
+#include "driver/bk4819.h"
+#include "driver/flashlog.h"
+#include "driver/keyboard.h"
+#include "driver/py25q16.h"
+#include "driver/systick.h"
+#ifdef ENABLE_UART
+    #include "driver/uart.h"
+#endif
+#ifdef ENABLE_USB
+    #include "driver/vcp.h"
+#endif
+#include "helper/battery.h"
+#include "helper/boot.h"
+#include "helper/boot_profile.h"
+#include "misc.h"
+#include "radio.h"
+#include "scheduler.h"
+#include "settings.h"
+#include "ui/menu.h"
+
+#ifdef ENABLE_SCAN_RANGES
+    #include "app/chFrScanner.h"
+#endif
+
+// Cost of one pass of the Main() super-loop when nothing is due
+#define LOOP_CYCLES 200u
+
+void HOST_Reset(void)
+{
+    HOST_SYSTICK_Reset();
+    gGlobalSysTickCounter = 0;      // uptime as seen by the firmware
+    HOST_GPIO_Reset();
+    HOST_BAND_Reset();
+    HOST_BK4819_Reset();
+    BK4819_InvalidateShadow();      // the chip is back at power-on values
+    FLASHLOG_Init();                // so is the log index in RAM
+    SETTINGS_InvalidateChannelIndex();
+    HOST_LCD_Reset();
+    HOST_UART_Reset();
+    HOST_VCP_Reset();
+    HOST_KEY_Clear();
+    HOST_FLASH_Reset();
+    HOST_FLASH_ResetStats();
+}
+
+// Mirrors Main() in main.c up to the super-loop, minus the welcome screen
+// delays and the resume-state handling.
+void HOST_Boot(void)
+{
+    SYSTICK_Init();
+    BOARD_Init();
+
+#ifdef ENABLE_SCAN_RANGES
+    gScanRangeStart = 0;
+    gScanRangeStop = 0;
+#endif
+
+#ifdef ENABLE_UART
+    UART_Init();
+#endif
+#ifdef ENABLE_USB
+    VCP_Init();
+#endif
+
+    memset(gDTMF_String, '-', sizeof(gDTMF_String));
+    gDTMF_String[sizeof(gDTMF_String) - 1] = 0;
+
+    BK4819_Init();
+
+    BOARD_ADC_GetBatteryInfo(&gBatteryCurrentVoltage, &gBatteryCurrent);
+    BOOT_PROFILE_Mark(BOOT_PHASE_BOARD);
+
+    SETTINGS_InitEEPROM();
+
+#ifdef ENABLE_FEAT_N7SIX
+    gDW = gEeprom.DUAL_WATCH;
+    gCB = gEeprom.CROSS_BAND_RX_TX;
+#endif
+
+    SETTINGS_WriteBuildOptions();
+    SETTINGS_LoadCalibration();
+    BOOT_PROFILE_Mark(BOOT_PHASE_SETTINGS);
+
+    RADIO_ConfigureChannel(0, VFO_CONFIGURE_RELOAD);
+    RADIO_ConfigureChannel(1, VFO_CONFIGURE_RELOAD);
+
+    RADIO_SelectVfos();
+    BOOT_PROFILE_Mark(BOOT_PHASE_CHANNELS);
+
+    RADIO_SetupRegisters(true);
+    BOOT_PROFILE_Mark(BOOT_PHASE_REGISTERS);
+
+    for (unsigned int i = 0; i < ARRAY_SIZE(gBatteryVoltages); i++)
+        BOARD_ADC_GetBatteryInfo(&gBatteryVoltages[i], &gBatteryCurrent);
+
+    BATTERY_GetReadings(false);
+
+#ifdef ENABLE_AM_FIX
+    AM_fix_init();
+#endif
+    BOOT_PROFILE_Mark(BOOT_PHASE_BATTERY);
+
+    gMenuListCount = 0;
+    while (MenuList[gMenuListCount].name[0] != '\0') {
+        if (MenuList[gMenuListCount].menu_id == FIRST_HIDDEN_MENU_ITEM)
+            break;
+        gMenuListCount++;
+    }
+
+    BOOT_PROFILE_Mark(BOOT_PHASE_WELCOME);
+
+    boot_counter_10ms = 0;
+    RADIO_SetupRegisters(true);
+    BOOT_PROFILE_Mark(BOOT_PHASE_FIRST_RX);
+
+    BOOT_ProcessMode(BOOT_MODE_NORMAL);
+    gUpdateStatus = true;
+    BOOT_PROFILE_Mark(BOOT_PHASE_MAIN_LOOP);
+}
+
+void HOST_RunMs(uint32_t Ms)
+{
+    const uint64_t End = HOST_GetCycles() + (uint64_t)Ms * 1000u * HOST_CYCLES_PER_US;
+
+    while (HOST_GetCycles() < End) {
+#ifdef ENABLE_FLASH_WRITE_BACK
+        PY25Q16_Poll();
+#endif
+        APP_Update();
+
+        if (gNextTimeslice) {
+            APP_TimeSlice10ms();
+
+            if (gNextTimeslice_500ms) {
+                APP_TimeSlice500ms();
+            }
+        }
+
+        HOST_AdvanceCycles(LOOP_CYCLES);
+    }
+}
+
+// Squelch tables at 0x010000 (UHF) and 0x010060 (VHF): six rows of 16 bytes,
+// open/close RSSI, open/close noise, close/open glitch, indexed by level.
+// Level 1 matches the VHF column of the comments in radio.c.
+void HOST_WriteSquelchCalibration(void)
+{
+    uint8_t Table[6][16];
+
+    memset(Table, 0xFF, sizeof(Table));
+    for (unsigned Level = 0; Level < 10; Level++) {
+        Table[0][Level] = 40 + 10 * Level;
+        Table[1][Level] = 30 + 10 * Level;
+        Table[2][Level] = 70 -  5 * Level;
+        Table[3][Level] = 75 -  5 * Level;
+        Table[4][Level] = 95 -  5 * Level;
+        Table[5][Level] = 105 - 5 * Level;
+    }
+
+    PY25Q16_WriteBuffer(0x010000, Table, sizeof(Table), false);
+    PY25Q16_WriteBuffer(0x010060, Table, sizeof(Table), false);
+}
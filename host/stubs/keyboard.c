@@ -0,0 +1,105 @@
+/* Scripted key matrix behind driver/keyboard.c.
+ *
+ * Presses are queued against the virtual clock. The matrix is resolved the
+ * same way the radio's is wired: side keys pull a row low directly, the
+ * other keys pull their row low only while their column output is low.
+ * KEY_PTT presses drive the PTT input (PB10) instead.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "host.h"
+
+#define MAX_PRESSES 32
+
+typedef struct {
+    KEY_Code_t Key;
+    uint64_t   Start;
+    uint64_t   End;
+} Press_t;
+
+static Press_t  gPresses[MAX_PRESSES];
+static unsigned gPressCount;
+
+// Column (0 = no column, side keys) and row of each key, see driver/keyboard.c
+static const uint8_t gKeyPos[][2] = {
+    [KEY_0]     = { 4, 2 },
+    [KEY_1]     = { 1, 1 },
+    [KEY_2]     = { 2, 1 },
+    [KEY_3]     = { 3, 1 },
+    [KEY_4]     = { 1, 2 },
+    [KEY_5]     = { 2, 2 },
+    [KEY_6]     = { 3, 2 },
+    [KEY_7]     = { 1, 3 },
+    [KEY_8]     = { 2, 3 },
+    [KEY_9]     = { 3, 3 },
+    [KEY_MENU]  = { 1, 0 },
+    [KEY_UP]    = { 2, 0 },
+    [KEY_DOWN]  = { 3, 0 },
+    [KEY_EXIT]  = { 4, 0 },
+    [KEY_STAR]  = { 4, 1 },
+    [KEY_F]     = { 4, 3 },
+    [KEY_SIDE2] = { 0, 1 },
+    [KEY_SIDE1] = { 0, 0 },
+};
+
+static bool IsHeld(KEY_Code_t *pKey)
+{
+    const uint64_t Now = HOST_GetCycles();
+
+    for (unsigned i = 0; i < gPressCount; i++) {
+        if (Now >= gPresses[i].Start && Now < gPresses[i].End) {
+            *pKey = gPresses[i].Key;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void HOST_KEY_Press(KEY_Code_t Key, uint32_t DelayMs, uint32_t HoldMs)
+{
+    const uint64_t Start = HOST_GetCycles() + (uint64_t)DelayMs * 1000u * HOST_CYCLES_PER_US;
+
+    if (gPressCount == MAX_PRESSES) {
+        // Drop presses that are already over
+        unsigned n = 0;
+        for (unsigned i = 0; i < gPressCount; i++)
+            if (gPresses[i].End > HOST_GetCycles())
+                gPresses[n++] = gPresses[i];
+        gPressCount = n;
+        if (gPressCount == MAX_PRESSES)
+            return;
+    }
+
+    gPresses[gPressCount++] = (Press_t){
+        .Key   = Key,
+        .Start = Start,
+        .End   = Start + (uint64_t)HoldMs * 1000u * HOST_CYCLES_PER_US,
+    };
+}
+
+void HOST_KEY_Clear(void)
+{
+    gPressCount = 0;
+}
+
+uint32_t HOST_KEY_ReadInputs(uint32_t PortOutput)
+{
+    KEY_Code_t Key;
+
+    if (!IsHeld(&Key) || Key >= KEY_INVALID)
+        return HOST_KEY_INPUT_MASK;
+
+    if (Key == KEY_PTT)
+        return HOST_KEY_INPUT_MASK & ~(1u << 10);
+
+    const uint8_t Column = gKeyPos[Key][0];
+    const uint8_t Row    = gKeyPos[Key][1];
+
+    if (Column > 0 && (PortOutput & (1u << (6 - (Column - 1)))))
+        return HOST_KEY_INPUT_MASK;
+
+    return HOST_KEY_INPUT_MASK & ~(1u << (15 - Row));
+}
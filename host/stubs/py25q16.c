@@ -0,0 +1,543 @@
+/* PY25Q16 SPI NOR flash model standing in for driver/py25q16.c.
+ *
+ * The 2 MB array follows NOR rules: erase sets a 4 KB sector to 0xFF,
+ * programming can only clear bits. PY25Q16_WriteBuffer() keeps the real
+ * driver's single-sector read-modify-erase-program algorithm, including the
+ * write-back mode and its background flush, so erase and program counts
+ * match the device. Every operation advances the virtual clock by its
+ * modelled bus time (24 MHz SPI); erase and program then keep the chip busy
+ * for their datasheet typical time.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "host.h"
+#include "driver/py25q16.h"
+
+#define SECTOR_SIZE HOST_FLASH_SECTOR_SIZE
+#define PAGE_SIZE   HOST_FLASH_PAGE_SIZE
+
+#define SPI_BYTE_CYCLES     16u     // 8 bits at HCLK/2
+#define DMA_SETUP_CYCLES    150u    // channel setup and completion interrupt
+#define PAGE_PROGRAM_US     700u
+#define SECTOR_ERASE_US     45000u
+
+static uint8_t gImage[HOST_FLASH_SIZE];
+static FILE   *gFile;
+
+static HOST_FLASH_Stats_t gStats;
+
+static uint8_t  SectorCache[SECTOR_SIZE];
+static uint32_t SectorCacheAddr = 0x1000000;
+#ifdef ENABLE_FLASH_WRITE_BACK
+static bool     CacheDirty;
+static bool     CacheNeedsErase;
+static uint16_t DirtyStart;
+static uint16_t DirtyEnd;
+
+typedef enum {
+    JOB_IDLE,
+    JOB_ERASE,
+    JOB_PROGRAM,
+    JOB_VERIFY,
+} JobState_t;
+
+static struct {
+    JobState_t         State;
+    uint16_t           Start;
+    uint16_t           End;
+    uint16_t           Offset;
+    bool               Ok;
+    PY25Q16_Callback_t pDone;
+} Job;
+#endif
+
+static uint64_t gBusyUntilUs;   // end of the erase/program in progress
+
+static void Persist(uint32_t Address, uint32_t Size)
+{
+    if (!gFile)
+        return;
+
+    fseek(gFile, Address, SEEK_SET);
+    fwrite(gImage + Address, 1, Size, gFile);
+    fflush(gFile);
+}
+
+static void BusTime(uint32_t Bytes)
+{
+    HOST_AdvanceCycles(Bytes * SPI_BYTE_CYCLES);
+}
+
+#ifdef ENABLE_FLASH_WRITE_BACK
+static bool IsBusy(void)
+{
+    BusTime(2);     // read status register
+    return HOST_GetTimeUs() < gBusyUntilUs;
+}
+#endif
+
+static void WaitWIP(void)
+{
+    const uint64_t Now = HOST_GetTimeUs();
+    if (Now < gBusyUntilUs)
+        HOST_AdvanceUs(gBusyUntilUs - Now);
+}
+
+static void StartSectorErase(uint32_t Addr)
+{
+    Addr %= HOST_FLASH_SIZE;
+    Addr -= Addr % SECTOR_SIZE;
+
+    WaitWIP();
+    BusTime(1 + 4);
+    memset(gImage + Addr, 0xFF, SECTOR_SIZE);
+    gBusyUntilUs = HOST_GetTimeUs() + SECTOR_ERASE_US;
+
+    gStats.SectorErases++;
+    gStats.EraseCount[Addr / SECTOR_SIZE]++;
+    Persist(Addr, SECTOR_SIZE);
+}
+
+static void SectorErase(uint32_t Addr)
+{
+    StartSectorErase(Addr);
+    WaitWIP();
+}
+
+static void StartPageProgram(uint32_t Addr, const uint8_t *Buf, uint32_t Size)
+{
+    Addr %= HOST_FLASH_SIZE;
+
+    WaitWIP();
+    BusTime(1 + 4 + Size);
+    for (uint32_t i = 0; i < Size; i++)
+        gImage[Addr + i] &= Buf[i];
+    gBusyUntilUs = HOST_GetTimeUs() + PAGE_PROGRAM_US;
+
+    gStats.PagePrograms++;
+    gStats.ProgramBytes += Size;
+    Persist(Addr, Size);
+}
+
+
+// Fast read (0x0B): command, address and a dummy byte per contiguous run,
+// then one DMA transfer per segment
+static void ReadList(const PY25Q16_ReadSeg_t *pList, uint32_t Count)
+{
+    uint32_t i = 0;
+
+    while (i < Count) {
+        uint32_t Address = pList[i].Address % HOST_FLASH_SIZE;
+
+        BusTime(1 + 3 + 1);
+        gStats.Reads++;
+
+        do {
+            uint32_t Size = pList[i].Size;
+            if (Address + Size > HOST_FLASH_SIZE)
+                Size = HOST_FLASH_SIZE - Address;
+
+            HOST_AdvanceCycles(DMA_SETUP_CYCLES);
+            BusTime(Size);
+            memcpy(pList[i].pBuffer, gImage + Address, Size);
+            gStats.ReadBytes += Size;
+
+            Address += pList[i].Size;
+            i++;
+        } while (i < Count && pList[i].Address == Address);
+    }
+}
+
+#ifndef ENABLE_FLASH_WRITE_BACK
+static void PageProgram(uint32_t Addr, const uint8_t *Buf, uint32_t Size)
+{
+    StartPageProgram(Addr, Buf, Size);
+    WaitWIP();
+}
+
+static void SectorProgram(uint32_t Addr, const uint8_t *Buf, uint32_t Size)
+{
+    uint32_t Size1 = PAGE_SIZE - (Addr % PAGE_SIZE);
+    if (Size < Size1)
+        Size1 = Size;
+
+    PageProgram(Addr, Buf, Size1);
+    Addr += Size1;
+    Buf  += Size1;
+    Size -= Size1;
+
+    while (Size) {
+        const uint32_t n = Size < PAGE_SIZE ? Size : PAGE_SIZE;
+        PageProgram(Addr, Buf, n);
+        Addr += n;
+        Buf  += n;
+        Size -= n;
+    }
+}
+#endif
+
+#ifdef ENABLE_FLASH_WRITE_BACK
+static void MarkDirty(uint32_t Start, uint32_t End, bool Erase)
+{
+    if (!CacheDirty)
+    {
+        CacheDirty = true;
+        CacheNeedsErase = false;
+        DirtyStart = Start;
+        DirtyEnd = End;
+    }
+
+    if (Start < DirtyStart)
+    {
+        DirtyStart = Start;
+    }
+    if (End > DirtyEnd)
+    {
+        DirtyEnd = End;
+    }
+    CacheNeedsErase |= Erase;
+}
+
+// Reads see pending writes: copy the dirty sector over what came off the chip
+static void OverlayCache(uint32_t Address, void *pBuffer, uint32_t Size)
+{
+    if (!CacheDirty || Address >= SectorCacheAddr + SECTOR_SIZE || Address + Size <= SectorCacheAddr)
+    {
+        return;
+    }
+
+    const uint32_t Start = Address > SectorCacheAddr ? Address : SectorCacheAddr;
+    const uint32_t End = Address + Size < SectorCacheAddr + SECTOR_SIZE ? Address + Size : SectorCacheAddr + SECTOR_SIZE;
+
+    memcpy((uint8_t *)pBuffer + (Start - Address), SectorCache + (Start - SectorCacheAddr), End - Start);
+}
+
+static void JobFinish(void)
+{
+    Job.State = JOB_IDLE;
+
+    if (!Job.Ok)
+        MarkDirty(0, SECTOR_SIZE, true);
+
+    if (Job.pDone)
+        Job.pDone(Job.Ok);
+}
+
+static void JobStep(void)
+{
+    switch (Job.State) {
+    case JOB_IDLE:
+        return;
+
+    case JOB_ERASE:
+        Job.State = JOB_PROGRAM;
+        // fallthrough
+
+    case JOB_PROGRAM:
+        if (Job.Offset < Job.End) {
+            uint32_t Size = PAGE_SIZE - (Job.Offset % PAGE_SIZE);
+            if (Size > (uint32_t)(Job.End - Job.Offset))
+                Size = Job.End - Job.Offset;
+
+            StartPageProgram(SectorCacheAddr + Job.Offset, SectorCache + Job.Offset, Size);
+            Job.Offset += Size;
+            return;
+        }
+
+        Job.State  = JOB_VERIFY;
+        Job.Offset = Job.Start;
+        // fallthrough
+
+    case JOB_VERIFY:
+        if (Job.Offset < Job.End) {
+            uint8_t  Buf[64];
+            uint32_t Size = Job.End - Job.Offset;
+            if (Size > sizeof(Buf))
+                Size = sizeof(Buf);
+
+            const PY25Q16_ReadSeg_t Seg = { SectorCacheAddr + Job.Offset, Buf, Size };
+            ReadList(&Seg, 1);
+            if (memcmp(Buf, SectorCache + Job.Offset, Size) != 0)
+                Job.Ok = false;
+            Job.Offset += Size;
+            return;
+        }
+
+        JobFinish();
+        return;
+    }
+}
+
+static void WaitJob(void)
+{
+    while (Job.State != JOB_IDLE) {
+        WaitWIP();
+        JobStep();
+    }
+}
+#endif
+
+void PY25Q16_Init()
+{
+}
+
+void PY25Q16_ReadBuffer(uint32_t Address, void *pBuffer, uint32_t Size)
+{
+    const PY25Q16_ReadSeg_t Seg = { Address, pBuffer, Size };
+    PY25Q16_ReadList(&Seg, 1);
+}
+
+void PY25Q16_ReadList(const PY25Q16_ReadSeg_t *pList, uint32_t Count)
+{
+#ifdef ENABLE_FLASH_WRITE_BACK
+    WaitJob();
+#endif
+
+    ReadList(pList, Count);
+
+#ifdef ENABLE_FLASH_WRITE_BACK
+    for (uint32_t i = 0; i < Count; i++)
+        OverlayCache(pList[i].Address, pList[i].pBuffer, pList[i].Size);
+#endif
+}
+
+void PY25Q16_WriteBuffer(uint32_t Address, const void *pBuffer, uint32_t Size, bool Append)
+{
+#ifdef ENABLE_FLASH_WRITE_BACK
+    WaitJob();
+#endif
+    uint32_t SecIndex = Address / SECTOR_SIZE;
+    uint32_t SecAddr = SecIndex * SECTOR_SIZE;
+    uint32_t SecOffset = Address % SECTOR_SIZE;
+    uint32_t SecSize = SECTOR_SIZE - SecOffset;
+
+    while (Size)
+    {
+        if (Size < SecSize)
+        {
+            SecSize = Size;
+        }
+
+        if (SecAddr != SectorCacheAddr)
+        {
+            PY25Q16_Flush();
+            PY25Q16_ReadBuffer(SecAddr, SectorCache, SECTOR_SIZE);
+            SectorCacheAddr = SecAddr;
+        }
+
+        if (0 != memcmp(pBuffer, (char *)SectorCache + SecOffset, SecSize))
+        {
+            bool Erase = false;
+            for (uint32_t i = 0; i < SecSize; i++)
+            {
+                if (0xff != SectorCache[SecOffset + i])
+                {
+                    Erase = true;
+                    break;
+                }
+            }
+
+            memcpy(SectorCache + SecOffset, pBuffer, SecSize);
+
+#ifdef ENABLE_FLASH_WRITE_BACK
+            if (Erase && Append)
+            {
+                memset(SectorCache + SecOffset + SecSize, 0xff, SECTOR_SIZE - SecOffset - SecSize);
+            }
+            MarkDirty(SecOffset, SecOffset + SecSize, Erase);
+#else
+            if (Erase)
+            {
+                SectorErase(SecAddr);
+                if (Append)
+                {
+                    SectorProgram(SecAddr, SectorCache, SecOffset + SecSize);
+                    memset(SectorCache + SecOffset + SecSize, 0xff, SECTOR_SIZE - SecOffset - SecSize);
+                }
+                else
+                {
+                    SectorProgram(SecAddr, SectorCache, SECTOR_SIZE);
+                }
+            }
+            else
+            {
+                SectorProgram(Address, pBuffer, SecSize);
+            }
+#endif
+        }
+
+        Address += SecSize;
+        pBuffer += SecSize;
+        Size -= SecSize;
+
+        SecAddr += SECTOR_SIZE;
+        SecOffset = 0;
+        SecSize = SECTOR_SIZE;
+    } // while
+}
+
+void PY25Q16_SectorErase(uint32_t Address)
+{
+#ifdef ENABLE_FLASH_WRITE_BACK
+    WaitJob();
+#endif
+    Address -= (Address % SECTOR_SIZE);
+    SectorErase(Address);
+    if (SectorCacheAddr == Address)
+    {
+        memset(SectorCache, 0xff, SECTOR_SIZE);
+#ifdef ENABLE_FLASH_WRITE_BACK
+        CacheDirty = false;
+#endif
+    }
+}
+
+void PY25Q16_FlushAsync(PY25Q16_Callback_t pDone)
+{
+#ifdef ENABLE_FLASH_WRITE_BACK
+    WaitJob();
+
+    if (!CacheDirty) {
+        if (pDone)
+            pDone(true);
+        return;
+    }
+
+    CacheDirty = false;
+
+    Job.Ok    = true;
+    Job.pDone = pDone;
+
+    if (CacheNeedsErase) {
+        uint32_t Size = SECTOR_SIZE;
+        while (Size && SectorCache[Size - 1] == 0xFF)
+            Size--;
+
+        Job.Start  = 0;
+        Job.End    = Size;
+        Job.Offset = 0;
+        Job.State  = JOB_ERASE;
+        StartSectorErase(SectorCacheAddr);
+    } else {
+        Job.Start  = DirtyStart;
+        Job.End    = DirtyEnd;
+        Job.Offset = DirtyStart;
+        Job.State  = JOB_PROGRAM;
+        JobStep();
+    }
+#else
+    if (pDone)
+        pDone(true);
+#endif
+}
+
+void PY25Q16_Flush()
+{
+    PY25Q16_FlushAsync(NULL);
+#ifdef ENABLE_FLASH_WRITE_BACK
+    WaitJob();
+#endif
+}
+
+void PY25Q16_Poll()
+{
+#ifdef ENABLE_FLASH_WRITE_BACK
+    if (Job.State != JOB_IDLE && !IsBusy())
+        JobStep();
+#endif
+}
+
+bool PY25Q16_IsBusy()
+{
+#ifdef ENABLE_FLASH_WRITE_BACK
+    return Job.State != JOB_IDLE;
+#else
+    return false;
+#endif
+}
+
+bool PY25Q16_IsDirty()
+{
+#ifdef ENABLE_FLASH_WRITE_BACK
+    return CacheDirty;
+#else
+    return false;
+#endif
+}
+
+// ---- Harness ----
+
+bool HOST_FLASH_Open(const char *Path)
+{
+    HOST_FLASH_Close();
+    HOST_FLASH_Erase();
+
+    if (!Path)
+        return true;
+
+    gFile = fopen(Path, "r+b");
+    if (gFile) {
+        if (fread(gImage, 1, HOST_FLASH_SIZE, gFile) != HOST_FLASH_SIZE)
+            Persist(0, HOST_FLASH_SIZE);     // short image, pad with erased bytes
+        return true;
+    }
+
+    gFile = fopen(Path, "w+b");
+    if (!gFile)
+        return false;
+
+    Persist(0, HOST_FLASH_SIZE);
+    return true;
+}
+
+void HOST_FLASH_Close(void)
+{
+    if (gFile)
+        fclose(gFile);
+    gFile = NULL;
+}
+
+static void DropCache(void)
+{
+    SectorCacheAddr = 0x1000000;
+#ifdef ENABLE_FLASH_WRITE_BACK
+    CacheDirty = false;
+    Job.State  = JOB_IDLE;
+#endif
+}
+
+void HOST_FLASH_Erase(void)
+{
+    memset(gImage, 0xFF, sizeof(gImage));
+    DropCache();
+    Persist(0, HOST_FLASH_SIZE);
+}
+
+uint8_t *HOST_FLASH_Image(void)
+{
+    // Direct edits bypass the driver: land its pending writes, then drop
+    // its sector cache
+    PY25Q16_Flush();
+    DropCache();
+    return gImage;
+}
+
+void HOST_FLASH_Reset(void)
+{
+    DropCache();        // firmware RAM, pending writes are lost with it
+    gBusyUntilUs = 0;
+}
+
+const HOST_FLASH_Stats_t *HOST_FLASH_GetStats(void)
+{
+    return &gStats;
+}
+
+void HOST_FLASH_ResetStats(void)
+{
+    memset(&gStats, 0, sizeof(gStats));
+}
@@ -0,0 +1,306 @@
+/* SPI1 and the ST7565 panel on it.
+ *
+ * driver/st7565.c is compiled unmodified; bytes it clocks out with A0 low
+ * (PA6) are decoded as page/column commands, bytes with A0 high land in the
+ * panel RAM, so tests see exactly what reached the glass. SPI bus time is
+ * charged to the virtual clock per byte.
+ *
+ * DMA channel 1 on the SPI1 TX request is the background flush: the bytes
+ * are decoded when the request is enabled, the channel stays busy for their
+ * bus time and the transfer-complete interrupt is raised from the virtual
+ * clock once it has passed.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "host.h"
+#include "stubs.h"
+#include "py32f071_ll_dma.h"
+#include "py32f071_ll_gpio.h"
+#include "py32f071_ll_spi.h"
+
+#define LCD_PAGES       9
+#define LCD_COLUMNS     132
+#define LCD_X_OFFSET    4           // SEG direction reversed, driver adds 4
+
+#define PIN_A0_PORT     GPIOA
+#define PIN_A0          LL_GPIO_PIN_6
+
+#define DMA_SETUP_CYCLES    150u    // channel setup and completion interrupt
+
+static uint32_t gPrescalerShift[2] = { 1, 1 };
+
+static uint8_t  gPanel[LCD_PAGES][LCD_COLUMNS];
+static uint8_t  gPage;
+static uint8_t  gColumn;
+static bool     gExpectVolume;
+static bool     gPageTouched;
+
+static HOST_LCD_Stats_t gStats;
+
+static struct {
+    const uint8_t *pMemory;
+    uint32_t       Length;
+    bool           Enabled;
+    bool           Request;     // SPI1 TXDMAEN
+    bool           IrqEnabled;
+    bool           Busy;
+    bool           Complete;    // TC flag
+    bool           InIrq;
+    uint64_t       DoneCycles;
+} gDma;
+
+#ifdef ENABLE_LCD_ASYNC_FLUSH
+extern void DMA1_Channel1_IRQHandler(void);
+#endif
+
+static unsigned SpiIndex(const SPI_TypeDef *SPIx)
+{
+    return SPIx == SPI1 ? 0 : 1;
+}
+
+static void PanelCommand(uint8_t Value)
+{
+    gStats.CommandBytes++;
+
+    if (gExpectVolume) {        // second byte of SET_EV
+        gExpectVolume = false;
+        return;
+    }
+
+    if (Value == 0x81) {
+        gExpectVolume = true;
+    } else if ((Value & 0xF0) == 0xB0) {
+        gPage        = Value & 0x0F;
+        gPageTouched = false;
+    } else if ((Value & 0xF0) == 0x10) {
+        gColumn = (gColumn & 0x0F) | ((Value & 0x0F) << 4);
+    } else if ((Value & 0xF0) == 0x00) {
+        gColumn = (gColumn & 0xF0) | (Value & 0x0F);
+    }
+}
+
+static void PanelData(uint8_t Value)
+{
+    gStats.DataBytes++;
+
+    if (!gPageTouched) {
+        gPageTouched = true;
+        gStats.PageWrites++;
+    }
+
+    if (gPage < LCD_PAGES && gColumn < LCD_COLUMNS)
+        gPanel[gPage][gColumn] = Value;
+
+    if (gColumn < LCD_COLUMNS)
+        gColumn++;
+}
+
+uint32_t LL_SPI_Init(SPI_TypeDef *SPIx, LL_SPI_InitTypeDef *SPI_InitStruct)
+{
+    gPrescalerShift[SpiIndex(SPIx)] = (SPI_InitStruct->BaudRate >> 3) + 1;
+    return 0;
+}
+
+void LL_SPI_Enable(SPI_TypeDef *SPIx)
+{
+    (void)SPIx;
+}
+
+uint32_t LL_SPI_IsActiveFlag_TXE(SPI_TypeDef *SPIx)
+{
+    (void)SPIx;
+    return 1;
+}
+
+uint32_t LL_SPI_IsActiveFlag_RXNE(SPI_TypeDef *SPIx)
+{
+    (void)SPIx;
+    return 1;
+}
+
+void LL_SPI_TransmitData8(SPI_TypeDef *SPIx, uint8_t TxData)
+{
+    HOST_AdvanceCycles(8u << gPrescalerShift[SpiIndex(SPIx)]);
+
+    if (SPIx != SPI1)
+        return;
+
+    if (HOST_GPIO_GetOutput(PIN_A0_PORT) & PIN_A0)
+        PanelData(TxData);
+    else
+        PanelCommand(TxData);
+}
+
+uint8_t LL_SPI_ReceiveData8(SPI_TypeDef *SPIx)
+{
+    (void)SPIx;
+    return 0xFF;
+}
+
+// ---- DMA channel 1 ----
+
+static void DmaStart(void)
+{
+    if (!gDma.Enabled || !gDma.Request || gDma.Busy || !gDma.pMemory)
+        return;
+
+    const bool Data = HOST_GPIO_GetOutput(PIN_A0_PORT) & PIN_A0;
+
+    for (uint32_t i = 0; i < gDma.Length; i++) {
+        if (Data)
+            PanelData(gDma.pMemory[i]);
+        else
+            PanelCommand(gDma.pMemory[i]);
+    }
+
+    gStats.DmaTransfers++;
+    gDma.Busy       = true;
+    gDma.DoneCycles = HOST_GetCycles() + DMA_SETUP_CYCLES + ((uint64_t)gDma.Length << (3 + gPrescalerShift[0]));
+}
+
+void LL_SPI_EnableDMAReq_TX(SPI_TypeDef *SPIx)
+{
+    if (SPIx != SPI1)
+        return;
+
+    gDma.Request = true;
+    DmaStart();
+}
+
+void LL_SPI_DisableDMAReq_TX(SPI_TypeDef *SPIx)
+{
+    if (SPIx == SPI1)
+        gDma.Request = false;
+}
+
+void LL_SYSCFG_SetDMARemap(DMA_TypeDef *DMAx, uint32_t Channel, uint32_t MapReqNum)
+{
+    (void)DMAx;
+    (void)Channel;
+    (void)MapReqNum;
+}
+
+void LL_DMA_ConfigTransfer(DMA_TypeDef *DMAx, uint32_t Channel, uint32_t Configuration)
+{
+    (void)DMAx;
+    (void)Channel;
+    (void)Configuration;
+}
+
+void LL_DMA_SetPeriphAddress(DMA_TypeDef *DMAx, uint32_t Channel, uintptr_t PeriphAddress)
+{
+    (void)DMAx;
+    (void)Channel;
+    (void)PeriphAddress;
+}
+
+void LL_DMA_SetMemoryAddress(DMA_TypeDef *DMAx, uint32_t Channel, uintptr_t MemoryAddress)
+{
+    (void)DMAx;
+    if (Channel == LL_DMA_CHANNEL_1)
+        gDma.pMemory = (const uint8_t *)MemoryAddress;
+}
+
+void LL_DMA_SetDataLength(DMA_TypeDef *DMAx, uint32_t Channel, uint32_t NbData)
+{
+    (void)DMAx;
+    if (Channel == LL_DMA_CHANNEL_1)
+        gDma.Length = NbData;
+}
+
+void LL_DMA_EnableChannel(DMA_TypeDef *DMAx, uint32_t Channel)
+{
+    (void)DMAx;
+    if (Channel != LL_DMA_CHANNEL_1)
+        return;
+
+    gDma.Enabled = true;
+    DmaStart();
+}
+
+void LL_DMA_DisableChannel(DMA_TypeDef *DMAx, uint32_t Channel)
+{
+    (void)DMAx;
+    if (Channel == LL_DMA_CHANNEL_1)
+        gDma.Enabled = false;
+}
+
+void LL_DMA_EnableIT_TC(DMA_TypeDef *DMAx, uint32_t Channel)
+{
+    (void)DMAx;
+    if (Channel == LL_DMA_CHANNEL_1)
+        gDma.IrqEnabled = true;
+}
+
+uint32_t LL_DMA_IsActiveFlag_TC1(DMA_TypeDef *DMAx)
+{
+    (void)DMAx;
+    return gDma.Complete;
+}
+
+void LL_DMA_ClearFlag_TC1(DMA_TypeDef *DMAx)
+{
+    (void)DMAx;
+    gDma.Complete = false;
+}
+
+void HOST_DMA_Service(void)
+{
+    if (!gDma.Busy || gDma.InIrq || HOST_IRQ_IsMasked() || HOST_GetCycles() < gDma.DoneCycles)
+        return;
+
+    gDma.Busy     = false;
+    gDma.Complete = true;
+
+#ifdef ENABLE_LCD_ASYNC_FLUSH
+    if (gDma.IrqEnabled) {
+        gDma.InIrq = true;
+        DMA1_Channel1_IRQHandler();
+        gDma.InIrq = false;
+    }
+#endif
+}
+
+// ---- Harness ----
+
+bool HOST_LCD_GetPixel(unsigned X, unsigned Y)
+{
+    if (X >= 128 || Y >= 64)
+        return false;
+
+    return (gPanel[Y / 8][X + LCD_X_OFFSET] >> (Y % 8)) & 1u;
+}
+
+void HOST_LCD_Dump(FILE *Out)
+{
+    for (unsigned y = 0; y < 64; y++) {
+        for (unsigned x = 0; x < 128; x++)
+            fputc(HOST_LCD_GetPixel(x, y) ? '#' : '.', Out);
+        fputc('\n', Out);
+    }
+}
+
+const HOST_LCD_Stats_t *HOST_LCD_GetStats(void)
+{
+    return &gStats;
+}
+
+void HOST_LCD_ResetStats(void)
+{
+    memset(&gStats, 0, sizeof(gStats));
+}
+
+void HOST_LCD_Reset(void)
+{
+    memset(gPanel, 0, sizeof(gPanel));
+    gPage         = 0;
+    gColumn       = 0;
+    gExpectVolume = false;
+    gPageTouched  = false;
+    gPrescalerShift[0] = gPrescalerShift[1] = 1;
+    memset(&gDma, 0, sizeof(gDma));
+    HOST_LCD_ResetStats();
+}
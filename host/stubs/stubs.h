@@ -0,0 +1,22 @@
+/* Reset and interrupt hooks shared between the host stubs and the harness. */
+
+#ifndef HOST_STUBS_H
+#define HOST_STUBS_H
+
+#include <stdbool.h>
+
+void HOST_SYSTICK_Reset(void);
+void HOST_GPIO_Reset(void);
+void HOST_BK4819_Reset(void);
+void HOST_BAND_Reset(void);
+void HOST_LCD_Reset(void);
+void HOST_UART_Reset(void);
+void HOST_VCP_Reset(void);
+void HOST_FLASH_Reset(void);
+
+// PRIMASK as set by __disable_irq()
+bool HOST_IRQ_IsMasked(void);
+// Completes a background SPI1 DMA transfer that is due and runs its interrupt
+void HOST_DMA_Service(void);
+
+#endif
@@ -0,0 +1,145 @@
+/* Virtual clock standing in for driver/systick.c and the Cortex-M core. */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "host.h"
+#include "driver/systick.h"
+#include "scheduler.h"
+#include "stubs.h"
+
+extern void SysTick_Handler(void);
+
+static uint64_t gCycles;
+static uint64_t gNextTick;
+static bool     gTickRunning;
+static bool     gTickMasked;
+static bool     gPrimask;
+static bool     gTickPending;
+static bool     gInHandler;
+
+uint64_t HOST_GetCycles(void)
+{
+    return gCycles;
+}
+
+uint64_t HOST_GetTimeUs(void)
+{
+    return gCycles / HOST_CYCLES_PER_US;
+}
+
+static void DeliverTick(void)
+{
+    if (gTickMasked || gPrimask || gInHandler) {
+        gTickPending = true;
+        return;
+    }
+
+    gInHandler = true;
+    SysTick_Handler();
+    gInHandler = false;
+}
+
+void HOST_AdvanceCycles(uint32_t Cycles)
+{
+    gCycles += Cycles;
+
+    while (gTickRunning && gCycles >= gNextTick) {
+        gNextTick += HOST_CYCLES_PER_TICK;
+        DeliverTick();
+    }
+
+    HOST_DMA_Service();
+}
+
+void HOST_AdvanceUs(uint32_t Us)
+{
+    HOST_AdvanceCycles(Us * HOST_CYCLES_PER_US);
+}
+
+void HOST_SYSTICK_Reset(void)
+{
+    gCycles      = 0;
+    gNextTick    = 0;
+    gTickRunning = false;
+    gTickMasked  = false;
+    gPrimask     = false;
+    gTickPending = false;
+    gInHandler   = false;
+}
+
+void SYSTICK_Init(void)
+{
+    gTickRunning = true;
+    gNextTick    = gCycles + HOST_CYCLES_PER_TICK;
+}
+
+void SYSTICK_DelayUs(uint32_t Delay)
+{
+    HOST_AdvanceUs(Delay);
+}
+
+uint32_t SYSTICK_GetElapsedUs(void)
+{
+    return (uint32_t)(gCycles + HOST_CYCLES_PER_TICK - gNextTick) / HOST_CYCLES_PER_US;
+}
+
+uint32_t SYSTICK_GetTimeUs(void)
+{
+    uint32_t Ticks;
+    uint32_t Us;
+
+    // Read again when the 10 ms tick lands in between
+    do {
+        Ticks = gGlobalSysTickCounter;
+        Us    = SYSTICK_GetElapsedUs();
+    } while (Ticks != gGlobalSysTickCounter);
+
+    return Ticks * 10000 + Us;
+}
+
+bool HOST_IRQ_IsMasked(void)
+{
+    return gPrimask;
+}
+
+// ---- Core intrinsics ----
+
+void NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    if (IRQn != SysTick_IRQn)
+        return;
+
+    gTickMasked = false;
+    if (gTickPending && !gPrimask) {
+        gTickPending = false;
+        DeliverTick();
+    }
+}
+
+void NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+    if (IRQn == SysTick_IRQn)
+        gTickMasked = true;
+}
+
+void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority)
+{
+    (void)IRQn;
+    (void)priority;
+}
+
+void __disable_irq(void)
+{
+    gPrimask = true;
+}
+
+void __enable_irq(void)
+{
+    gPrimask = false;
+    if (gTickPending && !gTickMasked) {
+        gTickPending = false;
+        DeliverTick();
+    }
+    HOST_DMA_Service();
+}
@@ -0,0 +1,91 @@
+/* USART1 for the host build: transmitted bytes are captured, received bytes
+ * are injected into the circular DMA buffer app/uart.c polls.
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "host.h"
+#include "py32f071_ll_dma.h"
+#include "driver/uart.h"
+
+#define TX_CAPTURE_SIZE 0x10000
+
+uint8_t UART_DMA_Buffer[256];
+
+static uint32_t gRxWriteIndex;
+
+static uint8_t  gTx[TX_CAPTURE_SIZE];
+static size_t   gTxHead;
+static size_t   gTxTail;
+
+// 38400 8N1
+#define UART_BYTE_CYCLES    (HOST_CPU_HZ / 3840u)
+
+void UART_Init(void)
+{
+    gRxWriteIndex = 0;
+    memset(UART_DMA_Buffer, 0, sizeof(UART_DMA_Buffer));
+}
+
+void UART_Send(const void *pBuffer, uint32_t Size)
+{
+    const uint8_t *pData = (const uint8_t *)pBuffer;
+
+    for (uint32_t i = 0; i < Size; i++) {
+        gTx[gTxHead++ % TX_CAPTURE_SIZE] = pData[i];
+        HOST_AdvanceCycles(UART_BYTE_CYCLES);
+    }
+}
+
+void UART_LogSend(const void *pBuffer, uint32_t Size)
+{
+    (void)pBuffer;
+    (void)Size;
+}
+
+#ifdef ENABLE_FEAT_N7SIX_SCREENSHOT
+    bool UART_IsCableConnected(void) {
+        for (size_t i = 0; i < sizeof(UART_DMA_Buffer); i++) {
+            if (UART_DMA_Buffer[i] == 0x55) {
+                UART_DMA_Buffer[i] = 0x00;  // Clear only the matched byte
+                return true;
+            }
+        }
+        return false;
+    }
+#endif
+
+uint32_t LL_DMA_GetDataLength(DMA_TypeDef *DMAx, uint32_t Channel)
+{
+    (void)DMAx;
+    (void)Channel;
+    return sizeof(UART_DMA_Buffer) - gRxWriteIndex;
+}
+
+size_t HOST_UART_Read(uint8_t *Buf, size_t Size)
+{
+    size_t n = 0;
+
+    if (gTxHead - gTxTail > TX_CAPTURE_SIZE)
+        gTxTail = gTxHead - TX_CAPTURE_SIZE;
+
+    while (n < Size && gTxTail != gTxHead)
+        Buf[n++] = gTx[gTxTail++ % TX_CAPTURE_SIZE];
+
+    return n;
+}
+
+void HOST_UART_Inject(const uint8_t *Buf, size_t Size)
+{
+    for (size_t i = 0; i < Size; i++) {
+        UART_DMA_Buffer[gRxWriteIndex] = Buf[i];
+        gRxWriteIndex = (gRxWriteIndex + 1) % sizeof(UART_DMA_Buffer);
+    }
+}
+
+void HOST_UART_Reset(void)
+{
+    UART_Init();
+    gTxHead = gTxTail = 0;
+}
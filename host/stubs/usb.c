@@ -0,0 +1,86 @@
+/* CherryUSB CDC-ACM glue (usb/usbd_cdc_if.c) for the host build.
+ *
+ * driver/vcp.c is compiled unmodified; data it sends is captured and data
+ * injected by tests lands in its receive ring, as the bulk OUT handler does.
+ * An async send keeps the IN endpoint busy for HOST_VCP_US_PER_BYTE per byte
+ * of virtual time, or until the PC reads again when it is stalled.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "host.h"
+#include "usb_config.h"
+
+#define TX_CAPTURE_SIZE 0x40000
+
+static uint8_t          *gRxBuf;
+static uint32_t          gRxSize;
+static volatile uint32_t *gRxWritePointer;
+
+static uint8_t  gTx[TX_CAPTURE_SIZE];
+static size_t   gTxHead;
+static size_t   gTxTail;
+
+static uint64_t gTxDoneUs;
+static bool     gTxStalled;
+
+void cdc_acm_init(cdc_acm_rx_buf_t rx_buf)
+{
+    gRxBuf          = rx_buf.buf;
+    gRxSize         = rx_buf.size;
+    gRxWritePointer = rx_buf.write_pointer;
+}
+
+void cdc_acm_data_send_with_dtr(const uint8_t *buf, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; i++)
+        gTx[gTxHead++ % TX_CAPTURE_SIZE] = buf[i];
+}
+
+void cdc_acm_data_send_with_dtr_async(const uint8_t *buf, uint32_t size)
+{
+    cdc_acm_data_send_with_dtr(buf, size);
+    gTxDoneUs = HOST_GetTimeUs() + (uint64_t)size * HOST_VCP_US_PER_BYTE;
+}
+
+bool cdc_acm_tx_busy(void)
+{
+    return gTxStalled || HOST_GetTimeUs() < gTxDoneUs;
+}
+
+void HOST_VCP_SetStalled(bool Stalled)
+{
+    gTxStalled = Stalled;
+}
+
+size_t HOST_VCP_Read(uint8_t *Buf, size_t Size)
+{
+    size_t n = 0;
+
+    if (gTxHead - gTxTail > TX_CAPTURE_SIZE)
+        gTxTail = gTxHead - TX_CAPTURE_SIZE;
+
+    while (n < Size && gTxTail != gTxHead)
+        Buf[n++] = gTx[gTxTail++ % TX_CAPTURE_SIZE];
+
+    return n;
+}
+
+void HOST_VCP_Inject(const uint8_t *Buf, size_t Size)
+{
+    if (!gRxBuf)
+        return;
+
+    for (size_t i = 0; i < Size; i++) {
+        gRxBuf[*gRxWritePointer] = Buf[i];
+        *gRxWritePointer = (*gRxWritePointer + 1) % gRxSize;
+    }
+}
+
+void HOST_VCP_Reset(void)
+{
+    gTxHead = gTxTail = 0;
+    gTxDoneUs  = 0;
+    gTxStalled = false;
+}
@@ -0,0 +1,55 @@
+/* Minimal assertion and runner macros for the host test suite.
+ *
+ * Each test_*.c builds into its own executable registered with CTest. A
+ * TEST() body runs on freshly reset models with an erased, RAM-only flash.
+ */
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host.h"
+
+extern unsigned gTestFailures;
+
+#define CHECK(cond)                                                         \
+    do {                                                                    \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n",                    \
+                    __FILE__, __LINE__, #cond);                             \
+            gTestFailures++;                                                \
+        }                                                                   \
+    } while (0)
+
+#define CHECK_EQ(a, b)                                                      \
+    do {                                                                    \
+        const long long _a = (long long)(a);                                \
+        const long long _b = (long long)(b);                                \
+        if (_a != _b) {                                                     \
+            fprintf(stderr, "%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", \
+                    __FILE__, __LINE__, #a, #b, _a, _b);                    \
+            gTestFailures++;                                                \
+        }                                                                   \
+    } while (0)
+
+#define TEST(name) static void name(void)
+
+#define RUN(name)                                                           \
+    do {                                                                    \
+        const unsigned _before = gTestFailures;                             \
+        HOST_Reset();                                                       \
+        HOST_FLASH_Open(NULL);                                              \
+        name();                                                             \
+        printf("%s %s\n", gTestFailures == _before ? "PASS" : "FAIL", #name); \
+    } while (0)
+
+#define TEST_MAIN_BEGIN  unsigned gTestFailures; int main(void) {
+#define TEST_MAIN_END    return gTestFailures ? EXIT_FAILURE : EXIT_SUCCESS; }
+
+// Benchmark figures, one per line, easy to grep out of the CTest log
+#define BENCH(name, fmt, ...) printf("BENCH %-32s " fmt "\n", name, __VA_ARGS__)
+
+#endif
@@ -0,0 +1,295 @@
+/* BK4819 chip model driven by a scripted band: squelch, interrupts, CxCSS,
+ * frequency scan and FSK, then closed-loop scans through the firmware. */
+
+#include "test.h"
+
+#include "app/chFrScanner.h"
+#include "dcs.h"
+#include "driver/bk4819.h"
+#include "driver/bk4819-regs.h"
+#include "driver/systick.h"
+#include "functions.h"
+#include "misc.h"
+#include "radio.h"
+
+#define TEST_FREQ   14652000
+
+static uint32_t NowMs(void)
+{
+    return HOST_GetTimeUs() / 1000;
+}
+
+static void AddCarrier(uint32_t Frequency, int16_t Level, uint32_t OnMs, uint32_t OffMs)
+{
+    const HOST_Signal_t s = { .Frequency = Frequency, .Level = Level, .OnMs = OnMs, .OffMs = OffMs };
+    HOST_BAND_Add(&s);
+}
+
+// Chip brought up the way RADIO_SetupRegisters() leaves it at squelch level 1
+static void ChipListen(uint32_t Frequency, uint16_t Interrupts)
+{
+    BK4819_Init();
+    BK4819_SetFrequency(Frequency);
+    BK4819_SetupSquelch(25, 40, 127, 70, 90, 200);
+    BK4819_WriteRegister(BK4819_REG_3F, Interrupts);
+}
+
+static uint16_t WaitInterrupt(uint32_t TimeoutMs)
+{
+    while (TimeoutMs--) {
+        if (BK4819_ReadRegister(BK4819_REG_0C) & 1u) {
+            BK4819_WriteRegister(BK4819_REG_02, 0);
+            return BK4819_ReadRegister(BK4819_REG_02);
+        }
+        SYSTICK_DelayUs(1000);
+    }
+    return 0;
+}
+
+static bool IsReceiving(void)
+{
+    return gCurrentFunction == FUNCTION_INCOMING || gCurrentFunction == FUNCTION_RECEIVE;
+}
+
+TEST(squelch_interrupts_latch_in_reg_02)
+{
+    ChipListen(TEST_FREQ, BK4819_REG_3F_SQUELCH_FOUND | BK4819_REG_3F_SQUELCH_LOST);
+    AddCarrier(TEST_FREQ, -90, NowMs() + 50, NowMs() + 250);
+
+    SYSTICK_DelayUs(40000);
+    CHECK(!(BK4819_ReadRegister(BK4819_REG_0C) & 1u));
+
+    // "Lost" is the squelch gate opening on a carrier, "found" it closing
+    CHECK_EQ(WaitInterrupt(100), BK4819_REG_02_SQUELCH_LOST);
+    CHECK(!(BK4819_ReadRegister(BK4819_REG_0C) & 1u));
+    CHECK(HOST_BK4819_IsSquelchOpen());
+
+    CHECK_EQ(WaitInterrupt(400), BK4819_REG_02_SQUELCH_FOUND);
+    CHECK_EQ(HOST_BK4819_GetStats()->SquelchOpens, 1);
+    CHECK_EQ(HOST_BK4819_GetStats()->FalseOpens, 0);
+}
+
+TEST(masked_interrupts_stay_quiet)
+{
+    ChipListen(TEST_FREQ, 0);
+    AddCarrier(TEST_FREQ, -90, 0, 0);
+
+    SYSTICK_DelayUs(100000);
+    CHECK(HOST_BK4819_IsSquelchOpen());
+    CHECK(!(BK4819_ReadRegister(BK4819_REG_0C) & 1u));
+}
+
+TEST(indicators_follow_level)
+{
+    ChipListen(TEST_FREQ, 0);
+    AddCarrier(TEST_FREQ + 100000, -60, 0, 0);
+
+    SYSTICK_DelayUs(HOST_BK4819_SETTLE_US);
+    const uint16_t NoiseRssi   = BK4819_GetRSSI();
+    const uint8_t  NoiseGlitch = BK4819_GetGlitchIndicator();
+
+    BK4819_SetFrequency(TEST_FREQ + 100000);
+    CHECK_EQ(BK4819_GetGlitchIndicator(), 255);     // still settling
+    SYSTICK_DelayUs(HOST_BK4819_SETTLE_US);
+
+    CHECK(NoiseRssi >= (HOST_BAND_NOISE_FLOOR + 160) * 2 - 2);
+    CHECK(NoiseRssi <= (HOST_BAND_NOISE_FLOOR + 160) * 2 + 2);
+    CHECK(NoiseGlitch > 200);
+    CHECK(BK4819_GetRSSI() >= (-60 + 160) * 2 - 2);
+    CHECK(BK4819_GetGlitchIndicator() < 20);
+    CHECK(BK4819_GetExNoiceIndicator() < 20);
+}
+
+TEST(ctcss_found_and_scan_result)
+{
+    const HOST_Signal_t s = {
+        .Frequency = TEST_FREQ, .Level = -80, .Css = HOST_CSS_CTCSS, .CssCode = 885,
+    };
+
+    ChipListen(TEST_FREQ, BK4819_REG_3F_CTCSS_FOUND);
+    BK4819_SetCTCSSFrequency(885);
+    HOST_BAND_Add(&s);
+
+    CHECK(WaitInterrupt(300) & BK4819_REG_02_CTCSS_FOUND);
+
+    uint32_t Cdcss;
+    uint16_t Ctcss = 0;
+    CHECK_EQ(BK4819_GetCxCSSScanResult(&Cdcss, &Ctcss), BK4819_CSS_RESULT_CTCSS);
+    CHECK(Ctcss >= 884 && Ctcss <= 886);
+}
+
+TEST(wrong_ctcss_is_not_found)
+{
+    const HOST_Signal_t s = {
+        .Frequency = TEST_FREQ, .Level = -80, .Css = HOST_CSS_CTCSS, .CssCode = 1000,
+    };
+
+    ChipListen(TEST_FREQ, BK4819_REG_3F_CTCSS_FOUND);
+    BK4819_SetCTCSSFrequency(885);
+    HOST_BAND_Add(&s);
+
+    CHECK_EQ(WaitInterrupt(500), 0);
+}
+
+TEST(cdcss_found_and_scan_result)
+{
+    const uint32_t Word = DCS_GetGolayCodeWord(CODE_TYPE_DIGITAL, 10);
+    const HOST_Signal_t s = {
+        .Frequency = TEST_FREQ, .Level = -80, .Css = HOST_CSS_CDCSS, .CssCode = Word,
+    };
+
+    ChipListen(TEST_FREQ, BK4819_REG_3F_CDCSS_FOUND);
+    BK4819_SetCDCSSCodeWord(Word);
+    HOST_BAND_Add(&s);
+
+    CHECK(WaitInterrupt(400) & BK4819_REG_02_CDCSS_FOUND);
+
+    uint32_t Cdcss = 0;
+    uint16_t Ctcss;
+    CHECK_EQ(BK4819_GetCxCSSScanResult(&Cdcss, &Ctcss), BK4819_CSS_RESULT_CDCSS);
+    CHECK_EQ(Cdcss, Word & 0xFFFFFF);
+}
+
+TEST(frequency_scan_result)
+{
+    uint32_t Result = 0;
+
+    BK4819_Init();
+    AddCarrier(TEST_FREQ, -50, 0, 0);
+    BK4819_EnableFrequencyScan();
+
+    SYSTICK_DelayUs(100000);
+    CHECK(!BK4819_GetFrequencyScanResult(&Result));
+    SYSTICK_DelayUs(150000);
+    CHECK(BK4819_GetFrequencyScanResult(&Result));
+    CHECK_EQ(Result, TEST_FREQ);
+}
+
+TEST(fsk_words_arrive_through_fifo)
+{
+    static const uint16_t Words[8] = { 0xABCD, 1, 2, 3, 4, 5, 6, 0xDCBA };
+    const HOST_Signal_t s = {
+        .Frequency = TEST_FREQ, .Level = -70, .Fsk = Words, .FskWords = 8,
+    };
+    uint16_t Got[8];
+    unsigned n = 0;
+    uint16_t Flags;
+
+    BK4819_Init();
+    BK4819_SetFrequency(TEST_FREQ);
+    BK4819_PrepareFSKReceive();
+    HOST_BAND_Add(&s);
+
+    while (n < 8 && (Flags = WaitInterrupt(500)) != 0) {
+        if (Flags & BK4819_REG_02_FSK_FIFO_ALMOST_FULL)
+            for (unsigned i = 0; i < 4 && n < 8; i++)
+                Got[n++] = BK4819_ReadRegister(BK4819_REG_5F);
+        if (Flags & BK4819_REG_02_FSK_RX_FINISHED)
+            break;
+    }
+
+    CHECK_EQ(n, 8);
+    CHECK(memcmp(Got, Words, sizeof(Words)) == 0);
+}
+
+TEST(radio_opens_on_carrier_only)
+{
+    HOST_WriteSquelchCalibration();
+    HOST_Boot();
+
+    const uint32_t f = gRxVfo->pRX->Frequency;
+    AddCarrier(f, -95, NowMs() + 2000, NowMs() + 3000);
+
+    HOST_RunMs(1900);
+    CHECK(!IsReceiving());
+    HOST_RunMs(500);
+    CHECK(IsReceiving());
+    HOST_RunMs(1000);
+    CHECK(!IsReceiving());
+
+    CHECK_EQ(HOST_BK4819_GetStats()->SquelchOpens, 1);
+    CHECK_EQ(HOST_BK4819_GetStats()->FalseOpens, 0);
+}
+
+// ---- Closed-loop scan figures ----
+
+static uint32_t gChannels;
+static uint32_t gLastFrequency;
+
+static void CountChannels(uint8_t Reg, uint16_t Value)
+{
+    (void)Value;
+    if ((Reg == BK4819_REG_38 || Reg == BK4819_REG_39) && HOST_BK4819_GetFrequency() != gLastFrequency) {
+        gLastFrequency = HOST_BK4819_GetFrequency();
+        gChannels++;
+    }
+}
+
+TEST(frequency_scan_locks_on_signal)
+{
+    HOST_WriteSquelchCalibration();
+    HOST_Boot();
+
+    const uint32_t Step   = gRxVfo->StepFrequency;
+    const uint32_t Target = gRxVfo->pRX->Frequency + 40 * Step;
+
+    AddCarrier(Target, -100, 0, 0);
+
+    gChannels      = 0;
+    gLastFrequency = HOST_BK4819_GetFrequency();
+    HOST_BK4819_SetHooks(NULL, CountChannels);
+    HOST_BK4819_ResetStats();
+
+    const uint64_t Start = HOST_GetTimeUs();
+    CHFRSCANNER_Start(true, SCAN_FWD);
+
+    unsigned ms = 0;
+    while (ms < 10000 && !(IsReceiving() && HOST_BK4819_GetFrequency() == Target)) {
+        HOST_RunMs(10);
+        ms += 10;
+    }
+
+    const double LockMs = (HOST_GetTimeUs() - Start) / 1000.0;
+    CHECK_EQ(HOST_BK4819_GetFrequency(), Target);
+    CHECK(IsReceiving());
+
+    BENCH("band.scan_channels_per_s", "%.1f", gChannels * 1000.0 / LockMs);
+    BENCH("band.scan_time_to_lock_ms", "%.0f", LockMs);
+    BENCH("band.scan_false_triggers", "%u", HOST_BK4819_GetStats()->FalseOpens);
+    BENCH("band.open_to_receive_ms", "%.0f", (HOST_GetTimeUs() - HOST_BK4819_GetStats()->LastOpenUs) / 1000.0);
+
+    CHFRSCANNER_Stop();
+}
+
+TEST(frequency_scan_through_splatter)
+{
+    HOST_WriteSquelchCalibration();
+    HOST_Boot();
+
+    const uint32_t Step = gRxVfo->StepFrequency;
+
+    AddCarrier(gRxVfo->pRX->Frequency + 10 * Step, -40, 0, 0);
+
+    HOST_BK4819_ResetStats();
+    CHFRSCANNER_Start(true, SCAN_FWD);
+    HOST_RunMs(5000);
+    CHFRSCANNER_Stop();
+
+    BENCH("band.splatter_false_triggers", "%u", HOST_BK4819_GetStats()->FalseOpens);
+    BENCH("band.splatter_opens", "%u", HOST_BK4819_GetStats()->SquelchOpens);
+    CHECK(HOST_BK4819_GetStats()->SquelchOpens >= 1);
+}
+
+TEST_MAIN_BEGIN
+    RUN(squelch_interrupts_latch_in_reg_02);
+    RUN(masked_interrupts_stay_quiet);
+    RUN(indicators_follow_level);
+    RUN(ctcss_found_and_scan_result);
+    RUN(wrong_ctcss_is_not_found);
+    RUN(cdcss_found_and_scan_result);
+    RUN(frequency_scan_result);
+    RUN(fsk_words_arrive_through_fifo);
+    RUN(radio_opens_on_carrier_only);
+    RUN(frequency_scan_locks_on_signal);
+    RUN(frequency_scan_through_splatter);
+TEST_MAIN_END
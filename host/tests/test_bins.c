@@ -0,0 +1,242 @@
+/* app/spectrum_bins.c: wide sweeps folded into the display bins and the
+ * fine level zoomed views are read from, against a brute-force fold. */
+
+#include "test.h"
+
+#include "app/spectrum_bins.h"
+
+#define SURVEY_STEPS    2800    // 400..470 MHz at 25 kHz
+
+static uint16_t gHistory[BINS_COUNT];
+static uint16_t gRssi[BINS_MAX_STEPS];
+
+static void Fill(uint16_t Steps)
+{
+    for (unsigned i = 0; i < Steps; i++)
+        gRssi[i] = 60 + (i * 37 + i / 7) % 90;
+
+    // A narrow carrier, one step wide
+    gRssi[Steps / 3] = 400;
+}
+
+static void Sweep(uint16_t Steps)
+{
+    BINS_Setup(gHistory, Steps);
+    for (unsigned i = 0; i < Steps; i++)
+        CHECK_EQ(BINS_Add(i, gRssi[i]), i * BINS_COUNT / Steps);
+}
+
+// Checks every bin against the samples with i * BINS_COUNT / Steps == b
+static void CheckBins(uint16_t Steps)
+{
+    for (unsigned b = 0; b < BINS_COUNT; b++) {
+        uint16_t Max = 0, MaxAt = 0, Min = UINT16_MAX;
+        uint32_t Sum = 0, Count = 0;
+
+        for (unsigned i = 0; i < Steps; i++) {
+            if (i * BINS_COUNT / Steps != b)
+                continue;
+            if (gRssi[i] > Max) Max = gRssi[i], MaxAt = i;
+            if (gRssi[i] < Min) Min = gRssi[i];
+            Sum += gRssi[i];
+            Count++;
+        }
+
+        CHECK(Count > 0);
+        CHECK_EQ(gHistory[b], Max);
+        CHECK_EQ(BINS_GetMaxAt(b), MaxAt);
+        CHECK_EQ(BINS_GetAvg(b), Sum / Count);
+        CHECK_EQ(BINS_GetMin(b), Min);
+    }
+}
+
+TEST(survey_bins_hold_max_avg)
+{
+    Fill(SURVEY_STEPS);
+    Sweep(SURVEY_STEPS);
+    CheckBins(SURVEY_STEPS);
+
+    // The carrier shows in its bin's max, not its min
+    CHECK(BINS_GetMin(BINS_Of(SURVEY_STEPS / 3)) < 400);
+
+    // The carrier shows in its bin, the neighbour is not wiped
+    const uint8_t Bin = BINS_Of(SURVEY_STEPS / 3);
+    CHECK_EQ(gHistory[Bin], 400);
+    CHECK(gHistory[Bin + 1] != 0);
+
+    // A second sweep starts every bin afresh instead of holding the first
+    gRssi[SURVEY_STEPS / 3] = 70;
+    Sweep(SURVEY_STEPS);
+    CHECK(gHistory[Bin] < 400);
+    CheckBins(SURVEY_STEPS);
+}
+
+TEST(uneven_and_longest_sweeps)
+{
+    const uint16_t Steps[] = { 129, 200, 511, 513, 1000, 4097, BINS_MAX_STEPS };
+
+    for (unsigned k = 0; k < sizeof(Steps) / sizeof(Steps[0]); k++) {
+        Fill(Steps[k]);
+        Sweep(Steps[k]);
+        CheckBins(Steps[k]);
+        CHECK_EQ(BINS_Of(Steps[k] - 1), BINS_COUNT - 1);
+    }
+}
+
+// Max over the steps whose fine column i * BINS_FINE / Steps is in [First, First + Count)
+static uint16_t FineMax(uint16_t Steps, unsigned First, unsigned Count)
+{
+    uint16_t Max = 0;
+
+    for (unsigned i = 0; i < Steps; i++) {
+        const unsigned Col = i * BINS_FINE / Steps;
+        if (Col >= First && Col < First + Count && gRssi[i] > Max)
+            Max = gRssi[i];
+    }
+
+    return Max & ~1u;   // the fine level is in 1 dB
+}
+
+TEST(zoom_reads_the_fine_level)
+{
+    uint16_t View[BINS_COUNT];
+
+    Fill(SURVEY_STEPS);
+    Sweep(SURVEY_STEPS);
+
+    for (uint8_t Zoom = 0; Zoom <= BINS_ZOOM_MAX; Zoom++) {
+        const unsigned Per    = (BINS_FINE / BINS_COUNT) >> Zoom;
+        const uint16_t Offset = Zoom ? BINS_FINE / 5 : 0;
+
+        BINS_View(View, Zoom, Offset);
+        for (unsigned x = 0; x < BINS_COUNT; x++)
+            CHECK_EQ(View[x], FineMax(SURVEY_STEPS, Offset + x * Per, Per));
+    }
+
+    // The carrier keeps its full level at x4 around it
+    const uint16_t Col = (SURVEY_STEPS / 3) * BINS_FINE / SURVEY_STEPS;
+    BINS_View(View, BINS_ZOOM_MAX, Col - BINS_COUNT / 2);
+    CHECK_EQ(View[BINS_COUNT / 2], 400);
+
+    // Past the end the view is held at the last column
+    BINS_View(View, 1, BINS_FINE);
+    CHECK_EQ(View[BINS_COUNT - 1], FineMax(SURVEY_STEPS, BINS_FINE - 2, 2));
+}
+
+TEST(short_sweeps_fill_every_fine_column)
+{
+    uint16_t View[BINS_COUNT];
+
+    Fill(200);
+    Sweep(200);
+
+    // 200 steps over 512 columns: a column no step falls in holds the one
+    // before it rather than reading as empty
+    uint16_t Held = 0;
+    BINS_View(View, BINS_ZOOM_MAX, 0);
+    for (unsigned x = 0; x < BINS_COUNT; x++) {
+        const uint16_t Own = FineMax(200, x, 1);
+        if (Own)
+            Held = Own;
+        CHECK(View[x] != 0);
+        CHECK_EQ(View[x], Held);
+    }
+
+    // The columns past the last step hold it too, not an older sweep's level
+    for (unsigned i = 0; i < 200; i++)
+        gRssi[i] = 70;
+    Sweep(200);
+    for (uint16_t Offset = 0; Offset < BINS_FINE; Offset += BINS_COUNT) {
+        BINS_View(View, BINS_ZOOM_MAX, Offset);
+        for (unsigned x = 0; x < BINS_COUNT; x++)
+            CHECK_EQ(View[x], 70);
+    }
+}
+
+TEST(skipped_steps_leave_the_average_alone)
+{
+    Fill(SURVEY_STEPS);
+    BINS_Setup(gHistory, SURVEY_STEPS);
+
+    // Every 5th step skipped, as a blacklisted one is
+    uint32_t Sum[BINS_COUNT] = { 0 }, Count[BINS_COUNT] = { 0 };
+    uint16_t Min[BINS_COUNT];
+    for (unsigned b = 0; b < BINS_COUNT; b++)
+        Min[b] = UINT16_MAX;
+    for (unsigned i = 0; i < SURVEY_STEPS; i++) {
+        if (i % 5 == 2) {
+            BINS_Skip(i);
+            continue;
+        }
+        const uint8_t Bin = BINS_Add(i, gRssi[i]);
+        CHECK_EQ(Bin, i * BINS_COUNT / SURVEY_STEPS);
+        Sum[Bin] += gRssi[i];
+        Count[Bin]++;
+        if (gRssi[i] < Min[Bin])
+            Min[Bin] = gRssi[i];
+    }
+
+    for (unsigned b = 0; b < BINS_COUNT; b++) {
+        CHECK_EQ(BINS_GetAvg(b), Sum[b] / Count[b]);
+        CHECK_EQ(BINS_GetMin(b), Min[b]);
+    }
+}
+
+TEST(skipped_bins_read_as_the_floor)
+{
+    uint16_t View[BINS_COUNT];
+
+    Fill(SURVEY_STEPS);
+    Sweep(SURVEY_STEPS);
+    const uint8_t Bin = BINS_Of(SURVEY_STEPS / 3);
+    CHECK_EQ(gHistory[Bin], 400);
+
+    // The carrier's bin blacklisted whole, the one after it in part
+    BINS_Setup(gHistory, SURVEY_STEPS);
+    for (unsigned i = 0; i < SURVEY_STEPS; i++) {
+        const uint8_t b = BINS_Of(i);
+        if (b == Bin || (b == Bin + 1 && i % 2))
+            BINS_Skip(i);
+        else
+            BINS_Add(i, gRssi[i]);
+    }
+
+    // The last sweep's carrier is gone from the max, the fine level and
+    // the average, the partly skipped bin keeps what was measured
+    CHECK_EQ(gHistory[Bin], 0);
+    CHECK_EQ(BINS_GetAvg(Bin), 0);
+    CHECK_EQ(BINS_GetMin(Bin), 0);
+    BINS_View(View, 0, 0);
+    CHECK_EQ(View[Bin], 0);
+
+    uint16_t Max = 0;
+    for (unsigned i = 0; i < SURVEY_STEPS; i++)
+        if (BINS_Of(i) == Bin + 1 && i % 2 == 0 && gRssi[i] > Max)
+            Max = gRssi[i];
+    CHECK_EQ(gHistory[Bin + 1], Max);
+}
+
+TEST(long_ranges_sweep_coarser_to_the_end)
+{
+    // 400..470 MHz at 6.25 kHz is 11200 steps, swept at 12.5 kHz
+    const uint32_t Span = 7000000;
+    const uint32_t Step = BINS_SweepStep(Span, 625);
+
+    CHECK_EQ(Step, 1250);
+    CHECK(Span / Step <= BINS_MAX_STEPS);
+
+    // Ranges that fit keep their step
+    CHECK_EQ(BINS_SweepStep(Span, 2500), 2500);
+    CHECK_EQ(BINS_SweepStep(BINS_MAX_STEPS * 625u, 625), 625);
+    CHECK_EQ(BINS_SweepStep(BINS_MAX_STEPS * 625u + 625, 625), 1250);
+}
+
+TEST_MAIN_BEGIN
+    RUN(survey_bins_hold_max_avg);
+    RUN(uneven_and_longest_sweeps);
+    RUN(zoom_reads_the_fine_level);
+    RUN(short_sweeps_fill_every_fine_column);
+    RUN(skipped_steps_leave_the_average_alone);
+    RUN(skipped_bins_read_as_the_floor);
+    RUN(long_ranges_sweep_coarser_to_the_end);
+TEST_MAIN_END
@@ -0,0 +1,166 @@
+/* driver/bk4829.c against the bus model: framing, read-back, bus timing. */
+
+#include "test.h"
+
+#include "driver/bk4819.h"
+#include "driver/bk4819-regs.h"
+#include "driver/systick.h"
+#include "radio.h"
+
+static uint16_t RssiRamp(uint32_t Frequency)
+{
+    return (Frequency / 1000) & 0x1FF;
+}
+
+// Read back values derived by the chip model rather than the last write
+static bool IsStatusRegister(unsigned Reg)
+{
+    switch (Reg) {
+    case 0x02: case 0x0B: case 0x0C: case 0x0D: case 0x0E: case 0x5F:
+    case 0x63: case 0x65: case 0x67: case 0x68: case 0x69: case 0x6A:
+        return true;
+    default:
+        return false;
+    }
+}
+
+TEST(write_then_read_every_register)
+{
+    for (unsigned reg = 0; reg < 0x80; reg++)
+        BK4819_WriteRegister(reg, 0xA5C3 ^ (reg * 0x0101));
+
+    for (unsigned reg = 0; reg < 0x80; reg++) {
+        CHECK_EQ(HOST_BK4819_Peek(reg), 0xA5C3 ^ (reg * 0x0101));
+        if (!IsStatusRegister(reg))
+            CHECK_EQ(BK4819_ReadRegister(reg), 0xA5C3 ^ (reg * 0x0101));
+    }
+
+    CHECK_EQ(HOST_BK4819_GetStats()->Writes, 0x80);
+}
+
+TEST(set_frequency_lands_in_reg_38_39)
+{
+    BK4819_SetFrequency(14652000);
+    CHECK_EQ(HOST_BK4819_GetFrequency(), 14652000);
+    CHECK_EQ(HOST_BK4819_GetStats()->RegWrites[BK4819_REG_38], 1);
+    CHECK_EQ(HOST_BK4819_GetStats()->RegWrites[BK4819_REG_39], 1);
+}
+
+TEST(rssi_follows_scripted_source)
+{
+    HOST_BK4819_SetRssiSource(RssiRamp);
+    BK4819_RX_TurnOn();
+
+    BK4819_SetFrequency(14500000);
+    SYSTICK_DelayUs(HOST_BK4819_SETTLE_US);
+    CHECK_EQ(BK4819_GetRSSI(), RssiRamp(14500000));
+
+    // Mid-settle the reading sits between the old and new frequency
+    BK4819_SetFrequency(43300000);
+    SYSTICK_DelayUs(HOST_BK4819_SETTLE_US / 2);
+    const uint16_t Mid = BK4819_GetRSSI();
+    CHECK(Mid > RssiRamp(14500000) && Mid < RssiRamp(43300000));
+
+    SYSTICK_DelayUs(HOST_BK4819_SETTLE_US);
+    CHECK_EQ(BK4819_GetRSSI(), RssiRamp(43300000));
+}
+
+TEST(init_programs_chip)
+{
+    BK4819_Init();
+    CHECK(HOST_BK4819_GetStats()->Writes > 40);
+    CHECK(HOST_BK4819_GetStats()->RegWrites[BK4819_REG_00] > 0);
+}
+
+TEST(shadow_skips_redundant_writes)
+{
+    BK4819_WriteRegister(BK4819_REG_47, 0x6040);
+    BK4819_WriteRegister(BK4819_REG_47, 0x6040);
+    BK4819_WriteRegister(BK4819_REG_47, 0x6140);
+    CHECK_EQ(HOST_BK4819_GetStats()->RegWrites[BK4819_REG_47], 2);
+    CHECK_EQ(HOST_BK4819_Peek(BK4819_REG_47), 0x6140);
+    CHECK_EQ(BK4819_GetSavedWrites(), 1);
+
+    // Side-effecting registers always reach the chip
+    BK4819_WriteRegister(BK4819_REG_02, 0);
+    BK4819_WriteRegister(BK4819_REG_02, 0);
+    BK4819_WriteRegister(BK4819_REG_30, 0xBFF1);
+    BK4819_WriteRegister(BK4819_REG_30, 0xBFF1);
+    CHECK_EQ(HOST_BK4819_GetStats()->RegWrites[BK4819_REG_02], 2);
+    CHECK_EQ(HOST_BK4819_GetStats()->RegWrites[BK4819_REG_30], 2);
+
+    // A soft reset forgets everything
+    BK4819_WriteRegister(BK4819_REG_00, 0x8000);
+    BK4819_WriteRegister(BK4819_REG_47, 0x6140);
+    CHECK_EQ(HOST_BK4819_GetStats()->RegWrites[BK4819_REG_47], 3);
+}
+
+TEST(shadow_saves_on_resetup)
+{
+    HOST_Boot();
+    HOST_BK4819_ResetStats();
+    const uint32_t Saved = BK4819_GetSavedWrites();
+
+    RADIO_SetupRegisters(true);
+
+    const uint32_t Skipped = BK4819_GetSavedWrites() - Saved;
+    BENCH("bk4819.setup_writes", "%u", (unsigned)HOST_BK4819_GetStats()->Writes);
+    BENCH("bk4819.setup_saved_writes", "%u", (unsigned)Skipped);
+    CHECK(Skipped > 0);
+}
+
+TEST(bus_timing)
+{
+    const unsigned n = 1000;
+
+    uint64_t start = HOST_GetCycles();
+    for (unsigned i = 0; i < n; i++)
+        BK4819_WriteRegister(BK4819_REG_38, i);
+    const double write_us = (double)(HOST_GetCycles() - start) / HOST_CYCLES_PER_US / n;
+
+    start = HOST_GetCycles();
+    for (unsigned i = 0; i < n; i++)
+        BK4819_ReadRegister(BK4819_REG_67);
+    const double read_us = (double)(HOST_GetCycles() - start) / HOST_CYCLES_PER_US / n;
+
+    BENCH("bk4819.write_us_per_reg", "%.2f", write_us);
+    BENCH("bk4819.read_us_per_reg", "%.2f", read_us);
+
+    CHECK(write_us > 0);
+    CHECK(read_us > 0);
+}
+
+TEST(burst_write)
+{
+    BK4819_RegisterWrite_t List[32];
+
+    for (unsigned i = 0; i < 32; i++)
+        List[i] = (BK4819_RegisterWrite_t){0x10 + i, 0x1000 + i};
+
+    uint64_t start = HOST_GetCycles();
+    BK4819_WriteRegisters(List, 32);
+    const double burst_us = (double)(HOST_GetCycles() - start) / HOST_CYCLES_PER_US / 32;
+
+    for (unsigned i = 0; i < 32; i++)
+        CHECK_EQ(HOST_BK4819_Peek(0x10 + i), 0x1000 + i);
+    CHECK_EQ(HOST_BK4819_GetStats()->Writes, 32);
+
+    // Entries already in the shadow are dropped from the burst
+    List[5].Value ^= 1;
+    BK4819_WriteRegisters(List, 32);
+    CHECK_EQ(HOST_BK4819_GetStats()->Writes, 33);
+    CHECK_EQ(HOST_BK4819_Peek(0x15), 0x1004);
+
+    BENCH("bk4819.burst_us_per_reg", "%.2f", burst_us);
+}
+
+TEST_MAIN_BEGIN
+    RUN(write_then_read_every_register);
+    RUN(set_frequency_lands_in_reg_38_39);
+    RUN(rssi_follows_scripted_source);
+    RUN(init_programs_chip);
+    RUN(shadow_skips_redundant_writes);
+    RUN(shadow_saves_on_resetup);
+    RUN(bus_timing);
+    RUN(burst_write);
+TEST_MAIN_END
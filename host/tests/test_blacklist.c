@@ -0,0 +1,128 @@
+/* app/blacklist.c: the saved per-band list and its projection onto the
+ * steps of the current sweep. */
+
+#include "test.h"
+
+#include "app/blacklist.h"
+#include "driver/py25q16.h"
+
+#define UHF_START   43000000    // 430 MHz, 10 Hz units
+#define VHF_START   14400000    // 144 MHz
+#define STEP        2500        // 25 kHz
+
+// The module keeps the band it last loaded across tests, while every test
+// starts on erased flash: park it on another band with an empty list
+static void Fresh(void)
+{
+    BLACKLIST_Project(5000000, STEP, 128);
+    BLACKLIST_Clear();
+}
+
+static unsigned CountSet(uint16_t Steps)
+{
+    unsigned Count = 0;
+    for (unsigned i = 0; i < Steps; i++)
+        Count += BLACKLIST_IsSet(i);
+    return Count;
+}
+
+TEST(entries_follow_the_step_grid)
+{
+    Fresh();
+    BLACKLIST_Project(UHF_START, STEP, 128);
+    CHECK_EQ(CountSet(128), 0);
+
+    BLACKLIST_Add(UHF_START + 10 * STEP);
+    BLACKLIST_Add(UHF_START + 10 * STEP);     // already there
+    CHECK_EQ(BLACKLIST_GetCount(), 1);
+    CHECK(BLACKLIST_IsSet(10));
+    CHECK_EQ(CountSet(128), 1);
+
+    // Halving the step moves the entry to step 20, the old step 10 is free
+    BLACKLIST_Project(UHF_START, STEP / 2, 128);
+    CHECK(BLACKLIST_IsSet(20));
+    CHECK_EQ(CountSet(128), 1);
+
+    // Panned past it, nothing is skipped
+    BLACKLIST_Project(UHF_START + 200 * STEP, STEP, 128);
+    CHECK_EQ(CountSet(128), 0);
+
+    // Off the grid it goes to the nearest step
+    BLACKLIST_Project(UHF_START - 1000, STEP, 128);
+    CHECK(BLACKLIST_IsSet(10));
+}
+
+TEST(lists_are_kept_per_band_in_flash)
+{
+    Fresh();
+    BLACKLIST_Project(UHF_START, STEP, 128);
+    BLACKLIST_Add(UHF_START + 5 * STEP);
+    BLACKLIST_Add(UHF_START + 7 * STEP);
+
+    BLACKLIST_Project(VHF_START, STEP, 128);
+    CHECK_EQ(BLACKLIST_GetCount(), 0);
+    BLACKLIST_Add(VHF_START + 3 * STEP);
+
+    // Power cycle: only what reached the flash is back
+    HOST_Reset();
+    Fresh();
+
+    BLACKLIST_Project(UHF_START, STEP, 128);
+    CHECK_EQ(BLACKLIST_GetCount(), 2);
+    CHECK(BLACKLIST_IsSet(5) && BLACKLIST_IsSet(7));
+    CHECK_EQ(CountSet(128), 2);
+
+    BLACKLIST_Project(VHF_START, STEP, 128);
+    CHECK_EQ(BLACKLIST_GetCount(), 1);
+    CHECK(BLACKLIST_IsSet(3));
+
+    // Clearing one band leaves the other
+    BLACKLIST_Clear();
+    CHECK_EQ(CountSet(128), 0);
+    BLACKLIST_Project(UHF_START, STEP, 128);
+    CHECK_EQ(BLACKLIST_GetCount(), 2);
+}
+
+TEST(a_full_list_drops_the_oldest)
+{
+    Fresh();
+    BLACKLIST_Project(UHF_START, STEP, 128);
+    for (unsigned i = 0; i < BLACKLIST_ENTRIES + 1; i++)
+        BLACKLIST_Add(UHF_START + i * STEP);
+
+    CHECK_EQ(BLACKLIST_GetCount(), BLACKLIST_ENTRIES);
+    CHECK(!BLACKLIST_IsSet(0));
+    CHECK(BLACKLIST_IsSet(1));
+    CHECK(BLACKLIST_IsSet(BLACKLIST_ENTRIES));
+    CHECK_EQ(CountSet(128), BLACKLIST_ENTRIES);
+}
+
+TEST(long_sweeps_share_bits)
+{
+    const uint16_t Fine = STEP / 10;
+
+    Fresh();
+    BLACKLIST_Project(UHF_START, Fine, 4000);
+    CHECK_EQ(gBlacklistShift, 2);
+
+    BLACKLIST_Add(UHF_START + 3001 * Fine);
+
+    // Skipped with the 3 others of its group of 4, the last step is reachable
+    CHECK_EQ(CountSet(4000), 4);
+    CHECK(BLACKLIST_IsSet(3000) && BLACKLIST_IsSet(3003));
+    CHECK(!BLACKLIST_IsSet(3004));
+    CHECK(!BLACKLIST_IsSet(3999));
+
+    // Back to a short sweep it is a single step again
+    BLACKLIST_Project(UHF_START + 3000 * Fine, Fine, 128);
+    CHECK_EQ(gBlacklistShift, 0);
+    CHECK_EQ(CountSet(128), 1);
+    CHECK(BLACKLIST_IsSet(1));
+}
+
+TEST_MAIN_BEGIN
+    RUN(entries_follow_the_step_grid);
+    RUN(lists_are_kept_per_band_in_flash);
+    RUN(a_full_list_drops_the_oldest);
+    RUN(long_sweeps_share_bits);
+TEST_MAIN_END
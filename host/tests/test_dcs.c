@@ -0,0 +1,49 @@
+/* CTCSS/DCS code tables and Golay encoding in dcs.c. */
+
+#include "test.h"
+
+#include "dcs.h"
+#include "misc.h"
+
+TEST(golay_round_trip)
+{
+    for (unsigned i = 0; i < ARRAY_SIZE(DCS_Options); i++) {
+        const uint32_t Word = DCS_GetGolayCodeWord(CODE_TYPE_DIGITAL, i);
+        CHECK_EQ(Word & 0xFFF, DCS_Options[i] + 0x800u);
+        CHECK(Word < (1u << 23));
+        CHECK_EQ(DCS_GetCdcssCode(Word), i);
+    }
+}
+
+TEST(golay_round_trip_rotated)
+{
+    // The decoder sees the word at an arbitrary bit phase
+    for (unsigned i = 0; i < ARRAY_SIZE(DCS_Options); i++) {
+        uint32_t Word = DCS_GetGolayCodeWord(CODE_TYPE_DIGITAL, i);
+        for (unsigned r = 0; r < 7; r++)
+            Word = ((Word << 1) | (Word >> 22)) & 0x7FFFFF;
+        CHECK_EQ(DCS_GetCdcssCode(Word), i);
+    }
+}
+
+TEST(reverse_is_inverted)
+{
+    for (unsigned i = 0; i < ARRAY_SIZE(DCS_Options); i++)
+        CHECK_EQ(DCS_GetGolayCodeWord(CODE_TYPE_REVERSE_DIGITAL, i),
+                 DCS_GetGolayCodeWord(CODE_TYPE_DIGITAL, i) ^ 0x7FFFFF);
+}
+
+TEST(ctcss_nearest)
+{
+    for (unsigned i = 0; i < ARRAY_SIZE(CTCSS_Options); i++) {
+        CHECK_EQ(DCS_GetCtcssCode(CTCSS_Options[i]), i);
+        CHECK_EQ(DCS_GetCtcssCode(CTCSS_Options[i] + 1), i);
+    }
+}
+
+TEST_MAIN_BEGIN
+    RUN(golay_round_trip);
+    RUN(golay_round_trip_rotated);
+    RUN(reverse_is_inverted);
+    RUN(ctcss_nearest);
+TEST_MAIN_END
@@ -0,0 +1,244 @@
+/* PY25Q16 model: NOR semantics, driver write algorithm, file backing. */
+
+#include <unistd.h>
+
+#include "test.h"
+
+#include "driver/py25q16.h"
+
+TEST(erased_reads_ff)
+{
+    uint8_t buf[32];
+    PY25Q16_ReadBuffer(0x1234, buf, sizeof(buf));
+    for (unsigned i = 0; i < sizeof(buf); i++)
+        CHECK_EQ(buf[i], 0xFF);
+}
+
+TEST(write_into_erased_area_does_not_erase)
+{
+    const uint8_t data[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+    uint8_t       back[8];
+
+    PY25Q16_WriteBuffer(0x004000, data, sizeof(data), false);
+    PY25Q16_Flush();
+    PY25Q16_ReadBuffer(0x004000, back, sizeof(back));
+
+    CHECK(memcmp(data, back, sizeof(data)) == 0);
+    CHECK_EQ(HOST_FLASH_GetStats()->SectorErases, 0);
+    CHECK_EQ(HOST_FLASH_GetStats()->PagePrograms, 1);
+}
+
+TEST(overwrite_erases_sector_and_keeps_neighbours)
+{
+    const uint8_t a[8] = { 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88 };
+    const uint8_t b[8] = { 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF, 0x00, 0x99 };
+    uint8_t       back[8];
+
+    PY25Q16_WriteBuffer(0x005000, a, sizeof(a), false);
+    PY25Q16_WriteBuffer(0x005010, a, sizeof(a), false);
+    PY25Q16_WriteBuffer(0x005000, b, sizeof(b), false);
+    PY25Q16_Flush();
+
+    PY25Q16_ReadBuffer(0x005000, back, sizeof(back));
+    CHECK(memcmp(b, back, sizeof(b)) == 0);
+    PY25Q16_ReadBuffer(0x005010, back, sizeof(back));
+    CHECK(memcmp(a, back, sizeof(a)) == 0);
+
+    CHECK_EQ(HOST_FLASH_GetStats()->SectorErases, 1);
+    CHECK_EQ(HOST_FLASH_GetStats()->EraseCount[5], 1);
+}
+
+TEST(unchanged_write_is_skipped)
+{
+    const uint8_t a[4] = { 1, 2, 3, 4 };
+
+    PY25Q16_WriteBuffer(0x006000, a, sizeof(a), false);
+    HOST_FLASH_ResetStats();
+    PY25Q16_WriteBuffer(0x006000, a, sizeof(a), false);
+
+    CHECK_EQ(HOST_FLASH_GetStats()->PagePrograms, 0);
+    CHECK_EQ(HOST_FLASH_GetStats()->SectorErases, 0);
+}
+
+TEST(append_drops_tail_of_sector)
+{
+    const uint8_t a[4] = { 1, 2, 3, 4 };
+    const uint8_t b[4] = { 5, 6, 7, 8 };
+    uint8_t       back[4];
+
+    PY25Q16_WriteBuffer(0x007000, a, sizeof(a), false);
+    PY25Q16_WriteBuffer(0x007100, a, sizeof(a), false);
+    PY25Q16_WriteBuffer(0x007000, b, sizeof(b), true);
+
+    PY25Q16_ReadBuffer(0x007000, back, sizeof(back));
+    CHECK(memcmp(b, back, sizeof(b)) == 0);
+
+    PY25Q16_ReadBuffer(0x007100, back, sizeof(back));
+    for (unsigned i = 0; i < sizeof(back); i++)
+        CHECK_EQ(back[i], 0xFF);
+}
+
+TEST(sector_erase_timing)
+{
+    const uint64_t start = HOST_GetTimeUs();
+    PY25Q16_SectorErase(0x008000);
+    CHECK(HOST_GetTimeUs() - start >= 40000);
+}
+
+TEST(file_backed_image_persists)
+{
+    char path[] = "/tmp/host_flash_XXXXXX";
+    const int fd = mkstemp(path);
+    CHECK(fd >= 0);
+    close(fd);
+    unlink(path);
+
+    const uint8_t data[4] = { 0xDE, 0xAD, 0xBE, 0xEF };
+    uint8_t       back[4];
+
+    CHECK(HOST_FLASH_Open(path));
+    PY25Q16_WriteBuffer(0x1FF000, data, sizeof(data), false);
+    PY25Q16_Flush();
+    HOST_FLASH_Close();
+
+    HOST_FLASH_Open(NULL);
+    PY25Q16_ReadBuffer(0x1FF000, back, sizeof(back));
+    CHECK_EQ(back[0], 0xFF);
+
+    CHECK(HOST_FLASH_Open(path));
+    PY25Q16_ReadBuffer(0x1FF000, back, sizeof(back));
+    CHECK(memcmp(data, back, sizeof(data)) == 0);
+    HOST_FLASH_Close();
+
+    unlink(path);
+}
+
+#ifdef ENABLE_FLASH_WRITE_BACK
+
+TEST(write_back_coalesces_one_sector)
+{
+    const uint8_t a[8] = { 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88 };
+    const uint8_t b[8] = { 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF, 0x00, 0x99 };
+    uint8_t       back[8];
+
+    PY25Q16_WriteBuffer(0x005000, a, sizeof(a), false);
+    PY25Q16_Flush();
+    HOST_FLASH_ResetStats();
+
+    // Three overwrites of a programmed sector cost a single erase
+    PY25Q16_WriteBuffer(0x005000, b, sizeof(b), false);
+    PY25Q16_WriteBuffer(0x005008, b, sizeof(b), false);
+    PY25Q16_WriteBuffer(0x005000, a, sizeof(a), false);
+    CHECK_EQ(HOST_FLASH_GetStats()->SectorErases, 0);
+
+    PY25Q16_ReadBuffer(0x005004, back, sizeof(back));
+    CHECK(memcmp(back, a + 4, 4) == 0);
+    CHECK(memcmp(back + 4, b, 4) == 0);
+
+    PY25Q16_Flush();
+    CHECK_EQ(HOST_FLASH_GetStats()->SectorErases, 1);
+    CHECK_EQ(HOST_FLASH_GetStats()->PagePrograms, 1);
+    CHECK(memcmp(HOST_FLASH_Image() + 0x005008, b, sizeof(b)) == 0);
+}
+
+TEST(write_back_flushes_on_sector_change)
+{
+    const uint8_t a[4] = { 1, 2, 3, 4 };
+
+    PY25Q16_WriteBuffer(0x004000, a, sizeof(a), false);
+    CHECK(PY25Q16_IsDirty());
+    CHECK_EQ(HOST_FLASH_GetStats()->PagePrograms, 0);
+
+    PY25Q16_WriteBuffer(0x006000, a, sizeof(a), false);
+    CHECK_EQ(HOST_FLASH_GetStats()->PagePrograms, 1);
+
+    // Power loss drops whatever the cache still holds
+    HOST_Reset();
+    CHECK(!PY25Q16_IsDirty());
+    CHECK_EQ(HOST_FLASH_Image()[0x004000], 1);
+    CHECK_EQ(HOST_FLASH_Image()[0x006000], 0xFF);
+}
+
+static unsigned gDoneCalls;
+static bool     gDoneOk;
+
+static void FlushDone(bool Ok)
+{
+    gDoneCalls++;
+    gDoneOk = Ok;
+}
+
+TEST(flush_async_steps_without_blocking)
+{
+    uint8_t a[0x300];
+    uint8_t back[sizeof(a)];
+
+    memset(a, 0x5A, sizeof(a));
+    PY25Q16_WriteBuffer(0x009000, a, sizeof(a), false);
+    PY25Q16_Flush();
+    memset(a, 0xA5, sizeof(a));
+    PY25Q16_WriteBuffer(0x009000, a, sizeof(a), false);
+
+    gDoneCalls = 0;
+    HOST_FLASH_ResetStats();
+
+    // Starting the erase costs bus time only, not the erase itself
+    uint64_t Start = HOST_GetTimeUs();
+    PY25Q16_FlushAsync(FlushDone);
+    CHECK(HOST_GetTimeUs() - Start < 100);
+    CHECK(PY25Q16_IsBusy());
+
+    unsigned Steps = 0;
+    uint64_t Longest = 0;
+    while (PY25Q16_IsBusy() && Steps < 10000) {
+        Start = HOST_GetTimeUs();
+        PY25Q16_Poll();
+        if (HOST_GetTimeUs() - Start > Longest)
+            Longest = HOST_GetTimeUs() - Start;
+        HOST_AdvanceUs(100);
+        Steps++;
+    }
+
+    BENCH("flash.flush_longest_step_us", "%llu", (unsigned long long)Longest);
+    CHECK(Longest < 200);
+    CHECK_EQ(gDoneCalls, 1);
+    CHECK(gDoneOk);
+    CHECK_EQ(HOST_FLASH_GetStats()->SectorErases, 1);
+    CHECK_EQ(HOST_FLASH_GetStats()->PagePrograms, 3);
+
+    PY25Q16_ReadBuffer(0x009000, back, sizeof(back));
+    CHECK(memcmp(a, back, sizeof(a)) == 0);
+}
+
+TEST(flush_async_is_finished_by_next_access)
+{
+    const uint8_t a[4] = { 1, 2, 3, 4 };
+    uint8_t       back[4];
+
+    PY25Q16_WriteBuffer(0x00a000, a, sizeof(a), false);
+    PY25Q16_FlushAsync(NULL);
+    CHECK(PY25Q16_IsBusy());
+
+    PY25Q16_ReadBuffer(0x00a000, back, sizeof(back));
+    CHECK(!PY25Q16_IsBusy());
+    CHECK(memcmp(a, back, sizeof(a)) == 0);
+    CHECK(memcmp(HOST_FLASH_Image() + 0x00a000, a, sizeof(a)) == 0);
+}
+
+#endif
+
+TEST_MAIN_BEGIN
+    RUN(erased_reads_ff);
+    RUN(write_into_erased_area_does_not_erase);
+    RUN(overwrite_erases_sector_and_keeps_neighbours);
+    RUN(unchanged_write_is_skipped);
+    RUN(append_drops_tail_of_sector);
+    RUN(sector_erase_timing);
+    RUN(file_backed_image_persists);
+#ifdef ENABLE_FLASH_WRITE_BACK
+    RUN(write_back_coalesces_one_sector);
+    RUN(write_back_flushes_on_sector_change);
+    RUN(flush_async_steps_without_blocking);
+    RUN(flush_async_is_finished_by_next_access);
+#endif
+TEST_MAIN_END
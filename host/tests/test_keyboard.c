@@ -0,0 +1,54 @@
+/* driver/keyboard.c scanning the scripted key matrix. */
+
+#include "test.h"
+
+#include "driver/gpio.h"
+#include "driver/keyboard.h"
+
+TEST(idle_reads_invalid)
+{
+    CHECK_EQ(KEYBOARD_Poll(), KEY_INVALID);
+    CHECK(!GPIO_IsPttPressed());
+}
+
+TEST(every_key_decodes)
+{
+    for (KEY_Code_t key = KEY_0; key < KEY_INVALID; key++) {
+        if (key == KEY_PTT)
+            continue;
+        HOST_KEY_Clear();
+        HOST_KEY_Press(key, 0, 10);
+        CHECK_EQ(KEYBOARD_Poll(), key);
+    }
+}
+
+TEST(press_window_follows_clock)
+{
+    HOST_KEY_Press(KEY_MENU, 5, 20);
+
+    CHECK_EQ(KEYBOARD_Poll(), KEY_INVALID);
+    HOST_AdvanceUs(6000);
+    CHECK_EQ(KEYBOARD_Poll(), KEY_MENU);
+    HOST_AdvanceUs(20000);
+    CHECK_EQ(KEYBOARD_Poll(), KEY_INVALID);
+}
+
+TEST(ptt_drives_pin)
+{
+    HOST_KEY_Press(KEY_PTT, 0, 10);
+    CHECK(GPIO_IsPttPressed());
+    CHECK_EQ(KEYBOARD_Poll(), KEY_INVALID);
+
+    HOST_KEY_Clear();
+    HOST_PTT_Set(true);
+    CHECK(GPIO_IsPttPressed());
+    HOST_PTT_Set(false);
+    CHECK(!GPIO_IsPttPressed());
+}
+
+TEST_MAIN_BEGIN
+    RUN(idle_reads_invalid);
+    RUN(every_key_decodes);
+    RUN(press_window_follows_clock);
+    RUN(ptt_drives_pin);
+TEST_MAIN_END
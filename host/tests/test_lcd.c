@@ -0,0 +1,184 @@
+/* driver/st7565.c through SPI1 into the panel model. */
+
+#include "test.h"
+
+#include "driver/st7565.h"
+#include "misc.h"
+#include "ui/ui.h"
+
+TEST(blit_full_screen)
+{
+    ST7565_Init();
+
+    memset(gFrameBuffer, 0, sizeof(gFrameBuffer));
+    gFrameBuffer[0][0]    = 0x01;   // x 0, y 8
+    gFrameBuffer[6][127]  = 0x80;   // x 127, y 63
+    gFrameBuffer[3][64]   = 0xFF;   // x 64, y 32..39
+
+    HOST_LCD_ResetStats();
+    ST7565_BlitFullScreen();
+    ST7565_WaitFlush();
+
+    CHECK(HOST_LCD_GetPixel(0, 8));
+    CHECK(!HOST_LCD_GetPixel(1, 8));
+    CHECK(HOST_LCD_GetPixel(127, 63));
+    for (unsigned y = 32; y < 40; y++)
+        CHECK(HOST_LCD_GetPixel(64, y));
+    CHECK(!HOST_LCD_GetPixel(64, 40));
+
+    CHECK_EQ(HOST_LCD_GetStats()->PageWrites, FRAME_LINES);
+    CHECK_EQ(HOST_LCD_GetStats()->DataBytes, FRAME_LINES * LCD_WIDTH);
+}
+
+TEST(blit_status_and_single_line)
+{
+    ST7565_Init();
+
+    memset(gStatusLine, 0, sizeof(gStatusLine));
+    gStatusLine[10] = 0x81;
+    ST7565_BlitStatusLine();
+    ST7565_WaitFlush();
+    CHECK(HOST_LCD_GetPixel(10, 0));
+    CHECK(HOST_LCD_GetPixel(10, 7));
+    CHECK(!HOST_LCD_GetPixel(10, 3));
+
+    memset(gFrameBuffer, 0, sizeof(gFrameBuffer));
+    gFrameBuffer[2][5] = 0x10;
+    HOST_LCD_ResetStats();
+    ST7565_BlitLine(2);
+    ST7565_WaitFlush();
+    CHECK(HOST_LCD_GetPixel(5, 8 * 3 + 4));
+    CHECK_EQ(HOST_LCD_GetStats()->PageWrites, 1);
+}
+
+#ifdef ENABLE_LCD_ASYNC_FLUSH
+TEST(blit_sends_changed_columns)
+{
+    ST7565_Init();
+
+    memset(gFrameBuffer, 0, sizeof(gFrameBuffer));
+    ST7565_BlitFullScreen();
+    ST7565_WaitFlush();
+
+    HOST_LCD_ResetStats();
+    ST7565_BlitFullScreen();
+    ST7565_WaitFlush();
+    CHECK_EQ(HOST_LCD_GetStats()->DataBytes, 0);
+
+    gFrameBuffer[4][70] = 0x01;     // x 70, y 40
+    gFrameBuffer[4][90] = 0x01;     // x 90, y 40
+    ST7565_BlitFullScreen();
+    ST7565_WaitFlush();
+    CHECK(HOST_LCD_GetPixel(70, 40));
+    CHECK(HOST_LCD_GetPixel(90, 40));
+    CHECK_EQ(HOST_LCD_GetStats()->PageWrites, 1);
+    CHECK_EQ(HOST_LCD_GetStats()->DataBytes, 32);   // chunks 64..79 and 80..95
+}
+
+TEST(redraw_during_flush)
+{
+    ST7565_Init();
+
+    memset(gFrameBuffer, 0xFF, sizeof(gFrameBuffer));
+    ST7565_BlitFullScreen();
+    CHECK(ST7565_IsBusy());
+
+    // The UI clears and redraws while the previous frame is still going out
+    memset(gFrameBuffer, 0, sizeof(gFrameBuffer));
+    gFrameBuffer[6][3] = 0x80;      // x 3, y 63
+    ST7565_BlitFullScreen();
+    ST7565_WaitFlush();
+
+    for (unsigned y = 8; y < 64; y++)
+        for (unsigned x = 0; x < 128; x++)
+            CHECK_EQ(HOST_LCD_GetPixel(x, y), x == 3 && y == 63);
+}
+
+TEST(draw_line_is_repainted)
+{
+    static const uint8_t Bitmap[] = { 0xFF, 0xFF };
+
+    ST7565_Init();
+
+    memset(gStatusLine, 0, sizeof(gStatusLine));
+    ST7565_BlitStatusLine();
+    ST7565_DrawLine(100, 0, Bitmap, sizeof(Bitmap));
+    CHECK(HOST_LCD_GetPixel(100, 0));
+
+    ST7565_BlitStatusLine();
+    ST7565_WaitFlush();
+    CHECK(!HOST_LCD_GetPixel(100, 0));
+}
+#endif
+
+#ifdef ENABLE_FRAME_GOVERNOR
+TEST(frame_governor)
+{
+    HOST_Boot();
+    HOST_RunMs(500);
+
+    const GUI_RenderStats_t Before = *GUI_GetRenderStats();
+
+    // A lone request after an idle spell is drawn on the next slice
+    gUpdateDisplay = true;
+    HOST_RunMs(10);
+    CHECK(!gUpdateDisplay);
+    CHECK_EQ(GUI_GetRenderStats()->Rendered - Before.Rendered, 1);
+
+    // Requests every 2 ms for 400 ms come out at the frame rate
+    HOST_RunMs(100);
+    const GUI_RenderStats_t Start = *GUI_GetRenderStats();
+    for (unsigned i = 0; i < 200; i++) {
+        gUpdateDisplay = true;
+        HOST_RunMs(2);
+    }
+    HOST_RunMs(50);
+
+    const uint32_t Rendered  = GUI_GetRenderStats()->Rendered - Start.Rendered;
+    const uint32_t Requested = GUI_GetRenderStats()->Requested - Start.Requested;
+
+    BENCH("gui.frames_rendered", "%u", (unsigned)Rendered);
+    BENCH("gui.slices_requested", "%u", (unsigned)Requested);
+    CHECK(!gUpdateDisplay);
+    CHECK(Rendered <= 400 / (gui_frame_period_10ms * 10) + 2);
+    CHECK(Requested >= 40);
+
+    // Widget lines queued between frames go out on their own
+    const GUI_RenderStats_t Widget = *GUI_GetRenderStats();
+    gFrameBuffer[4][20] = 0xFF;
+    GUI_BlitLine(4);
+    HOST_RunMs(50);
+    ST7565_WaitFlush();
+    CHECK(HOST_LCD_GetPixel(20, 8 * 5));
+    CHECK_EQ(GUI_GetRenderStats()->Partial - Widget.Partial, 1);
+}
+#endif
+
+TEST(blit_timing)
+{
+    ST7565_Init();
+
+    const uint64_t start = HOST_GetCycles();
+    ST7565_BlitFullScreen();
+    const double cpu_us = (double)(HOST_GetCycles() - start) / HOST_CYCLES_PER_US;
+    ST7565_WaitFlush();
+    const double us = (double)(HOST_GetCycles() - start) / HOST_CYCLES_PER_US;
+
+    BENCH("st7565.full_blit_us", "%.0f", us);
+    BENCH("st7565.full_blit_cpu_us", "%.0f", cpu_us);
+    CHECK(us > 0);
+}
+
+TEST_MAIN_BEGIN
+    RUN(blit_full_screen);
+    RUN(blit_status_and_single_line);
+#ifdef ENABLE_LCD_ASYNC_FLUSH
+    RUN(blit_sends_changed_columns);
+    RUN(redraw_during_flush);
+    RUN(draw_line_is_repainted);
+#endif
+#ifdef ENABLE_FRAME_GOVERNOR
+    RUN(frame_governor);
+#endif
+    RUN(blit_timing);
+TEST_MAIN_END
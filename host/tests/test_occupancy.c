@@ -0,0 +1,122 @@
+/* app/spectrum_occupancy.c: per-bin busy counts, levels and last-seen times
+ * over many sweeps. */
+
+#include "test.h"
+
+#include "app/spectrum_occupancy.h"
+
+#define START       43000000    // 430 MHz, 10 Hz units
+#define STEP        1250        // 12.5 kHz
+#define TRIGGER     100
+
+static uint16_t gRssi[OCCUPANCY_BINS];
+
+// One sweep of noise with the given bins over the trigger, a second later
+static void Sweep(const uint8_t *pBusy, unsigned Count, uint16_t Level)
+{
+    for (unsigned i = 0; i < OCCUPANCY_BINS; i++)
+        gRssi[i] = TRIGGER - 20 + i % 7;
+    for (unsigned k = 0; k < Count; k++)
+        gRssi[pBusy[k]] = Level;
+
+    HOST_AdvanceUs(1000000);
+    OCCUPANCY_Update(gRssi, TRIGGER);
+}
+
+TEST(counts_sweeps_over_the_trigger)
+{
+    const uint8_t Always[] = { 10 };
+    const uint8_t Both[]   = { 10, 70 };
+
+    HOST_Boot();    // the survey clock is the 10 ms tick
+    OCCUPANCY_Setup(START, STEP, 128);
+    OCCUPANCY_Reset();
+
+    // Bin 70 busy every fourth sweep, louder the last time
+    for (unsigned n = 0; n < 40; n++) {
+        if (n % 4 == 0)
+            Sweep(Both, 2, n == 36 ? 180 : 150);
+        else
+            Sweep(Always, 1, 120);
+    }
+
+    CHECK_EQ(OCCUPANCY_GetSweeps(), 40);
+    CHECK_EQ(OCCUPANCY_GetBins(), 128);
+    CHECK_EQ(OCCUPANCY_Get(10)->Busy, 40);
+    CHECK_EQ(OCCUPANCY_Get(70)->Busy, 10);
+    CHECK_EQ(OCCUPANCY_Get(70)->Max, 180);
+    CHECK_EQ(OCCUPANCY_GetPercent(10), 100);
+    CHECK_EQ(OCCUPANCY_GetPercent(70), 25);
+    CHECK_EQ(OCCUPANCY_Get(5)->Busy, 0);
+
+    // Seconds into the survey of the last busy sweep
+    CHECK_EQ(OCCUPANCY_GetElapsed(), 40);
+    CHECK_EQ(OCCUPANCY_Get(10)->LastSeen, 40);
+    CHECK_EQ(OCCUPANCY_Get(70)->LastSeen, 37);
+
+    uint8_t Order[OCCUPANCY_BINS];
+    CHECK_EQ(OCCUPANCY_Sort(Order), 2);
+    CHECK_EQ(Order[0], 10);
+    CHECK_EQ(Order[1], 70);
+
+    CHECK_EQ(OCCUPANCY_GetFrequency(70), START + 70 * STEP);
+}
+
+TEST(equally_busy_bins_sort_by_level)
+{
+    const uint8_t Busy[] = { 3, 50, 90 };
+
+    OCCUPANCY_Setup(START + STEP, STEP, 128);
+    CHECK_EQ(OCCUPANCY_GetSweeps(), 0);
+
+    Sweep(Busy, 3, 130);
+    gRssi[50] = 160;
+    OCCUPANCY_Update(gRssi, TRIGGER);
+    gRssi[90] = 20;
+    OCCUPANCY_Update(gRssi, TRIGGER);
+
+    uint8_t Order[OCCUPANCY_BINS];
+    CHECK_EQ(OCCUPANCY_Sort(Order), 3);
+    CHECK_EQ(Order[0], 50);
+    CHECK_EQ(Order[1], 3);
+    CHECK_EQ(Order[2], 90);
+}
+
+TEST(counters_never_wrap)
+{
+    const uint8_t Busy[] = { 0 };
+
+    HOST_Boot();
+    OCCUPANCY_Setup(START, STEP, 64);
+    CHECK_EQ(OCCUPANCY_GetBins(), 64);
+
+    // Bin 0 busy two sweeps in three, past what 16 bits count
+    for (unsigned n = 0; n < 70000; n++)
+        Sweep(Busy, n % 3 ? 1 : 0, 150);
+
+    CHECK(OCCUPANCY_GetSweeps() > 30000);
+    CHECK_EQ(OCCUPANCY_GetPercent(0), 66);
+    CHECK_EQ(OCCUPANCY_Get(0)->LastSeen, 0xFFFF);
+}
+
+TEST(wide_sweeps_tune_to_the_middle_of_a_bin)
+{
+    OCCUPANCY_Setup(START, STEP, 1000);
+    CHECK_EQ(OCCUPANCY_GetBins(), 128);
+
+    // Bin b holds the steps i * 128 / 1000 == b, 7 or 8 of them, the
+    // middle one is 3 away from either end
+    for (unsigned b = 0; b < OCCUPANCY_BINS; b++) {
+        const unsigned Step = OCCUPANCY_GetStep(b);
+        CHECK_EQ(Step * 128 / 1000, b);
+        CHECK_EQ((Step - 3) * 128 / 1000, b);
+        CHECK_EQ((Step + 3) * 128 / 1000, b);
+    }
+}
+
+TEST_MAIN_BEGIN
+    RUN(counts_sweeps_over_the_trigger);
+    RUN(equally_busy_bins_sort_by_level);
+    RUN(counters_never_wrap);
+    RUN(wide_sweeps_tune_to_the_middle_of_a_bin);
+TEST_MAIN_END
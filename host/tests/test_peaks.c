@@ -0,0 +1,203 @@
+/* app/spectrum_peaks.c: peaks of a sweep against the noise floor and the
+ * tracked signal list the table shows. */
+
+#include "test.h"
+
+#include "app/spectrum_peaks.h"
+
+#define FLOOR       60
+#define STEPS       128
+#define START       43000000    // 430 MHz, 10 Hz units
+#define STEP        1250        // 12.5 kHz
+
+static uint16_t gRssi[STEPS];
+
+// Noise within a couple of dB of FLOOR
+static void Noise(void)
+{
+    for (unsigned i = 0; i < STEPS; i++)
+        gRssi[i] = FLOOR + (i * 7) % 5;
+}
+
+// A carrier Level above the floor at Index, with sloped skirts
+static void Carrier(unsigned Index, uint16_t Level)
+{
+    for (unsigned d = 0; d < 4; d++) {
+        const uint16_t Rssi = FLOOR + (Level >> d);
+        if (Index + d < STEPS && gRssi[Index + d] < Rssi)
+            gRssi[Index + d] = Rssi;
+        if (Index >= d && gRssi[Index - d] < Rssi)
+            gRssi[Index - d] = Rssi;
+    }
+}
+
+// One sweep through the detector and the tracker
+static uint8_t Sweep(void)
+{
+    PEAK_Hit_t Hits[PEAKS_MAX];
+    const uint8_t Count = PEAKS_Find(gRssi, STEPS, FLOOR, Hits);
+
+    for (uint8_t k = 0; k < Count; k++)
+        Hits[k].f = START + Hits[k].i * STEP;
+    PEAKS_Track(Hits, Count, STEP);
+
+    return Count;
+}
+
+TEST(finds_every_carrier_strongest_first)
+{
+    PEAK_Hit_t Hits[PEAKS_MAX];
+
+    Noise();
+    CHECK_EQ(PEAKS_Find(gRssi, STEPS, FLOOR, Hits), 0);
+
+    Carrier(20, 40);
+    Carrier(30, 80);
+    Carrier(100, 60);
+    // A bump within the prominence is not a signal
+    gRssi[70] = FLOOR + PEAKS_PROMINENCE - 2;
+
+    CHECK_EQ(PEAKS_Find(gRssi, STEPS, FLOOR, Hits), 3);
+    CHECK_EQ(Hits[0].i, 30);
+    CHECK_EQ(Hits[0].rssi, FLOOR + 80);
+    CHECK_EQ(Hits[1].i, 100);
+    CHECK_EQ(Hits[2].i, 20);
+
+    // Carriers at both ends of the sweep
+    Noise();
+    Carrier(0, 50);
+    Carrier(STEPS - 1, 50);
+    CHECK_EQ(PEAKS_Find(gRssi, STEPS, FLOOR, Hits), 2);
+}
+
+TEST(only_the_strongest_are_kept)
+{
+    PEAK_Hit_t Hits[PEAKS_MAX];
+
+    Noise();
+    for (unsigned k = 0; k < PEAKS_MAX + 4; k++)
+        Carrier(6 + k * 12, 20 + k * 4);
+
+    CHECK_EQ(PEAKS_Find(gRssi, STEPS, FLOOR, Hits), PEAKS_MAX);
+    for (unsigned k = 0; k < PEAKS_MAX; k++)
+        CHECK_EQ(Hits[k].i, 6 + (PEAKS_MAX + 3 - k) * 12);
+}
+
+// Carriers at 40 and 44 with the level between them Dip above the floor
+static void Pair(uint16_t Dip)
+{
+    Noise();
+    gRssi[40] = FLOOR + 60;
+    gRssi[44] = FLOOR + 56;
+    for (unsigned i = 41; i < 44; i++)
+        gRssi[i] = FLOOR + Dip;
+}
+
+TEST(close_carriers_need_a_dip_between_them)
+{
+    PEAK_Hit_t Hits[PEAKS_MAX];
+
+    // A dip of less than the prominence: one signal
+    Pair(56 - PEAKS_PROMINENCE / 2);
+    CHECK_EQ(PEAKS_Find(gRssi, STEPS, FLOOR, Hits), 1);
+    CHECK_EQ(Hits[0].i, 40);
+
+    // Deep enough: two
+    Pair(56 - PEAKS_PROMINENCE);
+    CHECK_EQ(PEAKS_Find(gRssi, STEPS, FLOOR, Hits), 2);
+    CHECK_EQ(Hits[1].i, 44);
+}
+
+TEST(tracked_peaks_keep_their_duty_and_age)
+{
+    PEAKS_Reset();
+
+    // A steady carrier and one keyed every other sweep
+    for (unsigned n = 0; n < 20; n++) {
+        Noise();
+        Carrier(30, 70);
+        if (n % 2 == 0)
+            Carrier(90, 40);
+        Sweep();
+    }
+
+    CHECK_EQ(PEAKS_GetCount(), 2);
+    const PEAK_t *pSteady = PEAKS_Get(0);
+    const PEAK_t *pKeyed  = PEAKS_Get(1);
+    CHECK_EQ(pSteady->f, START + 30 * STEP);
+    CHECK_EQ(pKeyed->f, START + 90 * STEP);
+    CHECK_EQ(PEAKS_GetDuty(pSteady), 100);
+    CHECK_EQ(PEAKS_GetDuty(pKeyed), 50);
+    CHECK_EQ(pKeyed->age, 1);
+    CHECK_EQ(pSteady->seen, 20);
+
+    // Drifting by a step is still the same signal
+    Noise();
+    Carrier(31, 70);
+    Sweep();
+    CHECK_EQ(PEAKS_GetCount(), 2);
+    CHECK_EQ(PEAKS_Get(0)->i, 31);
+    CHECK(PEAKS_Near(START + 30 * STEP, STEP) == PEAKS_Get(0));
+
+    // Gone long enough it is forgotten
+    for (unsigned n = 0; n < PEAKS_MAX_AGE; n++) {
+        Noise();
+        Carrier(31, 70);
+        Sweep();
+    }
+    CHECK_EQ(PEAKS_GetCount(), 1);
+    CHECK(PEAKS_Near(START + 90 * STEP, STEP) == NULL);
+}
+
+TEST(table_is_in_frequency_order)
+{
+    PEAKS_Reset();
+
+    // Strongest at the top of the span
+    Noise();
+    Carrier(110, 80);
+    Carrier(10, 30);
+    Carrier(60, 50);
+    CHECK_EQ(Sweep(), 3);
+
+    CHECK_EQ(PEAKS_GetCount(), 3);
+    CHECK_EQ(PEAKS_Get(0)->i, 10);
+    CHECK_EQ(PEAKS_Get(1)->i, 60);
+    CHECK_EQ(PEAKS_Get(2)->i, 110);
+
+    // Panned away from the lowest one
+    PEAKS_Forget(START + 50 * STEP, START + 178 * STEP);
+    CHECK_EQ(PEAKS_GetCount(), 2);
+    CHECK_EQ(PEAKS_Get(0)->i, 60);
+}
+
+TEST(a_full_table_drops_a_lost_signal_first)
+{
+    PEAKS_Reset();
+
+    Noise();
+    for (unsigned k = 0; k < PEAKS_MAX; k++)
+        Carrier(8 + k * 16, 30 + k * 4);
+    Sweep();
+    CHECK_EQ(PEAKS_GetCount(), PEAKS_MAX);
+
+    // The strongest goes away and a weak new one comes up
+    Noise();
+    for (unsigned k = 0; k < PEAKS_MAX - 1; k++)
+        Carrier(8 + k * 16, 30 + k * 4);
+    Carrier(120, 20);
+    Sweep();
+
+    CHECK_EQ(PEAKS_GetCount(), PEAKS_MAX);
+    CHECK(PEAKS_Near(START + 120 * STEP, 0) != NULL);
+    CHECK(PEAKS_Near(START + (8 + (PEAKS_MAX - 1) * 16) * STEP, 0) == NULL);
+}
+
+TEST_MAIN_BEGIN
+    RUN(finds_every_carrier_strongest_first);
+    RUN(only_the_strongest_are_kept);
+    RUN(close_carriers_need_a_dip_between_them);
+    RUN(tracked_peaks_keep_their_duty_and_age);
+    RUN(table_is_in_frequency_order);
+    RUN(a_full_table_drops_a_lost_signal_first);
+TEST_MAIN_END
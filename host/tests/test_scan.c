@@ -0,0 +1,498 @@
+/* Frequency and memory scanning against the BK4819 model, with throughput. */
+
+#include <string.h>
+
+#include "test.h"
+
+#include "app/chFrScanner.h"
+#include "driver/bk4819.h"
+#include "driver/py25q16.h"
+#include "frequencies.h"
+#include "functions.h"
+#include "misc.h"
+#include "radio.h"
+#include "settings.h"
+
+static uint32_t gRetunes;
+static uint32_t gLastFrequency;
+static uint32_t gSavedWrites;
+
+static void CountRetunes(uint8_t Reg, uint16_t Value)
+{
+    (void)Value;
+    if (Reg != 0x38 && Reg != 0x39)
+        return;
+
+    const uint32_t f = HOST_BK4819_GetFrequency();
+    if (f != gLastFrequency) {
+        gLastFrequency = f;
+        gRetunes++;
+    }
+}
+
+static uint16_t Noise(uint32_t Frequency)
+{
+    (void)Frequency;
+    return 60;
+}
+
+static void RunScan(uint32_t Ms, double *ChannelsPerSecond)
+{
+    gRetunes       = 0;
+    gLastFrequency = HOST_BK4819_GetFrequency();
+    HOST_BK4819_SetHooks(NULL, CountRetunes);
+    HOST_BK4819_SetRssiSource(Noise);
+    HOST_BK4819_ResetStats();
+
+    const uint32_t Saved = BK4819_GetSavedWrites();
+    CHFRSCANNER_Start(true, SCAN_FWD);
+    HOST_RunMs(Ms);
+    CHFRSCANNER_Stop();
+    gSavedWrites = BK4819_GetSavedWrites() - Saved;
+
+    *ChannelsPerSecond = gRetunes * 1000.0 / Ms;
+}
+
+TEST(frequency_scan)
+{
+    double Rate;
+
+    HOST_Boot();
+    CHECK(IS_FREQ_CHANNEL(gRxVfo->CHANNEL_SAVE));
+
+    RunScan(2000, &Rate);
+
+    BENCH("scan.freq_channels_per_s", "%.1f", Rate);
+    BENCH("scan.freq_bk_writes_per_step", "%.1f",
+          gRetunes ? (double)HOST_BK4819_GetStats()->Writes / gRetunes : 0.0);
+    BENCH("scan.freq_bk_saved_per_step", "%.1f",
+          gRetunes ? (double)gSavedWrites / gRetunes : 0.0);
+    CHECK(gRetunes > 10);
+}
+
+static void SaveChannel(uint8_t Channel, uint32_t Frequency)
+{
+    VFO_Info_t Vfo = gEeprom.VfoInfo[0];
+
+    Vfo.freq_config_RX.Frequency = Frequency;
+    Vfo.freq_config_TX.Frequency = Frequency;
+    Vfo.TX_OFFSET_FREQUENCY      = 0;
+    Vfo.Band                     = FREQUENCY_GetBand(Frequency);
+    Vfo.SCANLIST1_PARTICIPATION  = 1;
+    SETTINGS_SaveChannel(Channel, 0, &Vfo, 2);
+}
+
+// Boots into memory mode with channels 0..Count-1 in scan list 1
+static void SetupMemoryScan(uint8_t Count)
+{
+    HOST_Boot();
+
+    for (uint8_t ch = 0; ch < Count; ch++)
+        SaveChannel(ch, 14400000 + ch * 12500);
+
+    gEeprom.SCAN_LIST_DEFAULT    = 1;
+    gEeprom.SCAN_LIST_ENABLED[0] = false;
+    gEeprom.ScreenChannel[0]     = 0;
+    gEeprom.MrChannel[0]         = 0;
+    RADIO_ConfigureChannel(0, VFO_CONFIGURE_RELOAD);
+    RADIO_SetupRegisters(true);
+}
+
+TEST(memory_scan)
+{
+    double Rate;
+
+    SetupMemoryScan(20);
+    CHECK(IS_MR_CHANNEL(gRxVfo->CHANNEL_SAVE));
+
+    RunScan(2000, &Rate);
+
+    BENCH("scan.mem_channels_per_s", "%.1f", Rate);
+    BENCH("scan.mem_bk_writes_per_step", "%.1f",
+          gRetunes ? (double)HOST_BK4819_GetStats()->Writes / gRetunes : 0.0);
+    BENCH("scan.mem_bk_saved_per_step", "%.1f",
+          gRetunes ? (double)gSavedWrites / gRetunes : 0.0);
+    CHECK(gRetunes > 10);
+}
+
+// Every step waits out the full dwell, so one ContinueScanning() is one hop
+// One step on, as the scheduler calls the scanner: with early reject a step
+// that passed its sample waits out its dwell before the next call retunes
+static void NextStep(void)
+{
+#ifdef ENABLE_SCAN_ADAPTIVE_DWELL
+    const uint32_t Steps = gScanSteps;
+    CHFRSCANNER_ContinueScanning();
+    if (gScanSteps == Steps)
+        CHFRSCANNER_ContinueScanning();
+#else
+    CHFRSCANNER_ContinueScanning();
+#endif
+}
+
+static void DisableEarlyReject(void)
+{
+#ifdef ENABLE_SCAN_ADAPTIVE_DWELL
+    gEeprom.SCAN_EARLY_RSSI   = 0xFE;
+    gEeprom.SCAN_EARLY_NOISE  = 0xFE;
+    gEeprom.SCAN_EARLY_GLITCH = 0xFE;
+#endif
+}
+
+// Register work of one hop, without the settle wait before its sample
+static uint64_t TimeHop(void)
+{
+    const uint64_t Start = HOST_GetCycles();
+    NextStep();
+    return HOST_GetCycles() - Start;
+}
+
+TEST(retune_fast_path)
+{
+    HOST_Boot();
+    HOST_BK4819_SetRssiSource(Noise);
+    DisableEarlyReject();
+
+    CHFRSCANNER_Start(true, SCAN_FWD);
+    HOST_RunMs(300);
+
+    HOST_BK4819_ResetStats();
+    const uint64_t Hop = TimeHop();
+    const uint32_t HopWrites = HOST_BK4819_GetStats()->Writes;
+    CHECK_EQ(HOST_BK4819_GetStats()->RegWrites[0x48], 0);     // AF gain left alone
+    CHECK(HOST_BK4819_GetStats()->RegWrites[0x3F] > 0);        // interrupts re-armed
+
+    // A modulation change takes the full setup
+    gRxVfo->Modulation = MODULATION_AM;
+    const uint64_t Full = TimeHop();
+    CHECK(HOST_BK4819_GetStats()->Writes - HopWrites > HopWrites);
+
+    // So do global settings it depends on, the shadow drops most of the
+    // repeated writes so count the attempts
+    uint32_t Saved = BK4819_GetSavedWrites();
+    HOST_BK4819_ResetStats();
+    TimeHop();
+    const uint32_t AmWrites = HOST_BK4819_GetStats()->Writes + BK4819_GetSavedWrites() - Saved;
+    gSetting_ScrambleEnable = !gSetting_ScrambleEnable;
+    Saved = BK4819_GetSavedWrites();
+    HOST_BK4819_ResetStats();
+    TimeHop();
+    CHECK(HOST_BK4819_GetStats()->Writes + BK4819_GetSavedWrites() - Saved > AmWrites);
+    gSetting_ScrambleEnable = !gSetting_ScrambleEnable;
+
+    CHFRSCANNER_Stop();
+
+    BENCH("scan.retune_us", "%.1f", (double)Hop / HOST_CYCLES_PER_US);
+    BENCH("scan.full_setup_us", "%.1f", (double)Full / HOST_CYCLES_PER_US);
+    CHECK(Hop < Full);
+}
+
+TEST(channel_profiles)
+{
+    SetupMemoryScan(40);
+    HOST_BK4819_SetRssiSource(Noise);
+    DisableEarlyReject();
+
+    // Starting configures the first channel only, not the whole list
+    HOST_FLASH_ResetStats();
+    CHFRSCANNER_Start(true, SCAN_FWD);
+    const uint32_t StartReads = HOST_FLASH_GetStats()->Reads;
+    for (unsigned i = 1; i < 40; i++)
+        NextStep();
+    CHECK(StartReads * 8 < HOST_FLASH_GetStats()->Reads);
+
+    // After the first lap the members with a profile slot hop from RAM, the
+    // ones past the last slot still read flash
+    unsigned FromRam = 0;
+    uint64_t Hop     = 0;
+    for (unsigned i = 0; i < 40; i++) {
+        HOST_FLASH_ResetStats();
+        const uint64_t Cycles = TimeHop();
+        if (HOST_FLASH_GetStats()->Reads == 0) {
+            FromRam++;
+            Hop = Cycles;
+        }
+    }
+    CHECK_EQ(FromRam, 32);
+
+    // A hop leaves the VFO as configuring the channel would, receive side
+    const VFO_Info_t Hopped = *gRxVfo;
+    RADIO_ConfigureChannel(gEeprom.RX_VFO, VFO_CONFIGURE_RELOAD);
+    CHECK_EQ(Hopped.CHANNEL_SAVE, gRxVfo->CHANNEL_SAVE);
+    CHECK_EQ(Hopped.pRX->Frequency, gRxVfo->pRX->Frequency);
+    CHECK_EQ(Hopped.pTX->Frequency, gRxVfo->pTX->Frequency);
+    CHECK_EQ(Hopped.Modulation, gRxVfo->Modulation);
+    CHECK_EQ(Hopped.STEP_SETTING, gRxVfo->STEP_SETTING);
+    CHECK(memcmp(&Hopped.SquelchOpenRSSIThresh, &gRxVfo->SquelchOpenRSSIThresh, 6) == 0);
+
+    // Editing a channel drops its profile, the next visit sees the change
+    SaveChannel(3, 14600000);
+    for (unsigned i = 0; i < 40 && gRxVfo->CHANNEL_SAVE != 3; i++)
+        NextStep();
+    CHECK_EQ(gRxVfo->CHANNEL_SAVE, 3);
+    CHECK_EQ(gRxVfo->pRX->Frequency, 14600000);
+    CHECK_EQ(HOST_BK4819_GetFrequency(), 14600000);
+
+    CHFRSCANNER_Stop();
+
+    BENCH("scan.mem_hop_us", "%.1f", (double)Hop / HOST_CYCLES_PER_US);
+}
+
+#ifdef ENABLE_CHANNEL_BANKS
+TEST(scan_across_banks)
+{
+    bool Seen[4] = { false };
+
+    // Scan list 1 holds channels 1..2 of bank 0 and 10..11 of the last bank
+    SetupMemoryScan(3);
+    SETTINGS_SelectChannelBank(CHANNEL_BANK_COUNT - 1);
+    SaveChannel(10, 43300000);
+    SaveChannel(11, 43302500);
+    SETTINGS_SelectChannelBank(0);
+    HOST_BK4819_SetRssiSource(Noise);
+    DisableEarlyReject();
+
+    CHFRSCANNER_Start(true, SCAN_FWD);
+    for (unsigned i = 0; i < 12; i++) {
+        NextStep();
+        switch (HOST_BK4819_GetFrequency()) {
+            case 14412500: Seen[0] = true; break;
+            case 14425000: Seen[1] = true; break;
+            case 43300000: Seen[2] = true; break;
+            case 43302500: Seen[3] = true; break;
+        }
+    }
+    CHECK(Seen[0] && Seen[1] && Seen[2] && Seen[3]);
+
+    // Later laps hop from RAM, only a bank crossing reads the new bank's
+    // attributes
+    unsigned Crossings = 0;
+    for (unsigned i = 0; i < 10; i++) {
+        const uint8_t Bank = gEeprom.CHANNEL_BANK;
+        HOST_FLASH_ResetStats();
+        NextStep();
+        if (gEeprom.CHANNEL_BANK != Bank)
+            Crossings++;
+        else
+            CHECK_EQ(HOST_FLASH_GetStats()->Reads, 0);
+    }
+    CHECK_EQ(Crossings, 4);
+
+    // Stopping goes back to the bank the scan started in
+    CHFRSCANNER_Stop();
+    CHECK_EQ(gEeprom.CHANNEL_BANK, 0);
+    CHECK_EQ(gRxVfo->CHANNEL_SAVE, 0);
+
+    // or stays in the one a signal was kept in
+    CHFRSCANNER_Start(true, SCAN_FWD);
+    for (unsigned i = 0; i < 12 && gEeprom.CHANNEL_BANK == 0; i++)
+        NextStep();
+    CHECK_EQ(gEeprom.CHANNEL_BANK, CHANNEL_BANK_COUNT - 1);
+    const uint8_t Found = gRxVfo->CHANNEL_SAVE;
+    CHFRSCANNER_Found();
+    CHFRSCANNER_Stop();
+    CHECK_EQ(gEeprom.CHANNEL_BANK, CHANNEL_BANK_COUNT - 1);
+    CHECK_EQ(gRxVfo->CHANNEL_SAVE, Found);
+    CHECK_EQ(gRxVfo->pRX->Frequency, Found == 10 ? 43300000 : 43302500);
+
+    SETTINGS_SelectChannelBank(0);
+}
+
+TEST(scan_exclusions_across_banks)
+{
+    SetupMemoryScan(3);
+    SETTINGS_SelectChannelBank(CHANNEL_BANK_COUNT - 1);
+    SaveChannel(10, 43300000);
+    SaveChannel(11, 43302500);
+    SETTINGS_SelectChannelBank(0);
+    HOST_BK4819_SetRssiSource(Noise);
+    DisableEarlyReject();
+
+    // Channel 1 of bank 0 is excluded before the scan, channel 10 of the last
+    // bank while the scan sits on it, as a long MENU does
+    gMR_ChannelExclude[1] = true;
+    RADIO_InvalidateChannelIndex();
+    CHFRSCANNER_Start(true, SCAN_FWD);
+    for (unsigned i = 0; i < 12 && HOST_BK4819_GetFrequency() != 43300000; i++)
+        NextStep();
+    CHECK_EQ(HOST_BK4819_GetFrequency(), 43300000);
+    gMR_ChannelExclude[10] = true;
+    RADIO_InvalidateChannelIndex();
+
+    // Both stay skipped however often the scan goes from bank to bank
+    unsigned Crossings = 0;
+    for (unsigned i = 0; i < 20; i++) {
+        const uint8_t Bank = gEeprom.CHANNEL_BANK;
+        NextStep();
+        if (gEeprom.CHANNEL_BANK != Bank)
+            Crossings++;
+        CHECK(HOST_BK4819_GetFrequency() != 14412500);
+        CHECK(HOST_BK4819_GetFrequency() != 43300000);
+    }
+    CHECK(Crossings >= 2);
+
+    CHFRSCANNER_Stop();
+    CHECK_EQ(gEeprom.CHANNEL_BANK, 0);
+    CHECK(gMR_ChannelExclude[1]);
+    SETTINGS_ViewChannelBank(CHANNEL_BANK_COUNT - 1);
+    CHECK(gMR_ChannelExclude[10]);
+    CHECK(!gMR_ChannelExclude[1]);
+    SETTINGS_SelectChannelBank(0);
+}
+#endif
+
+#ifdef ENABLE_SCAN_ADAPTIVE_DWELL
+// Scans towards a weak carrier Steps channels up, returns the time to lock in
+// ms, 0 when it was not found within 20 s
+static uint32_t ScanToCarrier(unsigned Steps, bool Early)
+{
+    HOST_WriteSquelchCalibration();
+    HOST_Boot();
+    if (!Early)
+        DisableEarlyReject();
+
+    const uint32_t Target = gRxVfo->pRX->Frequency + Steps * gRxVfo->StepFrequency;
+    const HOST_Signal_t s = { .Frequency = Target, .Level = -115 };
+    HOST_BAND_Clear();
+    HOST_BAND_Add(&s);
+    HOST_BK4819_ResetStats();
+
+    const uint32_t Steps0 = gScanSteps;
+    const uint64_t Start  = HOST_GetTimeUs();
+    CHFRSCANNER_Start(true, SCAN_FWD);
+
+    for (unsigned ms = 0; ms < 20000; ms += 10) {
+        if (gCurrentFunction == FUNCTION_RECEIVE && HOST_BK4819_GetFrequency() == Target)
+            break;
+        HOST_RunMs(10);
+    }
+
+    const bool     Found = gCurrentFunction == FUNCTION_RECEIVE && HOST_BK4819_GetFrequency() == Target;
+    const uint32_t LockMs = (HOST_GetTimeUs() - Start) / 1000;
+
+    BENCH(Early ? "scan.adaptive_steps_per_s" : "scan.fixed_steps_per_s", "%.1f",
+          (gScanSteps - Steps0) * 1000.0 / LockMs);
+    CHECK_EQ(HOST_BK4819_GetStats()->FalseOpens, 0);
+    CHFRSCANNER_Stop();
+
+    return Found ? LockMs : 0;
+}
+
+TEST(adaptive_dwell)
+{
+    const uint32_t Fixed    = ScanToCarrier(60, false);
+    const uint32_t Adaptive = ScanToCarrier(60, true);
+
+    CHECK(Fixed > 0);
+    CHECK(Adaptive > 0);
+    CHECK(Adaptive * 3 < Fixed);
+
+    BENCH("scan.fixed_time_to_lock_ms", "%u", Fixed);
+    BENCH("scan.adaptive_time_to_lock_ms", "%u", Adaptive);
+}
+
+TEST(early_reject_waits_for_the_next_tick)
+{
+    HOST_Boot();
+    HOST_BK4819_SetRssiSource(Noise);
+    CHFRSCANNER_Start(true, SCAN_FWD);
+
+    // Neither the retune nor the sample a tick later waits for the step to
+    // settle, the time slice stays with the main loop
+    for (unsigned i = 0; i < 4; i++) {
+        const uint64_t Start = HOST_GetCycles();
+        CHFRSCANNER_ContinueScanning();
+        CHECK((HOST_GetCycles() - Start) / HOST_CYCLES_PER_US < 1000);
+        CHECK_EQ(gScanPauseDelayIn_10ms, 1);
+    }
+
+    CHFRSCANNER_Stop();
+}
+
+TEST(early_reject_margins_out_of_range_load_defaults)
+{
+    HOST_Boot();
+    gEeprom.SCAN_EARLY_RSSI   = 0;
+    gEeprom.SCAN_EARLY_NOISE  = 61;
+    gEeprom.SCAN_EARLY_GLITCH = 30;
+    SETTINGS_SaveSettings();
+    PY25Q16_Flush();
+
+    HOST_Reset();
+    HOST_Boot();
+    CHECK_EQ(gEeprom.SCAN_EARLY_RSSI, 10);
+    CHECK_EQ(gEeprom.SCAN_EARLY_NOISE, 6);
+    CHECK_EQ(gEeprom.SCAN_EARLY_GLITCH, 30);
+}
+#endif
+
+// The linear walk RADIO_FindNextChannel() used to do
+static uint8_t WalkNextChannel(uint8_t Channel, int8_t Direction, bool CheckScanList, uint8_t List)
+{
+    for (unsigned i = 0; IS_MR_CHANNEL(i); i++, Channel += Direction) {
+        if (Channel == 0xFF)
+            Channel = MR_CHANNEL_LAST;
+        else if (!IS_MR_CHANNEL(Channel))
+            Channel = MR_CHANNEL_FIRST;
+
+        if (RADIO_CheckValidChannel(Channel, CheckScanList, List))
+            return Channel;
+    }
+
+    return 0xFF;
+}
+
+TEST(channel_index)
+{
+    HOST_Boot();
+
+    uint32_t Seed = 12345;
+    for (unsigned round = 0; round < 4; round++) {
+        // Sparse, random scan list membership and exclusions
+        for (unsigned ch = 0; IS_MR_CHANNEL(ch); ch++) {
+            Seed = Seed * 1103515245u + 12345u;
+            ChannelAttributes_t Att = { .__val = 0 };
+            Att.band      = (Seed >> 8) % 11 < 8 - 2 * round ? 2 : 7;
+            Att.scanlist1 = (Seed >> 12) & 1;
+            Att.scanlist2 = (Seed >> 13) & 1;
+            Att.scanlist3 = (Seed >> 14) & 1;
+            gMR_ChannelAttributes[ch] = Att;
+            gMR_ChannelExclude[ch]    = ((Seed >> 16) & 7) == 0;
+        }
+        gEeprom.SCANLIST_PRIORITY_CH1[0] = round * 7;
+        RADIO_InvalidateChannelIndex();
+
+        for (unsigned start = 0; start < 256; start += 3)
+            for (int dir = -1; dir <= 1; dir += 2)
+                for (unsigned list = 0; list < 6; list++) {
+                    CHECK_EQ(RADIO_FindNextChannel(start, dir, true, list),
+                             WalkNextChannel(start, dir, true, list));
+                    CHECK_EQ(RADIO_FindNextChannel(start, dir, false, list),
+                             WalkNextChannel(start, dir, false, list));
+                }
+    }
+
+    // Index follows exclusions once invalidated
+    const uint8_t Next = RADIO_FindNextChannel(0, 1, true, 5);
+    CHECK(Next != 0xFF);
+    gMR_ChannelExclude[Next] = true;
+    RADIO_InvalidateChannelIndex();
+    CHECK(RADIO_FindNextChannel(0, 1, true, 5) != Next);
+}
+
+TEST_MAIN_BEGIN
+    RUN(frequency_scan);
+    RUN(memory_scan);
+    RUN(retune_fast_path);
+    RUN(channel_profiles);
+    RUN(channel_index);
+#ifdef ENABLE_CHANNEL_BANKS
+    RUN(scan_across_banks);
+    RUN(scan_exclusions_across_banks);
+#endif
+#ifdef ENABLE_SCAN_ADAPTIVE_DWELL
+    RUN(adaptive_dwell);
+    RUN(early_reject_waits_for_the_next_tick);
+    RUN(early_reject_margins_out_of_range_load_defaults);
+#endif
+TEST_MAIN_END
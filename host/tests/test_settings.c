@@ -0,0 +1,404 @@
+/* settings.c against the flash model: defaults, channel save/fetch, reboot. */
+
+#include "test.h"
+
+#include "app/chFrScanner.h"
+#include "driver/flashlog.h"
+#include "driver/py25q16.h"
+#include "misc.h"
+#include "frequencies.h"
+#include "radio.h"
+#include "settings.h"
+
+static void SaveTestChannel(uint8_t Channel, uint32_t Frequency, bool Scanlist1)
+{
+    VFO_Info_t Vfo = gEeprom.VfoInfo[0];
+
+    Vfo.freq_config_RX.Frequency = Frequency;
+    Vfo.freq_config_TX.Frequency = Frequency;
+    Vfo.TX_OFFSET_FREQUENCY      = 0;
+    Vfo.Band                     = FREQUENCY_GetBand(Frequency);
+    Vfo.SCANLIST1_PARTICIPATION  = Scanlist1;
+    Vfo.SCANLIST2_PARTICIPATION  = 0;
+    Vfo.SCANLIST3_PARTICIPATION  = 0;
+
+    SETTINGS_SaveChannel(Channel, 0, &Vfo, 2);
+}
+
+TEST(boot_on_erased_flash)
+{
+    HOST_Boot();
+
+    CHECK(gEeprom.SQUELCH_LEVEL <= 9);
+    CHECK(gEeprom.VfoInfo[0].freq_config_RX.Frequency != 0);
+    CHECK(gEeprom.VfoInfo[0].freq_config_RX.Frequency != 0xFFFFFFFF);
+}
+
+TEST(channel_roundtrip)
+{
+    char Name[17];
+
+    HOST_Boot();
+    SaveTestChannel(5, 14550000, true);
+    SETTINGS_SaveChannelName(5, "HOST");
+
+    CHECK_EQ(SETTINGS_FetchChannelFrequency(5), 14550000);
+    CHECK(gMR_ChannelAttributes[5].scanlist1);
+    CHECK(!gMR_ChannelAttributes[5].scanlist2);
+
+    SETTINGS_FetchChannelName(Name, 5);
+    CHECK(strcmp(Name, "HOST") == 0);
+}
+
+TEST(channel_lookup)
+{
+    HOST_Boot();
+    SaveTestChannel(3, 14550000, false);
+    SaveTestChannel(9, 14550000, false);
+    SaveTestChannel(12, 43300000, false);
+    SETTINGS_SaveChannelName(3, "ALPHA");
+    SETTINGS_SaveChannelName(9, "beta");
+    SETTINGS_SaveChannelName(12, "Albert");
+
+    CHECK_EQ(SETTINGS_FindChannelByFrequency(14550000), 3);
+    CHECK_EQ(SETTINGS_FindChannelByFrequency(43300000), 12);
+    CHECK_EQ(SETTINGS_FindChannelByFrequency(12345670), -1);
+
+    // Moving a channel keeps the frequency order
+    SaveTestChannel(3, 43300000, false);
+    CHECK_EQ(SETTINGS_FindChannelByFrequency(14550000), 9);
+    CHECK_EQ(SETTINGS_FindChannelByFrequency(43300000), 3);
+
+#ifdef ENABLE_CHANNEL_INDEX
+    HOST_FLASH_ResetStats();
+    for (unsigned i = 0; i < 100; i++) {
+        SETTINGS_FindChannelByFrequency(43300000);
+        SETTINGS_FetchChannelFrequency(i % 200);
+    }
+    CHECK_EQ(HOST_FLASH_GetStats()->Reads, 0);
+
+    // Names shown on every redraw come from RAM after the first read
+    char Name[17];
+    SETTINGS_FetchChannelName(Name, 9);
+    SETTINGS_FetchChannelName(Name, 12);
+    HOST_FLASH_ResetStats();
+    for (unsigned i = 0; i < 100; i++) {
+        SETTINGS_FetchChannelName(Name, 9);
+        SETTINGS_FetchChannelName(Name, 12);
+        SETTINGS_FetchChannelName(Name, 20);    // unnamed
+    }
+    CHECK_EQ(HOST_FLASH_GetStats()->Reads, 0);
+    CHECK(strcmp(Name, "") == 0);
+
+    SETTINGS_SaveChannelName(12, "Charlie");
+    SETTINGS_FetchChannelName(Name, 12);
+    CHECK(strcmp(Name, "Charlie") == 0);
+    SETTINGS_FetchChannelName(Name, 9);
+    CHECK(strcmp(Name, "beta") == 0);
+#endif
+}
+
+TEST(channels_survive_reboot)
+{
+    char Name[17];
+
+    HOST_Boot();
+    SaveTestChannel(7, 43350000, true);
+    SETTINGS_SaveChannelName(7, "REBOOT");
+
+    HOST_RunMs(1500);   // idle long enough for any write-back
+    HOST_Reset();
+    memset(gMR_ChannelAttributes, 0, sizeof(gMR_ChannelAttributes));
+    HOST_Boot();
+
+    CHECK_EQ(SETTINGS_FetchChannelFrequency(7), 43350000);
+    CHECK(gMR_ChannelAttributes[7].scanlist1);
+    SETTINGS_FetchChannelName(Name, 7);
+    CHECK(strcmp(Name, "REBOOT") == 0);
+}
+
+TEST(save_settings_cost)
+{
+    HOST_Boot();
+    HOST_FLASH_ResetStats();
+
+    const uint64_t start = HOST_GetTimeUs();
+    gEeprom.SQUELCH_LEVEL = gEeprom.SQUELCH_LEVEL == 3 ? 4 : 3;
+    SETTINGS_SaveSettings();
+    const uint64_t us = HOST_GetTimeUs() - start;
+    PY25Q16_Flush();
+    const uint64_t flush_us = HOST_GetTimeUs() - start - us;
+
+    BENCH("settings.save_ms", "%.1f", us / 1000.0);
+    BENCH("settings.flush_ms", "%.1f", flush_us / 1000.0);
+    BENCH("settings.save_erases", "%u", HOST_FLASH_GetStats()->SectorErases);
+    CHECK(HOST_FLASH_GetStats()->PagePrograms > 0);
+}
+
+TEST(load_settings_cost)
+{
+    HOST_Boot();
+    gEeprom.SQUELCH_LEVEL = 5;
+    SETTINGS_SaveSettings();
+    PY25Q16_Flush();
+    HOST_FLASH_ResetStats();
+
+    const uint64_t start = HOST_GetTimeUs();
+    SETTINGS_InitEEPROM();
+    SETTINGS_LoadCalibration();
+    const uint64_t us = HOST_GetTimeUs() - start;
+
+    BENCH("settings.load_us", "%llu", (unsigned long long)us);
+    BENCH("settings.load_reads", "%u", HOST_FLASH_GetStats()->Reads);
+    CHECK_EQ(gEeprom.SQUELCH_LEVEL, 5);
+}
+
+#if defined(ENABLE_SETTINGS_LOG) || defined(ENABLE_CHANNEL_BANKS)
+static void Reboot(void)
+{
+    PY25Q16_Flush();
+    HOST_Reset();
+    HOST_Boot();
+}
+#endif
+
+#ifdef ENABLE_CHANNEL_BANKS
+TEST(channel_banks)
+{
+    char     Name[17];
+    uint32_t Legacy;
+
+    HOST_Boot();
+    SaveTestChannel(5, 14550000, true);
+    SETTINGS_SaveChannelName(5, "LEGACY");
+
+    SETTINGS_SelectChannelBank(2);
+    CHECK(!RADIO_CheckValidChannel(5, false, 0));
+    CHECK_EQ(SETTINGS_FindChannelByFrequency(14550000), -1);
+
+    SaveTestChannel(5, 43300000, false);
+    SETTINGS_SaveChannelName(5, "BANK2");
+    CHECK_EQ(SETTINGS_FindChannelByFrequency(43300000), 5);
+
+    // The legacy area the CPS reads is left alone
+    memcpy(&Legacy, HOST_FLASH_Image() + 5 * 16, 4);
+    CHECK_EQ(Legacy, 14550000);
+
+    Reboot();
+    CHECK_EQ(gEeprom.CHANNEL_BANK, 2);
+    CHECK(RADIO_CheckValidChannel(5, false, 0));
+    CHECK(!gMR_ChannelAttributes[5].scanlist1);
+    CHECK_EQ(SETTINGS_FetchChannelFrequency(5), 43300000);
+    SETTINGS_FetchChannelName(Name, 5);
+    CHECK(strcmp(Name, "BANK2") == 0);
+
+    SETTINGS_SelectChannelBank(0);
+    CHECK(gMR_ChannelAttributes[5].scanlist1);
+    CHECK_EQ(SETTINGS_FetchChannelFrequency(5), 14550000);
+    SETTINGS_FetchChannelName(Name, 5);
+    CHECK(strcmp(Name, "LEGACY") == 0);
+}
+
+TEST(reset_tx_lock_every_bank)
+{
+    uint8_t State[16];
+
+    HOST_Boot();
+    gEeprom.VfoInfo[0].TX_LOCK = false;
+    SaveTestChannel(5, 14550000, true);
+    SETTINGS_SelectChannelBank(CHANNEL_BANK_COUNT - 1);
+    SaveTestChannel(7, 43300000, true);
+    SETTINGS_SelectChannelBank(0);
+
+    FLASHLOG_ReadBuffer(SETTINGS_BankChannelAddress(CHANNEL_BANK_COUNT - 1, 7), State, sizeof(State));
+    CHECK(!(State[4] & (1 << 6)));
+
+    SETTINGS_ResetTxLock();
+
+    FLASHLOG_ReadBuffer(SETTINGS_BankChannelAddress(0, 5), State, sizeof(State));
+    CHECK(State[4] & (1 << 6));
+    FLASHLOG_ReadBuffer(SETTINGS_BankChannelAddress(CHANNEL_BANK_COUNT - 1, 7), State, sizeof(State));
+    CHECK(State[4] & (1 << 6));
+}
+
+TEST(bank_survives_settings_writes)
+{
+    HOST_Boot();
+    SETTINGS_SelectChannelBank(2);
+
+    // Rewrites of the bytes before the bank one erase their sector when the
+    // settings log is off
+    for (unsigned i = 0; i < 3; i++) {
+        gSetting_set_tot = i;
+        SETTINGS_SaveSettings();
+    }
+    SETTINGS_WriteBuildOptions();
+
+    Reboot();
+    CHECK_EQ(gEeprom.CHANNEL_BANK, 2);
+    SETTINGS_SelectChannelBank(0);
+}
+#endif
+
+#ifdef ENABLE_SETTINGS_LOG
+
+TEST(log_spreads_erases)
+{
+    const HOST_FLASH_Stats_t *Stats = HOST_FLASH_GetStats();
+    const unsigned            First = FLASHLOG_BASE / HOST_FLASH_SECTOR_SIZE;
+
+    HOST_Boot();
+    HOST_FLASH_ResetStats();
+
+    for (unsigned i = 0; i < 1000; i++) {
+        gEeprom.SQUELCH_LEVEL = i % 10;
+        SETTINGS_SaveSettings();
+    }
+
+    unsigned Min = 0xFFFF, Max = 0;
+    for (unsigned s = First; s < First + FLASHLOG_SECTORS; s++) {
+        Min = Stats->EraseCount[s] < Min ? Stats->EraseCount[s] : Min;
+        Max = Stats->EraseCount[s] > Max ? Stats->EraseCount[s] : Max;
+    }
+
+    BENCH("settings.log_erases_per_1000", "%u", Stats->SectorErases);
+    CHECK(Min > 0);
+    CHECK(Max - Min <= 1);
+    CHECK_EQ(Stats->EraseCount[0x004000 / HOST_FLASH_SECTOR_SIZE], 0);
+
+    Reboot();
+    CHECK_EQ(gEeprom.SQUELCH_LEVEL, 999 % 10);
+}
+
+TEST(log_reads_legacy_layout)
+{
+    HOST_FLASH_Image()[0x004001] = 5;   // squelch, as an older firmware left it
+
+    HOST_Boot();
+    CHECK_EQ(gEeprom.SQUELCH_LEVEL, 5);
+
+    HOST_FLASH_ResetStats();
+    gEeprom.SQUELCH_LEVEL = 6;
+    SETTINGS_SaveSettings();
+    CHECK_EQ(HOST_FLASH_GetStats()->EraseCount[0x004000 / HOST_FLASH_SECTOR_SIZE], 0);
+    CHECK_EQ(HOST_FLASH_Image()[0x004001], 5);
+
+    Reboot();
+    CHECK_EQ(gEeprom.SQUELCH_LEVEL, 6);
+}
+
+TEST(log_skips_torn_record)
+{
+    HOST_Boot();
+    gEeprom.SQUELCH_LEVEL = 3;
+    SETTINGS_SaveSettings();
+    gEeprom.SQUELCH_LEVEL = 4;
+    SETTINGS_SaveSettings();
+
+    uint8_t *Image = HOST_FLASH_Image();
+
+    // Last slot programmed in the pool, its data never made it to the chip
+    uint32_t Last = 0;
+    for (uint32_t a = FLASHLOG_BASE; a < FLASHLOG_BASE + FLASHLOG_SECTORS * HOST_FLASH_SECTOR_SIZE; a += 16)
+        if (Image[a] != 0xFF || Image[a + 15] != 0xFF)
+            Last = a;
+    CHECK(Last != 0);
+    memset(&Image[Last + 8], 0xFF, 8);
+
+    Reboot();
+    CHECK_EQ(gEeprom.SQUELCH_LEVEL, 3);
+}
+
+#endif
+
+#ifdef ENABLE_FLASH_WRITE_BACK
+
+TEST(write_back_waits_for_idle)
+{
+    const HOST_FLASH_Stats_t *Stats = HOST_FLASH_GetStats();
+
+    HOST_Boot();
+    HOST_RunMs(100);
+    HOST_FLASH_ResetStats();
+
+    gEeprom.SQUELCH_LEVEL = 7;
+    SETTINGS_SaveSettings();
+    CHECK_EQ(Stats->PagePrograms + Stats->SectorErases, 0);
+
+    HOST_RunMs(500);
+    CHECK(PY25Q16_IsDirty());
+    HOST_RunMs(600);
+    CHECK(!PY25Q16_IsDirty() && !PY25Q16_IsBusy());
+
+    // A power cut before the write-back loses only what was still pending
+    gEeprom.SQUELCH_LEVEL = 8;
+    SETTINGS_SaveSettings();
+    HOST_Reset();
+    HOST_Boot();
+    CHECK_EQ(gEeprom.SQUELCH_LEVEL, 7);
+}
+
+TEST(write_back_max_age)
+{
+    HOST_Boot();
+    HOST_RunMs(100);
+
+    gEeprom.SQUELCH_LEVEL = 7;
+    SETTINGS_SaveSettings();
+    CHFRSCANNER_Start(true, SCAN_FWD);  // busy, only the age limit flushes
+    HOST_RunMs(4000);
+    CHECK(PY25Q16_IsDirty());
+    HOST_RunMs(1100);
+    CHECK(!PY25Q16_IsDirty() && !PY25Q16_IsBusy());
+    CHFRSCANNER_Stop();
+}
+
+// Every 10 ms tick the main loop saw while a sector is erased behind it
+TEST(write_back_keeps_timeslices)
+{
+    uint8_t Name[16];
+
+    HOST_Boot();
+    HOST_RunMs(100);
+
+    // A channel name rewrite, which needs the sector erased
+    memset(Name, 'A', sizeof(Name));
+    PY25Q16_WriteBuffer(0x00e000, Name, sizeof(Name), false);
+    PY25Q16_Flush();
+    memset(Name, 'B', sizeof(Name));
+    PY25Q16_WriteBuffer(0x00e000, Name, sizeof(Name), false);
+
+    HOST_FLASH_ResetStats();
+    const uint32_t Ticks = gFlashLightBlinkCounter;
+    HOST_RunMs(1500);
+
+    BENCH("settings.write_back_ticks_1500ms", "%u", gFlashLightBlinkCounter - Ticks);
+    CHECK_EQ(HOST_FLASH_GetStats()->SectorErases, 1);
+    CHECK(gFlashLightBlinkCounter - Ticks >= 149);
+}
+
+#endif
+
+TEST_MAIN_BEGIN
+    RUN(boot_on_erased_flash);
+    RUN(channel_roundtrip);
+    RUN(channel_lookup);
+    RUN(channels_survive_reboot);
+#ifdef ENABLE_CHANNEL_BANKS
+    RUN(channel_banks);
+    RUN(reset_tx_lock_every_bank);
+    RUN(bank_survives_settings_writes);
+#endif
+    RUN(save_settings_cost);
+    RUN(load_settings_cost);
+#ifdef ENABLE_SETTINGS_LOG
+    RUN(log_spreads_erases);
+    RUN(log_reads_legacy_layout);
+    RUN(log_skips_torn_record);
+#endif
+#ifdef ENABLE_FLASH_WRITE_BACK
+    RUN(write_back_waits_for_idle);
+    RUN(write_back_max_age);
+    RUN(write_back_keeps_timeslices);
+#endif
+TEST_MAIN_END
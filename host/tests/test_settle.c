@@ -0,0 +1,143 @@
+/* app/rssi_settle.c: settle calibration per scan step against the bus
+ * model's filter-dependent settle, and the sweep rate it buys over polling
+ * the glitch indicator. */
+
+#include "test.h"
+
+#include "app/rssi_settle.h"
+#include "driver/bk4819.h"
+#include "driver/bk4819-regs.h"
+#include "driver/systick.h"
+
+#define F0          43300000u   // 433.000 MHz
+#define SIGNAL_BIN  40
+#define BINS        128
+
+// scanStepValues and scanStepBWRegValues from app/spectrum.h
+static const uint16_t STEP[] = {
+    1, 10, 50, 100, 250, 500, 625, 833, 1000, 1250, 1500, 2000, 2500, 5000, 10000
+};
+static const uint16_t BW_REG[] = {
+    0x0058, 0x0058, 0x0058, 0x0058, 0x0058, 0x2458, 0x4858, 0x6C48,
+    0x6C48, 0x7F08, 0x7F08, 0x7F08, 0x3628, 0x3628, 0x3628
+};
+
+// SetF() in app/spectrum.c
+static void Tune(uint32_t Frequency)
+{
+    BK4819_SetFrequency(Frequency);
+    const uint16_t Reg = BK4819_ReadRegister(BK4819_REG_30);
+    BK4819_WriteRegister(BK4819_REG_30, 0);
+    BK4819_WriteRegister(BK4819_REG_30, Reg);
+}
+
+// GetRssi() as it was: poll the glitch indicator until it drops below 255
+static uint16_t GlitchPollRssi(void)
+{
+    while ((BK4819_ReadRegister(BK4819_REG_63) & 0xFF) >= 255)
+        SYSTICK_DelayUs(100);
+    return BK4819_GetRSSI();
+}
+
+static void Setup(unsigned Index)
+{
+    const HOST_Signal_t Signal = { .Frequency = F0 + SIGNAL_BIN * STEP[Index], .Level = -70 };
+
+    HOST_BAND_Clear();
+    HOST_BAND_Add(&Signal);
+    BK4819_RX_TurnOn();
+    BK4819_WriteRegister(BK4819_REG_43, BW_REG[Index]);
+}
+
+// Virtual us for one sweep; *pWorst is the largest distance of a reading
+// from the level the bin settles to
+static uint64_t Sweep(unsigned Index, int SettleUs, unsigned *pWorst)
+{
+    const uint64_t Start = HOST_GetTimeUs();
+
+    *pWorst = 0;
+    for (unsigned b = 0; b < BINS; b++) {
+        Tune(F0 + b * STEP[Index]);
+        const uint16_t Rssi = SettleUs < 0 ? GlitchPollRssi() : SETTLE_GetRssi(SettleUs);
+
+        // What the bin settles to, signal or noise floor
+        const HOST_Signal_t *pSignal;
+        const int      Level  = HOST_BAND_Level(F0 + b * STEP[Index], HOST_GetTimeUs() / 1000, &pSignal);
+        const int      Expect = (Level + 160) * 2;
+        const unsigned Off    = Rssi > Expect ? Rssi - Expect : Expect - Rssi;
+        if (Off > *pWorst)
+            *pWorst = Off;
+    }
+
+    return HOST_GetTimeUs() - Start;
+}
+
+TEST(calibration_follows_the_filter)
+{
+    for (unsigned i = 0; i < sizeof(STEP) / sizeof(STEP[0]); i++) {
+        Setup(i);
+
+        const uint32_t Model  = HOST_BK4819_GetSettleUs();
+        const uint16_t Settle = SETTLE_Calibrate(Tune, F0, F0 + 100000);
+
+        CHECK(Settle >= Model);
+        CHECK(Settle <= Model + 300);
+    }
+}
+
+TEST(sweep_rate_per_step)
+{
+    unsigned Late = 0;
+
+    for (unsigned i = 0; i < sizeof(STEP) / sizeof(STEP[0]); i++) {
+        unsigned WorstPoll, WorstSettle;
+        char     Name[40];
+
+        Setup(i);
+        const uint16_t Settle = SETTLE_Calibrate(Tune, F0, F0 + 100000);
+        SETTLE_TakeLateReads();
+
+        const uint64_t PollUs   = Sweep(i, -1, &WorstPoll);
+        const uint64_t SettleUs = Sweep(i, Settle, &WorstSettle);
+        Late += SETTLE_TakeLateReads();
+
+        // Same readings as the poll, the model's jitter aside
+        CHECK(WorstSettle <= 4);
+        CHECK(WorstPoll <= 4);
+
+        snprintf(Name, sizeof(Name), "settle.step_%u.%02u_settle_us", STEP[i] / 100, STEP[i] % 100);
+        BENCH(Name, "%u", Settle);
+        snprintf(Name, sizeof(Name), "settle.step_%u.%02u_sweeps_s", STEP[i] / 100, STEP[i] % 100);
+        BENCH(Name, "%.2f poll, %.2f calibrated", 1e6 / PollUs, 1e6 / SettleUs);
+    }
+
+    CHECK_EQ(Late, 0);
+}
+
+// A receiver whose glitch indicator never leaves 255 used to hang the sweep
+static uint16_t StuckGlitch(uint8_t Reg, uint16_t Value)
+{
+    return Reg == BK4819_REG_63 ? (Value | 0xFF) : Value;
+}
+
+TEST(stuck_glitch_is_bounded)
+{
+    Setup(0);
+    HOST_BK4819_SetHooks(StuckGlitch, NULL);
+    SETTLE_TakeLateReads();
+
+    const uint64_t Start = HOST_GetTimeUs();
+    Tune(F0);
+    SETTLE_GetRssi(500);
+
+    const uint64_t Us = HOST_GetTimeUs() - Start;
+    BENCH("settle.stuck_glitch_read_us", "%llu", (unsigned long long)Us);
+    CHECK(Us <= 500 + SETTLE_POLL_MAX_US + 200);
+    CHECK_EQ(SETTLE_TakeLateReads(), 1);
+}
+
+TEST_MAIN_BEGIN
+    RUN(calibration_follows_the_filter);
+    RUN(sweep_rate_per_step);
+    RUN(stuck_glitch_is_bounded);
+TEST_MAIN_END
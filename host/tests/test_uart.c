@@ -0,0 +1,388 @@
+/* app/uart.c command framing over the UART and VCP models. */
+
+#include "test.h"
+
+#include "driver/crc.h"
+#include "driver/py25q16.h"
+#include "helper/boot_profile.h"
+#ifdef ENABLE_SPECTRUM
+    #include "app/spectrum_occupancy.h"
+#endif
+#ifdef ENABLE_SPECTRUM_STREAM
+    #include "app/spectrum_stream.h"
+    #include "app/uart.h"
+#endif
+
+static const uint8_t Obfuscation[16] = {
+    0x16, 0x6C, 0x14, 0xE6, 0x2E, 0x91, 0x0D, 0x40,
+    0x21, 0x35, 0xD5, 0x40, 0x13, 0x03, 0xE9, 0x80
+};
+
+// Frames Payload as AB CD | size | payload+crc (obfuscated) | DC BA.
+static size_t BuildFrame(uint8_t *Out, const uint8_t *Payload, uint16_t Size)
+{
+    const uint16_t Crc = CRC_Calculate(Payload, Size);
+
+    Out[0] = 0xAB;
+    Out[1] = 0xCD;
+    Out[2] = Size & 0xFF;
+    Out[3] = Size >> 8;
+    memcpy(Out + 4, Payload, Size);
+    Out[4 + Size] = Crc & 0xFF;
+    Out[5 + Size] = Crc >> 8;
+    for (unsigned i = 0; i < Size + 2u; i++)
+        Out[4 + i] ^= Obfuscation[i % 16];
+    Out[6 + Size] = 0xDC;
+    Out[7 + Size] = 0xBA;
+
+    return Size + 8u;
+}
+
+// Returns the de-obfuscated reply payload size, 0 if the frame is malformed.
+static uint16_t ParseReply(uint8_t *Payload, const uint8_t *In, size_t Len)
+{
+    if (Len < 8 || In[0] != 0xAB || In[1] != 0xCD)
+        return 0;
+
+    const uint16_t Size = In[2] | (In[3] << 8);
+    if (Len < Size + 8u || In[6 + Size] != 0xDC || In[7 + Size] != 0xBA)
+        return 0;
+
+    for (unsigned i = 0; i < Size; i++)
+        Payload[i] = In[4 + i] ^ Obfuscation[i % 16];
+
+    return Size;
+}
+
+static size_t BuildHello(uint8_t *Out)
+{
+    const uint8_t Cmd[8] = { 0x14, 0x05, 0x04, 0x00, 0x78, 0x56, 0x34, 0x12 };
+    return BuildFrame(Out, Cmd, sizeof(Cmd));
+}
+
+TEST(vcp_hello_returns_version)
+{
+    uint8_t Frame[64];
+    uint8_t Reply[256];
+    uint8_t Payload[256];
+
+    HOST_Boot();
+    HOST_VCP_Inject(Frame, BuildHello(Frame));
+    HOST_RunMs(30);
+
+    const size_t   Len  = HOST_VCP_Read(Reply, sizeof(Reply));
+    const uint16_t Size = ParseReply(Payload, Reply, Len);
+
+    CHECK(Size >= 4 + 16);
+    CHECK_EQ(Payload[0] | (Payload[1] << 8), 0x0515);
+    CHECK(memchr(Payload + 4, 0, 16) != NULL);
+}
+
+TEST(uart_hello_returns_version)
+{
+    uint8_t Frame[64];
+    uint8_t Reply[256];
+    uint8_t Payload[256];
+
+    HOST_Boot();
+    HOST_UART_Inject(Frame, BuildHello(Frame));
+    HOST_RunMs(30);
+
+    const size_t   Len  = HOST_UART_Read(Reply, sizeof(Reply));
+    const uint16_t Size = ParseReply(Payload, Reply, Len);
+
+    CHECK(Size >= 4 + 16);
+    CHECK_EQ(Payload[0] | (Payload[1] << 8), 0x0515);
+}
+
+TEST(bad_crc_is_ignored)
+{
+    uint8_t Frame[64];
+    uint8_t Reply[256];
+
+    HOST_Boot();
+    const size_t Len = BuildHello(Frame);
+    Frame[5] ^= 0x01;
+    HOST_VCP_Inject(Frame, Len);
+    HOST_RunMs(30);
+
+    CHECK_EQ(HOST_VCP_Read(Reply, sizeof(Reply)), 0);
+}
+
+#ifdef ENABLE_BOOT_PROFILE
+TEST(boot_profile_over_vcp)
+{
+    const uint8_t Cmd[4] = { 0x10, 0x06, 0x00, 0x00 };
+    uint8_t       Frame[64];
+    uint8_t       Reply[256];
+    uint8_t       Payload[256];
+
+    // The first boot on erased flash starts the settings log, time the next one
+    HOST_Boot();
+    PY25Q16_Flush();
+    HOST_Reset();
+    HOST_Boot();
+
+    HOST_VCP_Inject(Frame, BuildFrame(Frame, Cmd, sizeof(Cmd)));
+    HOST_RunMs(30);
+
+    const size_t   Len  = HOST_VCP_Read(Reply, sizeof(Reply));
+    const uint16_t Size = ParseReply(Payload, Reply, Len);
+
+    CHECK_EQ(Size, 4 + 4 * BOOT_PHASE_COUNT);
+    CHECK_EQ(Payload[0] | (Payload[1] << 8), 0x0610);
+
+    uint32_t Us[BOOT_PHASE_COUNT];
+    memcpy(Us, Payload + 4, sizeof(Us));
+    for (unsigned i = 1; i < BOOT_PHASE_COUNT; i++)
+        CHECK(Us[i] >= Us[i - 1]);
+    CHECK(Us[BOOT_PHASE_FIRST_RX] > 0);
+
+    BENCH("boot.settings_us", "%u", (unsigned)(Us[BOOT_PHASE_SETTINGS] - Us[BOOT_PHASE_BOARD]));
+    BENCH("boot.first_rx_us", "%u", (unsigned)Us[BOOT_PHASE_FIRST_RX]);
+}
+#endif
+
+#ifdef ENABLE_SPECTRUM_STREAM
+#define SWEEP_BINS  128
+
+static void GrantStream(uint8_t Credits)
+{
+    const uint8_t Cmd[5] = { 0x12, 0x06, 0x01, 0x00, Credits };
+    uint8_t       Frame[64];
+
+    HOST_VCP_Inject(Frame, BuildFrame(Frame, Cmd, sizeof(Cmd)));
+    HOST_RunMs(30);
+}
+
+// One sweep 10 ms after the last, as a fast scan would complete them
+static void Sweep(uint16_t Bias)
+{
+    uint16_t Rssi[SWEEP_BINS];
+
+    for (unsigned i = 0; i < SWEEP_BINS; i++)
+        Rssi[i] = Bias + i;
+
+    HOST_AdvanceUs(10000);
+    STREAM_SendSweep(Rssi, NULL, SWEEP_BINS, 43300000, 2500);
+}
+
+// Reads the next AA 55 03 frame, false if none is waiting; a min trace
+// lands in pRssi after the Count max values
+static bool ReadSweep(STREAM_Header_t *pHeader, uint16_t *pRssi)
+{
+    uint8_t Prefix[5];
+    uint8_t Payload[sizeof(STREAM_Header_t) + SWEEP_BINS * 4 + 1];
+
+    if (HOST_VCP_Read(Prefix, sizeof(Prefix)) != sizeof(Prefix))
+        return false;
+
+    const uint16_t Size = (Prefix[3] << 8) | Prefix[4];
+    if (Prefix[0] != 0xAA || Prefix[1] != 0x55 || Prefix[2] != STREAM_FRAME_TYPE || Size + 1u > sizeof(Payload))
+        return false;
+    if (HOST_VCP_Read(Payload, Size + 1u) != Size + 1u || Payload[Size] != 0x0A)
+        return false;
+
+    memcpy(pHeader, Payload, sizeof(*pHeader));
+    memcpy(pRssi, Payload + sizeof(*pHeader), (pHeader->Count + pHeader->MinCount) * 2);
+    return Size == sizeof(*pHeader) + (pHeader->Count + pHeader->MinCount) * 2;
+}
+
+TEST(stream_sends_granted_sweeps)
+{
+    STREAM_Header_t Header;
+    uint16_t        Rssi[SWEEP_BINS];
+
+    HOST_Boot();
+
+    // Nothing goes out before the PC asks
+    Sweep(0);
+    CHECK(!ReadSweep(&Header, Rssi));
+
+    GrantStream(2);
+    Sweep(100);
+    Sweep(200);
+    Sweep(300);     // out of credit
+
+    CHECK(ReadSweep(&Header, Rssi));
+    CHECK_EQ(Header.Seq, 0);
+    CHECK_EQ(Header.Count, SWEEP_BINS);
+    CHECK_EQ(Header.Start, 43300000);
+    CHECK_EQ(Header.Step, 2500);
+    CHECK_EQ(Header.MinCount, 0);
+    CHECK_EQ(Rssi[0], 100);
+    CHECK_EQ(Rssi[SWEEP_BINS - 1], 100 + SWEEP_BINS - 1);
+    const uint32_t TimeUs = Header.TimeUs;
+
+    CHECK(ReadSweep(&Header, Rssi));
+    CHECK_EQ(Header.Seq, 1);
+    CHECK_EQ(Header.TimeUs - TimeUs, 10000);
+    CHECK(!ReadSweep(&Header, Rssi));
+
+    // The top-up shows the sweep that found no credit
+    GrantStream(4);
+    Sweep(400);
+    CHECK(ReadSweep(&Header, Rssi));
+    CHECK_EQ(Header.Seq, 3);
+    CHECK_EQ(Header.DropCredit, 1);
+    CHECK_EQ(Header.DropBusy, 0);
+    CHECK_EQ(Rssi[0], 400);
+
+    GrantStream(0);
+    Sweep(500);
+    CHECK(!ReadSweep(&Header, Rssi));
+}
+
+TEST(stream_carries_the_min_trace)
+{
+    STREAM_Header_t Header;
+    uint16_t        Max[SWEEP_BINS], Min[SWEEP_BINS], Rssi[2 * SWEEP_BINS];
+
+    HOST_Boot();
+    GrantStream(1);
+
+    for (unsigned i = 0; i < SWEEP_BINS; i++) {
+        Max[i] = 200 + i;
+        Min[i] = 50 + i;
+    }
+    STREAM_SendSweep(Max, Min, SWEEP_BINS, 40000000, 62500);
+
+    CHECK(ReadSweep(&Header, Rssi));
+    CHECK_EQ(Header.Count, SWEEP_BINS);
+    CHECK_EQ(Header.MinCount, SWEEP_BINS);
+    CHECK_EQ(Rssi[0], 200);
+    CHECK_EQ(Rssi[SWEEP_BINS], 50);
+    CHECK_EQ(Rssi[2 * SWEEP_BINS - 1], 50 + SWEEP_BINS - 1);
+    GrantStream(0);
+}
+
+TEST(stream_drops_while_the_pc_is_not_reading)
+{
+    STREAM_Header_t Header;
+    uint16_t        Rssi[SWEEP_BINS];
+
+    HOST_Boot();
+    GrantStream(100);
+
+    Sweep(0);       // goes out, then sits in the endpoint
+    HOST_VCP_SetStalled(true);
+    const uint64_t Start = HOST_GetTimeUs();
+    for (unsigned i = 0; i < 5; i++)
+        Sweep(0);
+    const uint64_t Us = HOST_GetTimeUs() - Start;
+    HOST_VCP_SetStalled(false);
+
+    // Dropping costs the sweep nothing beyond the 10 ms between them
+    CHECK_EQ(Us, 5 * 10000);
+
+    Sweep(0);
+    CHECK(ReadSweep(&Header, Rssi));
+    CHECK(ReadSweep(&Header, Rssi));
+    CHECK_EQ(Header.Seq, 6);
+    CHECK_EQ(Header.DropBusy, 5);
+    CHECK_EQ(Header.DropCredit, 0);
+
+    const unsigned Bytes = 5 + sizeof(STREAM_Header_t) + SWEEP_BINS * 2 + 1;
+    BENCH("stream.frame_bytes", "%u", Bytes);
+    BENCH("stream.max_sweeps_s", "%u", 1000000 / (Bytes * HOST_VCP_US_PER_BYTE));
+    GrantStream(0);
+}
+#endif
+
+#ifdef ENABLE_SPECTRUM
+// Reads bins First.. of the survey, returns how many came back
+static uint8_t ReadOccupancy(uint8_t First, uint8_t Count, uint8_t *pPayload)
+{
+    const uint8_t Cmd[6] = { 0x13, 0x06, 0x02, 0x00, First, Count };
+    uint8_t       Frame[64];
+    uint8_t       Reply[256];
+
+    HOST_VCP_Inject(Frame, BuildFrame(Frame, Cmd, sizeof(Cmd)));
+    HOST_RunMs(30);
+
+    const size_t   Len  = HOST_VCP_Read(Reply, sizeof(Reply));
+    const uint16_t Size = ParseReply(pPayload, Reply, Len);
+
+    CHECK_EQ(pPayload[0] | (pPayload[1] << 8), 0x0613);
+    CHECK_EQ(Size, 4 + 9 + pPayload[12] * 10);
+    CHECK_EQ(pPayload[11], First);
+    return pPayload[12];
+}
+
+TEST(occupancy_is_read_in_chunks)
+{
+    uint16_t Rssi[OCCUPANCY_BINS];
+    uint8_t  Payload[256];
+
+    HOST_Boot();
+    OCCUPANCY_Setup(43000000, 2500, 128);
+    OCCUPANCY_Reset();
+    for (unsigned n = 0; n < 4; n++) {
+        for (unsigned i = 0; i < OCCUPANCY_BINS; i++)
+            Rssi[i] = i == 100 && n ? 200 : 50;
+        OCCUPANCY_Update(Rssi, 100);
+    }
+
+    // As many as fit in a reply, then the rest of the bins
+    CHECK_EQ(ReadOccupancy(0, 255, Payload), 12);
+    CHECK_EQ(ReadOccupancy(120, 12, Payload), 8);
+    CHECK_EQ(ReadOccupancy(128, 12, Payload), 0);
+
+    CHECK_EQ(ReadOccupancy(96, 8, Payload), 8);
+    CHECK_EQ(Payload[4] | (Payload[5] << 8), 4);        // sweeps
+    CHECK_EQ(Payload[10], 128);                         // bins
+
+    // Bin 100: frequency, busy, max, last seen
+    const uint8_t *pEntry = Payload + 13 + 4 * 10;
+    uint32_t Frequency;
+    uint16_t Bin[3];
+    memcpy(&Frequency, pEntry, 4);
+    memcpy(Bin, pEntry + 4, 6);
+    CHECK_EQ(Frequency, 43000000 + 100 * 2500);
+    CHECK_EQ(Bin[0], 3);
+    CHECK_EQ(Bin[1], 200);
+}
+
+#ifdef ENABLE_SPECTRUM_STREAM
+// The spectrum polls the VCP itself and serves only the stream and survey
+TEST(spectrum_takes_only_its_own_commands)
+{
+    const uint8_t Read[6] = { 0x13, 0x06, 0x02, 0x00, 0, 1 };
+    uint8_t       Frame[64];
+    uint8_t       Reply[256];
+
+    HOST_Boot();
+    OCCUPANCY_Setup(43000000, 2500, 128);
+
+    HOST_VCP_Inject(Frame, BuildHello(Frame));
+    CHECK(UART_IsCommandAvailable(UART_PORT_VCP));
+    UART_HandleSpectrumCommand(UART_PORT_VCP);
+    CHECK_EQ(HOST_VCP_Read(Reply, sizeof(Reply)), 0);
+
+    HOST_VCP_Inject(Frame, BuildFrame(Frame, Read, sizeof(Read)));
+    CHECK(UART_IsCommandAvailable(UART_PORT_VCP));
+    UART_HandleSpectrumCommand(UART_PORT_VCP);
+    CHECK(HOST_VCP_Read(Reply, sizeof(Reply)) > 0);
+}
+#endif
+#endif
+
+TEST_MAIN_BEGIN
+    RUN(vcp_hello_returns_version);
+    RUN(uart_hello_returns_version);
+    RUN(bad_crc_is_ignored);
+#ifdef ENABLE_BOOT_PROFILE
+    RUN(boot_profile_over_vcp);
+#endif
+#ifdef ENABLE_SPECTRUM_STREAM
+    RUN(stream_sends_granted_sweeps);
+    RUN(stream_carries_the_min_trace);
+    RUN(stream_drops_while_the_pc_is_not_reading);
+#endif
+#ifdef ENABLE_SPECTRUM
+    RUN(occupancy_is_read_in_chunks);
+#ifdef ENABLE_SPECTRUM_STREAM
+    RUN(spectrum_takes_only_its_own_commands);
+#endif
+#endif
+TEST_MAIN_END
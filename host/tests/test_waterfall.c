@@ -0,0 +1,307 @@
+/* app/waterfall.c: the packed history ring and its scroll-back, and the
+ * renderer against the float one it replaced. */
+
+#include "test.h"
+
+#include "app/waterfall.h"
+#include "driver/py25q16.h"
+#include "driver/st7565.h"
+#include "driver/systick.h"
+
+#define TOP     41
+#define ROWS    WATERFALL_VISIBLE
+
+// What was pushed, newest row first
+static uint8_t gHistory[WATERFALL_DEPTH][128];
+
+// A static estimate, not a measurement: the host model clocks the peripherals
+// only, so the renderers' own time on the Cortex-M0+ is charged from these
+// hand-picked constants. Soft-float calls at typical libgcc costs for a core
+// without an FPU. The ratio follows from the constants, so nothing is checked
+// against it.
+#define SOFT_FADD       70      // fadd, fsub
+#define SOFT_FMUL       60
+#define SOFT_FDIV       150
+#define SOFT_I2F        30
+#define SOFT_F2I        25
+// Thumb instructions of the integer pixel loop: two map and two level
+// loads, two multiplies, the threshold load and compare, the read-modify-
+// write of the lit half of the pixels and the loop, 2 cycles a load or store
+#define INT_PIXEL       26
+// Integer overhead the float pixel loop has as well
+#define FLOAT_PIXEL     20
+// Unpacking a step and setting up a row
+#define INT_UNPACK      7
+#define INT_ROW         40
+
+// DrawWaterfall() as it was in app/spectrum.c, minus the extrapolation past
+// the last step that read outside 0..15, reading rows by age
+static void DrawFloat(uint16_t Scroll, uint16_t Steps)
+{
+    static const uint8_t bayer4x4[4][4] = {
+        { 0, 8, 2, 10 }, { 12, 4, 14, 6 }, { 3, 11, 1, 9 }, { 15, 7, 13, 5 }
+    };
+    const float xScale = (float)Steps / 128;
+    HOST_AdvanceCycles(SOFT_I2F + SOFT_FDIV);
+
+    for (uint8_t y_offset = 0; y_offset < ROWS; y_offset++) {
+        const uint16_t historyRow = Scroll + y_offset;
+
+        const uint8_t y_pos = TOP + y_offset;
+        const float   fade  = 1.0f - (float)y_offset / ROWS;
+        HOST_AdvanceCycles(SOFT_I2F + SOFT_FDIV + SOFT_FADD);
+
+        for (uint8_t x = 0; x < 128; x++) {
+            uint16_t specIdx = (uint16_t)(x * xScale);
+            float    frac    = (x * xScale) - specIdx;
+            if (specIdx >= Steps - 1) {
+                specIdx = Steps - 2;
+                frac    = 1.0f;
+            }
+            const uint8_t l0    = gHistory[historyRow][specIdx];
+            const uint8_t l1    = gHistory[historyRow][specIdx + 1];
+            uint8_t       level = (uint8_t)((l0 * (1.0f - frac) + l1 * frac) * fade);
+            if (level > 15) level = 15;
+            // x, specIdx, l0 and l1 converted, four products, 1 - frac and
+            // the two differences, two truncations
+            HOST_AdvanceCycles(4 * SOFT_I2F + 4 * SOFT_FMUL + 3 * SOFT_FADD + 2 * SOFT_F2I + FLOAT_PIXEL);
+
+            if (level > bayer4x4[y_pos & 3][x & 3])
+                gFrameBuffer[y_pos / 8][x] |= 1u << (y_pos % 8);
+        }
+    }
+}
+
+static void FillHistory(unsigned Seed)
+{
+    srand(Seed);
+    WATERFALL_Clear();
+    for (unsigned j = WATERFALL_DEPTH; j-- > 0;) {
+        for (unsigned i = 0; i < 128; i++)
+            gHistory[j][i] = rand() % 16;
+        WATERFALL_Push(gHistory[j], 128);
+    }
+}
+
+// Row k of a long run, recognisable from any age
+static void PatternRow(uint8_t *pLevels, unsigned k)
+{
+    for (unsigned i = 0; i < 128; i++)
+        pLevels[i] = (k * 7 + i + k / 13) & 15;
+}
+
+// Checks every readable row of a run of Pushed rows made by PatternRow()
+static unsigned CheckPattern(unsigned Pushed)
+{
+    WATERFALL_Reader_t Reader;
+    const uint8_t     *pRow;
+    unsigned           Age = 0;
+    unsigned           Bad = 0;
+
+    WATERFALL_OpenReader(&Reader, 0);
+    while ((pRow = WATERFALL_ReadRow(&Reader)) != NULL) {
+        uint8_t Levels[128];
+        PatternRow(Levels, Pushed - 1 - Age);
+        for (unsigned i = 0; i < 128; i++)
+            Bad += WATERFALL_Level(pRow, i) != Levels[i];
+        Age++;
+    }
+
+    CHECK_EQ(Age, WATERFALL_GetDepth());
+    return Bad;
+}
+
+// Estimated Cortex-M0+ cycles of one frame, from the constants above
+static uint64_t CyclesPerFrame(bool Float, uint16_t Steps)
+{
+    const unsigned Frames = 20;
+    const uint64_t Start  = HOST_GetCycles();
+
+    for (unsigned i = 0; i < Frames; i++) {
+        if (Float) {
+            DrawFloat(i % (WATERFALL_DEPTH - ROWS), Steps);
+        } else {
+            WATERFALL_Draw(Steps, TOP, i % (WATERFALL_DEPTH - ROWS));
+            HOST_AdvanceCycles(ROWS * (INT_ROW + Steps * INT_UNPACK + LCD_WIDTH * INT_PIXEL));
+        }
+    }
+
+    return (HOST_GetCycles() - Start) / Frames;
+}
+
+TEST(rows_are_packed_in_push_order)
+{
+    uint8_t Levels[128];
+
+    SYSTICK_Init();
+    WATERFALL_Clear();
+    CHECK_EQ(WATERFALL_GetDepth(), 0);
+
+    // A spill interval apart, so the rows that reach flash are not merged
+    for (unsigned k = 0; k < WATERFALL_DEPTH + 5; k++) {
+        PatternRow(Levels, k);
+        WATERFALL_Push(Levels, 128);
+#ifdef ENABLE_WATERFALL_SCROLLBACK
+        HOST_AdvanceUs(WATERFALL_SPILL_MS * 1000);
+#endif
+    }
+    CHECK_EQ(WATERFALL_GetDepth() >= WATERFALL_DEPTH, 1);
+    CHECK_EQ(CheckPattern(WATERFALL_DEPTH + 5), 0);
+
+    // A short row leaves the steps past it dark
+    memset(Levels, 15, sizeof(Levels));
+    WATERFALL_Push(Levels, 33);
+
+    WATERFALL_Reader_t Reader;
+    WATERFALL_OpenReader(&Reader, 0);
+    const uint8_t *pRow = WATERFALL_ReadRow(&Reader);
+    CHECK(pRow != NULL);
+    CHECK_EQ(WATERFALL_Level(pRow, 32), 15);
+    CHECK_EQ(WATERFALL_Level(pRow, 33), 0);
+    CHECK_EQ(WATERFALL_Level(pRow, 127), 0);
+
+    BENCH("waterfall.ram_bytes_per_row", "%u", WATERFALL_ROW_BYTES);
+    BENCH("waterfall.ram_rows", "%u", WATERFALL_DEPTH);
+}
+
+#ifdef ENABLE_WATERFALL_SCROLLBACK
+TEST(scrollback_reads_rows_from_flash)
+{
+    const unsigned SectorRows = HOST_FLASH_SECTOR_SIZE / WATERFALL_ROW_BYTES;
+    const unsigned FlashRows  = WATERFALL_FLASH_SECTORS * SectorRows;
+    uint8_t        Levels[128];
+    unsigned       k = 0;
+
+    // One row per spill interval, every row reaches flash
+    SYSTICK_Init();
+    WATERFALL_Clear();
+    HOST_FLASH_ResetStats();
+
+    for (; k < WATERFALL_DEPTH + 3 * SectorRows + 10; k++) {
+        PatternRow(Levels, k);
+        WATERFALL_Push(Levels, 128);
+        PY25Q16_Poll();
+        HOST_AdvanceUs(WATERFALL_SPILL_MS * 1000);
+    }
+    CHECK_EQ(WATERFALL_GetDepth(), k);
+    CHECK_EQ(CheckPattern(k), 0);
+
+    // Round the flash ring and then some: the sector being filled replaces
+    // the oldest one
+    for (; k < WATERFALL_DEPTH + 2 * FlashRows + 5; k++) {
+        PatternRow(Levels, k);
+        WATERFALL_Push(Levels, 128);
+        PY25Q16_Poll();
+        HOST_AdvanceUs(WATERFALL_SPILL_MS * 1000);
+    }
+    CHECK(WATERFALL_GetDepth() > WATERFALL_DEPTH + FlashRows - SectorRows);
+    CHECK(WATERFALL_GetDepth() <= WATERFALL_DEPTH + FlashRows);
+    CHECK_EQ(CheckPattern(k), 0);
+
+    const HOST_FLASH_Stats_t *pStats = HOST_FLASH_GetStats();
+    BENCH("waterfall.scrollback_rows", "%u", WATERFALL_GetDepth());
+    BENCH("waterfall.flash_erases_per_1k_rows", "%.1f", pStats->SectorErases * 1000.0 / (k - WATERFALL_DEPTH));
+    CHECK(pStats->SectorErases <= (k - WATERFALL_DEPTH) / SectorRows + 1);
+
+    // Clear() drops the flash rows along with the RAM ones
+    WATERFALL_Clear();
+    CHECK_EQ(WATERFALL_GetDepth(), 0);
+}
+
+TEST(fast_rows_are_merged_before_flash)
+{
+    const unsigned PerSpill = 10;
+    uint8_t        Levels[128];
+
+    SYSTICK_Init();
+    WATERFALL_Clear();
+    memset(Levels, 0, sizeof(Levels));
+    for (unsigned k = 0; k < WATERFALL_DEPTH; k++)
+        WATERFALL_Push(Levels, 128);
+    HOST_FLASH_ResetStats();
+
+    // Ten rows per interval leave RAM and one flash row, and so a tenth of
+    // the erases, holds their max: a carrier seen in one of them is kept
+    const unsigned Spills = 3 * 64;
+    for (unsigned k = 0; k < Spills * PerSpill; k++) {
+        memset(Levels, 2, sizeof(Levels));
+        if (k % PerSpill == 3)
+            Levels[40] = 15;
+        WATERFALL_Push(Levels, 128);
+        PY25Q16_Poll();
+        HOST_AdvanceUs(WATERFALL_SPILL_MS * 1000 / PerSpill);
+    }
+    CHECK(WATERFALL_GetDepth() >= WATERFALL_DEPTH + Spills - 1);
+    CHECK(WATERFALL_GetDepth() <= WATERFALL_DEPTH + Spills + 1);
+
+    WATERFALL_Reader_t Reader;
+    const uint8_t     *pRow;
+    WATERFALL_OpenReader(&Reader, WATERFALL_DEPTH);
+    for (unsigned n = 0; n < 10 && (pRow = WATERFALL_ReadRow(&Reader)) != NULL; n++) {
+        CHECK_EQ(WATERFALL_Level(pRow, 40), 15);
+        CHECK_EQ(WATERFALL_Level(pRow, 41), 2);
+    }
+
+    BENCH("waterfall.flash_rows_per_1k_rows_10_per_spill", "%.1f",
+          (WATERFALL_GetDepth() - WATERFALL_DEPTH) * 1000.0 / (Spills * PerSpill));
+}
+#endif
+
+TEST(matches_float_renderer)
+{
+    static const uint16_t Steps[] = { 16, 32, 64, 128 };
+    uint8_t               Reference[FRAME_LINES][LCD_WIDTH];
+    unsigned              Pixels = 0;
+    unsigned              Differ = 0;
+
+    for (unsigned s = 0; s < 4; s++) {
+        for (unsigned Seed = 1; Seed <= 8; Seed++) {
+            FillHistory(Seed);
+            const uint16_t Scroll = Seed % (WATERFALL_DEPTH - ROWS + 1);
+
+            memset(gFrameBuffer, 0, sizeof(gFrameBuffer));
+            DrawFloat(Scroll, Steps[s]);
+            memcpy(Reference, gFrameBuffer, sizeof(Reference));
+
+            memset(gFrameBuffer, 0, sizeof(gFrameBuffer));
+            WATERFALL_Draw(Steps[s], TOP, Scroll);
+
+            for (unsigned y = TOP; y < TOP + ROWS; y++) {
+                for (unsigned x = 0; x < LCD_WIDTH; x++) {
+                    const uint8_t Mask = 1u << (y % 8);
+                    Pixels++;
+                    Differ += (Reference[y / 8][x] & Mask) != (gFrameBuffer[y / 8][x] & Mask);
+                }
+            }
+
+            // Nothing outside the waterfall rows
+            for (unsigned x = 0; x < LCD_WIDTH; x++)
+                CHECK_EQ(gFrameBuffer[TOP / 8][x] & ((1u << (TOP % 8)) - 1), 0);
+        }
+    }
+
+    BENCH("waterfall.pixels_differing", "%u/%u", Differ, Pixels);
+    CHECK(Differ == 0);
+}
+
+TEST(frame_cost_estimate)
+{
+    FillHistory(42);
+
+    const uint64_t Float = CyclesPerFrame(true, 128);
+    const uint64_t Int   = CyclesPerFrame(false, 128);
+
+    BENCH("waterfall.est_float_frame_us", "%.0f", (double)Float / HOST_CYCLES_PER_US);
+    BENCH("waterfall.est_int_frame_us", "%.0f", (double)Int / HOST_CYCLES_PER_US);
+    BENCH("waterfall.est_speedup", "%.1f", (double)Float / Int);
+}
+
+TEST_MAIN_BEGIN
+    RUN(rows_are_packed_in_push_order);
+#ifdef ENABLE_WATERFALL_SCROLLBACK
+    RUN(scrollback_reads_rows_from_flash);
+    RUN(fast_rows_are_merged_before_flash);
+#endif
+    RUN(matches_float_renderer);
+    RUN(frame_cost_estimate);
+TEST_MAIN_END
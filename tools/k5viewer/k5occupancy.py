@@ -0,0 +1,153 @@
+#!/usr/bin/env python3
+
+import sys
+import csv
+import struct
+import argparse
+
+import serial
+from serial.tools import list_ports
+
+# Version
+VERSION = '1.0'
+
+# Serial configuration
+DEFAULT_PORT = '/dev/ttyACM0'  # Change if needed (COM5, /dev/cu.usbmodem...)
+BAUDRATE = 38400               # Programming cable speed, ignored by the USB VCP
+TIMEOUT = 1.0
+
+# Protocol
+CMD_READ_OCCUPANCY = 0x0613
+CHUNK = 12                                  # bins per reply
+SURVEY_HEADER = struct.Struct('<HIBBB')     # sweeps, elapsed s, bins, first, count
+ENTRY = struct.Struct('<IHHH')              # frequency, busy, max, last seen
+
+OBFUSCATION = bytes([
+    0x16, 0x6C, 0x14, 0xE6, 0x2E, 0x91, 0x0D, 0x40,
+    0x21, 0x35, 0xD5, 0x40, 0x13, 0x03, 0xE9, 0x80,
+])
+
+
+def crc16(data: bytes) -> int:
+    crc = 0
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def build_command(payload: bytes) -> bytes:
+    # AB CD | size | payload+crc (obfuscated) | DC BA, as app/uart.c expects
+    body = bytearray(payload + struct.pack('<H', crc16(payload)))
+    for i in range(len(body)):
+        body[i] ^= OBFUSCATION[i % 16]
+    return b'\xAB\xCD' + struct.pack('<H', len(payload)) + bytes(body) + b'\xDC\xBA'
+
+
+def read_reply(ser: serial.Serial) -> bytes:
+    # AB CD | size | payload (obfuscated) | 2 padding bytes, DC BA
+    while True:
+        b = ser.read(1)
+        if not b:
+            raise TimeoutError("no reply from the radio")
+        if b != b'\xAB' or ser.read(1) != b'\xCD':
+            continue
+        size = struct.unpack('<H', ser.read(2))[0]
+        body = ser.read(size + 4)
+        if len(body) != size + 4 or body[-2:] != b'\xDC\xBA':
+            continue
+        return bytes(body[i] ^ OBFUSCATION[i % 16] for i in range(size))
+
+
+def read_chunk(ser: serial.Serial, first: int):
+    ser.write(build_command(struct.pack('<HHBB', CMD_READ_OCCUPANCY, 2, first, CHUNK)))
+    while True:
+        reply = read_reply(ser)
+        if struct.unpack_from('<H', reply)[0] == CMD_READ_OCCUPANCY:
+            break
+    sweeps, elapsed, bins, first, count = SURVEY_HEADER.unpack_from(reply, 4)
+    entries = [ENTRY.unpack_from(reply, 4 + SURVEY_HEADER.size + k * ENTRY.size) for k in range(count)]
+    return sweeps, elapsed, bins, entries
+
+
+def read_survey(ser: serial.Serial):
+    sweeps, elapsed, bins, entries = read_chunk(ser, 0)
+    while len(entries) < bins:
+        _, _, _, more = read_chunk(ser, len(entries))
+        if not more:
+            break
+        entries += more
+    return sweeps, elapsed, entries
+
+
+def cmd_list_ports(args: argparse.Namespace):
+    ports = list_ports.comports()
+    print("Available ports:")
+    for port in ports:
+        if port.vid is None:  # Skipping virtual or non-USB ports
+            continue
+        description = " - ".join(filter(None, (port.product, port.manufacturer)))
+        if description:
+            print(f"- {description} : {port.device}")
+        else:
+            print(f"- {port.device}")
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        prog="K5Occupancy",
+        description="Reads the UV-K5 spectrum occupancy survey, busiest frequencies first",
+    )
+    parser.add_argument("--list-ports", action="store_true", help="list available ports and exit")
+    parser.add_argument("--port", type=str, help="serial port to use (in place of 'DEFAULT_PORT')")
+    parser.add_argument("--csv", type=str, help="also write every bin to this CSV file")
+    parser.add_argument("--all", action="store_true", help="list bins that were never busy too")
+    parser.add_argument("--version", action="version", version=f"%(prog)s {VERSION}", help="show program's version number and exit")
+
+    args = parser.parse_args()
+    if args.list_ports:
+        cmd_list_ports(args)
+        exit(0)
+    try:
+        ser = serial.Serial(args.port or DEFAULT_PORT, BAUDRATE, timeout=TIMEOUT)
+    except serial.SerialException as e:
+        print(f"[!] Serial error: {e}")
+        sys.exit(1)
+
+    try:
+        sweeps, elapsed, entries = read_survey(ser)
+    except TimeoutError as e:
+        print(f"[!] {e}")
+        sys.exit(1)
+    finally:
+        ser.close()
+
+    rows = []
+    for frequency, busy, level, last_seen in entries:
+        rows.append({
+            'mhz': frequency / 100000,
+            'busy_pct': 100 * busy / sweeps if sweeps else 0,
+            'max_dbm': level / 2 - 160,
+            'last_seen_s_ago': elapsed - last_seen if busy else None,
+        })
+
+    print(f"{sweeps} sweeps over {elapsed} s")
+    print(f"{'MHz':>11} {'busy':>6} {'max dBm':>8} {'seen':>8}")
+    for row in sorted(rows, key=lambda r: (-r['busy_pct'], -r['max_dbm'])):
+        if row['last_seen_s_ago'] is None and not args.all:
+            continue
+        seen = '-' if row['last_seen_s_ago'] is None else f"{row['last_seen_s_ago']} s"
+        print(f"{row['mhz']:11.5f} {row['busy_pct']:5.1f}% {row['max_dbm']:8.1f} {seen:>8}")
+
+    if args.csv:
+        with open(args.csv, 'w', newline='') as f:
+            writer = csv.DictWriter(f, fieldnames=list(rows[0].keys()) if rows else ['mhz'])
+            writer.writeheader()
+            writer.writerows(rows)
+        print(f"[✔] Wrote {args.csv}")
+
+
+if __name__ == "__main__":
+    main()
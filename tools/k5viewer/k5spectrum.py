@@ -0,0 +1,252 @@
+#!/usr/bin/env python3
+
+import os
+import sys
+import time
+import struct
+import datetime
+import argparse
+
+os.environ["PYGAME_HIDE_SUPPORT_PROMPT"] = "hide"
+
+import pygame
+import serial
+from serial.tools import list_ports
+
+# Version
+VERSION = '1.0'
+
+# Serial configuration, the stream only runs over the radio's USB port
+DEFAULT_PORT = '/dev/ttyACM0'  # Change if needed (COM5, /dev/cu.usbmodem...)
+BAUDRATE = 115200              # Ignored by the USB VCP
+TIMEOUT = 0.2
+
+# Protocol
+HEADER = b'\xAA\x55'
+TYPE_SPECTRUM = 0x03
+SWEEP_HEADER = struct.Struct('<HHHIIIH')   # seq, drop busy, drop credit, time us, start, step, count
+MAX_BINS = 128
+
+# Flow control: frames granted at a time, topped up once half are used
+CREDITS = 8
+
+OBFUSCATION = bytes([
+    0x16, 0x6C, 0x14, 0xE6, 0x2E, 0x91, 0x0D, 0x40,
+    0x21, 0x35, 0xD5, 0x40, 0x13, 0x03, 0xE9, 0x80,
+])
+
+# Display
+HISTORY = 512               # waterfall rows kept
+TRACE_HEIGHT = 160
+DBM_MIN, DBM_MAX = -130, -40
+
+
+def crc16(data: bytes) -> int:
+    crc = 0
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def build_command(payload: bytes) -> bytes:
+    # AB CD | size | payload+crc (obfuscated) | DC BA, as app/uart.c expects
+    body = bytearray(payload + struct.pack('<H', crc16(payload)))
+    for i in range(len(body)):
+        body[i] ^= OBFUSCATION[i % 16]
+    return b'\xAB\xCD' + struct.pack('<H', len(payload)) + bytes(body) + b'\xDC\xBA'
+
+
+def send_grant(ser: serial.Serial, credits: int):
+    try:
+        ser.write(build_command(struct.pack('<HHB', 0x0612, 1, credits)))
+    except serial.SerialException:
+        pass
+
+
+def read_sweep(ser: serial.Serial):
+    # Returns (header fields, rssi list) or None on timeout
+    while True:
+        try:
+            b = ser.read(1)
+        except serial.SerialException:
+            print("[!] Serial read failed, is the port used by another application?")
+            sys.exit(1)
+        if not b:
+            return None
+        if b != HEADER[0:1] or ser.read(1) != HEADER[1:2]:
+            continue
+        t = ser.read(1)
+        size = int.from_bytes(ser.read(2), 'big')
+        if not t or t[0] != TYPE_SPECTRUM or size < SWEEP_HEADER.size:
+            continue
+        payload = ser.read(size + 1)
+        if len(payload) != size + 1 or payload[size] != 0x0A:
+            continue
+        fields = SWEEP_HEADER.unpack_from(payload)
+        count = fields[6]
+        if count > MAX_BINS or size != SWEEP_HEADER.size + count * 2:
+            continue
+        rssi = struct.unpack_from(f'<{count}H', payload, SWEEP_HEADER.size)
+        return fields, rssi
+
+
+def rssi_to_dbm(raw: int) -> float:
+    return raw / 2 - 160
+
+
+def make_palette():
+    # Black - blue - cyan - yellow - red - white
+    stops = [(0, 0, 0), (0, 0, 160), (0, 200, 220), (240, 230, 0), (230, 30, 0), (255, 255, 255)]
+    palette = []
+    for i in range(256):
+        pos = i / 255 * (len(stops) - 1)
+        k = min(int(pos), len(stops) - 2)
+        f = pos - k
+        a, b = stops[k], stops[k + 1]
+        palette.append(tuple(int(a[c] + (b[c] - a[c]) * f) for c in range(3)))
+    return palette
+
+
+def level(raw: int) -> int:
+    v = (rssi_to_dbm(raw) - DBM_MIN) / (DBM_MAX - DBM_MIN)
+    return max(0, min(255, int(v * 255)))
+
+
+def run_viewer(args: argparse.Namespace, ser: serial.Serial):
+    scale = 6
+    pygame.init()
+    font = pygame.font.SysFont("monospace", 14)
+    palette = make_palette()
+
+    bins = MAX_BINS
+    history = pygame.Surface((bins, HISTORY))
+    screen = pygame.display.set_mode((bins * scale, TRACE_HEIGHT + HISTORY))
+    base_title = f"Quansheng K5 Spectrum v{VERSION}"
+    pygame.display.set_caption(f"{base_title} – No data")
+
+    credits = 0
+    sweeps = 0
+    last_time = time.monotonic()
+    last_seq = None
+    lost = 0
+    fields, rssi = None, ()
+
+    while True:
+        for event in pygame.event.get():
+            if event.type == pygame.QUIT:
+                raise KeyboardInterrupt
+            elif event.type == pygame.KEYDOWN:
+                if event.key == pygame.K_q:
+                    raise KeyboardInterrupt
+                if event.key == pygame.K_SPACE:
+                    filename = datetime.datetime.now().strftime("spectrum_%Y%m%d_%H%M%S.png")
+                    pygame.image.save(screen, filename)
+                    print(f"[✔] Screenshot saved: {filename}")
+                elif event.key == pygame.K_UP and scale < 12:
+                    scale += 1
+                    screen = pygame.display.set_mode((bins * scale, TRACE_HEIGHT + HISTORY))
+                elif event.key == pygame.K_DOWN and scale > 2:
+                    scale -= 1
+                    screen = pygame.display.set_mode((bins * scale, TRACE_HEIGHT + HISTORY))
+
+        # Keep the radio's grant topped up; a lost grant or frame only
+        # stalls the stream until the read timeout
+        if credits <= CREDITS // 2:
+            send_grant(ser, CREDITS)
+            credits = CREDITS
+
+        sweep = read_sweep(ser)
+        if not sweep:
+            credits = 0
+            pygame.display.set_caption(f"{base_title} – No data")
+            continue
+
+        credits -= 1
+        fields, rssi = sweep
+        seq, drop_busy, drop_credit, time_us, start, step, count = fields
+        if last_seq is not None:
+            lost += (seq - last_seq - 1) & 0xFFFF
+        last_seq = seq
+
+        if count != bins:
+            bins = count
+            history = pygame.Surface((bins, HISTORY))
+            screen = pygame.display.set_mode((bins * scale, TRACE_HEIGHT + HISTORY))
+
+        # Waterfall: newest row on top, one pixel per bin
+        history.scroll(0, 1)
+        for i, raw in enumerate(rssi):
+            history.set_at((i, 0), palette[level(raw)])
+
+        screen.fill((0, 0, 0))
+        screen.blit(pygame.transform.scale(history, (bins * scale, HISTORY)), (0, TRACE_HEIGHT))
+
+        # Trace of the latest sweep
+        points = []
+        for i, raw in enumerate(rssi):
+            y = TRACE_HEIGHT - 1 - level(raw) * (TRACE_HEIGHT - 20) // 255
+            points.append((i * scale + scale // 2, y))
+        if len(points) > 1:
+            pygame.draw.lines(screen, (0, 255, 0), False, points)
+
+        f0 = start / 100000
+        f1 = (start + step * (count - 1)) / 100000
+        info = f"{f0:.5f} - {f1:.5f} MHz  step {step * 10} Hz  seq {seq}  lost {lost}  busy {drop_busy}  credit {drop_credit}"
+        screen.blit(font.render(info, True, (200, 200, 200)), (4, 2))
+        pygame.display.flip()
+
+        sweeps += 1
+        now = time.monotonic()
+        if now - last_time >= 1.0:
+            pygame.display.set_caption(f"{base_title} – {sweeps / (now - last_time):.1f} sweeps/s")
+            sweeps = 0
+            last_time = now
+
+
+def cmd_list_ports(args: argparse.Namespace):
+    ports = list_ports.comports()
+    print("Available ports:")
+    for port in ports:
+        if port.vid is None:  # Skipping virtual or non-USB ports
+            continue
+        description = " - ".join(filter(None, (port.product, port.manufacturer)))
+        if description:
+            print(f"- {description} : {port.device}")
+        else:
+            print(f"- {port.device}")
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        prog="K5Spectrum",
+        description="A live high resolution waterfall of the UV-K5 spectrum sweep over USB",
+    )
+    parser.add_argument("--list-ports", action="store_true", help="list available ports and exit")
+    parser.add_argument("--port", type=str, help="serial port to use (in place of 'DEFAULT_PORT')")
+    parser.add_argument("--version", action="version", version=f"%(prog)s {VERSION}", help="show program's version number and exit")
+
+    args = parser.parse_args()
+    if args.list_ports:
+        cmd_list_ports(args)
+        exit(0)
+    serial_port = args.port or DEFAULT_PORT
+    try:
+        ser = serial.Serial(serial_port, BAUDRATE, timeout=TIMEOUT)
+    except serial.SerialException as e:
+        print(f"[!] Serial error: {e}")
+        sys.exit(1)
+    try:
+        run_viewer(args, ser)
+    except KeyboardInterrupt:
+        print("[✔] Exiting")
+        send_grant(ser, 0)
+        ser.close()
+        pygame.quit()
+        sys.exit()
+
+
+if __name__ == "__main__":
+    main()